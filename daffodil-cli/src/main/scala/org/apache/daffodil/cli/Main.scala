@@ -834,6 +834,16 @@ class CLIConf(arguments: Array[String], stdout: PrintStream, stderr: PrintStream
         argName = "file",
         descr = "XML file containing configuration items"
       )
+      val filter = opt[String](
+        argName = "expression",
+        descr =
+          "DFDL expression which each record must pass to be parsed in full and written. Same as -T cFilter=<expression>."
+      )
+      val projection = opt[String](
+        argName = "paths",
+        descr =
+          "Whitespace separated infoset paths to keep, skipping the data of fixed length elements outside them. Same as -T cProjection=<paths>."
+      )
       val rootNS = opt[RefQName](
         "root",
         argName = "node",
@@ -1854,7 +1864,9 @@ class Main(
         // Read any config file and any tunables given as arguments
         val optDafConfig = generateOpts.config.toOption.map { DaffodilConfig.fromFile(_) }
         val tunables =
-          DaffodilTunables.configPlusMoreTunablesMap(generateOpts.tunables, optDafConfig)
+          DaffodilTunables.configPlusMoreTunablesMap(generateOpts.tunables, optDafConfig) ++
+            generateOpts.filter.toOption.map { "cFilter" -> _ } ++
+            generateOpts.projection.toOption.map { "cProjection" -> _ }
 
         // Create a CodeGenerator from the DFDL schema
         val generator = createGeneratorFromSchema(
@@ -18,10 +18,12 @@
 package org.apache.daffodil.cli.cliTest
 
 import java.nio.file.Files.exists
+import java.nio.file.Files.readString
 
 import org.apache.daffodil.cli.Main.ExitCode
 import org.apache.daffodil.cli.cliTest.Util.*
 
+import org.junit.Assert.assertFalse
 import org.junit.Assert.assertTrue
 import org.junit.Test
 
@@ -154,4 +156,34 @@ class TestCLIGenerate {
       assertTrue(exists(tempDir.resolve("c/libruntime/generated_code.c")))
     }
   }
+
+  @Test def test_CLI_Generate_filter(): Unit = {
+    val schema = path(
+      "daffodil-codegen-c/src/test/resources/org/apache/daffodil/codegen/c/lsbf.dfdl.xsd"
+    )
+
+    withTempDir { tempDir =>
+      val filter = "{ /record/c eq 2748 }"
+      runCLI(args"generate c -s $schema --filter $filter $tempDir") { _ => }(ExitCode.Success)
+      val code = readString(tempDir.resolve("c/libruntime/generated_code.c"))
+      assertTrue(code.contains("pstate->filteredOut = "))
+    }
+  }
+
+  @Test def test_CLI_Generate_projection(): Unit = {
+    val schema = path(
+      "daffodil-codegen-c/src/test/resources/org/apache/daffodil/codegen/c/lsbf.dfdl.xsd"
+    )
+
+    withTempDir { tempDir =>
+      val projection = "/record/c /record/e"
+      runCLI(args"generate c -s $schema --projection $projection $tempDir") { _ => }(
+        ExitCode.Success
+      )
+      val code = readString(tempDir.resolve("c/libruntime/generated_code.c"))
+      assertTrue(code.contains("skip_bits("))
+      assertTrue(code.contains("\"c\""))
+      assertFalse(code.contains("\"d\""))
+    }
+  }
 }
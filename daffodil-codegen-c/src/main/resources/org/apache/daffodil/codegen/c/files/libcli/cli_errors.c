@@ -33,22 +33,59 @@ static const ErrorLookup *
 error_lookup(uint8_t code)
 {
     static const ErrorLookup table[CLI__NUM_CODES - ERR__NUM_CODES] = {
+        {CLI_CSV_CHOICE, "unable to plan CSV columns for choice in element '%s'\n", FIELD_S},
+        {CLI_CSV_COLUMN, "found no CSV column for element '%s'\n", FIELD_S},
+        {CLI_CSV_MEMORY, "error allocating memory for CSV row\n", FIELD__NO_ARGS},
+        {CLI_CSV_UNBOUNDED, "unable to plan CSV columns for unbounded array '%s'\n", FIELD_S},
+        {CLI_CSV_WRITE, "error writing CSV row\n", FIELD__NO_ARGS},
         {CLI_DIAGNOSTICS, "parse failed with %" PRId64 " diagnostics\n", FIELD_D64},
         {CLI_FILE_CLOSE, "error closing file\n", FIELD__NO_ARGS},
         {CLI_FILE_OPEN, "error opening file '%s'\n", FIELD_S},
+        {CLI_FILE_READ, "error reading file '%s'\n", FIELD_S},
         {CLI_HELP_USAGE,
          "Usage: %s [OPTION...] <command> [infile]\n"
          "\n"
          "Options:\n"
+         "  --async       Write output on a separate thread through a queue\n"
+         "                of buffers (generate-data, parse, and unparse only)\n"
          "  -h            Give this help list\n"
-         "  -I            Infoset type to write or read. Must be 'xml'\n"
+         "  -I            Infoset type to write or read. Use xml (default),\n"
+         "                or csv, tsv, or null (parse only)\n"
+         "  -i, --record  Parse only record N or records N-M (counting from 1)\n"
+         "                using infile's index (parse only)\n"
+         "  --io          Input backend to read infile with. Use stdio (default),\n"
+         "                mmap, or uring (index and parse only, falls back to\n"
+         "                mmap or stdio where unsupported)\n"
+         "  -N            Number of times to parse or unparse infile\n"
+         "                (performance only, default 1)\n"
+         "  -n            Number of records to generate\n"
+         "                (generate-data only, default 1)\n"
          "  -o            Write output to file. If not given or is -,\n"
-         "                output is written to stdout\n"
+         "                output is written to stdout (or infile.idx\n"
+         "                for index)\n"
+         "  -P            Profile elements and print a report of calls, bits,\n"
+         "                and cycles per element to stderr (parse, unparse,\n"
+         "                and performance only, needs -DDAFFODIL_PROFILE)\n"
+         "  -R            Seed for generating random values\n"
+         "                (generate-data only, default 0)\n"
+         "  -S            Stream mode. Parse records until no data is left\n"
+         "  -t            Number of threads to use (performance only, default 1)\n"
+         "  -u            Unparse instead of parse (performance only)\n"
          "  -V            Validate mode to choose. Use off (default), limited, or on\n"
          "  -v            Print program version\n"
+         "  --warmup      Number of untimed times each thread parses or\n"
+         "                unparses infile first (performance only, default 1)\n"
          "\n"
          "Commands:\n"
+         "  generate-data Unparse random infosets which satisfy the schema's\n"
+         "                restrictions to a data file\n"
+         "  index         Frame each record of infile without parsing all\n"
+         "                its fields and write where each record starts\n"
          "  parse         Parse a data file to an infoset file\n"
+         "  performance   Parse (or unparse) infile from memory repeatedly\n"
+         "                and report rates and latencies to output\n"
+         "  serve         Answer parse and unparse requests framed by their\n"
+         "                lengths on stdin with responses on stdout\n"
          "  unparse       Unparse an infoset file to a data file\n"
          "\n"
          "Argument:\n"
@@ -58,17 +95,32 @@ error_lookup(uint8_t code)
         {CLI_HEXBINARY_LENGTH, "odd hexBinary length -- %" PRId64 " nibbles\n", FIELD_D64},
         {CLI_HEXBINARY_PARSE, "invalid character in hexBinary -- '%c'\n", FIELD_C},
         {CLI_HEXBINARY_SIZE, "hexBinary too long -- only %" PRId64 " bytes allowed\n", FIELD_D64},
+        {CLI_INDEX_RECORD, "record %" PRId64 " not found in index file\n", FIELD_D64},
+        {CLI_INDEX_TRUNCATED, "warning: record range ends early at record %" PRId64 ", the last record in infile\n",
+         FIELD_D64},
+        {CLI_INDEX_UNALIGNED, "record %" PRId64 " does not start on a byte boundary\n", FIELD_D64},
+        {CLI_INDEX_WRITE, "error writing index file\n", FIELD__NO_ARGS},
         {CLI_INVALID_COMMAND, "invalid command -- '%s'\n" USAGE, FIELD_S},
         {CLI_INVALID_INFOSET, "invalid infoset type -- '%s'\n" USAGE, FIELD_S},
+        {CLI_INVALID_INFOSET_UNPARSE, "infoset type '%s' cannot be unparsed\n" USAGE, FIELD_S},
+        {CLI_INVALID_IO, "invalid input backend -- '%s'\n" USAGE, FIELD_S},
+        {CLI_INVALID_NUMBER, "invalid number -- '%s'\n" USAGE, FIELD_S},
         {CLI_INVALID_OPTION, "invalid option -- '%c'\n" USAGE, FIELD_C},
+        {CLI_INVALID_RECORD, "invalid record range -- '%s'\n" USAGE, FIELD_S},
         {CLI_INVALID_VALIDATE, "invalid validate mode -- '%s'\n" USAGE, FIELD_S},
         {CLI_MISSING_COMMAND, "missing command\n" USAGE, FIELD__NO_ARGS},
         {CLI_MISSING_VALUE, "option requires an argument -- '%c'\n" USAGE, FIELD_C},
+        {CLI_PERFORMANCE_MEMORY, "error allocating memory for performance test\n", FIELD__NO_ARGS},
+        {CLI_PERFORMANCE_THREAD, "error starting performance test thread\n", FIELD__NO_ARGS},
+        {CLI_PROFILE_DISABLED, "profiling needs -DDAFFODIL_PROFILE in CPPFLAGS\n" USAGE, FIELD__NO_ARGS},
         {CLI_PROGRAM_ERROR,
          "unexpected getopt code %" PRId64 "\n"
          "Check for program error\n",
          FIELD_D64},
         {CLI_PROGRAM_VERSION, "%s\n", FIELD_S_ON_STDOUT},
+        {CLI_SERVE_MEMORY, "error allocating memory for serve request\n", FIELD__NO_ARGS},
+        {CLI_SERVE_REQUEST, "invalid serve request -- '%s'\n", FIELD_S},
+        {CLI_SERVE_WRITE, "error writing serve response\n", FIELD__NO_ARGS},
         {CLI_STACK_EMPTY, "stack empty, stopping program\n", FIELD__NO_ARGS},
         {CLI_STACK_OVERFLOW, "stack overflow, stopping program\n", FIELD__NO_ARGS},
         {CLI_STACK_UNDERFLOW, "stack underflow, stopping program\n", FIELD__NO_ARGS},
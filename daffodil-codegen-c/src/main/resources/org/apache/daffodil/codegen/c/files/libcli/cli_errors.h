@@ -27,21 +27,41 @@
 
 enum CliCode
 {
-    CLI_DIAGNOSTICS = ERR__NUM_CODES,
+    CLI_CSV_CHOICE = ERR__NUM_CODES,
+    CLI_CSV_COLUMN,
+    CLI_CSV_MEMORY,
+    CLI_CSV_UNBOUNDED,
+    CLI_CSV_WRITE,
+    CLI_DIAGNOSTICS,
     CLI_FILE_CLOSE,
     CLI_FILE_OPEN,
+    CLI_FILE_READ,
     CLI_HELP_USAGE,
     CLI_HEXBINARY_LENGTH,
     CLI_HEXBINARY_PARSE,
     CLI_HEXBINARY_SIZE,
+    CLI_INDEX_RECORD,
+    CLI_INDEX_TRUNCATED,
+    CLI_INDEX_UNALIGNED,
+    CLI_INDEX_WRITE,
     CLI_INVALID_COMMAND,
     CLI_INVALID_INFOSET,
+    CLI_INVALID_INFOSET_UNPARSE,
+    CLI_INVALID_IO,
+    CLI_INVALID_NUMBER,
     CLI_INVALID_OPTION,
+    CLI_INVALID_RECORD,
     CLI_INVALID_VALIDATE,
     CLI_MISSING_COMMAND,
     CLI_MISSING_VALUE,
+    CLI_PERFORMANCE_MEMORY,
+    CLI_PERFORMANCE_THREAD,
+    CLI_PROFILE_DISABLED,
     CLI_PROGRAM_ERROR,
     CLI_PROGRAM_VERSION,
+    CLI_SERVE_MEMORY,
+    CLI_SERVE_REQUEST,
+    CLI_SERVE_WRITE,
     CLI_STACK_EMPTY,
     CLI_STACK_OVERFLOW,
     CLI_STACK_UNDERFLOW,
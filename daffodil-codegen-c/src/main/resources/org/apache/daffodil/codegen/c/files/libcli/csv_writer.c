@@ -0,0 +1,505 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include "csv_writer.h"
+#include <stdbool.h>     // for bool
+#include <stdint.h>      // for uint64_t, int64_t, uint8_t, int16_t, int32_t, int8_t, uint16_t, uint32_t, SIZE_MAX
+#include <stdio.h>       // for snprintf, fwrite
+#include <stdlib.h>      // for free, realloc
+#include <string.h>      // for memcpy, strlen, memchr, strcspn
+#include "cli_errors.h"  // for CLI_CSV_CHOICE, CLI_CSV_COLUMN, CLI_CSV_MEMORY, CLI_CSV_UNBOUNDED, CLI_CSV_WRITE
+// clang-format on
+
+// LIMIT_CELL_LENGTH - room needed by any number's text (a 64-bit
+// integer needs 20 characters and a double needs at most 24)
+
+#define LIMIT_CELL_LENGTH 32
+
+// Make room for at least length more characters in the row's buffer.
+// Return an error if no dynamic memory could be allocated.
+
+static const Error *
+csvReserve(CSVWriter *writer, size_t length)
+{
+    if (writer->rowLength + length > writer->rowCapacity)
+    {
+        size_t capacity = writer->rowCapacity ? writer->rowCapacity : 256;
+        while (writer->rowLength + length > capacity)
+        {
+            capacity *= 2;
+        }
+
+        char *row = realloc(writer->row, capacity);
+        if (!row)
+        {
+            static Error error = {CLI_CSV_MEMORY, {0}};
+            return &error;
+        }
+        writer->row = row;
+        writer->rowCapacity = capacity;
+    }
+
+    return NULL;
+}
+
+// Append text to the row's buffer
+
+static const Error *
+csvAppend(CSVWriter *writer, const char *text, size_t length)
+{
+    const Error *error = csvReserve(writer, length);
+    if (!error)
+    {
+        memcpy(writer->row + writer->rowLength, text, length);
+        writer->rowLength += length;
+    }
+    return error;
+}
+
+// Start the next cell in the row by appending a separator before any
+// cell other than the first one
+
+static const Error *
+csvStartCell(CSVWriter *writer)
+{
+    const Error *error = NULL;
+    if (writer->nextColumn++ > 0)
+    {
+        error = csvAppend(writer, &writer->separator, 1);
+    }
+    return error;
+}
+
+// Finish the row by leaving any unfilled cells empty, then write the
+// row and a newline to the stream
+
+static const Error *
+csvEndRow(CSVWriter *writer)
+{
+    const Error *error = NULL;
+    while (writer->nextColumn < writer->numColumns && !error)
+    {
+        error = csvStartCell(writer);
+    }
+    if (!error)
+    {
+        error = csvAppend(writer, "\n", 1);
+    }
+    if (!error && fwrite(writer->row, 1, writer->rowLength, writer->stream) < writer->rowLength)
+    {
+        static Error error_write = {CLI_CSV_WRITE, {0}};
+        error = &error_write;
+    }
+
+    writer->nextColumn = 0;
+    writer->rowLength = 0;
+    return error;
+}
+
+// Convert an unsigned integer to decimal text without calling printf
+// and return the number of characters written (no null terminator)
+
+static size_t
+formatUnsigned(char *text, uint64_t value)
+{
+    char digits[20];
+    size_t numDigits = 0;
+    do
+    {
+        digits[numDigits++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    for (size_t i = 0; i < numDigits; i++)
+    {
+        text[i] = digits[numDigits - 1 - i];
+    }
+    return numDigits;
+}
+
+// Convert a signed integer to decimal text without calling printf
+// and return the number of characters written (no null terminator)
+
+static size_t
+formatSigned(char *text, int64_t value)
+{
+    if (value < 0)
+    {
+        text[0] = '-';
+        return 1 + formatUnsigned(text + 1, 0 - (uint64_t)value);
+    }
+    return formatUnsigned(text, (uint64_t)value);
+}
+
+// CSVPath - chain of complex elements enclosing a column's element
+// (innermost first) which qualifies the column's name in the header
+
+typedef struct CSVPath
+{
+    const ERD *erd;               // complex element's ERD
+    size_t index;                 // 1-based index if it's an array element
+    const struct CSVPath *parent; // next enclosing complex element
+} CSVPath;
+
+// Append an element's name (with a 1-based index if it's an array
+// element) to the header row
+
+static const Error *
+csvAppendName(CSVWriter *writer, const ERD *erd, size_t index)
+{
+    const char *name = get_erd_name(erd);
+    const Error *error = csvAppend(writer, name, strlen(name));
+    if (!error && index)
+    {
+        char suffix[LIMIT_CELL_LENGTH];
+        size_t length = 0;
+        suffix[length++] = '[';
+        length += formatUnsigned(suffix + length, index);
+        suffix[length++] = ']';
+        error = csvAppend(writer, suffix, length);
+    }
+    return error;
+}
+
+// Append the names of a column's enclosing complex elements
+// (outermost first) to the header row, each followed by a dot
+
+static const Error *
+csvAppendPath(CSVWriter *writer, const CSVPath *path)
+{
+    const Error *error = NULL;
+    if (path)
+    {
+        error = csvAppendPath(writer, path->parent);
+        if (!error)
+        {
+            error = csvAppendName(writer, path->erd, path->index);
+        }
+        if (!error)
+        {
+            error = csvAppend(writer, ".", 1);
+        }
+    }
+    return error;
+}
+
+// Add a column for a simple type element to the column plan and
+// append its path-qualified name to the header row (an element's
+// bare name may be used more than once in a schema, so a header of
+// bare names could have duplicate columns)
+
+static const Error *
+csvAddColumn(CSVWriter *writer, const ERD *erd, size_t index, const CSVPath *path)
+{
+    // Grow the column plan by doubling whenever it's full (which
+    // happens each time the number of columns is a power of two)
+    if ((writer->numColumns & (writer->numColumns - 1)) == 0)
+    {
+        size_t capacity = writer->numColumns ? writer->numColumns * 2 : 1;
+        const ERD **columns = realloc(writer->columns, capacity * sizeof(*columns));
+        if (!columns)
+        {
+            static Error error = {CLI_CSV_MEMORY, {0}};
+            return &error;
+        }
+        writer->columns = columns;
+    }
+    writer->columns[writer->numColumns++] = erd;
+
+    // Append the column's name to the header row
+    const Error *error = csvStartCell(writer);
+    if (!error)
+    {
+        error = csvAppendPath(writer, path);
+    }
+    if (!error)
+    {
+        error = csvAppendName(writer, erd, index);
+    }
+
+    return error;
+}
+
+static const Error *csvPlanChildren(CSVWriter *writer, const ERD *erd, const CSVPath *path);
+
+// Walk an ERD tree depth-first and add one column per simple type
+// element, expanding each bounded array to its maxOccurs number of
+// columns
+
+static const Error *
+csvPlanColumns(CSVWriter *writer, const ERD *erd, size_t index, const CSVPath *path)
+{
+    const Error *error = NULL;
+
+    switch (erd->typeCode)
+    {
+    case ARRAY:
+        if (erd->numChildren == SIZE_MAX)
+        {
+            // An unbounded array's columns would depend on each row's data
+            static Error error_unbounded = {CLI_CSV_UNBOUNDED, {0}};
+            error_unbounded.arg.s = get_erd_name(erd);
+            error = &error_unbounded;
+        }
+        for (size_t i = 0; i < erd->numChildren && !error; i++)
+        {
+            error = csvPlanColumns(writer, erd->childrenERDs[0], i + 1, path);
+        }
+        break;
+    case COMPLEX:
+    {
+        const CSVPath complexPath = {erd, index, path};
+        error = csvPlanChildren(writer, erd, &complexPath);
+        break;
+    }
+    case CHOICE:
+        // Not reached since csvPlanChildren rejects choices first
+        break;
+    default:
+        error = csvAddColumn(writer, erd, index, path);
+        break;
+    }
+
+    return error;
+}
+
+// Plan the columns of a complex element's children
+
+static const Error *
+csvPlanChildren(CSVWriter *writer, const ERD *erd, const CSVPath *path)
+{
+    const Error *error = NULL;
+
+    for (size_t i = 0; i < erd->numChildren && !error; i++)
+    {
+        const ERD *childERD = erd->childrenERDs[i];
+        if (childERD->typeCode == CHOICE)
+        {
+            // A choice's columns would depend on each row's data
+            static Error error_choice = {CLI_CSV_CHOICE, {0}};
+            error_choice.arg.s = get_erd_name(erd);
+            error = &error_choice;
+        }
+        else
+        {
+            error = csvPlanColumns(writer, childERD, 0, path);
+        }
+    }
+
+    return error;
+}
+
+// csv_init_writer - compute column plan from root ERD and write
+// header row (call once before first walk_infoset)
+
+const Error *
+csv_init_writer(CSVWriter *writer, const ERD *rootERD)
+{
+    // Leave the root element's name out of its columns' names
+    const Error *error = rootERD->typeCode == COMPLEX ? csvPlanChildren(writer, rootERD, NULL)
+                                                      : csvPlanColumns(writer, rootERD, 0, NULL);
+    if (!error)
+    {
+        error = csvEndRow(writer);
+    }
+    return error;
+}
+
+// csv_fini_writer - free memory allocated by CSVWriter
+
+void
+csv_fini_writer(CSVWriter *writer)
+{
+    free(writer->columns);
+    free(writer->row);
+    writer->columns = NULL;
+    writer->numColumns = 0;
+    writer->row = NULL;
+    writer->rowCapacity = 0;
+}
+
+// Start a new row
+
+static const Error *
+csvStartDocument(CSVWriter *writer)
+{
+    writer->nextColumn = 0;
+    writer->rowLength = 0;
+    return NULL;
+}
+
+// Write the completed row to stream
+
+static const Error *
+csvEndDocument(CSVWriter *writer)
+{
+    return csvEndRow(writer);
+}
+
+// Complex elements have no cells of their own
+
+static const Error *
+csvStartComplex(CSVWriter *writer, const InfosetBase *base)
+{
+    UNUSED(writer);
+    UNUSED(base);
+    return NULL;
+}
+
+static const Error *
+csvEndComplex(CSVWriter *writer, const InfosetBase *base)
+{
+    UNUSED(writer);
+    UNUSED(base);
+    return NULL;
+}
+
+// Write a boolean, 32-bit or 64-bit real number, hexBinary, string,
+// or 8, 16, 32, or 64-bit signed or unsigned integer as a row's cell
+
+static const Error *
+csvSimpleElem(CSVWriter *writer, const ERD *erd, const void *valueptr)
+{
+    // Move to this element's column, leaving any skipped columns
+    // (e.g., missing array elements) empty
+    const Error *error = NULL;
+    while (writer->nextColumn < writer->numColumns && writer->columns[writer->nextColumn] != erd && !error)
+    {
+        error = csvStartCell(writer);
+    }
+    if (!error && writer->nextColumn == writer->numColumns)
+    {
+        static Error error_column = {CLI_CSV_COLUMN, {0}};
+        error_column.arg.s = get_erd_name(erd);
+        error = &error_column;
+    }
+    if (!error)
+    {
+        error = csvStartCell(writer);
+    }
+    if (error)
+    {
+        return error;
+    }
+
+    // Format hexBinary as two hexadecimal characters per byte
+    if (erd->typeCode == PRIMITIVE_HEXBINARY)
+    {
+        const HexBinary *hexBinary = (const HexBinary *)valueptr;
+        error = csvReserve(writer, hexBinary->lengthInBytes * 2);
+        if (!error)
+        {
+            static const char hexDigit[] = "0123456789ABCDEF";
+            char *nibble = writer->row + writer->rowLength;
+            for (size_t i = 0; i < hexBinary->lengthInBytes; i++)
+            {
+                *(nibble++) = hexDigit[hexBinary->array[i] / 16]; // high nibble
+                *(nibble++) = hexDigit[hexBinary->array[i] % 16]; // low nibble
+            }
+            writer->rowLength += hexBinary->lengthInBytes * 2;
+        }
+        return error;
+    }
+
+    // Format string as text, quoting it if it contains a separator,
+    // quote, or newline and doubling any quotes inside it
+    if (erd->typeCode == PRIMITIVE_STRING)
+    {
+        const String *string = (const String *)valueptr;
+        const char *chars = string->chars ? string->chars : "";
+        bool quote = strcspn(chars, "\"\r\n") < string->length;
+        quote = quote || memchr(chars, writer->separator, string->length);
+        error = csvReserve(writer, string->length * 2 + 2);
+        if (!error)
+        {
+            char *text = writer->row + writer->rowLength;
+            if (quote) *(text++) = '"';
+            for (size_t i = 0; i < string->length; i++)
+            {
+                if (chars[i] == '"') *(text++) = '"';
+                *(text++) = chars[i];
+            }
+            if (quote) *(text++) = '"';
+            writer->rowLength = (size_t)(text - writer->row);
+        }
+        return error;
+    }
+
+    // Format other types of values directly into row's buffer
+    error = csvReserve(writer, LIMIT_CELL_LENGTH);
+    if (error)
+    {
+        return error;
+    }
+    char *text = writer->row + writer->rowLength;
+    size_t length = 0;
+    switch (erd->typeCode)
+    {
+    case PRIMITIVE_BOOLEAN:
+        length = *(const bool *)valueptr ? 4 : 5;
+        memcpy(text, *(const bool *)valueptr ? "true" : "false", length);
+        break;
+    case PRIMITIVE_FLOAT:
+        // Print enough digits to read the same float back
+        length = (size_t)snprintf(text, LIMIT_CELL_LENGTH, "%.9G", (double)*(const float *)valueptr);
+        break;
+    case PRIMITIVE_DOUBLE:
+        // Print enough digits to read the same double back
+        length = (size_t)snprintf(text, LIMIT_CELL_LENGTH, "%.17G", *(const double *)valueptr);
+        break;
+    case PRIMITIVE_INT16:
+        length = formatSigned(text, *(const int16_t *)valueptr);
+        break;
+    case PRIMITIVE_INT32:
+        length = formatSigned(text, *(const int32_t *)valueptr);
+        break;
+    case PRIMITIVE_INT64:
+        length = formatSigned(text, *(const int64_t *)valueptr);
+        break;
+    case PRIMITIVE_INT8:
+        length = formatSigned(text, *(const int8_t *)valueptr);
+        break;
+    case PRIMITIVE_UINT16:
+        length = formatUnsigned(text, *(const uint16_t *)valueptr);
+        break;
+    case PRIMITIVE_UINT32:
+        length = formatUnsigned(text, *(const uint32_t *)valueptr);
+        break;
+    case PRIMITIVE_UINT64:
+        length = formatUnsigned(text, *(const uint64_t *)valueptr);
+        break;
+    case PRIMITIVE_UINT8:
+        length = formatUnsigned(text, *(const uint8_t *)valueptr);
+        break;
+    default:
+        // Leave cell empty
+        break;
+    }
+    writer->rowLength += length;
+
+    return NULL;
+}
+
+// Initialize a struct with our visitor event handler methods
+
+const VisitEventHandler csvWriterMethods = {
+    (VisitStartDocument)&csvStartDocument, (VisitEndDocument)&csvEndDocument,
+    (VisitStartComplex)&csvStartComplex,   (VisitEndComplex)&csvEndComplex,
+    (VisitSimpleElem)&csvSimpleElem,
+};
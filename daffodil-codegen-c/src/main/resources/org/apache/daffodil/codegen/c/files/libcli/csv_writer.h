@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stddef.h>   // for size_t
+#include <stdio.h>    // for FILE
+#include "errors.h"   // for Error
+#include "infoset.h"  // for VisitEventHandler, ERD
+// clang-format on
+
+// CSVWriter - infoset visitor with methods to output one CSV or TSV
+// row per infoset using a column plan computed once from the ERDs
+
+typedef struct CSVWriter
+{
+    const VisitEventHandler handler;
+    FILE *stream;
+    char separator;      // ',' for CSV or '\t' for TSV
+    const ERD **columns; // one simple type ERD per column
+    size_t numColumns;   // number of columns in plan
+    size_t nextColumn;   // next column to be filled in current row
+    char *row;           // text of current row
+    size_t rowLength;    // length of text in current row
+    size_t rowCapacity;  // capacity of row's buffer
+} CSVWriter;
+
+// CSVWriter methods to pass to walk_infoset method
+
+extern const VisitEventHandler csvWriterMethods;
+
+// csv_init_writer - compute column plan from root ERD and write
+// header row (call once before first walk_infoset)
+
+extern const Error *csv_init_writer(CSVWriter *writer, const ERD *rootERD);
+
+// csv_fini_writer - free memory allocated by CSVWriter
+
+extern void csv_fini_writer(CSVWriter *writer);
+
+#endif // CSV_WRITER_H
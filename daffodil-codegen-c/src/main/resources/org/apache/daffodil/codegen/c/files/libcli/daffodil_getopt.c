@@ -18,10 +18,15 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "daffodil_getopt.h"
+#include <errno.h>             // for errno
+#include <getopt.h>            // for getopt_long, option, no_argument, required_argument
+#include <stdint.h>            // for uint64_t
+#include <stdlib.h>            // for strtoull
 #include <string.h>            // for strcmp, strrchr
-#include <unistd.h>            // for optarg, getopt, optopt, optind
-#include "cli_errors.h"        // for CLI_UNEXPECTED_ARGUMENT, CLI_HELP_USAGE, CLI_INVALID_COMMAND, CLI_INVALID_INFOSET, CLI_INVALID_OPTION, CLI_INVALID_VALIDATE, CLI_MISSING_COMMAND, CLI_MISSING_VALUE, CLI_PROGRAM_ERROR, CLI_PROGRAM_VERSION
+#include <unistd.h>            // for optarg, optopt, optind
+#include "cli_errors.h"        // for CLI_UNEXPECTED_ARGUMENT, CLI_HELP_USAGE, CLI_INVALID_COMMAND, CLI_INVALID_INFOSET, CLI_INVALID_INFOSET_UNPARSE, CLI_INVALID_IO, CLI_INVALID_NUMBER, CLI_INVALID_OPTION, CLI_INVALID_RECORD, CLI_INVALID_VALIDATE, CLI_MISSING_COMMAND, CLI_MISSING_VALUE, CLI_PROFILE_DISABLED, CLI_PROGRAM_ERROR, CLI_PROGRAM_VERSION
 #include "daffodil_version.h"  // for daffodil_version
+#include "input.h"             // for is_input_backend
 // clang-format on
 
 // Initialize our "daffodil" CLI options
@@ -30,15 +35,87 @@ struct daffodil_cli daffodil_cli = {
     DAFFODIL_MISSING_COMMAND, // default subcommand
 };
 
+// Initialize our "daffodil generate-data" CLI options
+
+struct daffodil_gen_cli daffodil_gen = {
+    1, // default records
+    0, // default seed
+};
+
 // Initialize our "daffodil parse/unparse" CLI options
 
 struct daffodil_pu_cli daffodil_pu = {
-    "xml", // default infoset type
-    "-",   // default infile
-    "-",   // default outfile
-    false, // default validate
+    "xml",   // default infoset type
+    "-",     // default infile
+    "-",     // default outfile
+    "stdio", // default input backend
+    0,       // default first record (0 parses all records)
+    0,       // default last record
+    false,   // default async
+    false,   // default profile
+    false,   // default stream
+    false,   // default validate
+};
+
+// Initialize our "daffodil performance" CLI options
+
+struct daffodil_perf_cli daffodil_perf = {
+    1,     // default number
+    1,     // default threads
+    1,     // default warmup
+    false, // default unparse
 };
 
+// Convert a nonnegative number from an option's value or return false
+// if the value isn't a nonnegative number
+
+static bool
+strtonumber(const char *value, uint64_t *number)
+{
+    char *end = NULL;
+    errno = 0;
+    *number = strtoull(value, &end, 10);
+    return !(errno || end == value || *end || value[0] == '-');
+}
+
+// Convert a positive number from an option's value or return 0 if the
+// value isn't a positive number
+
+static size_t
+strtocount(const char *value)
+{
+    uint64_t number = 0;
+    return strtonumber(value, &number) ? (size_t)number : 0;
+}
+
+// Convert a record number N or range N-M from an option's value or
+// return false if the value isn't a positive number or ascending range
+
+static bool
+strtorange(const char *value, size_t *first, size_t *last)
+{
+    char *end = NULL;
+    errno = 0;
+    uint64_t number = strtoull(value, &end, 10);
+    if (errno || end == value || value[0] == '-' || !number)
+    {
+        return false;
+    }
+    *first = *last = (size_t)number;
+
+    if (*end == '-')
+    {
+        const char *rest = end + 1;
+        number = strtoull(rest, &end, 10);
+        if (errno || end == rest || rest[0] == '-' || number < *first)
+        {
+            return false;
+        }
+        *last = (size_t)number;
+    }
+    return !*end;
+}
+
 // Parse our command line interface.  Note there is NO portable way to
 // parse "daffodil [options] command [more options] arguments" with
 // getopt.  We will have to put all options before all arguments,
@@ -54,9 +131,26 @@ parse_daffodil_cli(int argc, char *argv[])
     const char *exe = strrchr(argv[0], '/');
     exe = exe ? exe + 1 : argv[0];
 
+    // Accept long names for options which Daffodil's CLI doesn't have
+    // (--async, --io, and --warmup have no short names, so give them
+    // values past any char)
+    enum
+    {
+        OPT_ASYNC = 256,
+        OPT_IO,
+        OPT_WARMUP
+    };
+    static const struct option long_options[] = {
+        {"record", required_argument, NULL, 'i'},
+        {"async", no_argument, NULL, OPT_ASYNC},
+        {"io", required_argument, NULL, OPT_IO},
+        {"warmup", required_argument, NULL, OPT_WARMUP},
+        {NULL, 0, NULL, 0},
+    };
+
     // We expect callers to put all non-option arguments at the end
     int opt = 0;
-    while ((opt = getopt(argc, argv, ":hI:o:r:s:V:v")) != -1)
+    while ((opt = getopt_long(argc, argv, ":hI:i:N:n:o:PR:r:Ss:t:uV:v", long_options, NULL)) != -1)
     {
         switch (opt)
         {
@@ -65,7 +159,8 @@ parse_daffodil_cli(int argc, char *argv[])
             error.arg.s = exe;
             return &error;
         case 'I':
-            if (strcmp("xml", optarg) != 0)
+            if (strcmp("xml", optarg) != 0 && strcmp("csv", optarg) != 0 && strcmp("tsv", optarg) != 0 &&
+                strcmp("null", optarg) != 0)
             {
                 error.code = CLI_INVALID_INFOSET;
                 error.arg.s = optarg;
@@ -73,15 +168,97 @@ parse_daffodil_cli(int argc, char *argv[])
             }
             daffodil_pu.infoset_converter = optarg;
             break;
+        case 'i':
+            if (!strtorange(optarg, &daffodil_pu.first_record, &daffodil_pu.last_record))
+            {
+                error.code = CLI_INVALID_RECORD;
+                error.arg.s = optarg;
+                return &error;
+            }
+            break;
+        case OPT_ASYNC:
+            daffodil_pu.async = true;
+            break;
+        case OPT_IO:
+            if (!is_input_backend(optarg))
+            {
+                error.code = CLI_INVALID_IO;
+                error.arg.s = optarg;
+                return &error;
+            }
+            daffodil_pu.io = optarg;
+            break;
+        case OPT_WARMUP:
+        {
+            uint64_t warmup = 0;
+            if (!strtonumber(optarg, &warmup))
+            {
+                error.code = CLI_INVALID_NUMBER;
+                error.arg.s = optarg;
+                return &error;
+            }
+            daffodil_perf.warmup = (size_t)warmup;
+            break;
+        }
+        case 'N':
+            daffodil_perf.number = strtocount(optarg);
+            if (!daffodil_perf.number)
+            {
+                error.code = CLI_INVALID_NUMBER;
+                error.arg.s = optarg;
+                return &error;
+            }
+            break;
+        case 'n':
+            daffodil_gen.records = strtocount(optarg);
+            if (!daffodil_gen.records)
+            {
+                error.code = CLI_INVALID_NUMBER;
+                error.arg.s = optarg;
+                return &error;
+            }
+            break;
         case 'o':
             daffodil_pu.outfile = optarg;
             break;
+        case 'P':
+#ifdef DAFFODIL_PROFILE
+            daffodil_pu.profile = true;
+            break;
+#else
+            error.code = CLI_PROFILE_DISABLED;
+            error.arg.c = 0;
+            return &error;
+#endif
+        case 'R':
+            if (!strtonumber(optarg, &daffodil_gen.seed))
+            {
+                error.code = CLI_INVALID_NUMBER;
+                error.arg.s = optarg;
+                return &error;
+            }
+            break;
         case 'r':
             // Ignore "-r root" option/optarg
             break;
+        case 'S':
+            daffodil_pu.stream = true;
+            break;
         case 's':
             // Ignore "-s schema" option/optarg
             break;
+        case 't':
+            daffodil_perf.threads = strtocount(optarg);
+            if (!daffodil_perf.threads)
+            {
+                error.code = CLI_INVALID_NUMBER;
+                error.arg.s = optarg;
+                return &error;
+            }
+            break;
+        case 'u':
+            daffodil_perf.unparse = true;
+            break;
         case 'V':
             if (strcmp("daffodil", optarg) == 0 || strcmp("xerces", optarg) == 0)
             {
@@ -121,8 +298,9 @@ parse_daffodil_cli(int argc, char *argv[])
 
         if (DAFFODIL_MISSING_COMMAND != daffodil_cli.subcommand)
         {
-            // Set infile only once
-            if (strcmp("-", daffodil_pu.infile) == 0)
+            // Set infile only once (generate-data and serve read no infile)
+            if (strcmp("-", daffodil_pu.infile) == 0 && DAFFODIL_GENERATE_DATA != daffodil_cli.subcommand &&
+                DAFFODIL_SERVE != daffodil_cli.subcommand)
             {
                 daffodil_pu.infile = arg;
             }
@@ -134,10 +312,26 @@ parse_daffodil_cli(int argc, char *argv[])
                 return &error;
             }
         }
+        else if (strcmp("generate-data", arg) == 0)
+        {
+            daffodil_cli.subcommand = DAFFODIL_GENERATE_DATA;
+        }
+        else if (strcmp("index", arg) == 0)
+        {
+            daffodil_cli.subcommand = DAFFODIL_INDEX;
+        }
         else if (strcmp("parse", arg) == 0)
         {
             daffodil_cli.subcommand = DAFFODIL_PARSE;
         }
+        else if (strcmp("performance", arg) == 0)
+        {
+            daffodil_cli.subcommand = DAFFODIL_PERFORMANCE;
+        }
+        else if (strcmp("serve", arg) == 0)
+        {
+            daffodil_cli.subcommand = DAFFODIL_SERVE;
+        }
         else if (strcmp("unparse", arg) == 0)
         {
             daffodil_cli.subcommand = DAFFODIL_UNPARSE;
@@ -157,5 +351,15 @@ parse_daffodil_cli(int argc, char *argv[])
         return &error;
     }
 
+    // Only XML infosets can be read back for unparsing
+    const bool unparse = DAFFODIL_UNPARSE == daffodil_cli.subcommand ||
+                         (DAFFODIL_PERFORMANCE == daffodil_cli.subcommand && daffodil_perf.unparse);
+    if (unparse && strcmp("xml", daffodil_pu.infoset_converter) != 0)
+    {
+        error.code = CLI_INVALID_INFOSET_UNPARSE;
+        error.arg.s = daffodil_pu.infoset_converter;
+        return &error;
+    }
+
     return 0;
 }
@@ -21,6 +21,8 @@
 // auto-maintained by iwyu
 // clang-format off
 #include <stdbool.h>  // for bool
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for uint64_t
 #include "errors.h"   // for Error
 // clang-format on
 
@@ -31,11 +33,23 @@ extern struct daffodil_cli
     enum daffodil_subcommand
     {
         DAFFODIL_MISSING_COMMAND,
+        DAFFODIL_GENERATE_DATA,
+        DAFFODIL_INDEX,
         DAFFODIL_PARSE,
+        DAFFODIL_PERFORMANCE,
+        DAFFODIL_SERVE,
         DAFFODIL_UNPARSE
     } subcommand;
 } daffodil_cli;
 
+// Declare our "daffodil generate-data" CLI options
+
+extern struct daffodil_gen_cli
+{
+    size_t records;
+    uint64_t seed;
+} daffodil_gen;
+
 // Declare our "daffodil parse/unparse" CLI options
 
 extern struct daffodil_pu_cli
@@ -43,9 +57,25 @@ extern struct daffodil_pu_cli
     const char *infoset_converter;
     const char *infile;
     const char *outfile;
+    const char *io;
+    size_t first_record;
+    size_t last_record;
+    bool async;
+    bool profile;
+    bool stream;
     bool validate;
 } daffodil_pu;
 
+// Declare our "daffodil performance" CLI options
+
+extern struct daffodil_perf_cli
+{
+    size_t number;
+    size_t threads;
+    size_t warmup;
+    bool unparse;
+} daffodil_perf;
+
 // Parse our command line interface
 
 extern const Error *parse_daffodil_cli(int argc, char *argv[]);
@@ -17,13 +17,23 @@
 
 // auto-maintained by iwyu
 // clang-format off
-#include <stdbool.h>          // for bool, true
-#include <stdio.h>            // for NULL, FILE, perror, fclose, fopen, stdin, stdout
+#include <stdbool.h>          // for bool, false, true
+#include <stddef.h>           // for size_t
+#include <stdio.h>            // for NULL, FILE, perror, fclose, fopen, fputc, stderr, stdin, stdout
 #include <string.h>           // for strcmp
-#include "cli_errors.h"       // for CLI_DIAGNOSTICS, CLI_FILE_CLOSE, CLI_FILE_OPEN
-#include "daffodil_getopt.h"  // for daffodil_cli, daffodil_pu, daffodil_pu_cli, DAFFODIL_PARSE, DAFFODIL_UNPARSE
-#include "errors.h"           // for continue_or_exit, Diagnostics, print_diagnostics, Error
-#include "infoset.h"          // for ParserOrUnparserState, PState, UState, get_infoset, walk_infoset, parse_data, unparse_infoset, InfosetBase, VisitEventHandler
+#include "cli_errors.h"       // for CLI_DIAGNOSTICS, CLI_FILE_CLOSE, CLI_FILE_OPEN, CLI_INDEX_TRUNCATED
+#include "csv_writer.h"       // for csvWriterMethods, csv_fini_writer, csv_init_writer, CSVWriter
+#include "daffodil_getopt.h"  // for daffodil_cli, daffodil_gen, daffodil_pu, daffodil_gen_cli, daffodil_pu_cli, DAFFODIL_GENERATE_DATA, DAFFODIL_INDEX, DAFFODIL_PARSE, DAFFODIL_PERFORMANCE, DAFFODIL_SERVE, DAFFODIL_UNPARSE
+#include "errors.h"           // for continue_or_exit, Diagnostics, print_diagnostics, print_error, reset_diagnostics, Error
+#include "index.h"            // for build_index, index_filename, seek_record
+#include "input.h"            // for fopen_input
+#include "output.h"           // for async_output
+#include "infoset.h"          // for ParserOrUnparserState, PState, UState, get_infoset, walk_infoset, parse_data, parse_record, unparse_infoset, InfosetBase, VisitEventHandler
+#include "parsers.h"          // for has_more_data, no_leftover_data
+#include "performance.h"      // for performance_test
+#include "profiler.h"         // for get_profile, print_profile
+#include "randomizers.h"      // for randomize_infoset, RState
+#include "serve.h"            // for serve_requests
 #include "xml_reader.h"       // for xmlReaderMethods, XMLReader
 #include "xml_writer.h"       // for xmlWriterMethods, XMLWriter
 // clang-format on
@@ -46,6 +56,35 @@ fopen_or_exit(FILE *stream, const char *pathname, const char *mode)
     return stream;
 }
 
+// Open an input file with the input backend asked for or exit if it
+// can't be opened
+
+static FILE *
+fopen_input_or_exit(FILE *stream, const char *pathname)
+{
+    if (strcmp(pathname, "-") != 0)
+    {
+        stream = fopen_input(pathname, daffodil_pu.io);
+        if (!stream)
+        {
+            perror("fopen");
+            const Error error = {CLI_FILE_OPEN, {.s = pathname}};
+            continue_or_exit(&error);
+        }
+    }
+    return stream;
+}
+
+// Open an output file, writing it on a separate thread if asked to,
+// or exit if it can't be opened
+
+static FILE *
+fopen_output_or_exit(FILE *stream, const char *pathname)
+{
+    stream = fopen_or_exit(stream, pathname, "w");
+    return daffodil_pu.async ? async_output(stream) : stream;
+}
+
 // Close a file or exit if it can't be closed
 
 static void
@@ -73,38 +112,193 @@ main(int argc, char *argv[])
     FILE *output = stdout;
 
     // Perform our command
-    if (daffodil_cli.subcommand == DAFFODIL_PARSE)
+    if (daffodil_cli.subcommand == DAFFODIL_GENERATE_DATA)
+    {
+        // Open our output file if given as an argument
+        output = fopen_output_or_exit(output, daffodil_pu.outfile);
+
+        // Generate and unparse each record, reusing the same infoset
+        // (clearing it only once) so dynamic hexBinary storage gets
+        // reallocated instead of leaked
+        Diagnostics diagnostics = {0};
+        RState rstate = {daffodil_gen.seed, NULL};
+        for (size_t record = 0; record < daffodil_gen.records; record++)
+        {
+            // Fill our infoset with random values
+            InfosetBase *infoset = get_infoset(record == 0);
+            randomize_infoset(infoset, &rstate);
+            continue_or_exit(rstate.error);
+
+            // Unparse our infoset to the output file
+            UState ustate = {.pu = {.stream = output, .diagnostics = &diagnostics}};
+            unparse_infoset(infoset, &ustate);
+            print_diagnostics(ustate.pu.diagnostics, stderr);
+            continue_or_exit(ustate.pu.error);
+
+            // Any diagnostics will fail the unparse if validate mode is on
+            if (daffodil_pu.validate && diagnostics.total)
+            {
+                const Error error = {CLI_DIAGNOSTICS, {.d64 = diagnostics.total}};
+                continue_or_exit(&error);
+            }
+            reset_diagnostics(&diagnostics);
+        }
+    }
+    else if (daffodil_cli.subcommand == DAFFODIL_INDEX)
+    {
+        // Open our input file and write its index next to it unless
+        // we read stdin or get told where else to write the index
+        input = fopen_input_or_exit(input, daffodil_pu.infile);
+        const bool sidecar = strcmp(daffodil_pu.outfile, "-") == 0 && strcmp(daffodil_pu.infile, "-") != 0;
+        output = fopen_or_exit(output, sidecar ? index_filename(daffodil_pu.infile) : daffodil_pu.outfile, "wb");
+
+        // Frame each record and write where each record starts
+        error = build_index(input, output);
+        continue_or_exit(error);
+    }
+    else if (daffodil_cli.subcommand == DAFFODIL_PARSE)
     {
         // Open our input and output files if given as arguments
-        input = fopen_or_exit(input, daffodil_pu.infile, "r");
-        output = fopen_or_exit(output, daffodil_pu.outfile, "w");
+        input = fopen_input_or_exit(input, daffodil_pu.infile);
+        output = fopen_output_or_exit(output, daffodil_pu.outfile);
 
-        // Parse the input file into our infoset
+        // Start at the first record asked for (if any) using infile's
+        // index before writing anything so a missing record writes no
+        // CSV header
+        Diagnostics diagnostics = {0};
+        PState pstate = {.pu = {.stream = input, .diagnostics = &diagnostics}};
+        const bool ranged = daffodil_pu.first_record > 0;
+        if (ranged)
+        {
+            error = seek_record(daffodil_pu.infile, daffodil_pu.first_record, &pstate);
+            continue_or_exit(error);
+        }
+
+        // Get our infoset and pick a writer for it
         const bool CLEAR_INFOSET = true;
         InfosetBase *infoset = get_infoset(CLEAR_INFOSET);
-        PState pstate = {{input, 0, NULL, NULL}, 0, 0};
-        parse_data(infoset, &pstate);
-        print_diagnostics(pstate.pu.diagnostics);
-        continue_or_exit(pstate.pu.error);
-
-        // Visit the infoset and print XML from it
         XMLWriter xmlWriter = {xmlWriterMethods, output, {NULL, NULL, 0}};
-        error = walk_infoset((VisitEventHandler *)&xmlWriter, infoset);
-        continue_or_exit(error);
+        CSVWriter csvWriter = {csvWriterMethods, output, ',', NULL, 0, 0, NULL, 0, 0};
+        VisitEventHandler *writer = NULL;
+        if (strcmp("xml", daffodil_pu.infoset_converter) == 0)
+        {
+            writer = (VisitEventHandler *)&xmlWriter;
+        }
+        else if (strcmp("null", daffodil_pu.infoset_converter) != 0)
+        {
+            // Plan CSV columns and write header row only once
+            csvWriter.separator = strcmp("tsv", daffodil_pu.infoset_converter) == 0 ? '\t' : ',';
+            error = csv_init_writer(&csvWriter, infoset->erd);
+            continue_or_exit(error);
+            writer = (VisitEventHandler *)&csvWriter;
+        }
 
-        // Any diagnostics will fail the parse if validate mode is on
-        if (daffodil_pu.validate && pstate.pu.diagnostics)
+        // Parse one record, or each record if stream mode is on,
+        // writing only the records which pass the generated filter
+        bool more_data = true;
+        size_t written = 0;
+        for (size_t record = 0; more_data; record++)
         {
-            const Error error = {CLI_DIAGNOSTICS, {.d64 = pstate.pu.diagnostics->length}};
-            continue_or_exit(&error);
+            // Parse the input file into our infoset
+            const size_t start_bitPos0b = pstate.pu.bitPos0b;
+            if (record)
+            {
+                infoset = get_infoset(CLEAR_INFOSET);
+            }
+            if (daffodil_pu.stream || ranged)
+            {
+                parse_record(infoset, &pstate);
+            }
+            else
+            {
+                parse_data(infoset, &pstate);
+            }
+            print_diagnostics(pstate.pu.diagnostics, stderr);
+            continue_or_exit(pstate.pu.error);
+
+            // Separate XML documents with a NUL byte like Daffodil does
+            const bool keep = !pstate.filteredOut;
+            if (keep && written && writer == (VisitEventHandler *)&xmlWriter)
+            {
+                fputc('\0', output);
+            }
+
+            // Visit the infoset and print XML or CSV from it unless
+            // the null infoset type asks to discard it
+            if (keep && writer)
+            {
+                error = walk_infoset(writer, infoset);
+                continue_or_exit(error);
+            }
+            if (keep)
+            {
+                written++;
+            }
+
+            // Any diagnostics will fail the parse if validate mode is on
+            if (daffodil_pu.validate && diagnostics.total)
+            {
+                const Error error = {CLI_DIAGNOSTICS, {.d64 = diagnostics.total}};
+                continue_or_exit(&error);
+            }
+            reset_diagnostics(&diagnostics);
+
+            // Stop after the last record asked for, or if stream mode is
+            // off or no data remains, and report leftover data if a
+            // record consumed no data
+            if (ranged)
+            {
+                const size_t last_record = daffodil_pu.first_record + record;
+                const bool more_records = last_record < daffodil_pu.last_record;
+                more_data = more_records && has_more_data(&pstate);
+
+                // Warn if infile ran out of records before the range did
+                if (more_records && !more_data)
+                {
+                    const Error warning = {CLI_INDEX_TRUNCATED, {.d64 = (int64_t)last_record}};
+                    print_error(&warning, stderr);
+                }
+            }
+            else
+            {
+                more_data = daffodil_pu.stream && has_more_data(&pstate);
+            }
+            if (more_data && pstate.pu.bitPos0b == start_bitPos0b)
+            {
+                no_leftover_data(&pstate);
+                continue_or_exit(pstate.pu.error);
+            }
+        }
+        csv_fini_writer(&csvWriter);
+
+        // Report where parsing spent its time if profile mode is on
+        if (daffodil_pu.profile)
+        {
+            print_profile(get_profile(), stderr);
         }
     }
-    else if (daffodil_cli.subcommand == DAFFODIL_UNPARSE)
+    else if (daffodil_cli.subcommand == DAFFODIL_PERFORMANCE)
     {
         // Open our input and output files if given as arguments
         input = fopen_or_exit(input, daffodil_pu.infile, "r");
         output = fopen_or_exit(output, daffodil_pu.outfile, "w");
 
+        // Measure how fast we can parse or unparse our input
+        error = performance_test(input, daffodil_pu.infile, output);
+        continue_or_exit(error);
+    }
+    else if (daffodil_cli.subcommand == DAFFODIL_SERVE)
+    {
+        // Answer requests on stdin until the client closes it
+        error = serve_requests(input, output);
+        continue_or_exit(error);
+    }
+    else if (daffodil_cli.subcommand == DAFFODIL_UNPARSE)
+    {
+        // Open our input and output files if given as arguments
+        input = fopen_or_exit(input, daffodil_pu.infile, "r");
+        output = fopen_output_or_exit(output, daffodil_pu.outfile);
+
         // Initialize our infoset's values from the XML data
         const bool CLEAR_INFOSET = true;
         InfosetBase *infoset = get_infoset(CLEAR_INFOSET);
@@ -113,17 +307,24 @@ main(int argc, char *argv[])
         continue_or_exit(error);
 
         // Unparse our infoset to the output file
-        UState ustate = {{output, 0, NULL, NULL}, 0, 0};
+        Diagnostics diagnostics = {0};
+        UState ustate = {.pu = {.stream = output, .diagnostics = &diagnostics}};
         unparse_infoset(infoset, &ustate);
-        print_diagnostics(ustate.pu.diagnostics);
+        print_diagnostics(ustate.pu.diagnostics, stderr);
         continue_or_exit(ustate.pu.error);
 
         // Any diagnostics will fail the unparse if validate mode is on
-        if (daffodil_pu.validate && ustate.pu.diagnostics)
+        if (daffodil_pu.validate && diagnostics.total)
         {
-            const Error error = {CLI_DIAGNOSTICS, {.d64 = ustate.pu.diagnostics->length}};
+            const Error error = {CLI_DIAGNOSTICS, {.d64 = diagnostics.total}};
             continue_or_exit(&error);
         }
+
+        // Report where unparsing spent its time if profile mode is on
+        if (daffodil_pu.profile)
+        {
+            print_profile(get_profile(), stderr);
+        }
     }
 
     // Close our input and out files if we opened them
@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Get a 64-bit off_t for fseeko even on 32-bit platforms
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// auto-maintained by iwyu
+// clang-format off
+#include "index.h"
+#include <stdbool.h>     // for bool, false, true
+#include <stddef.h>      // for size_t, NULL
+#include <stdint.h>      // for uint64_t, uint8_t, int64_t
+#include <stdio.h>       // for fclose, fopen, fread, fseeko, fwrite, snprintf, FILENAME_MAX, SEEK_SET
+#ifndef _WIN32
+#include <sys/types.h>   // for off_t
+#endif
+#include "cli_errors.h"  // for CLI_FILE_OPEN, CLI_FILE_READ, CLI_INDEX_RECORD, CLI_INDEX_UNALIGNED, CLI_INDEX_WRITE
+#include "infoset.h"     // for frame_record, get_infoset, PState, InfosetBase
+#include "parsers.h"     // for has_more_data, no_leftover_data
+// clang-format on
+
+// Number of bytes in each index entry
+
+enum
+{
+    INDEX_ENTRY_SIZE = 8
+};
+
+// Seek to a file offset which may not fit in a long (which has only
+// 32 bits on Windows and 32-bit platforms)
+
+static int
+seek_offset(FILE *stream, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(stream, (__int64)offset, SEEK_SET);
+#else
+    return fseeko(stream, (off_t)offset, SEEK_SET);
+#endif
+}
+
+// Write one record's starting bit position to an index file
+
+static bool
+write_entry(uint64_t bitPos0b, FILE *output)
+{
+    uint8_t bytes[INDEX_ENTRY_SIZE];
+    for (size_t i = 0; i < INDEX_ENTRY_SIZE; i++)
+    {
+        bytes[i] = (uint8_t)(bitPos0b >> (8 * i));
+    }
+    return fwrite(bytes, 1, INDEX_ENTRY_SIZE, output) == INDEX_ENTRY_SIZE;
+}
+
+// Read one record's starting bit position from an index file
+
+static bool
+read_entry(FILE *index, size_t record, uint64_t *bitPos0b)
+{
+    uint8_t bytes[INDEX_ENTRY_SIZE];
+    const uint64_t offset = (uint64_t)(record - 1) * INDEX_ENTRY_SIZE;
+    if (seek_offset(index, offset) != 0 || fread(bytes, 1, INDEX_ENTRY_SIZE, index) < INDEX_ENTRY_SIZE)
+    {
+        return false;
+    }
+
+    *bitPos0b = 0;
+    for (size_t i = 0; i < INDEX_ENTRY_SIZE; i++)
+    {
+        *bitPos0b |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return true;
+}
+
+// build_index - frame each record read from input until input has no
+// more data and write each record's starting bit position to output
+
+const Error *
+build_index(FILE *input, FILE *output)
+{
+    static Error error = {CLI_INDEX_WRITE, {0}};
+
+    // Framing checks no restrictions, so it can ignore any diagnostics
+    Diagnostics diagnostics = {0};
+    PState pstate = {.pu = {.stream = input, .diagnostics = &diagnostics}};
+    while (has_more_data(&pstate))
+    {
+        const size_t start_bitPos0b = pstate.pu.bitPos0b;
+        InfosetBase *infoset = get_infoset(true);
+        frame_record(infoset, &pstate);
+        if (pstate.pu.error)
+        {
+            return pstate.pu.error;
+        }
+
+        // Report leftover data if a record consumed no data
+        if (pstate.pu.bitPos0b == start_bitPos0b)
+        {
+            no_leftover_data(&pstate);
+            return pstate.pu.error;
+        }
+
+        if (!write_entry(start_bitPos0b, output))
+        {
+            return &error;
+        }
+    }
+
+    return NULL;
+}
+
+// index_filename - get the name of the index file which sits next to
+// an input file
+
+const char *
+index_filename(const char *infile)
+{
+    static char filename[FILENAME_MAX];
+    snprintf(filename, sizeof(filename), "%s.idx", infile);
+    return filename;
+}
+
+// seek_record - look up record N (counting from 1) in the index file
+// next to infile and position pstate at the start of that record
+
+const Error *
+seek_record(const char *infile, size_t record, PState *pstate)
+{
+    static Error error;
+
+    const char *filename = index_filename(infile);
+    FILE *index = fopen(filename, "rb");
+    if (!index)
+    {
+        error.code = CLI_FILE_OPEN;
+        error.arg.s = filename;
+        return &error;
+    }
+    uint64_t bitPos0b = 0;
+    const bool found = read_entry(index, record, &bitPos0b);
+    fclose(index);
+    if (!found)
+    {
+        error.code = CLI_INDEX_RECORD;
+        error.arg.d64 = (int64_t)record;
+        return &error;
+    }
+
+    // We can seek only to whole bytes, so records must start on them
+    if (bitPos0b % 8)
+    {
+        error.code = CLI_INDEX_UNALIGNED;
+        error.arg.d64 = (int64_t)record;
+        return &error;
+    }
+    if (seek_offset(pstate->pu.stream, bitPos0b / 8) != 0)
+    {
+        error.code = CLI_FILE_READ;
+        error.arg.s = infile;
+        return &error;
+    }
+    pstate->pu.bitPos0b = bitPos0b;
+
+    return NULL;
+}
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INDEX_H
+#define INDEX_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stddef.h>   // for size_t
+#include <stdio.h>    // for FILE
+#include "errors.h"   // for Error
+#include "infoset.h"  // for PState
+// clang-format on
+
+// build_index - frame each record read from input until input has no
+// more data, parsing only the fields needed to find where each record
+// ends, and write each record's starting bit position to output as an
+// 8-byte little-endian number so record N's entry is at offset 8*(N-1)
+
+extern const Error *build_index(FILE *input, FILE *output);
+
+// index_filename - get the name of the index file which sits next to
+// an input file
+
+extern const char *index_filename(const char *infile);
+
+// seek_record - look up record N (counting from 1) in the index file
+// next to infile and position pstate at the start of that record
+
+extern const Error *seek_record(const char *infile, size_t record, PState *pstate);
+
+#endif // INDEX_H
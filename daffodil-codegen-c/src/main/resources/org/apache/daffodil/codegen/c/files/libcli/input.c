@@ -0,0 +1,538 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Get fopencookie, which lets the mmap and uring backends hand the
+// parsers an ordinary stream
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+// auto-maintained by iwyu
+// clang-format off
+#include "input.h"
+#include <stdbool.h>          // for bool, false, true
+#include <stdio.h>            // for fopen, FILE, NULL
+#include <string.h>           // for strcmp, memcpy, memset
+#ifdef __linux__
+#include <errno.h>            // for errno, EINTR, EINVAL
+#include <fcntl.h>            // for open, O_RDONLY
+#include <linux/io_uring.h>   // for io_uring_params, io_uring_sqe, io_uring_cqe, IORING_OFF_SQ_RING, IORING_OFF_CQ_RING, IORING_OFF_SQES, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_ENTER_GETEVENTS, IORING_FEAT_SINGLE_MMAP, IORING_REGISTER_BUFFERS, IORING_REGISTER_PROBE, IO_URING_OP_SUPPORTED, io_uring_probe, io_uring_probe_op
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint8_t, uint64_t, uintptr_t
+#include <stdlib.h>           // for aligned_alloc, calloc, free, malloc
+#include <sys/mman.h>         // for mmap, munmap, madvise, MAP_FAILED, MAP_PRIVATE, MAP_SHARED, MAP_POPULATE, MADV_SEQUENTIAL, PROT_READ, PROT_WRITE
+#include <sys/stat.h>         // for fstat, stat, S_ISREG
+#include <sys/syscall.h>      // for __NR_io_uring_setup, __NR_io_uring_enter, __NR_io_uring_register
+#include <sys/types.h>        // for off64_t, ssize_t
+#include <sys/uio.h>          // for iovec
+#include <unistd.h>           // for close, syscall
+#endif
+// clang-format on
+
+// is_input_backend - check whether a name is one of the input backends
+
+bool
+is_input_backend(const char *io)
+{
+    return strcmp("stdio", io) == 0 || strcmp("mmap", io) == 0 || strcmp("uring", io) == 0;
+}
+
+#ifdef __linux__
+
+// Compute where a seek goes from a position in a file of a given
+// length or return false if it would go before the start of the file
+
+static bool
+seek_target(off64_t offset, int whence, size_t position, size_t length, size_t *target)
+{
+    off64_t base = 0;
+    switch (whence)
+    {
+    case SEEK_SET:
+        base = 0;
+        break;
+    case SEEK_CUR:
+        base = (off64_t)position;
+        break;
+    case SEEK_END:
+        base = (off64_t)length;
+        break;
+    default:
+        return false;
+    }
+    if (offset < -base) return false;
+    *target = (size_t)(base + offset);
+    return true;
+}
+
+// MappedInput - state of a file mapped into memory
+
+typedef struct MappedInput
+{
+    const uint8_t *data; // file's bytes mapped into memory
+    size_t length;       // length of file in bytes
+    size_t position;     // offset of next byte to read
+} MappedInput;
+
+// Copy bytes from a mapped file
+
+static ssize_t
+mapped_read(void *cookie, char *buf, size_t size)
+{
+    MappedInput *input = cookie;
+    size_t count = input->position < input->length ? input->length - input->position : 0;
+    if (count > size) count = size;
+    memcpy(buf, input->data + input->position, count);
+    input->position += count;
+    return (ssize_t)count;
+}
+
+// Seek within a mapped file
+
+static int
+mapped_seek(void *cookie, off64_t *offset, int whence)
+{
+    MappedInput *input = cookie;
+    if (!seek_target(*offset, whence, input->position, input->length, &input->position))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    *offset = (off64_t)input->position;
+    return 0;
+}
+
+// Unmap a mapped file
+
+static int
+mapped_close(void *cookie)
+{
+    MappedInput *input = cookie;
+    munmap((void *)input->data, input->length);
+    free(input);
+    return 0;
+}
+
+// Open a stream which reads a file mapped into memory (the stream
+// doesn't need the file descriptor after mapping the file)
+
+static FILE *
+open_mapped(int fd, size_t length)
+{
+    void *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) return NULL;
+    madvise(data, length, MADV_SEQUENTIAL);
+
+    MappedInput *input = malloc(sizeof(MappedInput));
+    if (!input)
+    {
+        munmap(data, length);
+        return NULL;
+    }
+    input->data = data;
+    input->length = length;
+    input->position = 0;
+
+    const cookie_io_functions_t functions = {mapped_read, NULL, mapped_seek, mapped_close};
+    FILE *stream = fopencookie(input, "r", functions);
+    if (!stream) mapped_close(input);
+    return stream;
+}
+
+// Limits of the uring backend's ring of buffers
+
+enum
+{
+    URING_BUFFERS = 4,           // number of reads kept in flight
+    URING_BUFFER_SIZE = 1 << 20, // number of bytes each read asks for
+};
+
+// UringSlot - state of one buffer in the ring of buffers
+
+typedef struct UringSlot
+{
+    size_t offset;    // file offset where the buffer's read started
+    size_t requested; // number of bytes the read asked for (0 past end of file)
+    size_t length;    // number of bytes the read got
+    size_t consumed;  // number of bytes the parser took from the buffer
+    int error;        // errno of a failed read
+    bool pending;     // true while the read is in flight
+} UringSlot;
+
+// UringInput - state of a file read through io_uring
+
+typedef struct UringInput
+{
+    int fd;                     // file being read
+    int ring;                   // io_uring instance
+    size_t fileLength;          // length of file in bytes
+    void *sqRing;               // mapped submission queue ring
+    size_t sqRingSize;          // size of submission queue ring
+    void *cqRing;               // mapped completion queue ring (may be same as sqRing)
+    size_t cqRingSize;          // size of completion queue ring
+    struct io_uring_sqe *sqes;  // mapped submission queue entries
+    size_t sqesSize;            // size of submission queue entries
+    unsigned *sqTail;           // tail of submission queue
+    unsigned *sqMask;           // mask of submission queue indexes
+    unsigned *sqArray;          // submission queue's indexes of entries
+    unsigned *cqHead;           // head of completion queue
+    unsigned *cqTail;           // tail of completion queue
+    unsigned *cqMask;           // mask of completion queue indexes
+    struct io_uring_cqe *cqes;  // completion queue entries
+    uint8_t *buffers;           // URING_BUFFERS buffers of URING_BUFFER_SIZE bytes each
+    bool fixed;                 // true if buffers are registered with the ring
+    UringSlot slots[URING_BUFFERS];
+    size_t head;                // slot the parser reads from next
+    size_t nextOffset;          // file offset where the next read starts
+} UringInput;
+
+// Submit a read filling a slot's buffer from the next file offset
+
+static void
+uring_submit(UringInput *input, size_t index)
+{
+    UringSlot *slot = &input->slots[index];
+    slot->offset = input->nextOffset;
+    slot->requested = 0;
+    slot->length = slot->consumed = 0;
+    slot->error = 0;
+    slot->pending = false;
+    if (input->nextOffset >= input->fileLength) return;
+
+    size_t requested = input->fileLength - input->nextOffset;
+    if (requested > URING_BUFFER_SIZE) requested = URING_BUFFER_SIZE;
+    const unsigned tail = *input->sqTail;
+    const unsigned sqIndex = tail & *input->sqMask;
+    struct io_uring_sqe *sqe = &input->sqes[sqIndex];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = input->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->fd = input->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(input->buffers + index * URING_BUFFER_SIZE);
+    sqe->len = (unsigned)requested;
+    sqe->off = input->nextOffset;
+    sqe->buf_index = (uint16_t)index;
+    sqe->user_data = index;
+    input->sqArray[sqIndex] = sqIndex;
+    __atomic_store_n(input->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    if (syscall(__NR_io_uring_enter, input->ring, 1, 0, 0, NULL, 0) < 0)
+    {
+        // Take the entry back since the kernel didn't consume it
+        __atomic_store_n(input->sqTail, tail, __ATOMIC_RELEASE);
+        slot->error = errno;
+        return;
+    }
+    slot->requested = requested;
+    slot->pending = true;
+    input->nextOffset += requested;
+}
+
+// Wait for at least one read to finish and record every finished read
+// in its slot; returns false if waiting failed
+
+static bool
+uring_wait(UringInput *input)
+{
+    unsigned head = *input->cqHead;
+    if (head == __atomic_load_n(input->cqTail, __ATOMIC_ACQUIRE) &&
+        syscall(__NR_io_uring_enter, input->ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+    {
+        return false;
+    }
+
+    const unsigned tail = __atomic_load_n(input->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++)
+    {
+        const struct io_uring_cqe *cqe = &input->cqes[head & *input->cqMask];
+        UringSlot *slot = &input->slots[cqe->user_data];
+        slot->pending = false;
+        if (cqe->res < 0)
+        {
+            slot->error = -cqe->res;
+        }
+        else
+        {
+            slot->length = (size_t)cqe->res;
+        }
+    }
+    __atomic_store_n(input->cqHead, head, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Wait for every read in flight to finish; returns false if waiting
+// failed
+
+static bool
+uring_drain(UringInput *input)
+{
+    for (size_t i = 0; i < URING_BUFFERS; i++)
+    {
+        while (input->slots[i].pending)
+        {
+            if (!uring_wait(input)) return false;
+        }
+    }
+    return true;
+}
+
+// Throw away any reads in flight and start reading again from a file
+// offset with every buffer; returns false if waiting failed
+
+static bool
+uring_restart(UringInput *input, size_t offset)
+{
+    if (!uring_drain(input)) return false;
+    input->head = 0;
+    input->nextOffset = offset;
+    for (size_t i = 0; i < URING_BUFFERS; i++)
+    {
+        uring_submit(input, i);
+    }
+    return true;
+}
+
+// Copy bytes from the ring's buffers in file order, refilling each
+// buffer as soon as the parser has taken all of its bytes
+
+static ssize_t
+uring_read(void *cookie, char *buf, size_t size)
+{
+    UringInput *input = cookie;
+    size_t count = 0;
+    while (count < size)
+    {
+        UringSlot *slot = &input->slots[input->head];
+        while (slot->pending)
+        {
+            if (!uring_wait(input)) return count ? (ssize_t)count : -1;
+        }
+        if (slot->error)
+        {
+            errno = slot->error;
+            return count ? (ssize_t)count : -1;
+        }
+        if (!slot->length) break; // end of file
+
+        size_t available = slot->length - slot->consumed;
+        if (available > size - count) available = size - count;
+        memcpy(buf + count, input->buffers + input->head * URING_BUFFER_SIZE + slot->consumed, available);
+        slot->consumed += available;
+        count += available;
+        if (slot->consumed < slot->length) continue;
+
+        // Reads after a short read started past the bytes it got, so
+        // start over from there; otherwise refill this buffer and move on
+        if (slot->length < slot->requested)
+        {
+            if (!uring_restart(input, slot->offset + slot->length)) return count ? (ssize_t)count : -1;
+        }
+        else
+        {
+            uring_submit(input, input->head);
+            input->head = (input->head + 1) % URING_BUFFERS;
+        }
+    }
+    return (ssize_t)count;
+}
+
+// Seek within a file read through io_uring by reading again from there
+
+static int
+uring_seek(void *cookie, off64_t *offset, int whence)
+{
+    UringInput *input = cookie;
+    const UringSlot *slot = &input->slots[input->head];
+    size_t target = 0;
+    if (!seek_target(*offset, whence, slot->offset + slot->consumed, input->fileLength, &target))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!uring_restart(input, target)) return -1;
+    *offset = (off64_t)target;
+    return 0;
+}
+
+// Tear down an io_uring instance, its buffers, and its file
+
+static int
+uring_close(void *cookie)
+{
+    UringInput *input = cookie;
+    if (input->sqes) uring_drain(input);
+    if (input->sqes) munmap(input->sqes, input->sqesSize);
+    if (input->cqRing && input->cqRing != input->sqRing) munmap(input->cqRing, input->cqRingSize);
+    if (input->sqRing) munmap(input->sqRing, input->sqRingSize);
+    close(input->ring);
+    close(input->fd);
+    free(input->buffers);
+    free(input);
+    return 0;
+}
+
+// Map one of an io_uring instance's rings or return NULL
+
+static void *
+uring_map(int ring, size_t size, off_t offset)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, offset);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+// Ask the kernel whether an io_uring instance supports IORING_OP_READ,
+// which kernels before 5.6 reject only once a read is submitted
+
+static bool
+uring_probe(int ring)
+{
+    const unsigned numOps = IORING_OP_READ + 1;
+    struct io_uring_probe *probe =
+        calloc(1, sizeof(struct io_uring_probe) + numOps * sizeof(struct io_uring_probe_op));
+    if (!probe) return false;
+    const bool supported = syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe, numOps) == 0 &&
+                           probe->ops_len > IORING_OP_READ &&
+                           (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    return supported;
+}
+
+// Open a stream which reads a file through io_uring (taking ownership
+// of the file descriptor unless it returns NULL)
+
+static FILE *
+open_uring(int fd, size_t length)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int ring = (int)syscall(__NR_io_uring_setup, URING_BUFFERS, &params);
+    if (ring < 0) return NULL;
+    if (!uring_probe(ring))
+    {
+        close(ring);
+        return NULL;
+    }
+
+    UringInput *input = calloc(1, sizeof(UringInput));
+    if (!input)
+    {
+        close(ring);
+        return NULL;
+    }
+    input->fd = -1;
+    input->ring = ring;
+    input->fileLength = length;
+
+    // Map the rings and entries shared with the kernel
+    input->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    input->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (input->cqRingSize > input->sqRingSize) input->sqRingSize = input->cqRingSize;
+        input->sqRing = input->cqRing = uring_map(ring, input->sqRingSize, IORING_OFF_SQ_RING);
+    }
+    else
+    {
+        input->sqRing = uring_map(ring, input->sqRingSize, IORING_OFF_SQ_RING);
+        input->cqRing = uring_map(ring, input->cqRingSize, IORING_OFF_CQ_RING);
+    }
+    input->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    input->sqes = uring_map(ring, input->sqesSize, IORING_OFF_SQES);
+    input->buffers = aligned_alloc(4096, URING_BUFFERS * URING_BUFFER_SIZE);
+    if (!input->sqRing || !input->cqRing || !input->sqes || !input->buffers)
+    {
+        uring_close(input);
+        return NULL;
+    }
+    uint8_t *sq = input->sqRing;
+    uint8_t *cq = input->cqRing;
+    input->sqTail = (unsigned *)(sq + params.sq_off.tail);
+    input->sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    input->sqArray = (unsigned *)(sq + params.sq_off.array);
+    input->cqHead = (unsigned *)(cq + params.cq_off.head);
+    input->cqTail = (unsigned *)(cq + params.cq_off.tail);
+    input->cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    input->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // Register the buffers so the kernel doesn't map them for each
+    // read, but still read into them if we may not lock that much memory
+    struct iovec iovecs[URING_BUFFERS];
+    for (size_t i = 0; i < URING_BUFFERS; i++)
+    {
+        iovecs[i].iov_base = input->buffers + i * URING_BUFFER_SIZE;
+        iovecs[i].iov_len = URING_BUFFER_SIZE;
+    }
+    input->fixed = syscall(__NR_io_uring_register, ring, IORING_REGISTER_BUFFERS, iovecs, URING_BUFFERS) == 0;
+
+    // Start filling every buffer and wait for the first read, giving the
+    // file back for another backend if the kernel rejects the read
+    // after all, then hand the stream to the parser
+    input->fd = fd;
+    bool waited = uring_restart(input, 0);
+    while (waited && input->slots[0].pending)
+    {
+        waited = uring_wait(input);
+    }
+    if (!waited || input->slots[0].error == EINVAL)
+    {
+        input->fd = -1;
+        uring_close(input);
+        return NULL;
+    }
+    const cookie_io_functions_t functions = {uring_read, NULL, uring_seek, uring_close};
+    FILE *stream = fopencookie(input, "r", functions);
+    if (!stream)
+    {
+        input->fd = -1;
+        uring_close(input);
+    }
+    return stream;
+}
+
+#endif
+
+// fopen_input - open a file for reading with an input backend,
+// falling back to simpler backends when needed
+
+FILE *
+fopen_input(const char *pathname, const char *io)
+{
+#ifdef __linux__
+    if (strcmp("stdio", io) != 0)
+    {
+        // Only regular files with some data can be mapped or read at offsets
+        const int fd = open(pathname, O_RDONLY);
+        if (fd < 0) return NULL;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            const size_t length = (size_t)st.st_size;
+            FILE *stream = strcmp("uring", io) == 0 ? open_uring(fd, length) : NULL;
+            if (stream) return stream;
+            stream = open_mapped(fd, length);
+            if (stream)
+            {
+                close(fd);
+                return stream;
+            }
+        }
+        close(fd);
+    }
+#else
+    (void)io;
+#endif
+    return fopen(pathname, "r");
+}
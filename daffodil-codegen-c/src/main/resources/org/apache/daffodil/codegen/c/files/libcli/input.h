@@ -0,0 +1,42 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdbool.h>  // for bool
+#include <stdio.h>    // for FILE
+// clang-format on
+
+// is_input_backend - check whether a name is one of the input backends
+// (stdio, mmap, or uring)
+
+extern bool is_input_backend(const char *io);
+
+// fopen_input - open a file for reading with an input backend: stdio
+// reads it with fread, mmap maps it into memory, and uring keeps
+// several large reads in flight with io_uring while the parser
+// consumes data already read.  Falls back from uring to mmap and from
+// mmap to stdio when the platform or file (e.g., a pipe) doesn't
+// support a backend.  Returns NULL and sets errno like fopen if the
+// file can't be opened.
+
+extern FILE *fopen_input(const char *pathname, const char *io);
+
+#endif // INPUT_H
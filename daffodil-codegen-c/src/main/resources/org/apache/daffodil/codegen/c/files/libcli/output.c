@@ -0,0 +1,307 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Get fopencookie, which lets the writer thread sit behind an ordinary
+// stream
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+// auto-maintained by iwyu
+// clang-format off
+#include "output.h"
+#include <stdio.h>      // for fclose, fflush, fileno, FILE, stdout
+#ifdef __linux__
+#include <errno.h>      // for errno, EINTR, EIO
+#include <pthread.h>    // for pthread_cond_broadcast, pthread_cond_destroy, pthread_cond_init, pthread_cond_wait, pthread_create, pthread_join, pthread_mutex_destroy, pthread_mutex_init, pthread_mutex_lock, pthread_mutex_unlock, pthread_cond_t, pthread_mutex_t, pthread_t
+#include <stdbool.h>    // for bool, false, true
+#include <stddef.h>     // for size_t, NULL
+#include <stdint.h>     // for uint8_t
+#include <stdlib.h>     // for atexit, calloc, free, malloc
+#include <string.h>     // for memcpy
+#include <sys/types.h>  // for ssize_t
+#include <unistd.h>     // for write
+#endif
+// clang-format on
+
+#ifdef __linux__
+
+// Limits of the queue of buffers
+
+enum
+{
+    ASYNC_BUFFERS = 4,           // number of buffers in the queue
+    ASYNC_BUFFER_SIZE = 1 << 18, // number of bytes in each buffer
+};
+
+// AsyncOutput - state of a stream written by a writer thread.  The
+// queue is a single-producer single-consumer ring: only the parsing
+// thread advances tail and only the writer thread advances head, so
+// neither takes a lock to pass a buffer.  The mutex and condition
+// variable only let a thread sleep while the queue is full or empty,
+// and a thread takes the mutex to wake the other thread only when the
+// other thread has marked itself asleep.
+
+typedef struct AsyncOutput
+{
+    FILE *stream;                  // wrapped stream
+    int fd;                        // wrapped stream's file descriptor
+    pthread_t thread;              // writer thread
+    uint8_t *buffers;              // ASYNC_BUFFERS buffers of ASYNC_BUFFER_SIZE bytes each
+    size_t lengths[ASYNC_BUFFERS]; // number of bytes in each queued buffer
+    size_t length;                 // number of bytes in buffer being filled
+    size_t head;                   // number of buffers written (atomic)
+    size_t tail;                   // number of buffers queued (atomic)
+    bool closing;                  // true once the last buffer is queued (atomic)
+    bool parserSleeping;           // true while parsing thread may sleep on a full queue (atomic)
+    bool writerSleeping;           // true while writer thread may sleep on an empty queue (atomic)
+    int error;                     // errno of first failed write (atomic)
+    pthread_mutex_t mutex;         // guards sleeping on ready
+    pthread_cond_t ready;          // signaled when head, tail, or closing changes while a thread sleeps
+} AsyncOutput;
+
+// Stream which async_output wrapped most recently and which hasn't
+// been closed yet
+
+static FILE *unclosed_output;
+
+// Close that stream when the program exits early (e.g., after an
+// error) so its last buffer still gets written
+
+static void
+close_unclosed_output(void)
+{
+    if (unclosed_output) fclose(unclosed_output);
+}
+
+// Wake the other thread if it marked itself asleep.  Publishing head,
+// tail, or closing before reading the other thread's mark, while the
+// other thread marks itself before reading them again, means at least
+// one thread sees the other's store, so no wakeup gets lost (both
+// sides use sequentially consistent atomics for this)
+
+static void
+async_wake(AsyncOutput *output, const bool *sleeping)
+{
+    if (__atomic_load_n(sleeping, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&output->mutex);
+        pthread_cond_broadcast(&output->ready);
+        pthread_mutex_unlock(&output->mutex);
+    }
+}
+
+// Check whether the writer thread has nothing to write yet
+
+static bool
+async_empty(AsyncOutput *output, size_t head)
+{
+    return head == __atomic_load_n(&output->tail, __ATOMIC_SEQ_CST) &&
+           !__atomic_load_n(&output->closing, __ATOMIC_SEQ_CST);
+}
+
+// Check whether the parsing thread has no free buffer to fill yet
+
+static bool
+async_full(AsyncOutput *output, size_t tail)
+{
+    return tail - __atomic_load_n(&output->head, __ATOMIC_SEQ_CST) >= ASYNC_BUFFERS;
+}
+
+// Write every byte of a buffer to a file descriptor or return errno
+
+static int
+write_fully(int fd, const uint8_t *bytes, size_t length)
+{
+    while (length)
+    {
+        const ssize_t count = write(fd, bytes, length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return count < 0 ? errno : EIO;
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return 0;
+}
+
+// Write queued buffers in order until the last one is written (the
+// writer thread's body)
+
+static void *
+write_buffers(void *arg)
+{
+    AsyncOutput *output = arg;
+    size_t head = output->head;
+    while (true)
+    {
+        // Sleep while the queue is empty unless the last buffer is queued
+        if (async_empty(output, head))
+        {
+            pthread_mutex_lock(&output->mutex);
+            __atomic_store_n(&output->writerSleeping, true, __ATOMIC_SEQ_CST);
+            while (async_empty(output, head))
+            {
+                pthread_cond_wait(&output->ready, &output->mutex);
+            }
+            __atomic_store_n(&output->writerSleeping, false, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&output->mutex);
+        }
+        if (head == __atomic_load_n(&output->tail, __ATOMIC_ACQUIRE)) break;
+
+        // Keep emptying the queue after an error so the parsing thread
+        // doesn't wait forever, but stop writing
+        const size_t index = head % ASYNC_BUFFERS;
+        if (!__atomic_load_n(&output->error, __ATOMIC_ACQUIRE))
+        {
+            const int error =
+                write_fully(output->fd, output->buffers + index * ASYNC_BUFFER_SIZE, output->lengths[index]);
+            __atomic_store_n(&output->error, error, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&output->head, ++head, __ATOMIC_SEQ_CST);
+        async_wake(output, &output->parserSleeping);
+    }
+    return NULL;
+}
+
+// Queue the buffer being filled and wait until the next buffer is free
+
+static void
+async_queue(AsyncOutput *output)
+{
+    const size_t tail = output->tail;
+    output->lengths[tail % ASYNC_BUFFERS] = output->length;
+    output->length = 0;
+    __atomic_store_n(&output->tail, tail + 1, __ATOMIC_SEQ_CST);
+    async_wake(output, &output->writerSleeping);
+
+    if (async_full(output, tail + 1))
+    {
+        pthread_mutex_lock(&output->mutex);
+        __atomic_store_n(&output->parserSleeping, true, __ATOMIC_SEQ_CST);
+        while (async_full(output, tail + 1))
+        {
+            pthread_cond_wait(&output->ready, &output->mutex);
+        }
+        __atomic_store_n(&output->parserSleeping, false, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&output->mutex);
+    }
+}
+
+// Copy written bytes into the buffer being filled, queueing it when
+// it fills up
+
+static ssize_t
+async_write(void *cookie, const char *buf, size_t size)
+{
+    AsyncOutput *output = cookie;
+    const int error = __atomic_load_n(&output->error, __ATOMIC_ACQUIRE);
+    if (error)
+    {
+        errno = error;
+        return -1;
+    }
+
+    size_t count = 0;
+    while (count < size)
+    {
+        uint8_t *buffer = output->buffers + (output->tail % ASYNC_BUFFERS) * ASYNC_BUFFER_SIZE;
+        size_t available = ASYNC_BUFFER_SIZE - output->length;
+        if (available > size - count) available = size - count;
+        memcpy(buffer + output->length, buf + count, available);
+        output->length += available;
+        count += available;
+        if (output->length == ASYNC_BUFFER_SIZE) async_queue(output);
+    }
+    return (ssize_t)count;
+}
+
+// Queue the last buffer, wait for the writer thread to write it, and
+// close the wrapped stream
+
+static int
+async_close(void *cookie)
+{
+    AsyncOutput *output = cookie;
+    unclosed_output = NULL;
+    if (output->length) async_queue(output);
+    __atomic_store_n(&output->closing, true, __ATOMIC_SEQ_CST);
+    async_wake(output, &output->writerSleeping);
+    pthread_join(output->thread, NULL);
+
+    int error = output->error;
+    if (output->stream != stdout && fclose(output->stream) != 0 && !error) error = errno;
+    pthread_cond_destroy(&output->ready);
+    pthread_mutex_destroy(&output->mutex);
+    free(output->buffers);
+    free(output);
+    if (error)
+    {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+#endif
+
+// async_output - wrap a stream open for writing in a stream which a
+// writer thread writes
+
+FILE *
+async_output(FILE *stream)
+{
+#ifdef __linux__
+    // Write anything the wrapped stream buffered before bypassing it
+    if (fflush(stream) != 0) return stream;
+
+    AsyncOutput *output = calloc(1, sizeof(AsyncOutput));
+    uint8_t *buffers = malloc(ASYNC_BUFFERS * ASYNC_BUFFER_SIZE);
+    if (!output || !buffers)
+    {
+        free(output);
+        free(buffers);
+        return stream;
+    }
+    output->stream = stream;
+    output->fd = fileno(stream);
+    output->buffers = buffers;
+    pthread_mutex_init(&output->mutex, NULL);
+    pthread_cond_init(&output->ready, NULL);
+
+    // Start the writer thread and hand back a stream feeding it
+    const cookie_io_functions_t functions = {NULL, async_write, NULL, async_close};
+    if (pthread_create(&output->thread, NULL, write_buffers, output) == 0)
+    {
+        FILE *async = fopencookie(output, "w", functions);
+        if (async)
+        {
+            static bool registered = false;
+            if (!registered) registered = atexit(close_unclosed_output) == 0;
+            unclosed_output = async;
+            return async;
+        }
+        __atomic_store_n(&output->closing, true, __ATOMIC_SEQ_CST);
+        async_wake(output, &output->writerSleeping);
+        pthread_join(output->thread, NULL);
+    }
+    pthread_cond_destroy(&output->ready);
+    pthread_mutex_destroy(&output->mutex);
+    free(buffers);
+    free(output);
+#endif
+    return stream;
+}
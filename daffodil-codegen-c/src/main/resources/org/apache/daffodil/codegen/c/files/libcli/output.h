@@ -0,0 +1,37 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdio.h>  // for FILE
+// clang-format on
+
+// async_output - wrap a stream open for writing in a stream which
+// copies written bytes into a small queue of large buffers and hands
+// each filled buffer to a writer thread, so formatting and parsing
+// overlap with write syscalls on a slow file or pipe.  Closing the
+// returned stream writes the last buffer, joins the thread, and closes
+// the wrapped stream unless it is stdout.  Returns the wrapped stream
+// itself if the platform has no way to wrap it or the thread can't be
+// started.
+
+extern FILE *async_output(FILE *stream);
+
+#endif // OUTPUT_H
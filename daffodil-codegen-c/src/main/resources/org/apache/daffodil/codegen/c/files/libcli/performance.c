@@ -0,0 +1,622 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// auto-maintained by iwyu
+// clang-format off
+#include "performance.h"
+#include <inttypes.h>         // for uint8_t, int64_t
+#include <pthread.h>          // for pthread_create, pthread_join, pthread_mutex_lock, pthread_mutex_unlock, pthread_mutex_t, PTHREAD_MUTEX_INITIALIZER, pthread_t, pthread_barrier_destroy, pthread_barrier_init, pthread_barrier_wait, pthread_barrier_t, pthread_cond_broadcast, pthread_cond_destroy, pthread_cond_init, pthread_cond_wait, pthread_cond_t, pthread_mutex_destroy, pthread_mutex_init
+#include <stdbool.h>          // for bool, false, true
+#include <stddef.h>           // for size_t, NULL
+#include <stdlib.h>           // for free, calloc, malloc, qsort, realloc
+#include <string.h>           // for strcmp
+#include <time.h>             // for clock_gettime, timespec, CLOCK_MONOTONIC
+#include "cli_errors.h"       // for CLI_DIAGNOSTICS, CLI_FILE_OPEN, CLI_FILE_READ, CLI_PERFORMANCE_MEMORY, CLI_PERFORMANCE_THREAD
+#include "csv_writer.h"       // for csvWriterMethods, csv_fini_writer, csv_init_writer, CSVWriter
+#include "daffodil_getopt.h"  // for daffodil_perf, daffodil_pu, daffodil_perf_cli, daffodil_pu_cli
+#include "infoset.h"          // for PState, UState, arena_free, free_infoset, get_infoset, parse_data, parse_record, unparse_infoset, walk_infoset, InfosetBase, VisitEventHandler
+#include "parsers.h"          // for has_more_data, no_leftover_data
+#include "profiler.h"         // for add_profile, get_profile, print_profile, ProfileTable
+#include "xml_reader.h"       // for xmlReaderMethods, XMLReader
+#include "xml_writer.h"       // for xmlWriterMethods, XMLWriter
+// clang-format on
+
+// NULL_DEVICE - file which discards everything written to it
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Barrier - point where every thread waits until all threads arrive
+// (macOS has no pthread barriers, so build one from a condition
+// variable there)
+
+#ifdef __APPLE__
+typedef struct Barrier
+{
+    pthread_mutex_t mutex; // protects the fields below
+    pthread_cond_t cond;   // signals that all threads arrived
+    unsigned count;        // number of threads which must arrive
+    unsigned arrived;      // number of threads which arrived so far
+    unsigned cycle;        // incremented each time all threads arrive
+} Barrier;
+
+static int
+barrier_init(Barrier *barrier, unsigned count)
+{
+    barrier->count = count;
+    barrier->arrived = 0;
+    barrier->cycle = 0;
+    if (pthread_mutex_init(&barrier->mutex, NULL)) return -1;
+    if (pthread_cond_init(&barrier->cond, NULL))
+    {
+        pthread_mutex_destroy(&barrier->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+static void
+barrier_wait(Barrier *barrier)
+{
+    pthread_mutex_lock(&barrier->mutex);
+    const unsigned cycle = barrier->cycle;
+    if (++barrier->arrived == barrier->count)
+    {
+        barrier->arrived = 0;
+        barrier->cycle++;
+        pthread_cond_broadcast(&barrier->cond);
+    }
+    while (cycle == barrier->cycle)
+    {
+        pthread_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+    pthread_mutex_unlock(&barrier->mutex);
+}
+
+static void
+barrier_destroy(Barrier *barrier)
+{
+    pthread_cond_destroy(&barrier->cond);
+    pthread_mutex_destroy(&barrier->mutex);
+}
+#else
+typedef pthread_barrier_t Barrier;
+#define barrier_init(barrier, count) pthread_barrier_init(barrier, NULL, count)
+#define barrier_wait(barrier) pthread_barrier_wait(barrier)
+#define barrier_destroy(barrier) pthread_barrier_destroy(barrier)
+#endif
+
+// PerformanceThread - work and measurements of one thread
+
+typedef struct PerformanceThread
+{
+    pthread_t thread;    // thread running the work
+    const uint8_t *data; // input data shared by all threads
+    size_t dataLength;   // length of input data in bytes
+    size_t warmups;      // number of untimed times to parse or unparse data first
+    size_t iterations;   // number of times to parse or unparse data
+    Barrier *barrier;    // barrier all threads wait at after warmups
+    bool timing;         // true once thread waited at barrier
+    double start;        // time when first timed iteration started
+    double end;          // time when last timed iteration ended
+    size_t numRecords;   // number of records parsed or unparsed
+    size_t numBytes;     // number of bytes parsed or unparsed
+    double *latencies;   // seconds taken by each record
+    size_t capacity;     // capacity of latencies array
+    const Error *error;  // any error which stopped thread
+} PerformanceThread;
+
+// Each thread adds its own profile table to this table when it
+// finishes if profile mode is on
+
+static ProfileTable profile;
+static pthread_mutex_t profileMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// The main thread holds this mutex while it starts threads so no
+// thread starts working before all threads have a barrier
+
+static pthread_mutex_t startMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Get a monotonic time in seconds
+
+static double
+now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Wait until every thread has finished its warmups and then start
+// timing, so no thread's timed iterations overlap another thread's
+// warmups
+
+static void
+start_timing(PerformanceThread *perf)
+{
+    if (perf->barrier && !perf->timing)
+    {
+        barrier_wait(perf->barrier);
+    }
+    perf->timing = true;
+    perf->start = now_seconds();
+}
+
+// Add a record's latency to a thread's measurements
+
+static const Error *
+add_latency(PerformanceThread *perf, double latency)
+{
+    if (perf->numRecords == perf->capacity)
+    {
+        size_t capacity = perf->capacity ? perf->capacity * 2 : 1024;
+        double *latencies = realloc(perf->latencies, capacity * sizeof(*latencies));
+        if (!latencies)
+        {
+            static Error error = {CLI_PERFORMANCE_MEMORY, {0}};
+            return &error;
+        }
+        perf->latencies = latencies;
+        perf->capacity = capacity;
+    }
+    perf->latencies[perf->numRecords++] = latency;
+    return NULL;
+}
+
+// Fail a record if validate mode is on and it had any diagnostics
+
+static const Error *
+check_diagnostics(Diagnostics *diagnostics)
+{
+    const Error *error = NULL;
+    if (daffodil_pu.validate && diagnostics->total)
+    {
+        static Error error_diagnostics = {CLI_DIAGNOSTICS, {0}};
+        error_diagnostics.arg.d64 = (int64_t)diagnostics->total;
+        error = &error_diagnostics;
+    }
+    reset_diagnostics(diagnostics);
+    return error;
+}
+
+// Get how many times a thread will parse or unparse data, counting
+// warmups only if it has any timed iterations
+
+static size_t
+num_iterations(const PerformanceThread *perf)
+{
+    return perf->iterations ? perf->warmups + perf->iterations : 0;
+}
+
+// Parse input data over and over, converting each record's infoset
+// to XML, CSV, or TSV unless the infoset type is null
+
+static const Error *
+parse_repeatedly(PerformanceThread *perf, FILE *input, FILE *output)
+{
+    // Clear our infoset only once; reusing it lets parsers free any
+    // dynamic hexBinary storage instead of leaking it
+    const bool CLEAR_INFOSET = true;
+    InfosetBase *infoset = get_infoset(CLEAR_INFOSET);
+
+    // Pick a writer for our infoset, or no writer at all
+    XMLWriter xmlWriter = {xmlWriterMethods, output, {NULL, NULL, 0}};
+    CSVWriter csvWriter = {csvWriterMethods, output, ',', NULL, 0, 0, NULL, 0, 0};
+    const VisitEventHandler *writer = NULL;
+    const Error *error = NULL;
+    if (strcmp("xml", daffodil_pu.infoset_converter) == 0)
+    {
+        writer = (const VisitEventHandler *)&xmlWriter;
+    }
+    else if (strcmp("null", daffodil_pu.infoset_converter) != 0)
+    {
+        csvWriter.separator = strcmp("tsv", daffodil_pu.infoset_converter) == 0 ? '\t' : ',';
+        error = csv_init_writer(&csvWriter, infoset->erd);
+        writer = (const VisitEventHandler *)&csvWriter;
+    }
+
+    Diagnostics diagnostics = {0};
+    for (size_t i = 0; i < num_iterations(perf) && !error; i++)
+    {
+        // Parse one record, or each record if stream mode is on, timing
+        // records only after the warmups
+        const bool timed = i >= perf->warmups;
+        if (i == perf->warmups)
+        {
+            start_timing(perf);
+        }
+        rewind(input);
+        PState pstate = {.pu = {.stream = input, .diagnostics = &diagnostics}};
+        bool more_data = true;
+        while (more_data && !error)
+        {
+            const size_t start_bitPos0b = pstate.pu.bitPos0b;
+            const double start = now_seconds();
+            if (daffodil_pu.stream)
+            {
+                parse_record(infoset, &pstate);
+            }
+            else
+            {
+                parse_data(infoset, &pstate);
+            }
+            error = pstate.pu.error;
+            if (!error && writer)
+            {
+                error = walk_infoset(writer, infoset);
+            }
+            const double latency = now_seconds() - start;
+
+            if (!error)
+            {
+                error = check_diagnostics(&diagnostics);
+            }
+            if (!error && timed)
+            {
+                error = add_latency(perf, latency);
+            }
+
+            // Stop if stream mode is off or no data remains, and report
+            // leftover data if a record consumed no data
+            more_data = daffodil_pu.stream && has_more_data(&pstate);
+            if (!error && more_data && pstate.pu.bitPos0b == start_bitPos0b)
+            {
+                no_leftover_data(&pstate);
+                error = pstate.pu.error;
+            }
+        }
+        if (timed)
+        {
+            perf->numBytes += (pstate.pu.bitPos0b + 7) / 8;
+        }
+    }
+    perf->end = now_seconds();
+
+    // Free the last record's storage since the thread will exit
+    free_infoset(infoset);
+    csv_fini_writer(&csvWriter);
+    return error;
+}
+
+// Read input XML infoset once and then unparse it over and over,
+// timing only the unparsing
+
+static const Error *
+unparse_repeatedly(PerformanceThread *perf, FILE *input, FILE *output)
+{
+    const bool CLEAR_INFOSET = true;
+    InfosetBase *infoset = get_infoset(CLEAR_INFOSET);
+    XMLReader xmlReader = {xmlReaderMethods, input, NULL, NULL};
+    const Error *error = NULL;
+    if (num_iterations(perf))
+    {
+        error = walk_infoset((const VisitEventHandler *)&xmlReader, infoset);
+    }
+
+    Diagnostics diagnostics = {0};
+    for (size_t i = 0; i < num_iterations(perf) && !error; i++)
+    {
+        // Unparse the infoset, timing it only after the warmups
+        const bool timed = i >= perf->warmups;
+        if (i == perf->warmups)
+        {
+            start_timing(perf);
+        }
+        const double start = now_seconds();
+        UState ustate = {.pu = {.stream = output, .diagnostics = &diagnostics}};
+        unparse_infoset(infoset, &ustate);
+        error = ustate.pu.error;
+        const double latency = now_seconds() - start;
+
+        if (!error)
+        {
+            error = check_diagnostics(&diagnostics);
+        }
+        if (!error && timed)
+        {
+            error = add_latency(perf, latency);
+        }
+        if (timed)
+        {
+            perf->numBytes += (ustate.pu.bitPos0b + 7) / 8;
+        }
+    }
+    perf->end = now_seconds();
+
+    // Free the infoset's storage since the thread will exit
+    free_infoset(infoset);
+    return error;
+}
+
+// Open a stream which reads data from memory
+
+static FILE *
+open_memory_stream(const uint8_t *data, size_t length)
+{
+#ifdef _WIN32
+    // Windows has no fmemopen, so use a temporary file instead which
+    // the operating system will most likely keep in its cache
+    FILE *stream = tmpfile();
+    if (stream && fwrite(data, 1, length, stream) < length)
+    {
+        fclose(stream);
+        stream = NULL;
+    }
+    return stream;
+#else
+    return fmemopen((void *)data, length, "r");
+#endif
+}
+
+// Run one thread's share of the work and save its measurements
+
+static void *
+run_thread(void *arg)
+{
+    PerformanceThread *perf = arg;
+
+    // Wait until the main thread has started every thread
+    pthread_mutex_lock(&startMutex);
+    pthread_mutex_unlock(&startMutex);
+
+    // Read input from memory and discard output so we can measure
+    // parsing and unparsing separately from disk speed
+    FILE *input = open_memory_stream(perf->data, perf->dataLength);
+    FILE *output = fopen(NULL_DEVICE, "w");
+    if (!input)
+    {
+        static Error error = {CLI_PERFORMANCE_MEMORY, {0}};
+        perf->error = &error;
+    }
+    else if (!output)
+    {
+        static Error error = {CLI_FILE_OPEN, {.s = NULL_DEVICE}};
+        perf->error = &error;
+    }
+    else if (daffodil_perf.unparse)
+    {
+        perf->error = unparse_repeatedly(perf, input, output);
+    }
+    else
+    {
+        perf->error = parse_repeatedly(perf, input, output);
+    }
+
+    // Wait at the barrier even if an error or having no iterations kept
+    // this thread from reaching it so the other threads can go on
+    if (!perf->timing)
+    {
+        start_timing(perf);
+    }
+
+    if (daffodil_pu.profile)
+    {
+        pthread_mutex_lock(&profileMutex);
+        add_profile(&profile, get_profile());
+        pthread_mutex_unlock(&profileMutex);
+    }
+
+    if (input) fclose(input);
+    if (output) fclose(output);
+    arena_free();
+    return NULL;
+}
+
+// Read all data from input into memory
+
+static const Error *
+read_all(FILE *input, const char *infile, uint8_t **data, size_t *length)
+{
+    size_t capacity = 0;
+    *data = NULL;
+    *length = 0;
+    while (!feof(input) && !ferror(input))
+    {
+        if (*length == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 65536;
+            uint8_t *bigger = realloc(*data, capacity);
+            if (!bigger)
+            {
+                static Error error = {CLI_PERFORMANCE_MEMORY, {0}};
+                return &error;
+            }
+            *data = bigger;
+        }
+        *length += fread(*data + *length, 1, capacity - *length, input);
+    }
+
+    if (ferror(input))
+    {
+        static Error error = {CLI_FILE_READ, {0}};
+        error.arg.s = infile;
+        return &error;
+    }
+    return NULL;
+}
+
+// Compare two latencies for qsort
+
+static int
+compare_latencies(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Write total time, records per second, megabytes per second, and
+// latency percentiles (using nearest rank) measured by all threads
+
+static const Error *
+write_report(const PerformanceThread *threads, size_t numThreads, double seconds, FILE *output)
+{
+    size_t numRecords = 0;
+    size_t numBytes = 0;
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        numRecords += threads[i].numRecords;
+        numBytes += threads[i].numBytes;
+    }
+
+    double *latencies = malloc((numRecords ? numRecords : 1) * sizeof(*latencies));
+    if (!latencies)
+    {
+        static Error error = {CLI_PERFORMANCE_MEMORY, {0}};
+        return &error;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        for (size_t j = 0; j < threads[i].numRecords; j++)
+        {
+            latencies[n++] = threads[i].latencies[j];
+        }
+    }
+    qsort(latencies, n, sizeof(*latencies), compare_latencies);
+
+    const size_t percents[] = {50, 90, 99};
+    double usecs[] = {0, 0, 0, 0};
+    for (size_t i = 0; i < 3 && n; i++)
+    {
+        const size_t rank = (n * percents[i] + 99) / 100;
+        usecs[i] = latencies[rank ? rank - 1 : 0] * 1e6;
+    }
+    usecs[3] = n ? latencies[n - 1] * 1e6 : 0;
+    free(latencies);
+
+    fprintf(output, "threads: %zu, iterations: %zu, records: %zu, bytes: %zu\n", numThreads,
+            daffodil_perf.number, numRecords, numBytes);
+    fprintf(output, "total time (sec): %.6f\n", seconds);
+    fprintf(output, "rate (records/sec): %.1f\n", seconds > 0 ? numRecords / seconds : 0);
+    fprintf(output, "throughput (MB/sec): %.3f\n", seconds > 0 ? numBytes / seconds / 1e6 : 0);
+    fprintf(output, "latency (usec): p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n", usecs[0], usecs[1],
+            usecs[2], usecs[3]);
+    return NULL;
+}
+
+// performance_test - read all of input into memory, then parse (or
+// unparse) it over and over on one or more threads and write records
+// per second, megabytes per second, and latency percentiles to output
+
+const Error *
+performance_test(FILE *input, const char *infile, FILE *output)
+{
+    // Read input only once
+    uint8_t *data = NULL;
+    size_t length = 0;
+    const Error *error = read_all(input, infile, &data, &length);
+
+    // Divide iterations among threads as evenly as possible
+    const size_t numThreads = daffodil_perf.threads;
+    PerformanceThread *threads = NULL;
+    if (!error)
+    {
+        threads = calloc(numThreads, sizeof(*threads));
+        if (!threads)
+        {
+            static Error error_memory = {CLI_PERFORMANCE_MEMORY, {0}};
+            error = &error_memory;
+        }
+    }
+
+    // Start all threads at once and wait for all of them to finish,
+    // giving the threads a barrier only after knowing how many started
+    Barrier barrier;
+    bool haveBarrier = false;
+    size_t numStarted = 0;
+    pthread_mutex_lock(&startMutex);
+    for (size_t i = 0; i < numThreads && !error; i++)
+    {
+        threads[i].data = data;
+        threads[i].dataLength = length;
+        threads[i].warmups = daffodil_perf.warmup;
+        threads[i].iterations = daffodil_perf.number / numThreads + (i < daffodil_perf.number % numThreads);
+        if (pthread_create(&threads[i].thread, NULL, run_thread, &threads[i]) == 0)
+        {
+            numStarted++;
+        }
+        else
+        {
+            static Error error_thread = {CLI_PERFORMANCE_THREAD, {0}};
+            error = &error_thread;
+        }
+    }
+    if (!error && numStarted)
+    {
+        haveBarrier = barrier_init(&barrier, (unsigned)numStarted) == 0;
+        if (!haveBarrier)
+        {
+            static Error error_barrier = {CLI_PERFORMANCE_THREAD, {0}};
+            error = &error_barrier;
+        }
+    }
+    for (size_t i = 0; i < numStarted; i++)
+    {
+        // Skip all work if any thread or the barrier failed to start
+        threads[i].barrier = haveBarrier ? &barrier : NULL;
+        threads[i].iterations = error ? 0 : threads[i].iterations;
+    }
+    pthread_mutex_unlock(&startMutex);
+    for (size_t i = 0; i < numStarted; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+        if (!error)
+        {
+            error = threads[i].error;
+        }
+    }
+
+    // Measure the time from the first timed iteration of any thread to
+    // the last one of any thread, so warmups don't count
+    double start = 0;
+    double end = 0;
+    for (size_t i = 0; i < numStarted; i++)
+    {
+        if (threads[i].iterations)
+        {
+            start = start && start < threads[i].start ? start : threads[i].start;
+            end = end > threads[i].end ? end : threads[i].end;
+        }
+    }
+    const double seconds = end - start;
+    if (haveBarrier)
+    {
+        barrier_destroy(&barrier);
+    }
+
+    if (!error)
+    {
+        error = write_report(threads, numStarted, seconds, output);
+    }
+    if (!error && daffodil_pu.profile)
+    {
+        print_profile(&profile, stderr);
+    }
+
+    for (size_t i = 0; threads && i < numThreads; i++)
+    {
+        free(threads[i].latencies);
+    }
+    free(threads);
+    free(data);
+    return error;
+}
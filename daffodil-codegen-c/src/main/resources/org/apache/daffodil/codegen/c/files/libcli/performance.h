@@ -0,0 +1,34 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PERFORMANCE_H
+#define PERFORMANCE_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdio.h>   // for FILE
+#include "errors.h"  // for Error
+// clang-format on
+
+// performance_test - read all of input into memory, then parse (or
+// unparse) it over and over on one or more threads and write records
+// per second, megabytes per second, and latency percentiles to output
+
+extern const Error *performance_test(FILE *input, const char *infile, FILE *output);
+
+#endif // PERFORMANCE_H
@@ -0,0 +1,299 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include "serve.h"
+#include <mxml.h>             // for mxmlDelete
+#include <stdbool.h>          // for bool, false, true
+#include <stddef.h>           // for size_t, NULL
+#include <stdint.h>           // for uint8_t, int64_t, SIZE_MAX
+#include <stdio.h>            // for fclose, fprintf, fwrite, fflush, fgets, fread, FILE, ferror
+#include <stdlib.h>           // for free, malloc, realloc, strtoull
+#include <string.h>           // for strchr, strcmp
+#include "cli_errors.h"       // for CLI_DIAGNOSTICS, CLI_SERVE_MEMORY, CLI_SERVE_REQUEST, CLI_SERVE_WRITE
+#include "daffodil_getopt.h"  // for daffodil_pu, daffodil_pu_cli
+#include "infoset.h"          // for PState, UState, get_infoset, parse_data, unparse_infoset, walk_infoset, InfosetBase, VisitEventHandler
+#include "xml_reader.h"       // for xmlReaderMethods, XMLReader
+#include "xml_writer.h"       // for xmlWriterMethods, XMLWriter
+// clang-format on
+
+// LIMIT_REQUEST_LINE - room needed by a request's header line
+
+#define LIMIT_REQUEST_LINE 64
+
+// ResponseStream - stream which collects a response's infoset, data,
+// or messages in memory until the response gets written
+
+typedef struct ResponseStream
+{
+    FILE *stream;  // stream to write to
+    char *bytes;   // bytes written to stream (valid after closing it)
+    size_t length; // number of bytes written to stream
+} ResponseStream;
+
+// Open a stream which reads a request's payload from memory
+
+static FILE *
+open_request_stream(uint8_t *payload, size_t length)
+{
+#ifdef _WIN32
+    // Windows has no fmemopen, so use a temporary file instead
+    FILE *stream = tmpfile();
+    if (stream && (fwrite(payload, 1, length, stream) < length || fseek(stream, 0, SEEK_SET) != 0))
+    {
+        fclose(stream);
+        stream = NULL;
+    }
+    return stream;
+#else
+    return fmemopen(payload, length, "r");
+#endif
+}
+
+// Open a stream which collects bytes in memory
+
+static bool
+open_response_stream(ResponseStream *response)
+{
+    response->bytes = NULL;
+    response->length = 0;
+#ifdef _WIN32
+    // Windows has no open_memstream, so use a temporary file instead
+    response->stream = tmpfile();
+#else
+    response->stream = open_memstream(&response->bytes, &response->length);
+#endif
+    return response->stream != NULL;
+}
+
+// Close a response stream and get the bytes written to it
+
+static bool
+close_response_stream(ResponseStream *response)
+{
+#ifdef _WIN32
+    // Read the temporary file back into memory
+    long length = fflush(response->stream) == 0 ? ftell(response->stream) : -1;
+    response->bytes = length >= 0 ? malloc((size_t)length + 1) : NULL;
+    response->length = 0;
+    if (response->bytes && fseek(response->stream, 0, SEEK_SET) == 0)
+    {
+        response->length = fread(response->bytes, 1, (size_t)length, response->stream);
+    }
+    bool ok = response->bytes && response->length == (size_t)length;
+    return fclose(response->stream) == 0 && ok;
+#else
+    return fclose(response->stream) == 0;
+#endif
+}
+
+// Fail a request if validate mode is on and it had any diagnostics
+
+static const Error *
+check_diagnostics(const Diagnostics *diagnostics)
+{
+    if (daffodil_pu.validate && diagnostics->total)
+    {
+        static Error error = {CLI_DIAGNOSTICS, {0}};
+        error.arg.d64 = (int64_t)diagnostics->total;
+        return &error;
+    }
+    return NULL;
+}
+
+// Parse a request's data into an infoset and write the infoset as
+// XML, writing any diagnostics and errors to messages and returning
+// false if the parse failed
+
+static bool
+serve_parse(InfosetBase *infoset, FILE *input, FILE *output, FILE *messages)
+{
+    Diagnostics diagnostics = {0};
+    PState pstate = {.pu = {.stream = input, .diagnostics = &diagnostics}};
+    parse_data(infoset, &pstate);
+    print_diagnostics(&diagnostics, messages);
+
+    // A record which didn't pass the generated filter gets an empty infoset
+    const Error *error = pstate.pu.error;
+    if (!error && !pstate.filteredOut)
+    {
+        XMLWriter xmlWriter = {xmlWriterMethods, output, {NULL, NULL, 0}};
+        error = walk_infoset((const VisitEventHandler *)&xmlWriter, infoset);
+    }
+    if (!error)
+    {
+        error = check_diagnostics(&diagnostics);
+    }
+
+    print_error(error, messages);
+    return !error;
+}
+
+// Read a request's XML infoset into an infoset and unparse it to
+// data, writing any diagnostics and errors to messages and returning
+// false if the unparse failed
+
+static bool
+serve_unparse(InfosetBase *infoset, FILE *input, FILE *output, FILE *messages)
+{
+    XMLReader xmlReader = {xmlReaderMethods, input, NULL, NULL};
+    const Error *error = walk_infoset((const VisitEventHandler *)&xmlReader, infoset);
+
+    // A failed walk leaves its XML data behind for us to delete
+    if (xmlReader.xml)
+    {
+        mxmlDelete(xmlReader.xml);
+    }
+
+    Diagnostics diagnostics = {0};
+    if (!error)
+    {
+        UState ustate = {.pu = {.stream = output, .diagnostics = &diagnostics}};
+        unparse_infoset(infoset, &ustate);
+        print_diagnostics(&diagnostics, messages);
+        error = ustate.pu.error;
+    }
+    if (!error)
+    {
+        error = check_diagnostics(&diagnostics);
+    }
+
+    print_error(error, messages);
+    return !error;
+}
+
+// Answer one request and write its response to output
+
+static const Error *
+serve_request(InfosetBase *infoset, bool parse, uint8_t *payload, size_t length, FILE *output)
+{
+    static Error error_memory = {CLI_SERVE_MEMORY, {0}};
+    static Error error_write = {CLI_SERVE_WRITE, {0}};
+
+    // Read the request from memory and collect the response in memory
+    // since its lengths must be written before its bytes
+    ResponseStream infosetOrData = {NULL, NULL, 0};
+    ResponseStream messages = {NULL, NULL, 0};
+    FILE *input = open_request_stream(payload, length);
+    bool ok = input && open_response_stream(&infosetOrData);
+    ok = ok && open_response_stream(&messages);
+    if (!ok)
+    {
+        if (input) fclose(input);
+        if (infosetOrData.stream) fclose(infosetOrData.stream);
+        free(infosetOrData.bytes);
+        return &error_memory;
+    }
+
+    // Perform the request and finish collecting its response
+    const bool success = parse ? serve_parse(infoset, input, infosetOrData.stream, messages.stream)
+                               : serve_unparse(infoset, input, infosetOrData.stream, messages.stream);
+    fclose(input);
+    ok = close_response_stream(&infosetOrData);
+    ok = close_response_stream(&messages) && ok;
+
+    // Write the response and flush it so the client can read it now
+    const Error *error = ok ? NULL : &error_memory;
+    if (!error)
+    {
+        fprintf(output, "%s %zu %zu\n", success ? "ok" : "error", infosetOrData.length, messages.length);
+        fwrite(infosetOrData.bytes, 1, infosetOrData.length, output);
+        fwrite(messages.bytes, 1, messages.length, output);
+        if (fflush(output) != 0 || ferror(output))
+        {
+            error = &error_write;
+        }
+    }
+
+    free(infosetOrData.bytes);
+    free(messages.bytes);
+    return error;
+}
+
+// serve_requests - answer parse and unparse requests read from input
+// until input has no more requests, writing each response to output
+// right away
+
+const Error *
+serve_requests(FILE *input, FILE *output)
+{
+    // Clear our infoset only once; reusing it lets parsers free any
+    // dynamic hexBinary storage instead of leaking it
+    const bool CLEAR_INFOSET = true;
+    InfosetBase *infoset = get_infoset(CLEAR_INFOSET);
+
+    static char line[LIMIT_REQUEST_LINE];
+    static Error error_request = {CLI_SERVE_REQUEST, {.s = line}};
+    uint8_t *payload = NULL;
+    size_t capacity = 0;
+    const Error *error = NULL;
+    while (!error && fgets(line, sizeof(line), input))
+    {
+        // Split the header line into a command and a payload length
+        char *newline = strchr(line, '\n');
+        char *space = strchr(line, ' ');
+        char *end = NULL;
+        const unsigned long long length = space ? strtoull(space + 1, &end, 10) : 0;
+        if (!newline || !space || end == space + 1 || end != newline || space[1] == '-')
+        {
+            if (newline) *newline = '\0';
+            error = &error_request;
+            break;
+        }
+        *newline = '\0';
+        *space = '\0';
+        const bool parse = strcmp("parse", line) == 0;
+        if (!parse && strcmp("unparse", line) != 0)
+        {
+            *space = ' ';
+            error = &error_request;
+            break;
+        }
+
+        // Read the payload into a buffer which grows as needed (with
+        // room for at least one byte since fmemopen needs a buffer)
+        if (length >= capacity)
+        {
+            size_t bigger = capacity ? capacity : 65536;
+            while (length >= bigger && bigger < SIZE_MAX / 2)
+            {
+                bigger *= 2;
+            }
+            uint8_t *buffer = length < bigger ? realloc(payload, bigger) : NULL;
+            if (!buffer)
+            {
+                static Error error_memory = {CLI_SERVE_MEMORY, {0}};
+                error = &error_memory;
+                break;
+            }
+            payload = buffer;
+            capacity = bigger;
+        }
+        if (fread(payload, 1, length, input) < length)
+        {
+            *space = ' ';
+            error = &error_request;
+            break;
+        }
+
+        error = serve_request(infoset, parse, payload, length, output);
+    }
+
+    free(payload);
+    return error;
+}
@@ -0,0 +1,38 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVE_H
+#define SERVE_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdio.h>   // for FILE
+#include "errors.h"  // for Error
+// clang-format on
+
+// serve_requests - answer parse and unparse requests read from input
+// until input has no more requests, writing each response to output
+// right away.  Each request is a header line "parse <length>" or
+// "unparse <length>" followed by <length> bytes of data or XML
+// infoset.  Each response is a header line "ok <length1> <length2>"
+// or "error <length1> <length2>" followed by <length1> bytes of XML
+// infoset or data and <length2> bytes of diagnostics and error
+// messages.  Only a malformed request or an I/O error stops serving.
+
+extern const Error *serve_requests(FILE *input, FILE *output);
+
+#endif // SERVE_H
@@ -25,9 +25,9 @@
 #include <stdbool.h>     // for bool, false, true
 #include <stdint.h>      // for int64_t, intmax_t, uint8_t, uintmax_t, int16_t, int32_t, int8_t, uint16_t, uint32_t, uint64_t, INT16_MAX, INT16_MIN, INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN, INT8_MAX, INT8_MIN, UINT16_MAX, UINT32_MAX, UINT64_MAX, UINT8_MAX
 #include <stdlib.h>      // for free, malloc, strtod, strtof
-#include <string.h>      // for strcmp, strlen, strncmp, memset
+#include <string.h>      // for strcmp, strlen, strncmp, memcpy, memset
 #include "cli_errors.h"  // for CLI_STRTONUM_EMPTY, CLI_STRTONUM_NOT, CLI_XML_GONE, CLI_STRTOD_ERRNO, CLI_STRTOI_ERRNO, CLI_STRTONUM_RANGE, CLI_XML_MISMATCH, CLI_HEXBINARY_LENGTH, CLI_HEXBINARY_PARSE, CLI_HEXBINARY_SIZE, CLI_STRTOBOOL, CLI_XML_ERD, CLI_XML_INPUT, CLI_XML_LEFT
-#include "errors.h"      // for Error, Error::(anonymous), ERR_HEXBINARY_ALLOC, UNUSED
+#include "errors.h"      // for Error, Error::(anonymous), ERR_HEXBINARY_ALLOC, ERR_STRING_ALLOC, UNUSED
 // clang-format on
 
 // Convert an XML element's text to a boolean with error checking
@@ -227,6 +227,27 @@ strtounum(const char *text, uintmax_t maxval, uintmax_t *valueptr)
     return NULL;
 }
 
+// Store an XML element's text into a string's character array.
+// Grow character array if needed (a reused infoset may still hold a
+// previous infoset's shorter string).  Return error if no memory
+// could be allocated.
+
+static const Error *
+strtostring(const char *text, String *string)
+{
+    size_t length = text ? strlen(text) : 0;
+    if (!string_reserve(string, length))
+    {
+        static Error error = {ERR_STRING_ALLOC, {0}};
+        error.arg.d64 = (int64_t)length;
+        return &error;
+    }
+
+    memcpy(string->chars, text ? text : "", length + 1);
+    string->length = length;
+    return NULL;
+}
+
 // Store an XML element's text (a string of hexadecimal characters,
 // two nibbles per byte) into a byte array.  Allocate memory for byte
 // array if needed.  Return error if text does not fit into byte
@@ -245,16 +266,18 @@ strtohexbinary(const char *text, HexBinary *hexBinary)
         return &error;
     }
 
-    // Allocate memory for byte array if needed
-    if (hexBinary->dynamic && hexBinary->lengthInBytes < numBytes)
+    // Allocate memory for byte array if needed (a reused infoset may
+    // still hold a previous infoset's byte array of another length)
+    if (hexBinary->dynamic && hexBinary->lengthInBytes != numBytes)
     {
         free(hexBinary->array);
         hexBinary->array = malloc(numBytes);
         hexBinary->lengthInBytes = numBytes;
-        if (hexBinary->array == NULL)
+        if (numBytes && hexBinary->array == NULL)
         {
             static Error error = {ERR_HEXBINARY_ALLOC, {0}};
             error.arg.d64 = (int64_t)numBytes;
+            hexBinary->lengthInBytes = 0;
             return &error;
         }
     }
@@ -357,7 +380,7 @@ xmlEndDocument(XMLReader *reader)
     // Check whether we have consumed all of the XML data
     if (reader->node)
     {
-        // This code path exits the program - no need to call mxmlDelete
+        // Leave XML data for the caller to delete (most callers just exit)
         static Error error = {CLI_XML_LEFT, {0}};
         error.arg.s = mxmlGetElement(reader->node);
         return &error;
@@ -417,8 +440,8 @@ xmlEndComplex(XMLReader *reader, const InfosetBase *base)
     return NULL;
 }
 
-// Read a boolean, 32-bit or 64-bit real number, hexBinary, or
-// 8, 16, 32, or 64-bit signed or unsigned integer from XML data
+// Read a boolean, 32-bit or 64-bit real number, hexBinary, string,
+// or 8, 16, 32, or 64-bit signed or unsigned integer from XML data
 
 static const Error *
 xmlSimpleElem(XMLReader *reader, const ERD *erd, void *valueptr)
@@ -473,6 +496,8 @@ xmlSimpleElem(XMLReader *reader, const ERD *erd, void *valueptr)
                 error = strtoinum(text, INT8_MIN, INT8_MAX, &num);
                 *(int8_t *)valueptr = (int8_t)num;
                 return error;
+            case PRIMITIVE_STRING:
+                return strtostring(text, (String *)valueptr);
             case PRIMITIVE_UINT16:
                 error = strtounum(text, UINT16_MAX, &unum);
                 *(uint16_t *)valueptr = (uint16_t)unum;
@@ -83,8 +83,8 @@ fixNumberIfNeeded(const char *text)
 static const char *
 binaryToHex(HexBinary hexBinary, bool freeMemory)
 {
-    static char *text = NULL;
-    static size_t capacity = 256;
+    static _Thread_local char *text = NULL;
+    static _Thread_local size_t capacity = 256;
 
     // Call with freeMemory true when finished
     if (freeMemory)
@@ -124,13 +124,13 @@ binaryToHex(HexBinary hexBinary, bool freeMemory)
 }
 
 // Push new XML document on stack (note the stack is stored in a
-// static array which could overflow and stop the program; it also
-// means none of those functions are thread-safe)
+// thread-local static array which could overflow and stop the
+// program; it also means each thread can use only one XMLWriter)
 
 static const Error *
 xmlStartDocument(XMLWriter *writer)
 {
-    static mxml_node_t *array[LIMIT_XML_NESTING];
+    static _Thread_local mxml_node_t *array[LIMIT_XML_NESTING];
     stack_init(&writer->stack, array, LIMIT_XML_NESTING);
 
     mxml_node_t *xml = mxmlNewXML("1.0");
@@ -206,8 +206,9 @@ xmlEndComplex(XMLWriter *writer, const InfosetBase *base)
     return NULL;
 }
 
-// Write a boolean, 32-bit or 64-bit real number, hexBinary, or
-// 8, 16, 32, or 64-bit signed or unsigned integer as an XML element's text
+// Write a boolean, 32-bit or 64-bit real number, hexBinary, string,
+// or 8, 16, 32, or 64-bit signed or unsigned integer as an XML
+// element's text
 
 static const Error *
 xmlSimpleElem(XMLWriter *writer, const ERD *erd, const void *valueptr)
@@ -257,6 +258,12 @@ xmlSimpleElem(XMLWriter *writer, const ERD *erd, const void *valueptr)
     case PRIMITIVE_INT8:
         text = mxmlNewOpaquef(simple, "%hhi", *(const int8_t *)valueptr);
         break;
+    case PRIMITIVE_STRING:
+    {
+        const char *chars = ((const String *)valueptr)->chars;
+        text = mxmlNewOpaque(simple, chars ? chars : "");
+        break;
+    }
     case PRIMITIVE_UINT16:
         text = mxmlNewOpaquef(simple, "%hu", *(const uint16_t *)valueptr);
         break;
@@ -21,10 +21,15 @@
 #include <assert.h>    // for assert
 #include <inttypes.h>  // for PRId64
 #include <stdbool.h>   // for bool, false, true
+#include <stdint.h>    // for uintptr_t, int64_t, uint8_t
 #include <stdio.h>     // for fprintf, stderr, feof, ferror, FILE, stdout
 #include <stdlib.h>    // for exit, EXIT_FAILURE, EXIT_SUCCESS
 // clang-format oon
 
+// Prototypes needed for compilation
+
+static const ErrorLookup *find_error_lookup(uint8_t code);
+
 // eof_or_error - get pointer to error if stream has eof or error indicator set
 
 const Error *
@@ -46,50 +51,136 @@ eof_or_error(FILE *stream)
     }
 }
 
-// get_diagnostics - get pointer to validation diagnostics
+// get_diagnostics - get pointer to this thread's validation diagnostics
+// (used by any parser or unparser state without its own diagnostics)
 
 Diagnostics *
 get_diagnostics(void)
 {
-    static Diagnostics diagnostics;
+    static _Thread_local Diagnostics diagnostics;
     return &diagnostics;
 }
 
-// add_diagnostic - add a new error to validation diagnostics
+// count_diagnostic - count an error num_errors times by its code and
+// its element (if the error has one), or just drop it from the counts
+// if there are already too many distinct errors being counted
+
+static void
+count_diagnostic(Diagnostics *diagnostics, const Error *error, size_t num_errors)
+{
+    // Only errors with a string argument name an element
+    const ErrorLookup *lookup = find_error_lookup(error->code);
+    const char *element = lookup->field == FIELD_S ? error->arg.s : NULL;
+
+    // Probe the hash table linearly starting from the hash of the error
+    const size_t mask = LIMIT_DIAGNOSTIC_COUNTS - 1;
+    size_t hash = ((uintptr_t)element >> 3) ^ ((size_t)error->code * 0x9E3779B9u);
+    for (size_t i = 0; i < LIMIT_DIAGNOSTIC_COUNTS; i++)
+    {
+        DiagnosticCount *count = &diagnostics->counts[(hash + i) & mask];
+        if (count->count == 0 || count->epoch != diagnostics->epoch)
+        {
+            // Found an empty (or stale) slot, so start a new count
+            count->first = *error;
+            count->count = num_errors;
+            count->epoch = diagnostics->epoch;
+            return;
+        }
+        if (count->first.code == error->code && (!element || count->first.arg.s == element))
+        {
+            count->count += num_errors;
+            return;
+        }
+    }
+}
+
+// add_diagnostic - add a new error to validation diagnostics, return
+// true if the error was kept in full detail or false if only counted
 
 bool
 add_diagnostic(Diagnostics *diagnostics, const Error *error)
 {
     if (diagnostics && error)
     {
+        diagnostics->total++;
+        count_diagnostic(diagnostics, error, 1);
         if (diagnostics->length < LIMIT_DIAGNOSTICS)
         {
             Error *err = &diagnostics->array[diagnostics->length++];
             err->code = error->code;
-            err->arg.s = error->arg.s;
+            err->arg = error->arg;
             return true;
         }
     }
     return false;
 }
 
+// merge_diagnostics - add all errors from one set of validation
+// diagnostics to another (e.g., once a parse which could have been
+// retried is kept)
+
+void
+merge_diagnostics(Diagnostics *diagnostics, const Diagnostics *from)
+{
+    if (diagnostics && from)
+    {
+        for (size_t i = 0; i < from->length && diagnostics->length < LIMIT_DIAGNOSTICS; i++)
+        {
+            diagnostics->array[diagnostics->length++] = from->array[i];
+        }
+
+        // Counts include the errors kept in full detail too
+        for (size_t i = 0; i < LIMIT_DIAGNOSTIC_COUNTS; i++)
+        {
+            const DiagnosticCount *count = &from->counts[i];
+            if (count->count && count->epoch == from->epoch)
+            {
+                count_diagnostic(diagnostics, &count->first, count->count);
+            }
+        }
+        diagnostics->total += from->total;
+    }
+}
+
+// reset_diagnostics - remove all errors from validation diagnostics
+// in constant time (e.g., between records)
+
+void
+reset_diagnostics(Diagnostics *diagnostics)
+{
+    if (diagnostics)
+    {
+        // Incrementing epoch makes all counts stale at once
+        diagnostics->length = 0;
+        diagnostics->total = 0;
+        diagnostics->epoch++;
+    }
+}
+
 // error_lookup - look up an internationalized error message
 
 static const ErrorLookup *
 error_lookup(uint8_t code)
 {
     static const ErrorLookup table[ERR__NUM_CODES] = {
+        {ERR_ARRAY_ALLOC, "error allocating array memory -- %" PRId64 " elements\n", FIELD_D64},
         {ERR_ARRAY_BOUNDS, "%s count out of bounds\n", FIELD_S},
         {ERR_CHOICE_KEY, "no match between choice dispatch key %" PRId64 " and any branch key\n", FIELD_D64},
         {ERR_DFDL_ASSERT, "Assertion expression failed: %s", FIELD_S},
+        {ERR_DIAGNOSTICS_MORE, "%" PRId64 " more diagnostics not shown, all diagnostics counted by kind:\n",
+         FIELD_D64},
         {ERR_HEXBINARY_ALLOC, "error allocating hexBinary memory -- %" PRId64 " bytes\n", FIELD_D64},
         {ERR_LEFTOVER_DATA, "Left over data, at least %i bit(s) remaining after end of parse\n", FIELD_C},
         {ERR_PARSE_BOOL, "error parsing binary value %" PRId64 " as either true or false\n", FIELD_D64},
+        {ERR_PARSE_DELIMITER, "delimiter '%s' not found in data\n", FIELD_S},
+        {ERR_PUSH_ALLOC, "error allocating push parser memory -- %" PRId64 " bytes\n", FIELD_D64},
+        {ERR_PUSH_UNALIGNED, "record ends at bit %" PRId64 " instead of a byte boundary\n", FIELD_D64},
         {ERR_RESTR_ENUM, "value of element '%s' does not match any of its enumerations\n", FIELD_S},
         {ERR_RESTR_FIXED, "value of element '%s' does not match value of its 'fixed' attribute\n", FIELD_S},
         {ERR_RESTR_RANGE, "value of element '%s' is outside its allowed range\n", FIELD_S},
         {ERR_STREAM_EOF, "EOF in stream, stopping program\n", FIELD__NO_ARGS},
         {ERR_STREAM_ERROR, "error in stream, stopping program\n", FIELD__NO_ARGS},
+        {ERR_STRING_ALLOC, "error allocating string memory -- %" PRId64 " bytes\n", FIELD_D64},
     };
 
     if (code < ERR__NUM_CODES)
@@ -107,28 +198,40 @@ error_lookup(uint8_t code)
     }
 }
 
-// print_maybe_stop - print a message and maybe stop the program
+// find_error_lookup - look up an error message in libruntime's table
+// or else libcli's table
 
-static void
-print_maybe_stop(const Error *error, int status)
+static const ErrorLookup *
+find_error_lookup(uint8_t code)
 {
-    const ErrorLookup *lookup = error_lookup(error->code);
+    const ErrorLookup *lookup = error_lookup(code);
     if (!lookup && cli_error_lookup)
     {
-        lookup = cli_error_lookup(error->code);
+        lookup = cli_error_lookup(code);
     }
     assert(lookup);
 
+    return lookup;
+}
+
+// print_maybe_stop - print a message to a stream and maybe stop the
+// program
+
+static void
+print_maybe_stop(const Error *error, FILE *stream, int status)
+{
+    const ErrorLookup *lookup = find_error_lookup(error->code);
+
     switch (lookup->field)
     {
     case FIELD_C:
-        fprintf(stderr, lookup->message, error->arg.c);
+        fprintf(stream, lookup->message, error->arg.c);
         break;
     case FIELD_D64:
-        fprintf(stderr, lookup->message, error->arg.d64);
+        fprintf(stream, lookup->message, error->arg.d64);
         break;
     case FIELD_S:
-        fprintf(stderr, lookup->message, error->arg.s);
+        fprintf(stream, lookup->message, error->arg.s);
         break;
     case FIELD_S_ON_STDOUT:
         fprintf(stdout, lookup->message, error->arg.s);
@@ -136,7 +239,7 @@ print_maybe_stop(const Error *error, int status)
         break;
     case FIELD__NO_ARGS:
     default:
-        fprintf(stderr, "%s", lookup->message);
+        fprintf(stream, "%s", lookup->message);
         break;
     }
 
@@ -147,18 +250,47 @@ print_maybe_stop(const Error *error, int status)
     }
 }
 
-// print_diagnostics - print any validation diagnostics
+// print_diagnostics - print any validation diagnostics to a stream
 
 void
-print_diagnostics(const Diagnostics *diagnostics)
+print_diagnostics(const Diagnostics *diagnostics, FILE *stream)
 {
     if (diagnostics)
     {
         for (size_t i = 0; i < diagnostics->length; i++)
         {
             const Error *error = &diagnostics->array[i];
-            print_maybe_stop(error, 0);
+            print_maybe_stop(error, stream, 0);
         }
+
+        // Summarize any diagnostics which were counted but not kept
+        if (diagnostics->total > diagnostics->length)
+        {
+            const int64_t numMore = (int64_t)(diagnostics->total - diagnostics->length);
+            const Error more = {ERR_DIAGNOSTICS_MORE, {.d64 = numMore}};
+            print_maybe_stop(&more, stream, 0);
+            for (size_t i = 0; i < LIMIT_DIAGNOSTIC_COUNTS; i++)
+            {
+                const DiagnosticCount *count = &diagnostics->counts[i];
+                if (count->count && count->epoch == diagnostics->epoch)
+                {
+                    fprintf(stream, "%8zu x ", count->count);
+                    print_maybe_stop(&count->first, stream, 0);
+                }
+            }
+        }
+    }
+}
+
+// print_error - print an error to a stream without stopping the
+// program (e.g., to report it to a client instead)
+
+void
+print_error(const Error *error, FILE *stream)
+{
+    if (error)
+    {
+        print_maybe_stop(error, stream, 0);
     }
 }
 
@@ -169,7 +301,7 @@ continue_or_exit(const Error *error)
 {
     if (error)
     {
-        print_maybe_stop(error, EXIT_FAILURE);
+        print_maybe_stop(error, stderr, EXIT_FAILURE);
     }
 }
 
@@ -30,17 +30,23 @@
 
 enum ErrorCode
 {
+    ERR_ARRAY_ALLOC,
     ERR_ARRAY_BOUNDS,
     ERR_CHOICE_KEY,
     ERR_DFDL_ASSERT,
+    ERR_DIAGNOSTICS_MORE,
     ERR_HEXBINARY_ALLOC,
     ERR_LEFTOVER_DATA,
     ERR_PARSE_BOOL,
+    ERR_PARSE_DELIMITER,
+    ERR_PUSH_ALLOC,
+    ERR_PUSH_UNALIGNED,
     ERR_RESTR_ENUM,
     ERR_RESTR_FIXED,
     ERR_RESTR_RANGE,
     ERR_STREAM_EOF,
     ERR_STREAM_ERROR,
+    ERR_STRING_ALLOC,
     ERR__NUM_CODES,
 };
 
@@ -81,33 +87,70 @@ typedef struct Error
 
 enum Limits
 {
-    LIMIT_DIAGNOSTICS = 100,  // limits how many diagnostics can accumulate
-    LIMIT_NAME_LENGTH = 9999, // limits how long infoset names can become
+    LIMIT_DIAGNOSTIC_COUNTS = 64,  // limits how many distinct diagnostics get counted (power of 2)
+    LIMIT_DIAGNOSTICS = 100,       // limits how many diagnostics are kept in full detail
+    LIMIT_NAME_LENGTH = 9999,      // limits how long infoset names can become
+    LIMIT_PROFILE_ELEMENTS = 1024, // limits how many distinct elements get profiled (power of 2)
+    LIMIT_READ_AHEAD = 4096,       // limits how many bytes parsers can read ahead at once
 };
 
-// Diagnostics - array of validation errors
+// DiagnosticCount - number of validation errors with the same code
+// and element
+
+typedef struct DiagnosticCount
+{
+    Error first;  // first validation error with this code and element
+    size_t count; // number of validation errors with this code and element
+    size_t epoch; // count is valid only if epoch is same as Diagnostics' epoch
+} DiagnosticCount;
+
+// Diagnostics - bounded sink of validation errors which keeps the
+// first errors in full detail and counts all of them by code and
+// element, so its size doesn't grow with the number of errors
 
 typedef struct Diagnostics
 {
-    Error array[LIMIT_DIAGNOSTICS];
-    size_t length;
+    Error array[LIMIT_DIAGNOSTICS];                  // first validation errors
+    size_t length;                                   // number of errors in array
+    size_t total;                                    // number of errors added since last reset
+    size_t epoch;                                    // incremented by each reset
+    DiagnosticCount counts[LIMIT_DIAGNOSTIC_COUNTS]; // hash table of counts
 } Diagnostics;
 
 // eof_or_error - get pointer to error if stream has eof or error indicator set
 
 extern const Error *eof_or_error(FILE *stream);
 
-// get_diagnostics - get pointer to validation diagnostics
+// get_diagnostics - get pointer to this thread's validation diagnostics
+// (used by any parser or unparser state without its own diagnostics,
+// so threads never count diagnostics into each other's)
 
 extern Diagnostics *get_diagnostics(void);
 
-// add_diagnostic - add a new error to validation diagnostics
+// add_diagnostic - add a new error to validation diagnostics, return
+// true if the error was kept in full detail or false if only counted
 
 extern bool add_diagnostic(Diagnostics *diagnostics, const Error *error);
 
-// print_diagnostics - print any validation diagnostics
+// merge_diagnostics - add all errors from one set of validation
+// diagnostics to another (e.g., once a parse which could have been
+// retried is kept)
+
+extern void merge_diagnostics(Diagnostics *diagnostics, const Diagnostics *from);
+
+// reset_diagnostics - remove all errors from validation diagnostics
+// in constant time (e.g., between records)
+
+extern void reset_diagnostics(Diagnostics *diagnostics);
+
+// print_diagnostics - print any validation diagnostics to a stream
+
+extern void print_diagnostics(const Diagnostics *diagnostics, FILE *stream);
+
+// print_error - print an error to a stream without stopping the
+// program (e.g., to report it to a client instead)
 
-extern void print_diagnostics(const Diagnostics *diagnostics);
+extern void print_error(const Error *error, FILE *stream);
 
 // continue_or_exit - print and exit if any error or continue otherwise
 
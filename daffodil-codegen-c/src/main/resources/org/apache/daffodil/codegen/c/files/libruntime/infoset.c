@@ -18,7 +18,11 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "infoset.h"
-#include <string.h>     // for memccpy
+#include <stdbool.h>    // for bool, false, true
+#include <stddef.h>     // for max_align_t, size_t, NULL
+#include <stdint.h>     // for SIZE_MAX
+#include <stdlib.h>     // for free, malloc
+#include <string.h>     // for memccpy, memcpy, memset
 #include "errors.h"     // for Error, LIMIT_NAME_LENGTH
 #include "parsers.h"    // for no_leftover_data
 #include "unparsers.h"  // for flush_fragment_byte
@@ -38,7 +42,7 @@ static const Error *walk_infoset_node_children(const VisitEventHandler *handler,
 const char *
 get_erd_name(const ERD *erd)
 {
-    static char name[LIMIT_NAME_LENGTH];
+    static _Thread_local char name[LIMIT_NAME_LENGTH];
 
     char *next = name;
     char *last = name + sizeof(name) - 1;
@@ -80,7 +84,7 @@ get_erd_xmlns(const ERD *erd)
 {
     if (erd->namedQName.ns)
     {
-        static char xmlns[LIMIT_NAME_LENGTH];
+        static _Thread_local char xmlns[LIMIT_NAME_LENGTH];
         char *next = xmlns;
         char *last = xmlns + sizeof(xmlns) - 1;
 
@@ -125,16 +129,250 @@ get_erd_ns(const ERD *erd)
     return erd->namedQName.ns;
 }
 
+// ArenaChunk - a chunk of memory from which out-of-line arrays and
+// strings get their storage, linked to the chunks allocated before it
+
+typedef struct ArenaChunk
+{
+    struct ArenaChunk *prev; // chunk allocated before this one or NULL
+    size_t size;             // number of bytes in data
+    size_t used;             // number of bytes already allocated from data
+    max_align_t data[];      // storage for out-of-line arrays' elements and strings
+} ArenaChunk;
+
+// Size of the first chunk (later chunks double in size)
+
+enum
+{
+    ARENA_CHUNK_SIZE = 64 * 1024
+};
+
+// Each thread gets its own arena just like its own infoset
+
+static _Thread_local ArenaChunk *arena;
+
+// arena_alloc - allocate size bytes of storage from the current
+// thread's arena, adding a bigger chunk to the arena if needed
+
+static void *
+arena_alloc(size_t size)
+{
+    // Keep every allocation aligned for any type of element
+    const size_t alignment = sizeof(max_align_t);
+    if (size > SIZE_MAX - sizeof(ArenaChunk) - alignment)
+    {
+        return NULL;
+    }
+    size = (size + alignment - 1) / alignment * alignment;
+
+    if (!arena || arena->size - arena->used < size)
+    {
+        size_t chunkSize = arena && arena->size < SIZE_MAX / 4 ? arena->size * 2 : ARENA_CHUNK_SIZE;
+        if (chunkSize < size)
+        {
+            chunkSize = size;
+        }
+        ArenaChunk *chunk = malloc(sizeof(ArenaChunk) + chunkSize);
+        if (!chunk)
+        {
+            return NULL;
+        }
+        chunk->prev = arena;
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        arena = chunk;
+    }
+
+    void *storage = (char *)arena->data + arena->used;
+    arena->used += size;
+    return storage;
+}
+
+// arena_grow - allocate new storage for an out-of-line array's
+// elements from the current thread's arena, copy its old elements
+// into the new storage, zero the rest, and return the new storage (or
+// NULL if no memory could be allocated)
+
+void *
+arena_grow(const void *elements, size_t capacity, size_t newCapacity, size_t elementSize)
+{
+    if (newCapacity > SIZE_MAX / elementSize)
+    {
+        return NULL;
+    }
+
+    // Old storage stays in the arena until the arena gets freed, but
+    // arrays keep their storage across infosets and double their
+    // capacity when they grow, so little storage gets wasted
+    char *newElements = arena_alloc(newCapacity * elementSize);
+    if (newElements)
+    {
+        if (capacity)
+        {
+            memcpy(newElements, elements, capacity * elementSize);
+        }
+        memset(newElements + capacity * elementSize, 0, (newCapacity - capacity) * elementSize);
+    }
+
+    return newElements;
+}
+
+// arena_free - free all chunks of the current thread's arena (call
+// before a thread exits, since nothing else frees them)
+
+void
+arena_free(void)
+{
+    while (arena)
+    {
+        ArenaChunk *prev = arena->prev;
+        free(arena);
+        arena = prev;
+    }
+}
+
+// Methods of a visitor which frees dynamic hexBinary storage and
+// ignores all other infoset nodes
+
+static const Error *
+visit_nothing(const VisitEventHandler *handler)
+{
+    UNUSED(handler);
+    return NULL;
+}
+
+static const Error *
+visit_no_node(const VisitEventHandler *handler, const InfosetBase *base)
+{
+    UNUSED(handler);
+    UNUSED(base);
+    return NULL;
+}
+
+static const Error *
+free_hexBinary_elem(const VisitEventHandler *handler, const ERD *erd, const void *valueptr)
+{
+    UNUSED(handler);
+    if (erd->typeCode == PRIMITIVE_HEXBINARY)
+    {
+        HexBinary *hexBinary = (HexBinary *)valueptr;
+        if (hexBinary->dynamic)
+        {
+            free(hexBinary->array);
+            hexBinary->array = NULL;
+            hexBinary->lengthInBytes = 0;
+        }
+    }
+    return NULL;
+}
+
+// free_infoset - free any dynamic hexBinary storage held by an
+// infoset's elements (call before a thread exits and before
+// arena_free, since reusing an infoset keeps the storage of the last
+// record it held)
+
+static const VisitEventHandler freeMethods = {
+    visit_nothing, visit_nothing, visit_no_node, visit_no_node, free_hexBinary_elem,
+};
+
+void
+free_infoset(InfosetBase *infoset)
+{
+    walk_infoset(&freeMethods, infoset);
+}
+
+// switch_choice - make a choice element hold another branch (its
+// position in the choice's children) before parsing or unparsing it.
+// Branches share their storage in a union, so switching frees the old
+// branch's dynamic hexBinary storage and zeroes the union to keep the
+// new branch from taking the old branch's pointers and capacities as
+// its own (any arena storage of the old branch stays in the arena).
+// Staying on the same branch keeps its storage for reuse.
+
+void
+switch_choice(InfosetBase *infoNode, size_t *choice, size_t branch, size_t size)
+{
+    if (*choice == branch)
+    {
+        return;
+    }
+    if (*choice)
+    {
+        const ERD *erd = infoNode->erd;
+        const void *child = (const char *)infoNode + erd->childrenOffsets[*choice];
+        walk_infoset_node(&freeMethods, infoNode, erd->childrenERDs[*choice], child);
+    }
+    char *storage = (char *)(choice + 1);
+    memset(storage, 0, size - (size_t)(storage - (char *)infoNode));
+    *choice = branch;
+}
+
+// string_reserve - make room for at least capacity bytes (plus a NUL)
+// in a string's character array, keeping its text, and return false if
+// no memory could be allocated
+
+bool
+string_reserve(String *string, size_t capacity)
+{
+    if (string->chars && capacity <= string->capacity)
+    {
+        return true;
+    }
+
+    // Grow geometrically so appending to a string takes amortized
+    // constant time and its old arrays waste little of the arena
+    size_t newCapacity = string->capacity ? string->capacity : 32;
+    while (newCapacity < capacity)
+    {
+        if (newCapacity > SIZE_MAX / 4)
+        {
+            return false;
+        }
+        newCapacity *= 2;
+    }
+
+    char *chars = arena_alloc(newCapacity + 1);
+    if (!chars)
+    {
+        return false;
+    }
+    if (string->chars)
+    {
+        memcpy(chars, string->chars, string->length + 1);
+    }
+    else
+    {
+        chars[0] = '\0';
+    }
+    string->chars = chars;
+    string->capacity = newCapacity;
+    return true;
+}
+
 // parse_data - parse an input stream into an infoset, check for
 // leftover data, and return any errors in pstate
 
 void
 parse_data(InfosetBase *infoset, PState *pstate)
 {
-    infoset->erd->parseSelf(infoset, pstate);
+    parse_record(infoset, pstate);
     no_leftover_data(pstate);
 }
 
+// parse_record - parse one record from an input stream into an
+// infoset, leave any following data unread, and return any errors in
+// pstate (and whether the record didn't pass the generated filter or
+// needed more data than the stream had)
+
+void
+parse_record(InfosetBase *infoset, PState *pstate)
+{
+    pstate->filteredOut = false;
+    pstate->numMissingBytes = 0;
+    pstate->scannedPastEnd = false;
+    infoset->erd->parseSelf(infoset, pstate);
+}
+
 // unparse_infoset - unparse an infoset to an output stream, flush the
 // fragment byte if not done yet, and return any errors in ustate
 
@@ -204,6 +442,7 @@ walk_infoset_node(const VisitEventHandler *handler, const InfosetBase *infoNode,
     case PRIMITIVE_INT32:
     case PRIMITIVE_INT64:
     case PRIMITIVE_INT8:
+    case PRIMITIVE_STRING:
     case PRIMITIVE_UINT16:
     case PRIMITIVE_UINT32:
     case PRIMITIVE_UINT64:
@@ -229,6 +468,15 @@ walk_array(const VisitEventHandler *handler, const InfosetBase *infoNode, const
     const ERD *childERD = arrayERD->childrenERDs[0];
     const size_t childOffset = arrayERD->childrenOffsets[0];
 
+    // Follow an out-of-line array's pointer to its elements after making
+    // sure its storage can hold them all (only an XML reader filling an
+    // infoset will need its storage to grow)
+    if (arrayERD->reserveArray)
+    {
+        error = arrayERD->reserveArray((InfosetBase *)infoNode, arraySize);
+        child = *(const void *const *)child;
+    }
+
     // Walk each element of the array
     for (size_t i = 0; i < arraySize && !error; i++)
     {
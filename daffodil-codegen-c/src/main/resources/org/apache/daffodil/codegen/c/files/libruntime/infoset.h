@@ -39,6 +39,7 @@ typedef void (*ERDParseSelf)(struct InfosetBase *infoNode, struct PState *pstate
 typedef void (*ERDUnparseSelf)(const struct InfosetBase *infoNode, struct UState *ustate);
 typedef const Error *(*InitChoiceRD)(const struct InfosetBase *infoNode);
 typedef size_t (*GetArraySize)(const struct InfosetBase *infoNode);
+typedef const Error *(*ReserveArray)(struct InfosetBase *infoNode, size_t count);
 
 typedef const Error *(*VisitStartDocument)(const struct VisitEventHandler *handler);
 typedef const Error *(*VisitEndDocument)(const struct VisitEventHandler *handler);
@@ -73,6 +74,7 @@ enum TypeCode
     PRIMITIVE_INT32,
     PRIMITIVE_INT64,
     PRIMITIVE_INT8,
+    PRIMITIVE_STRING,
     PRIMITIVE_UINT16,
     PRIMITIVE_UINT32,
     PRIMITIVE_UINT64,
@@ -95,7 +97,11 @@ typedef struct ERD
     union
     {
         const InitChoiceRD initChoice;
-        const GetArraySize getArraySize;
+        struct
+        {
+            const GetArraySize getArraySize;
+            const ReserveArray reserveArray; // NULL if array's elements are inline
+        };
     };
 } ERD;
 
@@ -108,6 +114,31 @@ typedef struct HexBinary
     bool dynamic;         // true if byte array was malloc'ed
 } HexBinary;
 
+// String - data of a delimited text element (its character array is
+// allocated from the thread's arena, NUL-terminated, and reused by
+// later parses)
+
+typedef struct String
+{
+    char *chars;     // pointer to text in character array (NULL until first use)
+    size_t length;   // length of text in bytes
+    size_t capacity; // capacity of character array in bytes (not counting NUL)
+} String;
+
+// Delimiters - alternative delimiters which a delimiter must match or
+// which end a delimited text element, plus that element's escape
+// characters
+
+typedef struct Delimiters
+{
+    const char *name;           // delimiters as written in schema (for errors)
+    const char *const *strings; // alternatives to match, longest first
+    size_t numStrings;          // number of alternatives
+    const char *candidates;     // first bytes of alternatives and escape characters
+    int escapeChar;             // escape character, or -1 if none
+    int escapeEscapeChar;       // escape escape character, or -1 if none
+} Delimiters;
+
 // InfosetBase - metadata of an infoset element
 
 typedef struct InfosetBase
@@ -122,7 +153,7 @@ typedef struct ParserOrUnparserState
 {
     FILE *stream;             // stream to read from / write to
     size_t bitPos0b;          // 0-based position after last read/write (1-bit granularity)
-    Diagnostics *diagnostics; // any validation diagnostics
+    Diagnostics *diagnostics; // own or else thread's validation diagnostics
     const Error *error;       // any error which stops parser/unparser
 } ParserOrUnparserState;
 
@@ -130,9 +161,15 @@ typedef struct ParserOrUnparserState
 
 typedef struct PState
 {
-    ParserOrUnparserState pu; // common mutable state
-    uint8_t unreadBits;       // any buffered bits not read yet
-    uint8_t numUnreadBits;    // number of buffered bits not read yet
+    ParserOrUnparserState pu;            // common mutable state
+    uint8_t unreadBits;                  // any buffered bits not read yet
+    uint8_t numUnreadBits;               // number of buffered bits not read yet
+    size_t numReadAhead;                 // number of bytes in read ahead buffer
+    size_t ixReadAhead;                  // index of next byte to read from read ahead buffer
+    uint8_t readAhead[LIMIT_READ_AHEAD]; // bytes read ahead of parsers by parse_read_ahead
+    bool filteredOut;                    // true if the record didn't pass the generated filter
+    size_t numMissingBytes;              // number of bytes a read needed beyond the end of stream
+    bool scannedPastEnd;                 // true if scanning text for a delimiter needed those bytes
 } PState;
 
 // UState - mutable state while unparsing infoset
@@ -142,6 +179,7 @@ typedef struct UState
     ParserOrUnparserState pu; // common mutable state
     uint8_t unwritBits;       // any buffered bits not written yet
     uint8_t numUnwritBits;    // number of buffered bits not written yet
+    bool unwritLsbf;          // whether buffered bits were written leastSignificantBitFirst
 } UState;
 
 // VisitEventHandler - methods to be called when walking an infoset
@@ -162,6 +200,37 @@ extern const char *get_erd_name(const ERD *erd);
 extern const char *get_erd_xmlns(const ERD *erd);
 extern const char *get_erd_ns(const ERD *erd);
 
+// arena_grow - allocate new storage for an out-of-line array's
+// elements from the current thread's arena, copy its old elements
+// into the new storage, zero the rest, and return the new storage (or
+// NULL if no memory could be allocated)
+
+extern void *arena_grow(const void *elements, size_t capacity, size_t newCapacity, size_t elementSize);
+
+// arena_free - free all chunks of the current thread's arena (call
+// before a thread exits, since nothing else frees them)
+
+extern void arena_free(void);
+
+// free_infoset - free any dynamic hexBinary storage held by an
+// infoset's elements (call before a thread exits and before
+// arena_free, since reusing an infoset keeps the storage of the last
+// record it held)
+
+extern void free_infoset(InfosetBase *infoset);
+
+// switch_choice - make a choice element hold another branch, freeing
+// the old branch's dynamic storage and zeroing the union of branches
+// (size is the size of the choice element's struct) if it changes
+
+extern void switch_choice(InfosetBase *infoNode, size_t *choice, size_t branch, size_t size);
+
+// string_reserve - make room for at least capacity bytes (plus a NUL)
+// in a string's character array, keeping its text, and return false if
+// no memory could be allocated
+
+extern bool string_reserve(String *string, size_t capacity);
+
 // get_infoset - get an infoset (optionally clearing it first) for
 // parsing/walking (note get_infoset actually is defined in
 // generated_code.c, not infoset.c)
@@ -173,6 +242,19 @@ extern InfosetBase *get_infoset(bool clear_infoset);
 
 extern void parse_data(InfosetBase *infoset, PState *pstate);
 
+// parse_record - parse one record from an input stream into an
+// infoset, leave any following data unread, and return any errors in
+// pstate
+
+extern void parse_record(InfosetBase *infoset, PState *pstate);
+
+// frame_record - parse only the fields needed to find where a record
+// ends, skip over the rest of its data, and return any errors in pstate
+// (note frame_record actually is defined in generated_code.c, not
+// infoset.c)
+
+extern void frame_record(InfosetBase *infoset, PState *pstate);
+
 // unparse_infoset - unparse an infoset to an output stream, flush the
 // fragment byte if not done yet, and return any errors in ustate
 
@@ -15,6 +15,9 @@
  * limitations under the License.
  */
 
+#ifndef P_ENDIAN_H
+#define P_ENDIAN_H
+
 // for be64toh, le64toh, be32toh, le32toh
 // for htobe64, htole64, htobe32, htole32
 #if defined(__APPLE__)
@@ -35,3 +38,5 @@
 #else
 #include <endian.h>
 #endif
+
+#endif // P_ENDIAN_H
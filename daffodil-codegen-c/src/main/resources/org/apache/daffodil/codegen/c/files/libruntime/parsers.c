@@ -19,22 +19,57 @@
 // clang-format off
 #include "parsers.h"
 #include <assert.h>   // for assert
+#include <limits.h>   // for LONG_MAX
 #include <stdbool.h>  // for bool, false, true
-#include <stdio.h>    // for fread, fgetc, EOF
+#include <stdio.h>    // for fread, fseek, fgetc, ftell, ungetc, EOF, FILE, SEEK_CUR, SEEK_END
 #include <stdlib.h>   // for free, malloc
-#include "errors.h"   // for Error, eof_or_error, ERR_LEFTOVER_DATA, Error::(anonymous), ERR_HEXBINARY_ALLOC, ERR_PARSE_BOOL
-#include "p_endian.h" // for be64toh, le64toh, be32toh, le32toh
+#include <string.h>   // for memcpy, memmove, memchr, memcmp, strlen
+#include "errors.h"   // for Error, eof_or_error, ERR_LEFTOVER_DATA, Error::(anonymous), ERR_HEXBINARY_ALLOC, ERR_PARSE_BOOL, ERR_PARSE_DELIMITER, ERR_STRING_ALLOC, LIMIT_READ_AHEAD
+#include "p_endian.h" // for be64toh, le64toh
 // clang-format on
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h> // for _mm_cmpeq_epi8, _mm_movemask_epi8, _mm256_cmpeq_epi8, _mm256_movemask_epi8
+#endif
 
 // Helper macros to get "n" highest bits from a byte's high end
 
 #define BYTE_WIDTH 8
-#define BIG_ENDIAN_DATA 1
-#define LITTLE_ENDIAN_DATA 0
 #define LOW_MASK(n) ((1 << n) - 1)
 #define HIGH_MASK(n) (LOW_MASK(n) << (BYTE_WIDTH - n))
 #define HIGH_BITS(byte, n) ((byte & HIGH_MASK(n)) >> (BYTE_WIDTH - n))
 
+// Helper method to read whole bytes, taking bytes from the read ahead
+// buffer first and reading any remaining bytes from stream; returns
+// number of bytes read
+
+static size_t
+read_bytes(uint8_t *bytes, size_t num_bytes, PState *pstate)
+{
+    size_t count = pstate->numReadAhead - pstate->ixReadAhead;
+    if (count > num_bytes) count = num_bytes;
+    if (count)
+    {
+        memcpy(bytes, pstate->readAhead + pstate->ixReadAhead, count);
+        pstate->ixReadAhead += count;
+    }
+    if (count < num_bytes)
+    {
+        count += fread(bytes + count, 1, num_bytes - count, pstate->pu.stream);
+    }
+    return count;
+}
+
+// Helper method to report the end of stream (or a stream error) after
+// a read got fewer bytes than it needed, remembering how many more bytes
+// it needed so a push parser knows when its next parse can get further
+
+static void
+missing_bytes(size_t num_missing, PState *pstate)
+{
+    pstate->pu.error = eof_or_error(pstate->pu.stream);
+    pstate->numMissingBytes = num_missing;
+}
+
 // Helper method to read bits using whole bytes while storing
 // remaining bits not yet read within a fragment byte; returns last
 // bits of last byte already shifted to left end
@@ -52,10 +87,10 @@ read_bits(uint8_t *bytes, size_t num_bits, PState *pstate)
         size_t num_bytes = num_bits / BYTE_WIDTH;
         if (num_bytes)
         {
-            size_t count = fread(bytes, 1, num_bytes, pstate->pu.stream);
+            size_t count = read_bytes(bytes, num_bytes, pstate);
             if (count < num_bytes)
             {
-                pstate->pu.error = eof_or_error(pstate->pu.stream);
+                missing_bytes((num_bits + BYTE_WIDTH - 1) / BYTE_WIDTH - count, pstate);
                 return;
             }
             num_bits -= count * BYTE_WIDTH;
@@ -67,11 +102,12 @@ read_bits(uint8_t *bytes, size_t num_bits, PState *pstate)
     while (num_bits > pstate->numUnreadBits)
     {
         // Copy one whole byte from stream to temporary storage
-        size_t whole_byte = 0;
-        size_t count = fread(&whole_byte, 1, 1, pstate->pu.stream);
+        uint8_t byte = 0;
+        size_t count = read_bytes(&byte, 1, pstate);
+        size_t whole_byte = byte;
         if (count < 1)
         {
-            pstate->pu.error = eof_or_error(pstate->pu.stream);
+            missing_bytes((num_bits - pstate->numUnreadBits + BYTE_WIDTH - 1) / BYTE_WIDTH, pstate);
             return;
         }
 
@@ -118,100 +154,50 @@ read_bits(uint8_t *bytes, size_t num_bits, PState *pstate)
     }
 }
 
-// Helper method to read doubles depending on data endianness;
-// num_bits must be exactly 64 bits
+// Read ahead enough bytes to parse the next num_bits bits with a
+// single bounds check; numbers parsed from these bytes can't fail
 
-static void
-parse_endian_double(bool big_endian_data, double *number, size_t num_bits, PState *pstate)
+void
+parse_read_ahead(size_t num_bits, PState *pstate)
 {
-    // Parse all doubles in ths helper function
-    union
-    {
-        uint8_t bytes[sizeof(double)];
-        double number;
-        uint64_t integer;
-    } buffer;
-
-    // Read data bits
-    buffer.integer = 0;
-    read_bits(buffer.bytes, num_bits, pstate);
-    if (pstate->pu.error) return;
-
-    // Convert data endianness to host endianness
-    if (big_endian_data)
+    // Count whole bytes needed beyond any unread bits in fragment byte
+    size_t num_bytes = 0;
+    if (num_bits > pstate->numUnreadBits)
     {
-        buffer.integer = be64toh(buffer.integer);
+        num_bytes = (num_bits - pstate->numUnreadBits + BYTE_WIDTH - 1) / BYTE_WIDTH;
     }
-    else
-    {
-        buffer.integer = le64toh(buffer.integer);
-    }
-
-    // Don't need to remove any padding bits since doubles must be
-    // exactly 64 bits, otherwise SDE would happen sooner
-    assert(num_bits == sizeof(double) * BYTE_WIDTH);
-
-    // Return successfully parsed number and update our last
-    // successful parse position
-    *number = buffer.number;
-    pstate->pu.bitPos0b += num_bits;
-}
-
-// Helper method to read floats depending on data endianness; note
-// num_bits must be exactly 32 bits
 
-static void
-parse_endian_float(bool big_endian_data, float *number, size_t num_bits, PState *pstate)
-{
-    // Parse all floats in this helper function
-    union
+    // Return early if enclosing element has read these bytes already
+    size_t available = pstate->numReadAhead - pstate->ixReadAhead;
+    if (num_bytes <= available) return;
+
+    // Move bytes not read yet to front of buffer, then read rest of
+    // bytes from stream with one call
+    assert(num_bytes <= LIMIT_READ_AHEAD);
+    memmove(pstate->readAhead, pstate->readAhead + pstate->ixReadAhead, available);
+    pstate->ixReadAhead = 0;
+    size_t count = fread(pstate->readAhead + available, 1, num_bytes - available, pstate->pu.stream);
+    pstate->numReadAhead = available + count;
+    if (count < num_bytes - available)
     {
-        uint8_t bytes[sizeof(float)];
-        float number;
-        uint32_t integer;
-    } buffer;
-
-    // Read data bits
-    buffer.integer = 0;
-    read_bits(buffer.bytes, num_bits, pstate);
-    if (pstate->pu.error) return;
-
-    // Convert data endianness to host endianness
-    if (big_endian_data)
-    {
-        buffer.integer = be32toh(buffer.integer);
-    }
-    else
-    {
-        buffer.integer = le32toh(buffer.integer);
+        missing_bytes(num_bytes - pstate->numReadAhead, pstate);
     }
-
-    // Don't need to remove any padding bits since floats must be
-    // exactly 32 bits, otherwise SDE would happen sooner
-    assert(num_bits == sizeof(float) * BYTE_WIDTH);
-
-    // Return successfully parsed number and update our last
-    // successful parse position
-    *number = buffer.number;
-    pstate->pu.bitPos0b += num_bits;
 }
 
-// Helper method to read signed integers using fragment byte shifts
-// depending on data endianness (note not tested on big-endian
-// architecture; might work only on low-endian architecture)
-
-// When shifting signed integers, it is important that the type be
-// signed, otherwise the shift will not preserve the sign bit; this is
-// why we need a separate helper method for signed integers
+// Parse an unsigned integer of 1 to 64 bits at any bit position,
+// reading from the stream if needed (slow path of inline parsers);
+// uses fragment byte shifts depending on data endianness (note not
+// tested on big-endian architecture; might work only on low-endian
+// architecture)
 
-static void
-parse_endian_int64(bool big_endian_data, int64_t *number, size_t num_bits, PState *pstate)
+void
+parse_endian_uint64(bool big_endian_data, uint64_t *number, size_t num_bits, PState *pstate)
 {
-    // Parse all signed integers in this helper function
+    // Parse all unsigned integers in this helper function
     union
     {
-        uint8_t bytes[sizeof(int64_t)];
-        int64_t integer;
+        uint8_t bytes[sizeof(uint64_t)];
+        uint64_t integer;
     } buffer;
 
     // Read data bits
@@ -226,8 +212,8 @@ parse_endian_int64(bool big_endian_data, int64_t *number, size_t num_bits, PStat
         buffer.integer = be64toh(buffer.integer);
 
         // Need only num_bits so remove any padding bits
-        size_t shift = sizeof(int64_t) * 8 - num_bits;
-        buffer.integer >>= shift; // type must be signed
+        size_t shift = sizeof(uint64_t) * BYTE_WIDTH - num_bits;
+        buffer.integer >>= shift;
     }
     else
     {
@@ -236,19 +222,8 @@ parse_endian_int64(bool big_endian_data, int64_t *number, size_t num_bits, PStat
 
         // Need only num_bits so remove any padding bits
         size_t msb_ix = (num_bits - 1) / BYTE_WIDTH;
-        int8_t msb_byte = (int8_t)buffer.bytes[msb_ix];
         size_t shift = (BYTE_WIDTH - num_bits % BYTE_WIDTH) % BYTE_WIDTH;
-        buffer.bytes[msb_ix] = msb_byte >> shift; // type must be signed
-
-        // Also, negative low-endian integers require setting
-        // following bytes to -1 to preserve the sign bit too
-        if (msb_byte < 0)
-        {
-            for (msb_ix++; msb_ix < sizeof(int64_t); msb_ix++)
-            {
-                buffer.bytes[msb_ix] = -1;
-            }
-        }
+        buffer.bytes[msb_ix] >>= shift;
     }
 
     // Return successfully parsed number and update our last
@@ -257,287 +232,436 @@ parse_endian_int64(bool big_endian_data, int64_t *number, size_t num_bits, PStat
     pstate->pu.bitPos0b += num_bits;
 }
 
-// Helper method to read unsigned integers using fragment byte shifts
-// depending on data endianness (note not tested on big-endian
-// architecture; might work only on low-endian architecture)
+// Parse an unsigned integer of 1 to 64 bits at any bit position in
+// leastSignificantBitFirst bit order (slow path of inline LSBF
+// parsers); reads all the whole bytes it needs from the stream at
+// once and then fills a 64-bit accumulator from its low end the same
+// way as the inline parsers
 
-static void
-parse_endian_uint64(bool big_endian_data, uint64_t *number, size_t num_bits, PState *pstate)
+void
+parse_lsbf_slow(uint64_t *number, size_t num_bits, PState *pstate)
 {
-    // Parse all unsigned integers in this helper function
+    // Take bits only from the fragment byte if it has enough of them
+    const size_t num_unread = pstate->numUnreadBits;
+    if (num_bits <= num_unread)
+    {
+        *number = pstate->unreadBits & LOW_MASK(num_bits);
+        pstate->unreadBits >>= num_bits;
+        pstate->numUnreadBits -= num_bits;
+        pstate->pu.bitPos0b += num_bits;
+        return;
+    }
+
+    // Read whole bytes needed beyond the fragment byte's unread bits
     union
     {
         uint8_t bytes[sizeof(uint64_t)];
         uint64_t integer;
     } buffer;
-
-    // Read data bits
     buffer.integer = 0;
-    read_bits(buffer.bytes, num_bits, pstate);
-    if (pstate->pu.error) return;
-
-    // Shift data bits differently on endianness
-    if (big_endian_data)
+    const size_t num_bytes = (num_bits - num_unread + BYTE_WIDTH - 1) / BYTE_WIDTH;
+    size_t count = read_bytes(buffer.bytes, num_bytes, pstate);
+    if (count < num_bytes)
     {
-        // Convert data endianness to host endianness
-        buffer.integer = be64toh(buffer.integer);
-
-        // Need only num_bits so remove any padding bits
-        size_t shift = sizeof(uint64_t) * BYTE_WIDTH - num_bits;
-        buffer.integer >>= shift;
+        missing_bytes(num_bytes - count, pstate);
+        return;
     }
-    else
-    {
-        // Convert data endianness to host endianness
-        buffer.integer = le64toh(buffer.integer);
 
-        // Need only num_bits so remove any padding bits
-        size_t msb_ix = (num_bits - 1) / BYTE_WIDTH;
-        size_t shift = (BYTE_WIDTH - num_bits % BYTE_WIDTH) % BYTE_WIDTH;
-        buffer.bytes[msb_ix] >>= shift;
+    // Put the bytes above the fragment byte's bits, remove any bits
+    // beyond num_bits, and keep them in the fragment byte instead
+    const size_t num_left = num_bytes * BYTE_WIDTH - (num_bits - num_unread);
+    uint64_t integer = pstate->unreadBits | (le64toh(buffer.integer) << num_unread);
+    if (num_bits < sizeof(integer) * BYTE_WIDTH)
+    {
+        integer &= ((uint64_t)1 << num_bits) - 1;
     }
+    pstate->unreadBits = (uint8_t)(buffer.bytes[num_bytes - 1] >> (BYTE_WIDTH - num_left));
+    pstate->numUnreadBits = (uint8_t)num_left;
 
     // Return successfully parsed number and update our last
     // successful parse position
-    *number = buffer.integer;
+    *number = integer;
     pstate->pu.bitPos0b += num_bits;
 }
 
-// Helper method to read booleans depending on data endianness;
-// num_bits should be 1 to 32 bits
+// Report a boolean matching neither its true nor its false
+// representation and restore the last successful parse position
 
-static void
-parse_endian_bool(bool big_endian_data, bool *number, size_t num_bits, int64_t true_rep, uint32_t false_rep,
-                  PState *pstate)
+void
+parse_invalid_bool(uint64_t integer, size_t num_bits, PState *pstate)
 {
-    // Parse all booleans in this helper function
-    const size_t last_successful_parse = pstate->pu.bitPos0b;
-    uint64_t integer;
+    static Error error = {ERR_PARSE_BOOL, {0}};
+    error.arg.d64 = (int64_t)integer;
+    pstate->pu.error = &error;
+    pstate->pu.bitPos0b -= num_bits;
+}
 
-    // Booleans are limited to 32 bits in the DFDL spec, but we read
-    // all unsigned integers with parse_endian_uint64 using num_bits
-    assert(num_bits && num_bits <= sizeof(uint32_t) * BYTE_WIDTH);
+// Allocate memory for hexBinary array
 
-    // parse_endian_uint64 will change position of last successful parse
-    parse_endian_uint64(big_endian_data, &integer, num_bits, pstate);
-    if (pstate->pu.error) return;
+void
+alloc_hexBinary(HexBinary *hexBinary, size_t num_bytes, PState *pstate)
+{
+    // Free old byte array
+    assert(hexBinary->dynamic);
+    free(hexBinary->array);
 
-    // Recognize true or false representation and assign boolean value
-    // negative true_rep means it is absent and only false_rep needs
-    // to be checked, otherwise true_rep must fit within uint32_t
-    assert(true_rep <= UINT32_MAX);
-    if (true_rep < 0)
-    {
-        *number = (integer != false_rep);
-    }
-    else if (integer == (uint32_t)true_rep)
-    {
-        *number = true;
-    }
-    else if (integer == false_rep)
-    {
-        *number = false;
-    }
-    else
+    // Allocate new byte array
+    hexBinary->array = malloc(num_bytes);
+    hexBinary->lengthInBytes = num_bytes;
+
+    // Return error if necessary
+    if (num_bytes && hexBinary->array == NULL)
     {
-        static Error error = {ERR_PARSE_BOOL, {0}};
-        error.arg.d64 = (int64_t)integer;
+        static Error error = {ERR_HEXBINARY_ALLOC, {0}};
+        error.arg.d64 = (int64_t)num_bytes;
         pstate->pu.error = &error;
-
-        // Restore original position of last successful parse
-        pstate->pu.bitPos0b = last_successful_parse;
     }
 }
 
-// Parse all binary booleans, real numbers, and integers in helper
-// functions, but wrap calls for type safety and simpler calls
+// Parse opaque bytes into hexBinary array
 
 void
-parse_be_bool(bool *number, size_t num_bits, int64_t true_rep, uint32_t false_rep, PState *pstate)
+parse_hexBinary(HexBinary *hexBinary, PState *pstate)
 {
-    parse_endian_bool(BIG_ENDIAN_DATA, number, num_bits, true_rep, false_rep, pstate);
+    read_bits(hexBinary->array, hexBinary->lengthInBytes * BYTE_WIDTH, pstate);
+    if (pstate->pu.error) return;
+    pstate->pu.bitPos0b += hexBinary->lengthInBytes * BYTE_WIDTH;
 }
 
-void
-parse_be_double(double *number, size_t num_bits, PState *pstate)
-{
-    parse_endian_double(BIG_ENDIAN_DATA, number, num_bits, pstate);
-}
+// Parse opaque bytes into hexBinary array in leastSignificantBitFirst
+// bit order (only bytes not starting on a byte boundary differ)
 
 void
-parse_be_float(float *number, size_t num_bits, PState *pstate)
+parse_lsbf_hexBinary(HexBinary *hexBinary, PState *pstate)
 {
-    parse_endian_float(BIG_ENDIAN_DATA, number, num_bits, pstate);
-}
+    if (!pstate->numUnreadBits)
+    {
+        parse_hexBinary(hexBinary, pstate);
+        return;
+    }
 
-void
-parse_be_int16(int16_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int16_t)integer;
+    for (size_t i = 0; i < hexBinary->lengthInBytes; i++)
+    {
+        uint64_t byte = 0;
+        parse_lsbf_slow(&byte, BYTE_WIDTH, pstate);
+        if (pstate->pu.error) return;
+        hexBinary->array[i] = (uint8_t)byte;
+    }
 }
 
-void
-parse_be_int32(int32_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int32_t)integer;
-}
+// Helper method to make at least num_bytes bytes available in the
+// read ahead buffer if data remains, filling the rest of the buffer
+// with one read so scanning text needs few reads; returns number of
+// bytes available (fewer than num_bytes only at end of data)
 
-void
-parse_be_int64(int64_t *number, size_t num_bits, PState *pstate)
+static size_t
+peek_read_ahead(size_t num_bytes, PState *pstate)
 {
-    parse_endian_int64(BIG_ENDIAN_DATA, number, num_bits, pstate);
-}
+    size_t available = pstate->numReadAhead - pstate->ixReadAhead;
+    if (num_bytes <= available) return available;
 
-void
-parse_be_int8(int8_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int8_t)integer;
+    // Move bytes not read yet to front of buffer, then fill it up
+    assert(num_bytes <= LIMIT_READ_AHEAD);
+    memmove(pstate->readAhead, pstate->readAhead + pstate->ixReadAhead, available);
+    pstate->ixReadAhead = 0;
+    size_t count = fread(pstate->readAhead + available, 1, LIMIT_READ_AHEAD - available, pstate->pu.stream);
+    pstate->numReadAhead = available + count;
+    if (count < LIMIT_READ_AHEAD - available && ferror(pstate->pu.stream))
+    {
+        pstate->pu.error = eof_or_error(pstate->pu.stream);
+    }
+    else if (pstate->numReadAhead < num_bytes)
+    {
+        // Remember that the data ended before the bytes we peeked at,
+        // which is only a lower bound on what scanning for a delimiter
+        // needs
+        pstate->numMissingBytes = num_bytes - pstate->numReadAhead;
+        pstate->scannedPastEnd = true;
+    }
+    return pstate->numReadAhead;
 }
 
-void
-parse_be_uint16(uint16_t *number, size_t num_bits, PState *pstate)
-{
-    uint64_t integer;
-    parse_endian_uint64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint16_t)integer;
-}
+// Helper method to append bytes to a delimited text element's string;
+// returns false after reporting an error if no memory could be allocated
 
-void
-parse_be_uint32(uint32_t *number, size_t num_bits, PState *pstate)
+static bool
+append_string(String *string, const uint8_t *bytes, size_t num_bytes, PState *pstate)
 {
-    uint64_t integer;
-    parse_endian_uint64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint32_t)integer;
+    if (!num_bytes) return true;
+    if (!string_reserve(string, string->length + num_bytes))
+    {
+        static Error error = {ERR_STRING_ALLOC, {0}};
+        error.arg.d64 = (int64_t)(string->length + num_bytes);
+        pstate->pu.error = &error;
+        return false;
+    }
+    memcpy(string->chars + string->length, bytes, num_bytes);
+    string->length += num_bytes;
+    string->chars[string->length] = '\0';
+    return true;
 }
 
-void
-parse_be_uint64(uint64_t *number, size_t num_bits, PState *pstate)
-{
-    parse_endian_uint64(BIG_ENDIAN_DATA, number, num_bits, pstate);
-}
+// Helper method to match one of the delimiters' alternatives at the
+// next byte to read; returns its length or -1 if none match
 
-void
-parse_be_uint8(uint8_t *number, size_t num_bits, PState *pstate)
+static ptrdiff_t
+match_delimiter(const Delimiters *delimiters, PState *pstate)
 {
-    uint64_t integer;
-    parse_endian_uint64(BIG_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint8_t)integer;
+    for (size_t i = 0; i < delimiters->numStrings; i++)
+    {
+        const char *delimiter = delimiters->strings[i];
+        size_t length = strlen(delimiter);
+        size_t available = peek_read_ahead(length, pstate);
+        if (pstate->pu.error) return -1;
+        if (available >= length && memcmp(pstate->readAhead + pstate->ixReadAhead, delimiter, length) == 0)
+        {
+            return (ptrdiff_t)length;
+        }
+    }
+    return -1;
 }
 
-void
-parse_le_bool(bool *number, size_t num_bits, int64_t true_rep, uint32_t false_rep, PState *pstate)
-{
-    parse_endian_bool(LITTLE_ENDIAN_DATA, number, num_bits, true_rep, false_rep, pstate);
-}
+// Find the first byte which may begin a delimiter or an escape
+// sequence, comparing 32 (AVX2) or 16 (SSE2) bytes at once with each
+// candidate when the compiler targets those instruction sets
 
-void
-parse_le_double(double *number, size_t num_bits, PState *pstate)
+size_t
+scan_delimiters(const uint8_t *bytes, size_t num_bytes, const char *candidates)
 {
-    parse_endian_double(LITTLE_ENDIAN_DATA, number, num_bits, pstate);
-}
+    const size_t num_candidates = strlen(candidates);
+    size_t i = 0;
 
-void
-parse_le_float(float *number, size_t num_bits, PState *pstate)
-{
-    parse_endian_float(LITTLE_ENDIAN_DATA, number, num_bits, pstate);
-}
+#if defined(__AVX2__)
+    for (; i + sizeof(__m256i) <= num_bytes; i += sizeof(__m256i))
+    {
+        const __m256i block = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        __m256i found = _mm256_setzero_si256();
+        for (size_t j = 0; j < num_candidates; j++)
+        {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(candidates[j])));
+        }
+        const uint32_t mask = (uint32_t)_mm256_movemask_epi8(found);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + sizeof(__m128i) <= num_bytes; i += sizeof(__m128i))
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i found = _mm_setzero_si128();
+        for (size_t j = 0; j < num_candidates; j++)
+        {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(candidates[j])));
+        }
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(found);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+#endif
 
-void
-parse_le_int16(int16_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int16_t)integer;
+    // Check any bytes left over (or all bytes without SIMD) one at a time
+    for (; i < num_bytes; i++)
+    {
+        if (memchr(candidates, bytes[i], num_candidates)) return i;
+    }
+    return num_bytes;
 }
 
-void
-parse_le_int32(int32_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int32_t)integer;
-}
+// Parse a delimited text element into a string, stopping before the
+// first delimiter which isn't escaped or at end of data
 
 void
-parse_le_int64(int64_t *number, size_t num_bits, PState *pstate)
+parse_delimited_string(String *string, const Delimiters *delimiters, PState *pstate)
 {
-    parse_endian_int64(LITTLE_ENDIAN_DATA, number, num_bits, pstate);
-}
+    // Text starts on a byte boundary since its alignment was parsed first
+    assert(!pstate->numUnreadBits);
 
-void
-parse_le_int8(int8_t *number, size_t num_bits, PState *pstate)
-{
-    int64_t integer;
-    parse_endian_int64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (int8_t)integer;
-}
+    const int ec = delimiters->escapeChar;
+    const int eec = delimiters->escapeEscapeChar;
+    size_t num_bytes = 0;
+    string->length = 0;
+    if (string->chars) string->chars[0] = '\0';
 
-void
-parse_le_uint16(uint16_t *number, size_t num_bits, PState *pstate)
-{
-    uint64_t integer;
-    parse_endian_uint64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint16_t)integer;
-}
+    while (peek_read_ahead(1, pstate))
+    {
+        if (pstate->pu.error) return;
 
-void
-parse_le_uint32(uint32_t *number, size_t num_bits, PState *pstate)
-{
-    uint64_t integer;
-    parse_endian_uint64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint32_t)integer;
-}
+        // Copy all bytes before the next candidate at once
+        const uint8_t *bytes = pstate->readAhead + pstate->ixReadAhead;
+        size_t available = pstate->numReadAhead - pstate->ixReadAhead;
+        size_t count = scan_delimiters(bytes, available, delimiters->candidates);
+        if (!append_string(string, bytes, count, pstate)) return;
+        pstate->ixReadAhead += count;
+        num_bytes += count;
+        if (count == available) continue;
+
+        // Unescape an escape escape character followed by an escape
+        // character or an escape character followed by any character
+        const int c = bytes[count];
+        if (c == eec || c == ec)
+        {
+            available = peek_read_ahead(2, pstate);
+            if (pstate->pu.error) return;
+            bytes = pstate->readAhead + pstate->ixReadAhead;
+            if (c == eec && available >= 2 && bytes[1] == ec)
+            {
+                if (!append_string(string, bytes + 1, 1, pstate)) return;
+                pstate->ixReadAhead += 2;
+                num_bytes += 2;
+                continue;
+            }
+            if (c == ec)
+            {
+                count = available >= 2 ? 2 : 1;
+                if (!append_string(string, bytes + 1, count - 1, pstate)) return;
+                pstate->ixReadAhead += count;
+                num_bytes += count;
+                continue;
+            }
+        }
 
-void
-parse_le_uint64(uint64_t *number, size_t num_bits, PState *pstate)
-{
-    parse_endian_uint64(LITTLE_ENDIAN_DATA, number, num_bits, pstate);
+        // Stop before a delimiter, otherwise keep the candidate as text
+        if (match_delimiter(delimiters, pstate) >= 0) break;
+        if (pstate->pu.error) return;
+        if (!append_string(string, pstate->readAhead + pstate->ixReadAhead, 1, pstate)) return;
+        pstate->ixReadAhead += 1;
+        num_bytes += 1;
+    }
+    if (pstate->pu.error) return;
+
+    pstate->pu.bitPos0b += num_bytes * BYTE_WIDTH;
 }
 
+// Parse an initiator, separator, or terminator matching one of its
+// alternatives (the longest one first)
+
 void
-parse_le_uint8(uint8_t *number, size_t num_bits, PState *pstate)
+parse_delimiter(const Delimiters *delimiters, PState *pstate)
 {
-    uint64_t integer;
-    parse_endian_uint64(LITTLE_ENDIAN_DATA, &integer, num_bits, pstate);
-    *number = (uint8_t)integer;
+    // Delimiters start on a byte boundary since their alignment was parsed first
+    assert(!pstate->numUnreadBits);
+
+    ptrdiff_t length = match_delimiter(delimiters, pstate);
+    if (pstate->pu.error) return;
+    if (length < 0)
+    {
+        static Error error = {ERR_PARSE_DELIMITER, {0}};
+        error.arg.s = delimiters->name;
+        pstate->pu.error = &error;
+        return;
+    }
+    pstate->ixReadAhead += (size_t)length;
+    pstate->pu.bitPos0b += (size_t)length * BYTE_WIDTH;
+}
+
+// Skip whole bytes without copying them, first by bumping the read
+// ahead buffer's index and then by seeking the stream past any bytes
+// beyond the read ahead buffer (or reading and discarding them if the
+// stream can't seek); returns number of bytes not skipped if the
+// stream ends or fails first or else 0
+
+static size_t
+skip_bytes(size_t num_bytes, PState *pstate)
+{
+    size_t count = pstate->numReadAhead - pstate->ixReadAhead;
+    if (count > num_bytes) count = num_bytes;
+    pstate->ixReadAhead += count;
+    num_bytes -= count;
+    if (!num_bytes) return 0;
+
+    // Seeking past the end of a file doesn't fail, so read the last
+    // skipped byte back to find out whether the stream has that many
+    FILE *stream = pstate->pu.stream;
+    const bool seekable = num_bytes > LIMIT_READ_AHEAD && num_bytes - 1 <= (size_t)LONG_MAX;
+    const long start = seekable ? ftell(stream) : -1;
+    if (start >= 0 && fseek(stream, (long)(num_bytes - 1), SEEK_CUR) == 0)
+    {
+        uint8_t byte;
+        if (fread(&byte, 1, 1, stream) == 1) return 0;
+
+        // Otherwise measure the stream to find out exactly how many
+        // bytes it lacks, then hit its end again to set its EOF
+        // indicator (the seek clears it)
+        size_t num_missing = num_bytes;
+        if (!ferror(stream) && fseek(stream, 0, SEEK_END) == 0)
+        {
+            const long end = ftell(stream);
+            if (end >= start && (size_t)(end - start) < num_bytes) num_missing -= (size_t)(end - start);
+            fgetc(stream);
+        }
+        return num_missing;
+    }
+
+    // Otherwise read and discard bytes using the (now empty) read ahead
+    // buffer as scratch space
+    pstate->numReadAhead = pstate->ixReadAhead = 0;
+    while (num_bytes)
+    {
+        size_t chunk = (num_bytes < LIMIT_READ_AHEAD) ? num_bytes : LIMIT_READ_AHEAD;
+        count = fread(pstate->readAhead, 1, chunk, pstate->pu.stream);
+        num_bytes -= count;
+        if (count < chunk) return num_bytes;
+    }
+    return 0;
 }
 
-// Allocate memory for hexBinary array
+// Skip num_bits bits at any bit position without reading them into
+// a buffer (alignment fill and unused regions); keeps unread bits in
+// the fragment byte the same way as the parsers of each bit order
 
-void
-alloc_hexBinary(HexBinary *hexBinary, size_t num_bytes, PState *pstate)
+static void
+skip_bits(bool lsbf, size_t num_bits, PState *pstate)
 {
-    // Free old byte array
-    assert(hexBinary->dynamic);
-    free(hexBinary->array);
-
-    // Allocate new byte array
-    hexBinary->array = malloc(num_bytes);
-    hexBinary->lengthInBytes = num_bytes;
+    // Skip bits in the fragment byte first (next bit is lowest bit in
+    // leastSignificantBitFirst and highest unread bit otherwise)
+    size_t num_fragment_bits = (num_bits < pstate->numUnreadBits) ? num_bits : pstate->numUnreadBits;
+    if (lsbf)
+    {
+        pstate->unreadBits >>= num_fragment_bits;
+    }
+    pstate->numUnreadBits -= num_fragment_bits;
+    pstate->unreadBits &= LOW_MASK(pstate->numUnreadBits);
 
-    // Return error if necessary
-    if (num_bytes && hexBinary->array == NULL)
+    // Skip whole bytes, then keep the rest of the last byte's bits
+    size_t num_bits_left = num_bits - num_fragment_bits;
+    if (num_bits_left)
     {
-        static Error error = {ERR_HEXBINARY_ALLOC, {0}};
-        error.arg.d64 = (int64_t)num_bytes;
-        pstate->pu.error = &error;
+        size_t num_missing = skip_bytes(num_bits_left / BYTE_WIDTH, pstate);
+        if (num_missing)
+        {
+            missing_bytes(num_missing + (num_bits_left % BYTE_WIDTH ? 1 : 0), pstate);
+            return;
+        }
+        num_bits_left %= BYTE_WIDTH;
+        if (num_bits_left)
+        {
+            uint8_t byte = 0;
+            if (read_bytes(&byte, 1, pstate) < 1)
+            {
+                missing_bytes(1, pstate);
+                return;
+            }
+            pstate->numUnreadBits = (uint8_t)(BYTE_WIDTH - num_bits_left);
+            pstate->unreadBits =
+                (uint8_t)(lsbf ? byte >> num_bits_left : byte & LOW_MASK(pstate->numUnreadBits));
+        }
     }
+
+    // If we got all the way here, update our last successful parse position
+    pstate->pu.bitPos0b += num_bits;
 }
 
-// Parse opaque bytes into hexBinary array
+// Skip num_bits bits of fill or unused data
 
 void
-parse_hexBinary(HexBinary *hexBinary, PState *pstate)
+parse_skip_bits(size_t num_bits, PState *pstate)
 {
-    read_bits(hexBinary->array, hexBinary->lengthInBytes * BYTE_WIDTH, pstate);
-    if (pstate->pu.error) return;
-    pstate->pu.bitPos0b += hexBinary->lengthInBytes * BYTE_WIDTH;
+    skip_bits(false, num_bits, pstate);
+}
+
+void
+parse_lsbf_skip_bits(size_t num_bits, PState *pstate)
+{
+    skip_bits(true, num_bits, pstate);
 }
 
 // Parse alignment bits up to alignmentInBits or end_bitPos0b
@@ -553,19 +677,24 @@ void
 parse_alignment_bits(size_t end_bitPos0b, PState *pstate)
 {
     assert(pstate->pu.bitPos0b <= end_bitPos0b);
+    parse_skip_bits(end_bitPos0b - pstate->pu.bitPos0b, pstate);
+}
 
-    size_t fill_bits = end_bitPos0b - pstate->pu.bitPos0b;
-    uint8_t bytes[1];
-    while (fill_bits)
-    {
-        size_t num_bits = (fill_bits >= BYTE_WIDTH) ? BYTE_WIDTH : fill_bits;
-        read_bits(bytes, num_bits, pstate);
-        if (pstate->pu.error) return;
-        fill_bits -= num_bits;
-    }
+// Parse alignment bits up to alignmentInBits or end_bitPos0b in
+// leastSignificantBitFirst bit order
 
-    // If we got all the way here, update our last successful parse position
-    pstate->pu.bitPos0b = end_bitPos0b;
+void
+parse_lsbf_align_to(size_t alignmentInBits, PState *pstate)
+{
+    size_t end_bitPos0b = ((pstate->pu.bitPos0b + alignmentInBits - 1) / alignmentInBits) * alignmentInBits;
+    parse_lsbf_alignment_bits(end_bitPos0b, pstate);
+}
+
+void
+parse_lsbf_alignment_bits(size_t end_bitPos0b, PState *pstate)
+{
+    assert(pstate->pu.bitPos0b <= end_bitPos0b);
+    parse_lsbf_skip_bits(end_bitPos0b - pstate->pu.bitPos0b, pstate);
 }
 
 // Check for any data left over after end of parse
@@ -584,6 +713,13 @@ no_leftover_data(PState *pstate)
             error.arg.c = pstate->numUnreadBits;
             pstate->pu.error = &error;
         }
+        else if (pstate->numReadAhead > pstate->ixReadAhead)
+        {
+            // We have some bytes read ahead but not parsed, so report leftover data
+            static Error error = {ERR_LEFTOVER_DATA, {0}};
+            error.arg.c = BYTE_WIDTH;
+            pstate->pu.error = &error;
+        }
         else
         {
             // Check for any unread bytes left in input stream
@@ -598,3 +734,22 @@ no_leftover_data(PState *pstate)
         }
     }
 }
+
+// Check whether any data remains to be parsed without consuming it
+
+bool
+has_more_data(PState *pstate)
+{
+    if (pstate->numUnreadBits || pstate->numReadAhead > pstate->ixReadAhead)
+    {
+        return true;
+    }
+
+    int c = fgetc(pstate->pu.stream);
+    if (c == EOF)
+    {
+        return false;
+    }
+    ungetc(c, pstate->pu.stream);
+    return true;
+}
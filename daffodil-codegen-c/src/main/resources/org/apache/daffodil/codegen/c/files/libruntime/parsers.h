@@ -20,43 +20,204 @@
 
 // auto-maintained by iwyu
 // clang-format off
-#include <stdbool.h>  // for bool
-#include <stddef.h>   // for size_t
-#include <stdint.h>   // for int64_t, uint32_t, int16_t, int32_t, int8_t, uint16_t, uint64_t, uint8_t
-#include "infoset.h"  // for PState, HexBinary
+#include <limits.h>    // for CHAR_BIT
+#include <stdbool.h>   // for bool, false, true
+#include <stddef.h>    // for size_t
+#include <stdint.h>    // for uint64_t, int64_t, uint32_t, int16_t, int32_t, int8_t, uint16_t, uint8_t
+#include <string.h>    // for memcpy
+#include "infoset.h"   // for PState, HexBinary, String, Delimiters
+#include "p_endian.h"  // for be64toh, le64toh
 // clang-format on
 
-// Parse binary booleans, real numbers, and integers
+// Read ahead enough bytes to parse the next num_bits bits with a
+// single bounds check; numbers parsed from these bytes can't fail
 
-extern void parse_be_bool(bool *number, size_t num_bits, int64_t true_rep, uint32_t false_rep,
-                          PState *pstate);
-extern void parse_be_double(double *number, size_t num_bits, PState *pstate);
-extern void parse_be_float(float *number, size_t num_bits, PState *pstate);
+extern void parse_read_ahead(size_t num_bits, PState *pstate);
 
-extern void parse_be_int16(int16_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_int32(int32_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_int64(int64_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_int8(int8_t *number, size_t num_bits, PState *pstate);
+// Parse an unsigned integer of 1 to 64 bits at any bit position,
+// reading from the stream if needed (slow path of inline parsers)
 
-extern void parse_be_uint16(uint16_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_uint32(uint32_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_uint64(uint64_t *number, size_t num_bits, PState *pstate);
-extern void parse_be_uint8(uint8_t *number, size_t num_bits, PState *pstate);
+extern void parse_endian_uint64(bool big_endian_data, uint64_t *number, size_t num_bits, PState *pstate);
 
-extern void parse_le_bool(bool *number, size_t num_bits, int64_t true_rep, uint32_t false_rep,
-                          PState *pstate);
-extern void parse_le_double(double *number, size_t num_bits, PState *pstate);
-extern void parse_le_float(float *number, size_t num_bits, PState *pstate);
+// Report a boolean matching neither its true nor its false
+// representation and restore the last successful parse position
 
-extern void parse_le_int16(int16_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_int32(int32_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_int64(int64_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_int8(int8_t *number, size_t num_bits, PState *pstate);
+extern void parse_invalid_bool(uint64_t integer, size_t num_bits, PState *pstate);
 
-extern void parse_le_uint16(uint16_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_uint32(uint32_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_uint64(uint64_t *number, size_t num_bits, PState *pstate);
-extern void parse_le_uint8(uint8_t *number, size_t num_bits, PState *pstate);
+// Parse an unsigned integer of num_bits bits, taking whole bytes
+// straight from the read ahead buffer when the fragment byte is empty
+// and calling the slow path otherwise.  Generated code passes num_bits
+// as a constant, so each inlined call folds the checks, shifts, and
+// byte count down to one load and byte swap for its own width.
+
+static inline uint64_t
+parse_endian_bits(bool big_endian_data, size_t num_bits, PState *pstate)
+{
+    const size_t num_bytes = num_bits / CHAR_BIT;
+    uint64_t integer = 0;
+
+    if (num_bits && num_bits % CHAR_BIT == 0 && !pstate->numUnreadBits &&
+        pstate->numReadAhead - pstate->ixReadAhead >= num_bytes)
+    {
+        // Big-endian bytes land in the high end after the byte swap
+        memcpy(&integer, pstate->readAhead + pstate->ixReadAhead, num_bytes);
+        if (big_endian_data)
+        {
+            integer = be64toh(integer) >> (sizeof(integer) * CHAR_BIT - num_bits);
+        }
+        else
+        {
+            integer = le64toh(integer);
+        }
+        pstate->ixReadAhead += num_bytes;
+        pstate->pu.bitPos0b += num_bits;
+    }
+    else
+    {
+        parse_endian_uint64(big_endian_data, &integer, num_bits, pstate);
+    }
+
+    return integer;
+}
+
+// Parse an unsigned integer of 1 to 64 bits at any bit position in
+// leastSignificantBitFirst bit order (slow path of inline LSBF parsers)
+
+extern void parse_lsbf_slow(uint64_t *number, size_t num_bits, PState *pstate);
+
+// Parse big-endian and little-endian integers of num_bits bits in
+// mostSignificantBitFirst bit order
+
+static inline uint64_t
+parse_be_bits(size_t num_bits, PState *pstate)
+{
+    return parse_endian_bits(true, num_bits, pstate);
+}
+
+static inline uint64_t
+parse_le_bits(size_t num_bits, PState *pstate)
+{
+    return parse_endian_bits(false, num_bits, pstate);
+}
+
+// Parse an integer of num_bits bits in leastSignificantBitFirst bit
+// order, loading the next bytes from the read ahead buffer into a
+// 64-bit accumulator above the fragment byte's unread bits (which LSBF
+// parsers keep in its right end with the next bit to read lowest) and
+// keeping the last byte's leftover bits in the fragment byte.  Works
+// at any bit position without looping over bits or bytes.
+
+static inline uint64_t
+parse_lsbf_bits(size_t num_bits, PState *pstate)
+{
+    const size_t num_unread = pstate->numUnreadBits;
+    uint64_t integer = 0;
+
+    if (num_bits > num_unread)
+    {
+        const size_t num_bytes = (num_bits - num_unread + CHAR_BIT - 1) / CHAR_BIT;
+        if (pstate->numReadAhead - pstate->ixReadAhead >= num_bytes)
+        {
+            // Bits beyond the 64th fall off the accumulator's high end
+            // but they come from the last byte, which we keep anyway
+            const uint8_t *bytes = pstate->readAhead + pstate->ixReadAhead;
+            const size_t num_left = num_bytes * CHAR_BIT - (num_bits - num_unread);
+            memcpy(&integer, bytes, num_bytes);
+            integer = pstate->unreadBits | (le64toh(integer) << num_unread);
+            if (num_bits < sizeof(integer) * CHAR_BIT)
+            {
+                integer &= ((uint64_t)1 << num_bits) - 1;
+            }
+            pstate->unreadBits = (uint8_t)(bytes[num_bytes - 1] >> (CHAR_BIT - num_left));
+            pstate->numUnreadBits = (uint8_t)num_left;
+            pstate->ixReadAhead += num_bytes;
+            pstate->pu.bitPos0b += num_bits;
+            return integer;
+        }
+    }
+
+    parse_lsbf_slow(&integer, num_bits, pstate);
+    return integer;
+}
+
+// Extend the sign bit of a num_bits signed integer to 64 bits
+
+static inline int64_t
+parse_sign_extend(uint64_t integer, size_t num_bits)
+{
+    const size_t shift = sizeof(integer) * CHAR_BIT - num_bits;
+    return (int64_t)(integer << shift) >> shift; // type must be signed
+}
+
+// Define parsers for binary booleans, real numbers, and integers as
+// static inline functions, instantiated once per type and bit/byte order
+
+#define PARSE_SIGNED(ENDIAN, TYPE)                                                                           \
+    static inline void parse_##ENDIAN##_##TYPE(TYPE##_t *number, size_t num_bits, PState *pstate)            \
+    {                                                                                                        \
+        uint64_t integer = parse_##ENDIAN##_bits(num_bits, pstate);                                          \
+        *number = (TYPE##_t)parse_sign_extend(integer, num_bits);                                            \
+    }
+
+#define PARSE_UNSIGNED(ENDIAN, TYPE)                                                                         \
+    static inline void parse_##ENDIAN##_##TYPE(TYPE##_t *number, size_t num_bits, PState *pstate)            \
+    {                                                                                                        \
+        *number = (TYPE##_t)parse_##ENDIAN##_bits(num_bits, pstate);                                         \
+    }
+
+#define PARSE_REAL(ENDIAN, TYPE, BITS_TYPE)                                                                  \
+    static inline void parse_##ENDIAN##_##TYPE(TYPE *number, size_t num_bits, PState *pstate)                \
+    {                                                                                                        \
+        BITS_TYPE bits = (BITS_TYPE)parse_##ENDIAN##_bits(num_bits, pstate);                                 \
+        if (!pstate->pu.error) memcpy(number, &bits, sizeof(*number));                                       \
+    }
+
+#define PARSE_BOOL(ENDIAN)                                                                                   \
+    static inline void parse_##ENDIAN##_bool(bool *number, size_t num_bits, int64_t true_rep,                \
+                                             uint32_t false_rep, PState *pstate)                             \
+    {                                                                                                        \
+        /* Negative true_rep means it is absent and only false_rep */                                        \
+        /* needs to be checked, otherwise true_rep fits in uint32_t */                                       \
+        uint64_t integer = parse_##ENDIAN##_bits(num_bits, pstate);                                          \
+        if (pstate->pu.error) return;                                                                        \
+        if (true_rep < 0)                                                                                    \
+        {                                                                                                    \
+            *number = (integer != false_rep);                                                                \
+        }                                                                                                    \
+        else if (integer == (uint32_t)true_rep)                                                              \
+        {                                                                                                    \
+            *number = true;                                                                                  \
+        }                                                                                                    \
+        else if (integer == false_rep)                                                                       \
+        {                                                                                                    \
+            *number = false;                                                                                 \
+        }                                                                                                    \
+        else                                                                                                 \
+        {                                                                                                    \
+            parse_invalid_bool(integer, num_bits, pstate);                                                   \
+        }                                                                                                    \
+    }
+
+#define PARSE_ENDIAN(ENDIAN)                                                                                 \
+    PARSE_BOOL(ENDIAN)                                                                                       \
+    PARSE_REAL(ENDIAN, double, uint64_t)                                                                     \
+    PARSE_REAL(ENDIAN, float, uint32_t)                                                                      \
+    PARSE_SIGNED(ENDIAN, int16)                                                                              \
+    PARSE_SIGNED(ENDIAN, int32)                                                                              \
+    PARSE_SIGNED(ENDIAN, int64)                                                                              \
+    PARSE_SIGNED(ENDIAN, int8)                                                                               \
+    PARSE_UNSIGNED(ENDIAN, uint16)                                                                           \
+    PARSE_UNSIGNED(ENDIAN, uint32)                                                                           \
+    PARSE_UNSIGNED(ENDIAN, uint64)                                                                           \
+    PARSE_UNSIGNED(ENDIAN, uint8)
+
+// Parse binary booleans, real numbers, and integers (parse_be_bool,
+// parse_be_double, parse_be_float, parse_be_int16, ..., parse_le_uint8,
+// ..., parse_lsbf_uint8)
+
+PARSE_ENDIAN(be)
+PARSE_ENDIAN(le)
+PARSE_ENDIAN(lsbf)
 
 // Allocate memory for hexBinary array
 
@@ -65,14 +226,43 @@ extern void alloc_hexBinary(HexBinary *hexBinary, size_t num_bytes, PState *psta
 // Parse opaque bytes into hexBinary array
 
 extern void parse_hexBinary(HexBinary *hexBinary, PState *pstate);
+extern void parse_lsbf_hexBinary(HexBinary *hexBinary, PState *pstate);
+
+// Find the first byte which may begin a delimiter or an escape
+// sequence, comparing 32 (AVX2) or 16 (SSE2) bytes at once with each
+// candidate when the compiler targets those instruction sets; returns
+// num_bytes if none of the bytes is a candidate
+
+extern size_t scan_delimiters(const uint8_t *bytes, size_t num_bytes, const char *candidates);
+
+// Parse a delimited text element into a string, stopping before the
+// first delimiter which isn't escaped or at end of data
+
+extern void parse_delimited_string(String *string, const Delimiters *delimiters, PState *pstate);
+
+// Parse an initiator, separator, or terminator matching one of its
+// alternatives (the longest one first)
+
+extern void parse_delimiter(const Delimiters *delimiters, PState *pstate);
+
+// Skip num_bits bits of fill or unused data
+
+extern void parse_skip_bits(size_t num_bits, PState *pstate);
+extern void parse_lsbf_skip_bits(size_t num_bits, PState *pstate);
 
 // Parse alignment bits up to alignmentInBits or end_bitPos0b
 
 extern void parse_align_to(size_t alignmentInBits, PState *pstate);
 extern void parse_alignment_bits(size_t end_bitPos0b, PState *pstate);
+extern void parse_lsbf_align_to(size_t alignmentInBits, PState *pstate);
+extern void parse_lsbf_alignment_bits(size_t end_bitPos0b, PState *pstate);
 
 // Check for any data left over after end of parse
 
 extern void no_leftover_data(PState *pstate);
 
+// Check whether any data remains to be parsed without consuming it
+
+extern bool has_more_data(PState *pstate);
+
 #endif // PARSERS_H
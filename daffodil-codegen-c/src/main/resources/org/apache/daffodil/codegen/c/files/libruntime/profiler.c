@@ -0,0 +1,239 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include "profiler.h"
+#include <inttypes.h>  // for PRIu64
+#include <stdlib.h>    // for free, malloc, qsort
+#include <stdint.h>    // for uint64_t, uintptr_t
+#include <time.h>      // for clock_gettime, timespec, CLOCK_MONOTONIC
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // for __rdtsc
+#endif
+// clang-format on
+
+// Each thread has its own table of samples and its own stack of
+// functions being sampled, so threads never contend with each other
+
+static _Thread_local ProfileTable profile;
+static _Thread_local ProfileSample *current;
+
+// Read the time stamp counter, or a monotonic clock in nanoseconds if
+// there is no time stamp counter
+
+static uint64_t
+read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Find an element's entry in a table, claiming a free entry if the
+// element has none yet, or return NULL if the table is full
+
+static ProfileEntry *
+find_entry(ProfileTable *table, const ERD *erd)
+{
+    const size_t mask = LIMIT_PROFILE_ELEMENTS - 1;
+    size_t index = (size_t)(((uintptr_t)erd >> 4) * 0x9E3779B97F4A7C15ULL >> 32) & mask;
+    for (size_t probes = 0; probes < LIMIT_PROFILE_ELEMENTS; probes++)
+    {
+        ProfileEntry *entry = &table->entries[index];
+        if (entry->erd == erd)
+        {
+            return entry;
+        }
+        if (!entry->erd)
+        {
+            entry->erd = erd;
+            table->count++;
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+// profile_enter, profile_exit - start and finish sampling a function
+// (profile_exit adds the sample to the calling thread's table)
+
+void
+profile_enter(ProfileSample *sample, const ERD *erd, const ParserOrUnparserState *pu)
+{
+    sample->erd = erd;
+    sample->pu = pu;
+    sample->startBitPos0b = pu->bitPos0b;
+    sample->childCycles = 0;
+    sample->parent = current;
+    current = sample;
+    sample->markBitPos0b = sample->startBitPos0b;
+    sample->startCycles = sample->markCycles = read_cycles();
+}
+
+// Add one call of an element to the calling thread's table
+
+static void
+add_sample(const ERD *erd, size_t bits, uint64_t cycles, uint64_t selfCycles)
+{
+    ProfileEntry *entry = find_entry(&profile, erd);
+    if (entry)
+    {
+        entry->calls++;
+        entry->bits += bits;
+        entry->cycles += cycles;
+        entry->selfCycles += selfCycles;
+    }
+    else
+    {
+        profile.dropped++;
+    }
+}
+
+void
+profile_exit(ProfileSample *sample)
+{
+    const uint64_t cycles = read_cycles() - sample->startCycles;
+    add_sample(sample->erd, sample->pu->bitPos0b - sample->startBitPos0b, cycles, cycles - sample->childCycles);
+
+    // Charge these cycles to the enclosing function's nested elements
+    // and start its next simple element's sample here
+    current = sample->parent;
+    if (current)
+    {
+        current->childCycles += cycles;
+        current->markBitPos0b = current->pu->bitPos0b;
+        current->markCycles = read_cycles();
+    }
+}
+
+// profile_field - add a sample of a simple element parsed or unparsed
+// inline in the function being sampled to the calling thread's table
+
+void
+profile_field(const ERD *erd)
+{
+    const uint64_t now = read_cycles();
+    if (!current) return;
+
+    const uint64_t cycles = now - current->markCycles;
+    add_sample(erd, current->pu->bitPos0b - current->markBitPos0b, cycles, cycles);
+
+    // Charge these cycles to the function's nested elements too and
+    // start the next simple element's sample here
+    current->childCycles += cycles;
+    current->markBitPos0b = current->pu->bitPos0b;
+    current->markCycles = read_cycles();
+}
+
+// get_profile - get pointer to calling thread's table of samples
+
+ProfileTable *
+get_profile(void)
+{
+    return &profile;
+}
+
+// add_profile - add all entries of one table to another table (e.g.,
+// to combine the tables of several threads)
+
+void
+add_profile(ProfileTable *sum, const ProfileTable *table)
+{
+    for (size_t i = 0; i < LIMIT_PROFILE_ELEMENTS; i++)
+    {
+        const ProfileEntry *entry = &table->entries[i];
+        if (entry->erd)
+        {
+            ProfileEntry *sumEntry = find_entry(sum, entry->erd);
+            if (sumEntry)
+            {
+                sumEntry->calls += entry->calls;
+                sumEntry->bits += entry->bits;
+                sumEntry->cycles += entry->cycles;
+                sumEntry->selfCycles += entry->selfCycles;
+            }
+            else
+            {
+                sum->dropped += entry->calls;
+            }
+        }
+    }
+    sum->dropped += table->dropped;
+}
+
+// Compare two entries for qsort (most self cycles first)
+
+static int
+compare_entries(const void *a, const void *b)
+{
+    const uint64_t x = (*(const ProfileEntry *const *)a)->selfCycles;
+    const uint64_t y = (*(const ProfileEntry *const *)b)->selfCycles;
+    return (x < y) - (x > y);
+}
+
+// print_profile - print one line per element (calls, bits, cycles,
+// and share of all cycles) sorted by most cycles spent in element's
+// own function first
+
+void
+print_profile(const ProfileTable *table, FILE *stream)
+{
+    // Sort pointers to used entries instead of the entries themselves
+    const ProfileEntry **sorted = malloc((table->count ? table->count : 1) * sizeof(*sorted));
+    if (!sorted)
+    {
+        return;
+    }
+    size_t n = 0;
+    uint64_t totalCycles = 0;
+    for (size_t i = 0; i < LIMIT_PROFILE_ELEMENTS && n < table->count; i++)
+    {
+        if (table->entries[i].erd)
+        {
+            sorted[n++] = &table->entries[i];
+            totalCycles += table->entries[i].selfCycles;
+        }
+    }
+    qsort(sorted, n, sizeof(*sorted), compare_entries);
+
+    // Name arrays with [] to tell them apart from their elements
+    fprintf(stream, "%-32s %12s %16s %16s %16s %7s\n", "element", "calls", "bits", "cycles", "self cycles",
+            "self %");
+    for (size_t i = 0; i < n; i++)
+    {
+        const ProfileEntry *entry = sorted[i];
+        const char *suffix = entry->erd->typeCode == ARRAY ? "[]" : "";
+        char name[LIMIT_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%s%s", get_erd_name(entry->erd), suffix);
+        const double share = totalCycles ? 100.0 * (double)entry->selfCycles / (double)totalCycles : 0;
+        fprintf(stream, "%-32s %12" PRIu64 " %16" PRIu64 " %16" PRIu64 " %16" PRIu64 " %6.2f%%\n", name,
+                entry->calls, entry->bits, entry->cycles, entry->selfCycles, share);
+    }
+    if (table->dropped)
+    {
+        fprintf(stream, "(%" PRIu64 " samples dropped since more than %d elements were profiled)\n",
+                table->dropped, LIMIT_PROFILE_ELEMENTS);
+    }
+
+    free(sorted);
+}
@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for uint64_t
+#include <stdio.h>    // for FILE
+#include "errors.h"   // for LIMIT_PROFILE_ELEMENTS
+#include "infoset.h"  // for ERD, ParserOrUnparserState
+// clang-format on
+
+// ProfileSample - cycle counter and bit position sampled when a
+// parseSelf or unparseSelf function starts
+
+typedef struct ProfileSample
+{
+    const ERD *erd;                  // element being parsed or unparsed
+    const ParserOrUnparserState *pu; // state whose bit position gets sampled
+    uint64_t startCycles;            // cycle counter when function started
+    size_t startBitPos0b;            // bit position when function started
+    uint64_t childCycles;            // cycles spent in nested elements' functions
+    uint64_t markCycles;             // cycle counter when function started or last element finished
+    size_t markBitPos0b;             // bit position when function started or last element finished
+    struct ProfileSample *parent;    // sample of enclosing element's function
+} ProfileSample;
+
+// ProfileEntry - accumulated samples of one element
+
+typedef struct ProfileEntry
+{
+    const ERD *erd;      // element (NULL if entry is unused)
+    uint64_t calls;      // number of times function was called
+    uint64_t bits;       // number of bits consumed or produced
+    uint64_t cycles;     // cycles spent in function including nested elements
+    uint64_t selfCycles; // cycles spent in function excluding nested elements
+} ProfileEntry;
+
+// ProfileTable - accumulated samples of all elements, kept in a hash
+// table keyed by ERD address
+
+typedef struct ProfileTable
+{
+    ProfileEntry entries[LIMIT_PROFILE_ELEMENTS]; // hash table of entries
+    size_t count;                                 // number of used entries
+    uint64_t dropped;                             // samples which found no free entry
+} ProfileTable;
+
+// PROFILE_ELEMENT - sample an element's parseSelf or unparseSelf
+// function from this statement until the function returns.  Generated
+// code calls it first thing in each function, but it costs nothing
+// unless the C files are compiled with -DDAFFODIL_PROFILE.
+
+#ifdef DAFFODIL_PROFILE
+#define PROFILE_ELEMENT(erd, pu)                                                                             \
+    ProfileSample _profile __attribute__((cleanup(profile_exit)));                                           \
+    profile_enter(&_profile, erd, pu)
+#else
+#define PROFILE_ELEMENT(erd, pu) (void)0
+#endif
+
+// PROFILE_FIELD - sample a simple element, whose statements run inline
+// in its parent's function, from the end of the previous element (or
+// the start of the function) until this statement.  Generated code
+// calls it after each simple element's statements, so any statements
+// between elements (e.g., reading ahead) count toward the next simple
+// element.  It costs nothing unless compiled with -DDAFFODIL_PROFILE.
+
+#ifdef DAFFODIL_PROFILE
+#define PROFILE_FIELD(erd) profile_field(erd)
+#else
+#define PROFILE_FIELD(erd) (void)0
+#endif
+
+// profile_enter, profile_exit - start and finish sampling a function
+// (profile_exit adds the sample to the calling thread's table)
+
+extern void profile_enter(ProfileSample *sample, const ERD *erd, const ParserOrUnparserState *pu);
+extern void profile_exit(ProfileSample *sample);
+
+// profile_field - add a sample of a simple element parsed or unparsed
+// inline in the function being sampled to the calling thread's table
+
+extern void profile_field(const ERD *erd);
+
+// get_profile - get pointer to calling thread's table of samples
+
+extern ProfileTable *get_profile(void);
+
+// add_profile - add all entries of one table to another table (e.g.,
+// to combine the tables of several threads)
+
+extern void add_profile(ProfileTable *sum, const ProfileTable *table);
+
+// print_profile - print one line per element (calls, bits, cycles,
+// and share of all cycles) sorted by most cycles spent in element's
+// own function first
+
+extern void print_profile(const ProfileTable *table, FILE *stream);
+
+#endif // PROFILER_H
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include "push.h"
+#include <stdbool.h>  // for bool, false, true
+#include <stddef.h>   // for size_t, NULL
+#include <stdint.h>   // for uint8_t, int64_t
+#include <stdio.h>    // for fclose, fmemopen, fseek, fwrite, tmpfile, FILE, SEEK_SET
+#include <stdlib.h>   // for free, realloc
+#include <string.h>   // for memcpy, memmove
+#include "errors.h"   // for Diagnostics, Error, get_diagnostics, merge_diagnostics, ERR_LEFTOVER_DATA, ERR_PUSH_ALLOC, ERR_PUSH_UNALIGNED, LIMIT_READ_AHEAD
+#include "infoset.h"  // for PState, get_infoset, parse_record, InfosetBase
+// clang-format on
+
+// Open a stream which reads the bytes not parsed yet from memory
+
+static FILE *
+open_unparsed_stream(uint8_t *bytes, size_t length)
+{
+#ifdef _WIN32
+    // Windows has no fmemopen, so use a temporary file instead
+    FILE *stream = tmpfile();
+    if (stream && (fwrite(bytes, 1, length, stream) < length || fseek(stream, 0, SEEK_SET) != 0))
+    {
+        fclose(stream);
+        stream = NULL;
+    }
+    return stream;
+#else
+    return fmemopen(bytes, length, "r");
+#endif
+}
+
+// Report that a push parser couldn't allocate memory
+
+static void
+push_alloc_error(size_t num_bytes, PushParser *parser)
+{
+    static Error error = {ERR_PUSH_ALLOC, {0}};
+    error.arg.d64 = (int64_t)num_bytes;
+    parser->error = &error;
+}
+
+// push_data - append a chunk of data to a push parser's buffer and
+// return false after setting the parser's error if no memory could be
+// allocated
+
+bool
+push_data(PushParser *parser, const uint8_t *bytes, size_t length)
+{
+    // Move the bytes not parsed yet to the front of the buffer first
+    if (parser->numParsed)
+    {
+        parser->length -= parser->numParsed;
+        memmove(parser->buffer, parser->buffer + parser->numParsed, parser->length);
+        parser->numParsed = 0;
+    }
+
+    // Grow the buffer by doubling its capacity as needed
+    if (parser->length + length > parser->capacity)
+    {
+        size_t capacity = parser->capacity ? parser->capacity : LIMIT_READ_AHEAD;
+        while (capacity < parser->length + length) capacity *= 2;
+        uint8_t *buffer = realloc(parser->buffer, capacity);
+        if (!buffer)
+        {
+            push_alloc_error(capacity, parser);
+            return false;
+        }
+        parser->buffer = buffer;
+        parser->capacity = capacity;
+    }
+
+    if (length) memcpy(parser->buffer + parser->length, bytes, length);
+    parser->length += length;
+    return true;
+}
+
+// push_end - tell a push parser that no more data will be pushed so it
+// treats the end of its buffer as the end of data
+
+void
+push_end(PushParser *parser)
+{
+    parser->ended = true;
+}
+
+// push_parse - parse the next record from the data pushed so far into
+// the current thread's infoset or else say how much more data it needs
+
+enum PushStatus
+push_parse(PushParser *parser, InfosetBase **infoset)
+{
+    if (parser->error) return PUSH_ERROR;
+
+    // Keep going past any records which didn't pass the generated filter
+    while (true)
+    {
+        // Don't parse again until enough data is there to get further
+        const size_t available = parser->length - parser->numParsed;
+        if (parser->ended && !available) return PUSH_END;
+        if (!parser->ended && (!available || available < parser->numNeeded))
+        {
+            if (parser->numNeeded < 1) parser->numNeeded = 1;
+            return PUSH_NEED_MORE_DATA;
+        }
+
+        FILE *stream = open_unparsed_stream(parser->buffer + parser->numParsed, available);
+        if (!stream)
+        {
+            push_alloc_error(available, parser);
+            return PUSH_ERROR;
+        }
+        // Collect diagnostics apart so a parse which gets retried later
+        // doesn't add them more than once
+        Diagnostics diagnostics = {0};
+        PState pstate = {.pu = {.stream = stream, .diagnostics = &diagnostics}};
+        *infoset = get_infoset(true);
+        parse_record(*infoset, &pstate);
+        fclose(stream);
+
+        // A parser which read or peeked past the end of the data pushed
+        // so far may succeed or fail differently once more data comes.
+        // Scanning for a delimiter knows only that it needs one more
+        // byte, so wait for twice as many more bytes each time it needs
+        // more to parse a long delimited record O(log n) times, not n times
+        if (pstate.numMissingBytes && !parser->ended)
+        {
+            size_t step = pstate.numMissingBytes;
+            if (pstate.scannedPastEnd)
+            {
+                if (step < parser->numStep) step = parser->numStep;
+                parser->numStep = 2 * step;
+            }
+            parser->numNeeded = available + step;
+            return PUSH_NEED_MORE_DATA;
+        }
+        merge_diagnostics(parser->diagnostics ? parser->diagnostics : get_diagnostics(), &diagnostics);
+        if (pstate.pu.error)
+        {
+            parser->error = pstate.pu.error;
+            return PUSH_ERROR;
+        }
+
+        // The next record must start on a byte boundary in the buffer
+        // and a record which used no data would repeat forever
+        if (pstate.pu.bitPos0b % 8)
+        {
+            static Error error = {ERR_PUSH_UNALIGNED, {0}};
+            error.arg.d64 = (int64_t)pstate.pu.bitPos0b;
+            parser->error = &error;
+            return PUSH_ERROR;
+        }
+        if (!pstate.pu.bitPos0b)
+        {
+            static Error error = {ERR_LEFTOVER_DATA, {8}};
+            parser->error = &error;
+            return PUSH_ERROR;
+        }
+        parser->numParsed += pstate.pu.bitPos0b / 8;
+        parser->numNeeded = parser->numStep = 0;
+        if (!pstate.filteredOut) return PUSH_RECORD;
+    }
+}
+
+// push_free - free a push parser's buffer
+
+void
+push_free(PushParser *parser)
+{
+    free(parser->buffer);
+    parser->buffer = NULL;
+    parser->length = parser->capacity = parser->numParsed = parser->numNeeded = parser->numStep = 0;
+}
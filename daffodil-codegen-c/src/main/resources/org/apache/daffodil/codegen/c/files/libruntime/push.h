@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PUSH_H
+#define PUSH_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdbool.h>  // for bool
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for uint8_t
+#include "errors.h"   // for Diagnostics, Error
+#include "infoset.h"  // for InfosetBase
+// clang-format on
+
+// PushStatus - what push_parse did with the data pushed so far
+
+enum PushStatus
+{
+    PUSH_RECORD,         // parsed a record into the infoset
+    PUSH_NEED_MORE_DATA, // needs at least numNeeded bytes before parsing further
+    PUSH_END,            // parsed every record and no more data will come
+    PUSH_ERROR,          // failed to parse a record (see error)
+};
+
+// PushParser - mutable state of a parser which gets its data pushed to
+// it in chunks of any size (e.g., as bytes arrive on a non-blocking
+// socket) instead of reading its data from a blocking stream.  Zero
+// initialize it, optionally set diagnostics, and call push_free when
+// done with it.
+
+typedef struct PushParser
+{
+    uint8_t *buffer;          // bytes pushed but not parsed yet (malloc'ed)
+    size_t length;            // number of bytes in buffer
+    size_t capacity;          // capacity of buffer in bytes
+    size_t numParsed;         // number of bytes at front of buffer which parsed records used
+    size_t numNeeded;         // number of bytes after numParsed which the next record needs at least
+    size_t numStep;           // number of bytes a delimited record's next retry waits for at least
+    bool ended;               // true if no more data will be pushed
+    Diagnostics *diagnostics; // own or else thread's validation diagnostics
+    const Error *error;       // any error which stopped the parser
+} PushParser;
+
+// push_data - append a chunk of data to a push parser's buffer and
+// return false after setting the parser's error if no memory could be
+// allocated
+
+extern bool push_data(PushParser *parser, const uint8_t *bytes, size_t length);
+
+// push_end - tell a push parser that no more data will be pushed so it
+// treats the end of its buffer as the end of data
+
+extern void push_end(PushParser *parser);
+
+// push_parse - parse the next record from the data pushed so far into
+// the current thread's infoset (valid until that thread parses again)
+// and return PUSH_RECORD, or return PUSH_NEED_MORE_DATA without parsing
+// again until at least parser->numNeeded bytes follow the parsed
+// records.  The generated parsers can't stop in the middle of a record,
+// so a record which needs more data gets parsed again from its start
+// once enough data has been pushed, which costs a parse of all of the
+// record's bytes pushed so far each time.  A record which needs a known
+// number of bytes more waits for just those bytes, while a delimited
+// record (which only knows it needs more bytes than it has) waits for
+// twice as many more bytes as the last time, so it gets parsed
+// O(log n) times but may not get parsed until up to as many bytes as it
+// has buffered follow it (or push_end is called).  Validation
+// diagnostics get added only once a record's parse is kept.  Records
+// must end on byte boundaries.
+
+extern enum PushStatus push_parse(PushParser *parser, InfosetBase **infoset);
+
+// push_free - free a push parser's buffer
+
+extern void push_free(PushParser *parser);
+
+#endif // PUSH_H
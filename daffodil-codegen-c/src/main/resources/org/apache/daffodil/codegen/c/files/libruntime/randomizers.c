@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include "randomizers.h"
+#include <assert.h>   // for assert
+#include <stdlib.h>   // for free, malloc
+#include <string.h>   // for memcpy, memchr, strlen
+#include "errors.h"   // for Error, ERR_HEXBINARY_ALLOC, ERR_STRING_ALLOC, Error::(anonymous)
+// clang-format on
+
+// Get the next 64 random bits from a splitmix64 generator, which
+// passes statistical tests, accepts any seed (even zero), and needs
+// only one 64-bit word of state
+
+static uint64_t
+random_bits(RState *rstate)
+{
+    uint64_t z = (rstate->seed += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+// Get a random real number within a range
+
+double
+random_double(double min, double max, RState *rstate)
+{
+    // Use the top 53 bits to get a uniform double in [0, 1]
+    const double unit = (double)(random_bits(rstate) >> 11) / (double)((UINT64_C(1) << 53) - 1);
+    return min + (max - min) * unit;
+}
+
+// Get a random array index less than count
+
+size_t
+random_index(size_t count, RState *rstate)
+{
+    return count ? (size_t)random_uint(0, count - 1, rstate) : 0;
+}
+
+// Get a random signed integer within a range
+
+int64_t
+random_int(int64_t min, int64_t max, RState *rstate)
+{
+    // Unsigned arithmetic wraps around instead of overflowing
+    const uint64_t span = (uint64_t)max - (uint64_t)min;
+    return (int64_t)((uint64_t)min + random_uint(0, span, rstate));
+}
+
+// Get a random unsigned integer within a range (modulo bias is
+// negligible for the small ranges schemas usually have)
+
+uint64_t
+random_uint(uint64_t min, uint64_t max, RState *rstate)
+{
+    if (max <= min)
+    {
+        return min;
+    }
+    const uint64_t span = max - min;
+    const uint64_t bits = random_bits(rstate);
+    return min + (span == UINT64_MAX ? bits : bits % (span + 1));
+}
+
+// Fill hexBinary array with random bytes
+
+void
+random_hexBinary(HexBinary *hexBinary, RState *rstate)
+{
+    for (size_t i = 0; i < hexBinary->lengthInBytes; i += sizeof(uint64_t))
+    {
+        const uint64_t bits = random_bits(rstate);
+        const size_t remaining = hexBinary->lengthInBytes - i;
+        memcpy(hexBinary->array + i, &bits, remaining < sizeof(bits) ? remaining : sizeof(bits));
+    }
+}
+
+// Allocate memory for hexBinary array and fill it with random bytes
+
+void
+random_hexBinary_alloc(HexBinary *hexBinary, size_t num_bytes, RState *rstate)
+{
+    // Free old byte array
+    assert(hexBinary->dynamic);
+    free(hexBinary->array);
+
+    // Allocate new byte array
+    hexBinary->array = malloc(num_bytes);
+    hexBinary->lengthInBytes = num_bytes;
+
+    // Return error if necessary
+    if (num_bytes && hexBinary->array == NULL)
+    {
+        static Error error = {ERR_HEXBINARY_ALLOC, {0}};
+        error.arg.d64 = (int64_t)num_bytes;
+        hexBinary->lengthInBytes = 0;
+        rstate->error = &error;
+        return;
+    }
+
+    random_hexBinary(hexBinary, rstate);
+}
+
+// Fill hexBinary array with a copy of the given bytes
+
+void
+random_hexBinary_copy(HexBinary *hexBinary, const uint8_t *bytes, size_t num_bytes, RState *rstate)
+{
+    if (hexBinary->dynamic)
+    {
+        random_hexBinary_alloc(hexBinary, num_bytes, rstate);
+        if (rstate->error) return;
+    }
+    else if (num_bytes > hexBinary->lengthInBytes)
+    {
+        // Never write past a fixed length array
+        num_bytes = hexBinary->lengthInBytes;
+    }
+    if (num_bytes)
+    {
+        memcpy(hexBinary->array, bytes, num_bytes);
+    }
+}
+
+// Fill string with random letters and digits, leaving out any which
+// could begin a delimiter or an escape sequence
+
+void
+random_string(String *string, const Delimiters *delimiters, size_t max_length, RState *rstate)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    char allowed[sizeof(alphabet)];
+    size_t num_allowed = 0;
+    for (size_t i = 0; i < sizeof(alphabet) - 1; i++)
+    {
+        if (!memchr(delimiters->candidates, alphabet[i], strlen(delimiters->candidates)))
+        {
+            allowed[num_allowed++] = alphabet[i];
+        }
+    }
+
+    size_t length = num_allowed ? (size_t)random_uint(1, max_length, rstate) : 0;
+    if (!string_reserve(string, length))
+    {
+        static Error error = {ERR_STRING_ALLOC, {0}};
+        error.arg.d64 = (int64_t)length;
+        rstate->error = &error;
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        string->chars[i] = allowed[random_index(num_allowed, rstate)];
+    }
+    string->chars[length] = '\0';
+    string->length = length;
+}
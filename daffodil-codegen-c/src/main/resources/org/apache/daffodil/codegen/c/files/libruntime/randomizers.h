@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RANDOMIZERS_H
+#define RANDOMIZERS_H
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for int64_t, uint64_t, uint8_t
+#include "errors.h"   // for Error
+#include "infoset.h"  // for HexBinary, InfosetBase, String, Delimiters
+// clang-format on
+
+// RState - mutable state while filling an infoset with random values
+
+typedef struct RState
+{
+    uint64_t seed;      // state of pseudorandom number generator
+    const Error *error; // error which stopped randomizing, if any
+} RState;
+
+// randomize_infoset - fill an infoset with random values which
+// satisfy its schema's fixed values, enumerations, ranges, and
+// occursCount relationships (the same seed always produces the same
+// values since randomize_infoset and the functions below use only
+// rstate's generator, not rand())
+
+extern void randomize_infoset(InfosetBase *infoset, RState *rstate);
+
+// Get random integers, real numbers, or array indexes within ranges
+// (integer and real number ranges include both min and max, while
+// random_index returns an index less than count)
+
+extern double random_double(double min, double max, RState *rstate);
+extern size_t random_index(size_t count, RState *rstate);
+extern int64_t random_int(int64_t min, int64_t max, RState *rstate);
+extern uint64_t random_uint(uint64_t min, uint64_t max, RState *rstate);
+
+// Fill hexBinary array with random bytes, allocating num_bytes first
+// if random_hexBinary_alloc is called instead of random_hexBinary
+
+extern void random_hexBinary(HexBinary *hexBinary, RState *rstate);
+extern void random_hexBinary_alloc(HexBinary *hexBinary, size_t num_bytes, RState *rstate);
+
+// Fill hexBinary array with a copy of the given bytes, allocating
+// num_bytes first if hexBinary's array is dynamic
+
+extern void random_hexBinary_copy(HexBinary *hexBinary, const uint8_t *bytes, size_t num_bytes,
+                                  RState *rstate);
+
+// Fill string with 1 to max_length random letters and digits, leaving
+// out any which could begin a delimiter or an escape sequence
+
+extern void random_string(String *string, const Delimiters *delimiters, size_t max_length, RState *rstate);
+
+#endif // RANDOMIZERS_H
@@ -19,21 +19,29 @@
 // clang-format off
 #include "unparsers.h"
 #include <assert.h>   // for assert
-#include <stdbool.h>  // for bool
-#include <stdio.h>    // for fwrite
-#include "errors.h"   // for eof_or_error
-#include "p_endian.h" // for htobe64, htole64, htobe32, htole32
+#include <stdbool.h>  // for bool, false, true
+#include <stdio.h>    // for fflush, fileno, fwrite
+#include <string.h>   // for memchr, memcmp, memcpy, memset, strlen
+#ifndef _WIN32
+#include <errno.h>    // for errno, EINTR
+#include <unistd.h>   // for write, ssize_t
+#endif
+#include "errors.h"   // for eof_or_error, Error, ERR_STREAM_ERROR
+#include "p_endian.h" // for htobe64, htole64
 // clang-format on
 
 // Helper macros to get "n" highest bits from a byte's high end
 
 #define BYTE_WIDTH 8
-#define BIG_ENDIAN_DATA 1
-#define LITTLE_ENDIAN_DATA 0
 #define LOW_MASK(n) ((1 << n) - 1)
 #define HIGH_MASK(n) (LOW_MASK(n) << (BYTE_WIDTH - n))
 #define HIGH_BITS(byte, n) ((byte & HIGH_MASK(n)) >> (BYTE_WIDTH - n))
 
+// Number of bytes at which a byte-aligned payload gets written straight
+// to the stream's file descriptor instead of through its buffer
+
+#define DIRECT_WRITE_BYTES 65536
+
 // Helper method to write bits using whole bytes while storing
 // remaining bits not yet written within a fragment byte; expects last
 // bits of last byte to be already shifted to left end
@@ -108,88 +116,19 @@ write_bits(const uint8_t *bytes, size_t num_bits, UState *ustate)
     }
 }
 
-// Helper method to write doubles depending on data endianness;
-// num_bits must be exactly 64 bits
-
-static void
-unparse_endian_double(bool big_endian_data, double number, size_t num_bits, UState *ustate)
-{
-    // Unparse all doubles in ths helper function
-    union
-    {
-        uint8_t bytes[sizeof(double)];
-        double number;
-        uint64_t integer;
-    } buffer;
-
-    // Don't need to fill with any padding bits since doubles must be
-    // exactly 64 bits, otherwise SDE would happen sooner
-    assert(num_bits == sizeof(double) * BYTE_WIDTH);
-
-    // Convert host endianness to data endianness
-    buffer.number = number;
-    if (big_endian_data)
-    {
-        buffer.integer = htobe64(buffer.integer);
-    }
-    else
-    {
-        buffer.integer = htole64(buffer.integer);
-    }
-
-    // Write data bits and update our last successful write position
-    write_bits(buffer.bytes, num_bits, ustate);
-    if (ustate->pu.error) return;
-    ustate->pu.bitPos0b += num_bits;
-}
-
-// Helper method to write floats depending on data endianness;
-// num_bits must be exactly 32 bits
-
-void
-unparse_endian_float(bool big_endian_data, float number, size_t num_bits, UState *ustate)
-{
-    // Unparse all floats in this helper function
-    union
-    {
-        uint8_t bytes[sizeof(float)];
-        float number;
-        uint32_t integer;
-    } buffer;
-
-    // Don't need to fill with any padding bits since floats must be
-    // exactly 32 bits, otherwise SDE would happen sooner
-    assert(num_bits == sizeof(float) * BYTE_WIDTH);
-
-    // Convert host endianness to data endianness
-    buffer.number = number;
-    if (big_endian_data)
-    {
-        buffer.integer = htobe32(buffer.integer);
-    }
-    else
-    {
-        buffer.integer = htole32(buffer.integer);
-    }
-
-    // Write data bits and update our last successful write position
-    write_bits(buffer.bytes, num_bits, ustate);
-    if (ustate->pu.error) return;
-    ustate->pu.bitPos0b += num_bits;
-}
-
-// Helper method to write signed integers using fragment byte shifts
+// Unparse an unsigned integer of 1 to 64 bits at any bit position
+// (slow path of inline unparsers); uses fragment byte shifts
 // depending on data endianness (note not tested on big-endian
 // architecture; might work only on low-endian architecture)
 
-static void
-unparse_endian_int64(bool big_endian_data, int64_t number, size_t num_bits, UState *ustate)
+void
+unparse_endian_uint64(bool big_endian_data, uint64_t number, size_t num_bits, UState *ustate)
 {
-    // Unparse all signed integers in this helper function
+    // Unparse all unsigned integers in this helper function
     union
     {
-        uint8_t bytes[sizeof(int64_t)];
-        int64_t integer;
+        uint8_t bytes[sizeof(uint64_t)];
+        uint64_t integer;
     } buffer;
 
     // Shift data bits differently on endianness
@@ -197,7 +136,7 @@ unparse_endian_int64(bool big_endian_data, int64_t number, size_t num_bits, USta
     if (big_endian_data)
     {
         // Shift data bits and pad with fill bits
-        size_t shift = sizeof(int64_t) * BYTE_WIDTH - num_bits;
+        size_t shift = sizeof(uint64_t) * BYTE_WIDTH - num_bits;
         buffer.integer <<= shift;
 
         // Convert host endianness to data endianness
@@ -220,196 +159,265 @@ unparse_endian_int64(bool big_endian_data, int64_t number, size_t num_bits, USta
     ustate->pu.bitPos0b += num_bits;
 }
 
-// Helper method to write unsigned integers using fragment byte shifts
-// depending on data endianness (note not tested on big-endian
-// architecture; might work only on low-endian architecture)
+// Unparse an unsigned integer of 1 to 64 bits at any bit position in
+// leastSignificantBitFirst bit order (slow path of inline LSBF
+// unparsers); fills a 64-bit accumulator from its low end with the
+// fragment byte's bits and then the number's bits, writes all whole
+// bytes at once, and keeps the rest of the bits in the fragment byte
 
-// Also note that we probably could use this helper function to write
-// signed integers too but let's make debugging easier
-
-static void
-unparse_endian_uint64(bool big_endian_data, uint64_t number, size_t num_bits, UState *ustate)
+void
+unparse_lsbf_slow(uint64_t number, size_t num_bits, UState *ustate)
 {
-    // Unparse all unsigned integers in this helper function
-    union
-    {
-        uint8_t bytes[sizeof(uint64_t)];
-        uint64_t integer;
-    } buffer;
-
-    // Shift data bits differently on endianness
-    buffer.integer = number;
-    if (big_endian_data)
+    const size_t num_unwrit = ustate->numUnwritBits;
+    const size_t integer_bits = sizeof(uint64_t) * BYTE_WIDTH;
+    if (num_bits < integer_bits)
     {
-        // Shift data bits and pad with fill bits
-        size_t shift = sizeof(uint64_t) * BYTE_WIDTH - num_bits;
-        buffer.integer <<= shift;
-
-        // Convert host endianness to data endianness
-        buffer.integer = htobe64(buffer.integer);
+        number &= ((uint64_t)1 << num_bits) - 1;
     }
-    else
-    {
-        // Pad with any bits needed to fill most significant byte
-        size_t msb_ix = (num_bits - 1) / BYTE_WIDTH;
-        size_t shift = (BYTE_WIDTH - num_bits % BYTE_WIDTH) % BYTE_WIDTH;
-        buffer.bytes[msb_ix] <<= shift;
 
-        // Convert host endianness to data endianness
-        buffer.integer = htole64(buffer.integer);
-    }
+    // Bits shifted out of the accumulator's high end go in a ninth byte
+    uint8_t bytes[sizeof(uint64_t) + 1];
+    uint64_t integer = htole64(ustate->unwritBits | (number << num_unwrit));
+    memcpy(bytes, &integer, sizeof(integer));
+    bytes[sizeof(integer)] = num_unwrit ? (uint8_t)(number >> (integer_bits - num_unwrit)) : 0;
 
     // Write data bits and update our last successful write position
-    write_bits(buffer.bytes, num_bits, ustate);
-    if (ustate->pu.error) return;
+    const size_t num_bytes = (num_unwrit + num_bits) / BYTE_WIDTH;
+    if (num_bytes)
+    {
+        size_t count = fwrite(bytes, 1, num_bytes, ustate->pu.stream);
+        if (count < num_bytes)
+        {
+            ustate->pu.error = eof_or_error(ustate->pu.stream);
+            return;
+        }
+    }
+    ustate->numUnwritBits = (uint8_t)((num_unwrit + num_bits) % BYTE_WIDTH);
+    ustate->unwritBits = bytes[num_bytes] & LOW_MASK(ustate->numUnwritBits);
+    ustate->unwritLsbf = ustate->numUnwritBits != 0;
     ustate->pu.bitPos0b += num_bits;
 }
 
-// Unparse all binary booleans, real numbers, and integers in helper
-// functions, but wrap calls for type safety and simpler calls
+// Helper method to write a large byte-aligned payload straight from
+// the infoset to the stream's file descriptor, flushing the smaller
+// fields already buffered first so the bytes stay in order; returns
+// false without writing anything if the stream has no file descriptor
+// (e.g., a memory stream) or the payload doesn't qualify, or else true
+// even if writing failed, so callers must check ustate->pu.error after
+// it returns true
 
-void
-unparse_be_bool(bool number, size_t num_bits, uint32_t true_rep, uint32_t false_rep, UState *ustate)
-{
-    uint64_t integer = number ? true_rep : false_rep;
-    unparse_endian_uint64(BIG_ENDIAN_DATA, integer, num_bits, ustate);
-}
-
-void
-unparse_be_double(double number, size_t num_bits, UState *ustate)
+static bool
+write_direct(const uint8_t *bytes, size_t num_bytes, UState *ustate)
 {
-    unparse_endian_double(BIG_ENDIAN_DATA, number, num_bits, ustate);
+#ifdef _WIN32
+    (void)bytes;
+    (void)num_bytes;
+    (void)ustate;
+    return false;
+#else
+    FILE *stream = ustate->pu.stream;
+    if (num_bytes < DIRECT_WRITE_BYTES || ustate->numUnwritBits) return false;
+    const int fd = fileno(stream);
+    if (fd < 0) return false;
+
+    static Error error = {ERR_STREAM_ERROR, {0}};
+    if (fflush(stream) != 0)
+    {
+        ustate->pu.error = &error;
+        return true;
+    }
+    while (num_bytes)
+    {
+        const ssize_t count = write(fd, bytes, num_bytes);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0)
+        {
+            ustate->pu.error = &error;
+            return true;
+        }
+        bytes += count;
+        num_bytes -= (size_t)count;
+    }
+    return true;
+#endif
 }
 
-void
-unparse_be_float(float number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_float(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Unparse opaque bytes from hexBinary field
 
 void
-unparse_be_int16(int16_t number, size_t num_bits, UState *ustate)
+unparse_hexBinary(HexBinary hexBinary, UState *ustate)
 {
-    unparse_endian_int64(BIG_ENDIAN_DATA, number, num_bits, ustate);
+    if (!write_direct(hexBinary.array, hexBinary.lengthInBytes, ustate))
+    {
+        write_bits(hexBinary.array, hexBinary.lengthInBytes * BYTE_WIDTH, ustate);
+    }
+    if (ustate->pu.error) return;
+    ustate->pu.bitPos0b += hexBinary.lengthInBytes * BYTE_WIDTH;
 }
 
-void
-unparse_be_int32(int32_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_int64(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Unparse opaque bytes from hexBinary field in leastSignificantBitFirst
+// bit order (only bytes not starting on a byte boundary differ)
 
 void
-unparse_be_int64(int64_t number, size_t num_bits, UState *ustate)
+unparse_lsbf_hexBinary(HexBinary hexBinary, UState *ustate)
 {
-    unparse_endian_int64(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+    if (!ustate->numUnwritBits)
+    {
+        unparse_hexBinary(hexBinary, ustate);
+        return;
+    }
 
-void
-unparse_be_int8(int8_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_int64(BIG_ENDIAN_DATA, number, num_bits, ustate);
+    for (size_t i = 0; i < hexBinary.lengthInBytes; i++)
+    {
+        unparse_lsbf_slow(hexBinary.array[i], BYTE_WIDTH, ustate);
+        if (ustate->pu.error) return;
+    }
 }
 
-void
-unparse_be_uint16(uint16_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_uint64(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Helper method to check whether one of the delimiters' alternatives
+// begins at the start of the given bytes
 
-void
-unparse_be_uint32(uint32_t number, size_t num_bits, UState *ustate)
+static bool
+starts_with_delimiter(const uint8_t *bytes, size_t num_bytes, const Delimiters *delimiters)
 {
-    unparse_endian_uint64(BIG_ENDIAN_DATA, number, num_bits, ustate);
+    for (size_t i = 0; i < delimiters->numStrings; i++)
+    {
+        const char *delimiter = delimiters->strings[i];
+        size_t length = strlen(delimiter);
+        if (length && length <= num_bytes && memcmp(bytes, delimiter, length) == 0) return true;
+    }
+    return false;
 }
 
-void
-unparse_be_uint64(uint64_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_uint64(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Unparse a delimited text element from a string, writing an escape
+// character before any delimiter or escape character in its text
 
 void
-unparse_be_uint8(uint8_t number, size_t num_bits, UState *ustate)
+unparse_delimited_string(const String *string, const Delimiters *delimiters, UState *ustate)
 {
-    unparse_endian_uint64(BIG_ENDIAN_DATA, number, num_bits, ustate);
-}
+    // Text starts on a byte boundary since its alignment was unparsed first
+    assert(!ustate->numUnwritBits);
+
+    const uint8_t *bytes = (const uint8_t *)string->chars;
+    const size_t num_bytes = string->length;
+    const int ec = delimiters->escapeChar;
+    const int eec = delimiters->escapeEscapeChar;
+    const size_t num_candidates = strlen(delimiters->candidates);
+    size_t ix_written = 0;
+
+    // Text can't hide its delimiters without an escape character
+    for (size_t i = 0; ec >= 0 && i < num_bytes; i++)
+    {
+        if (!memchr(delimiters->candidates, bytes[i], num_candidates)) continue;
 
-void
-unparse_le_bool(bool number, size_t num_bits, uint32_t true_rep, uint32_t false_rep, UState *ustate)
-{
-    uint64_t integer = number ? true_rep : false_rep;
-    unparse_endian_uint64(LITTLE_ENDIAN_DATA, integer, num_bits, ustate);
-}
+        // Escape an escape character with an escape escape character if
+        // there is one, and anything else which parsing would mistake
+        // for a delimiter or an escape sequence with an escape character
+        int escape = -1;
+        if (bytes[i] == ec)
+        {
+            escape = eec >= 0 ? eec : ec;
+        }
+        else if (bytes[i] == eec || starts_with_delimiter(bytes + i, num_bytes - i, delimiters))
+        {
+            escape = ec;
+        }
+        if (escape < 0) continue;
 
-void
-unparse_le_double(double number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_double(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+        const uint8_t escape_byte = (uint8_t)escape;
+        write_bits(bytes + ix_written, (i - ix_written) * BYTE_WIDTH, ustate);
+        if (ustate->pu.error) return;
+        write_bits(&escape_byte, BYTE_WIDTH, ustate);
+        if (ustate->pu.error) return;
+        ustate->pu.bitPos0b += (i - ix_written + 1) * BYTE_WIDTH;
+        ix_written = i;
+    }
 
-void
-unparse_le_float(float number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_float(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
+    write_bits(bytes + ix_written, (num_bytes - ix_written) * BYTE_WIDTH, ustate);
+    if (ustate->pu.error) return;
+    ustate->pu.bitPos0b += (num_bytes - ix_written) * BYTE_WIDTH;
 }
 
-void
-unparse_le_int16(int16_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_int64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Unparse an initiator, separator, or terminator
 
 void
-unparse_le_int32(int32_t number, size_t num_bits, UState *ustate)
+unparse_delimiter(const char *delimiter, UState *ustate)
 {
-    unparse_endian_int64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
+    size_t num_bits = strlen(delimiter) * BYTE_WIDTH;
+    write_bits((const uint8_t *)delimiter, num_bits, ustate);
+    if (ustate->pu.error) return;
+    ustate->pu.bitPos0b += num_bits;
 }
 
-void
-unparse_le_int64(int64_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_int64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Helper method to write whole fill bytes from a buffer in chunks
+// instead of one byte at a time; returns false if the stream fails
 
-void
-unparse_le_int8(int8_t number, size_t num_bits, UState *ustate)
+static bool
+write_fill_bytes(size_t num_bytes, const uint8_t fill_byte, UState *ustate)
 {
-    unparse_endian_int64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
+    uint8_t bytes[256];
+    memset(bytes, fill_byte, (num_bytes < sizeof(bytes)) ? num_bytes : sizeof(bytes));
+    while (num_bytes)
+    {
+        size_t chunk = (num_bytes < sizeof(bytes)) ? num_bytes : sizeof(bytes);
+        if (fwrite(bytes, 1, chunk, ustate->pu.stream) < chunk) return false;
+        num_bytes -= chunk;
+    }
+    return true;
 }
 
-void
-unparse_le_uint16(uint16_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_uint64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+// Helper method to write fill bits up to end_bitPos0b in either bit
+// order, filling the fragment byte first and then writing whole fill
+// bytes in chunks
 
-void
-unparse_le_uint32(uint32_t number, size_t num_bits, UState *ustate)
+static void
+write_fill_bits(bool lsbf, size_t end_bitPos0b, uint8_t fill_byte, UState *ustate)
 {
-    unparse_endian_uint64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+    assert(ustate->pu.bitPos0b <= end_bitPos0b);
 
-void
-unparse_le_uint64(uint64_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_uint64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+    // Fill bits repeat every 8 bits, so once the fragment byte is full,
+    // each whole byte holds the fill byte rotated by the bits it took
+    size_t fill_bits = end_bitPos0b - ustate->pu.bitPos0b;
+    if (ustate->numUnwritBits && fill_bits)
+    {
+        size_t num_bits = BYTE_WIDTH - ustate->numUnwritBits;
+        if (num_bits > fill_bits) num_bits = fill_bits;
+        if (lsbf)
+        {
+            unparse_lsbf_slow(fill_byte, num_bits, ustate);
+            fill_byte = (uint8_t)(fill_byte >> num_bits | fill_byte << (BYTE_WIDTH - num_bits));
+        }
+        else
+        {
+            write_bits(&fill_byte, num_bits, ustate);
+            fill_byte = (uint8_t)(fill_byte << num_bits | fill_byte >> (BYTE_WIDTH - num_bits));
+        }
+        if (ustate->pu.error) return;
+        fill_bits -= num_bits;
+    }
 
-void
-unparse_le_uint8(uint8_t number, size_t num_bits, UState *ustate)
-{
-    unparse_endian_uint64(LITTLE_ENDIAN_DATA, number, num_bits, ustate);
-}
+    if (!write_fill_bytes(fill_bits / BYTE_WIDTH, fill_byte, ustate))
+    {
+        ustate->pu.error = eof_or_error(ustate->pu.stream);
+        return;
+    }
 
-// Unparse opaque bytes from hexBinary field
+    fill_bits %= BYTE_WIDTH;
+    if (fill_bits)
+    {
+        if (lsbf)
+        {
+            unparse_lsbf_slow(fill_byte, fill_bits, ustate);
+        }
+        else
+        {
+            write_bits(&fill_byte, fill_bits, ustate);
+        }
+        if (ustate->pu.error) return;
+    }
 
-void
-unparse_hexBinary(HexBinary hexBinary, UState *ustate)
-{
-    write_bits(hexBinary.array, hexBinary.lengthInBytes * BYTE_WIDTH, ustate);
-    if (ustate->pu.error) return;
-    ustate->pu.bitPos0b += hexBinary.lengthInBytes * BYTE_WIDTH;
+    // If we got all the way here, update our last successful write position
+    ustate->pu.bitPos0b = end_bitPos0b;
 }
 
 // Unparse alignment bits up to alignmentInBits or end_bitPos0b
@@ -424,19 +432,23 @@ unparse_align_to(size_t alignmentInBits, const uint8_t fill_byte, UState *ustate
 void
 unparse_alignment_bits(size_t end_bitPos0b, const uint8_t fill_byte, UState *ustate)
 {
-    assert(ustate->pu.bitPos0b <= end_bitPos0b);
+    write_fill_bits(false, end_bitPos0b, fill_byte, ustate);
+}
 
-    size_t fill_bits = end_bitPos0b - ustate->pu.bitPos0b;
-    while (fill_bits)
-    {
-        size_t num_bits = (fill_bits >= BYTE_WIDTH) ? BYTE_WIDTH : fill_bits;
-        write_bits(&fill_byte, num_bits, ustate);
-        if (ustate->pu.error) return;
-        fill_bits -= num_bits;
-    }
+// Unparse alignment bits up to alignmentInBits or end_bitPos0b in
+// leastSignificantBitFirst bit order
 
-    // If we got all the way here, update our last successful write position
-    ustate->pu.bitPos0b = end_bitPos0b;
+void
+unparse_lsbf_align_to(size_t alignmentInBits, const uint8_t fill_byte, UState *ustate)
+{
+    size_t end_bitPos0b = ((ustate->pu.bitPos0b + alignmentInBits - 1) / alignmentInBits) * alignmentInBits;
+    unparse_lsbf_alignment_bits(end_bitPos0b, fill_byte, ustate);
+}
+
+void
+unparse_lsbf_alignment_bits(size_t end_bitPos0b, const uint8_t fill_byte, UState *ustate)
+{
+    write_fill_bits(true, end_bitPos0b, fill_byte, ustate);
 }
 
 // Flush the fragment byte if not done yet
@@ -450,10 +462,17 @@ flush_fragment_byte(const uint8_t fill_byte, UState *ustate)
         // Do we have any unwritten bits left in the fragment byte?
         if (ustate->numUnwritBits)
         {
-            // Fill the fragment byte
+            // Fill the fragment byte (LSBF bits fill it from its low end)
             size_t num_bits_fill = BYTE_WIDTH - ustate->numUnwritBits;
-            ustate->unwritBits <<= num_bits_fill;
-            ustate->unwritBits |= HIGH_BITS(fill_byte, num_bits_fill);
+            if (ustate->unwritLsbf)
+            {
+                ustate->unwritBits |= (uint8_t)(fill_byte << ustate->numUnwritBits);
+            }
+            else
+            {
+                ustate->unwritBits <<= num_bits_fill;
+                ustate->unwritBits |= HIGH_BITS(fill_byte, num_bits_fill);
+            }
 
             // Flush the fragment byte
             size_t num_bits_write = ustate->numUnwritBits;
@@ -464,6 +483,7 @@ flush_fragment_byte(const uint8_t fill_byte, UState *ustate)
                 num_bits_write = 0;
             }
             ustate->numUnwritBits -= num_bits_write;
+            ustate->unwritLsbf = false;
             ustate->pu.bitPos0b += num_bits_write;
         }
     }
@@ -20,52 +20,160 @@
 
 // auto-maintained by iwyu
 // clang-format off
-#include <stdbool.h>  // for bool
-#include <stddef.h>   // for size_t
-#include <stdint.h>   // for uint32_t, uint8_t, int16_t, int32_t, int64_t, int8_t, uint16_t, uint64_t
-#include "infoset.h"  // for UState, HexBinary
+#include <limits.h>    // for CHAR_BIT
+#include <stdbool.h>   // for bool
+#include <stddef.h>    // for size_t
+#include <stdint.h>    // for uint64_t, uint32_t, uint8_t, int16_t, int32_t, int64_t, int8_t, uint16_t
+#include <stdio.h>     // for fwrite
+#include <string.h>    // for memcpy
+#include "errors.h"    // for eof_or_error
+#include "infoset.h"   // for UState, HexBinary, String, Delimiters
+#include "p_endian.h"  // for htobe64, htole64
 // clang-format on
 
-// Unparse binary booleans, real numbers, and integers
+// Unparse an unsigned integer of 1 to 64 bits at any bit position
+// (slow path of inline unparsers)
+
+extern void unparse_endian_uint64(bool big_endian_data, uint64_t number, size_t num_bits, UState *ustate);
+
+// Unparse the low num_bits bits of an integer, writing whole bytes
+// straight to the stream when the fragment byte is empty and calling
+// the slow path otherwise.  Generated code passes num_bits as a
+// constant, so each inlined call folds the checks, shifts, and byte
+// count down to one byte swap and write for its own width.
+
+static inline void
+unparse_endian_bits(bool big_endian_data, uint64_t integer, size_t num_bits, UState *ustate)
+{
+    const size_t num_bytes = num_bits / CHAR_BIT;
+
+    if (num_bits && num_bits % CHAR_BIT == 0 && !ustate->numUnwritBits)
+    {
+        // Big-endian bytes must start in the high end before the byte swap
+        if (big_endian_data)
+        {
+            integer = htobe64(integer << (sizeof(integer) * CHAR_BIT - num_bits));
+        }
+        else
+        {
+            integer = htole64(integer);
+        }
+        if (fwrite(&integer, 1, num_bytes, ustate->pu.stream) < num_bytes)
+        {
+            ustate->pu.error = eof_or_error(ustate->pu.stream);
+            return;
+        }
+        ustate->pu.bitPos0b += num_bits;
+    }
+    else
+    {
+        unparse_endian_uint64(big_endian_data, integer, num_bits, ustate);
+    }
+}
+
+// Unparse an unsigned integer of 1 to 64 bits at any bit position in
+// leastSignificantBitFirst bit order (slow path of inline LSBF
+// unparsers)
+
+extern void unparse_lsbf_slow(uint64_t number, size_t num_bits, UState *ustate);
+
+// Unparse big-endian and little-endian integers of num_bits bits in
+// mostSignificantBitFirst bit order
+
+static inline void
+unparse_be_bits(uint64_t integer, size_t num_bits, UState *ustate)
+{
+    unparse_endian_bits(true, integer, num_bits, ustate);
+}
+
+static inline void
+unparse_le_bits(uint64_t integer, size_t num_bits, UState *ustate)
+{
+    unparse_endian_bits(false, integer, num_bits, ustate);
+}
+
+// Unparse an integer of num_bits bits in leastSignificantBitFirst bit
+// order, which writes whole bytes the same way as little-endian data
+// when the fragment byte is empty and calls the slow path otherwise
+
+static inline void
+unparse_lsbf_bits(uint64_t integer, size_t num_bits, UState *ustate)
+{
+    if (num_bits % CHAR_BIT == 0 && !ustate->numUnwritBits)
+    {
+        unparse_endian_bits(false, integer, num_bits, ustate);
+    }
+    else
+    {
+        unparse_lsbf_slow(integer, num_bits, ustate);
+    }
+}
+
+// Define unparsers for binary booleans, real numbers, and integers as
+// static inline functions, instantiated once per type and bit/byte order
+
+#define UNPARSE_INTEGER(ENDIAN, TYPE)                                                                        \
+    static inline void unparse_##ENDIAN##_##TYPE(TYPE##_t number, size_t num_bits, UState *ustate)           \
+    {                                                                                                        \
+        unparse_##ENDIAN##_bits((uint64_t)number, num_bits, ustate);                                         \
+    }
+
+#define UNPARSE_REAL(ENDIAN, TYPE, BITS_TYPE)                                                                \
+    static inline void unparse_##ENDIAN##_##TYPE(TYPE number, size_t num_bits, UState *ustate)               \
+    {                                                                                                        \
+        BITS_TYPE bits;                                                                                      \
+        memcpy(&bits, &number, sizeof(bits));                                                                \
+        unparse_##ENDIAN##_bits(bits, num_bits, ustate);                                                     \
+    }
+
+#define UNPARSE_BOOL(ENDIAN)                                                                                 \
+    static inline void unparse_##ENDIAN##_bool(bool number, size_t num_bits, uint32_t true_rep,              \
+                                               uint32_t false_rep, UState *ustate)                           \
+    {                                                                                                        \
+        unparse_##ENDIAN##_bits(number ? true_rep : false_rep, num_bits, ustate);                            \
+    }
+
+#define UNPARSE_ENDIAN(ENDIAN)                                                                               \
+    UNPARSE_BOOL(ENDIAN)                                                                                     \
+    UNPARSE_REAL(ENDIAN, double, uint64_t)                                                                   \
+    UNPARSE_REAL(ENDIAN, float, uint32_t)                                                                    \
+    UNPARSE_INTEGER(ENDIAN, int16)                                                                           \
+    UNPARSE_INTEGER(ENDIAN, int32)                                                                           \
+    UNPARSE_INTEGER(ENDIAN, int64)                                                                           \
+    UNPARSE_INTEGER(ENDIAN, int8)                                                                            \
+    UNPARSE_INTEGER(ENDIAN, uint16)                                                                          \
+    UNPARSE_INTEGER(ENDIAN, uint32)                                                                          \
+    UNPARSE_INTEGER(ENDIAN, uint64)                                                                          \
+    UNPARSE_INTEGER(ENDIAN, uint8)
+
+// Unparse binary booleans, real numbers, and integers (unparse_be_bool,
+// unparse_be_double, unparse_be_float, ..., unparse_le_uint8, ...,
+// unparse_lsbf_uint8)
+
+UNPARSE_ENDIAN(be)
+UNPARSE_ENDIAN(le)
+UNPARSE_ENDIAN(lsbf)
 
-extern void unparse_be_bool(bool number, size_t num_bits, uint32_t true_rep, uint32_t false_rep,
-                            UState *ustate);
-extern void unparse_be_double(double number, size_t num_bits, UState *ustate);
-extern void unparse_be_float(float number, size_t num_bits, UState *ustate);
-
-extern void unparse_be_int16(int16_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_int32(int32_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_int64(int64_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_int8(int8_t number, size_t num_bits, UState *ustate);
-
-extern void unparse_be_uint16(uint16_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_uint32(uint32_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_uint64(uint64_t number, size_t num_bits, UState *ustate);
-extern void unparse_be_uint8(uint8_t number, size_t num_bits, UState *ustate);
+// Unparse opaque bytes from hexBinary field
 
-extern void unparse_le_bool(bool number, size_t num_bits, uint32_t true_rep, uint32_t false_rep,
-                            UState *ustate);
-extern void unparse_le_double(double number, size_t num_bits, UState *ustate);
-extern void unparse_le_float(float number, size_t num_bits, UState *ustate);
+extern void unparse_hexBinary(HexBinary hexBinary, UState *ustate);
+extern void unparse_lsbf_hexBinary(HexBinary hexBinary, UState *ustate);
 
-extern void unparse_le_int16(int16_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_int32(int32_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_int64(int64_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_int8(int8_t number, size_t num_bits, UState *ustate);
+// Unparse a delimited text element from a string, writing an escape
+// character before any delimiter or escape character in its text
 
-extern void unparse_le_uint16(uint16_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_uint32(uint32_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_uint64(uint64_t number, size_t num_bits, UState *ustate);
-extern void unparse_le_uint8(uint8_t number, size_t num_bits, UState *ustate);
+extern void unparse_delimited_string(const String *string, const Delimiters *delimiters, UState *ustate);
 
-// Unparse opaque bytes from hexBinary field
+// Unparse an initiator, separator, or terminator
 
-extern void unparse_hexBinary(HexBinary hexBinary, UState *ustate);
+extern void unparse_delimiter(const char *delimiter, UState *ustate);
 
 // Unparse alignment bits up to alignmentInBits or end_bitPos0b
 
 extern void unparse_align_to(size_t alignmentInBits, const uint8_t fill_byte, UState *ustate);
 extern void unparse_alignment_bits(size_t end_bitPos0b, const uint8_t fill_byte, UState *ustate);
+extern void unparse_lsbf_align_to(size_t alignmentInBits, const uint8_t fill_byte, UState *ustate);
+extern void unparse_lsbf_alignment_bits(size_t end_bitPos0b, const uint8_t fill_byte, UState *ustate);
 
 // Flush the fragment byte if not done yet
 
@@ -19,10 +19,24 @@
 // clang-format off
 #include "validators.h"
 #include <stdbool.h>  // for bool, false, true
+#include <stdint.h>   // for uint64_t, int64_t, uint8_t
 #include <string.h>   // for memcmp
 #include "errors.h"   // for add_diagnostic, get_diagnostics, Error, Diagnostics, ERR_RESTR_ENUM, ERR_ARRAY_BOUNDS, ERR_RESTR_FIXED, ERR_RESTR_RANGE, Error::(anonymous)
 // clang-format on
 
+// Add a diagnostic to the state's own diagnostics, or to this thread's
+// diagnostics if the state doesn't have its own
+
+static void
+diagnose(const Error *error, ParserOrUnparserState *pu)
+{
+    if (!pu->diagnostics)
+    {
+        pu->diagnostics = get_diagnostics();
+    }
+    add_diagnostic(pu->diagnostics, error);
+}
+
 // Validate element's array count is within its array bounds
 
 void
@@ -49,11 +63,8 @@ validate_dfdl_assert(bool assertion, const char *expression, bool recoverable, P
     // which is printed later or an error which terminates processing now.
     if (!assertion && recoverable)
     {
-        Diagnostics *diagnostics = get_diagnostics();
         const Error error = {ERR_DFDL_ASSERT, {.s = expression}};
-
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+        diagnose(&error, pu);
     }
     else if (!assertion)
     {
@@ -71,18 +82,25 @@ validate_fixed_attribute(bool same, const char *element, ParserOrUnparserState *
     if (!same)
     {
         // Element is not same as its fixed attribute, so diagnose problem
-        Diagnostics *diagnostics = get_diagnostics();
         const Error error = {ERR_RESTR_FIXED, {.s = element}};
-
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+        diagnose(&error, pu);
     }
 }
 
+// Diagnose element's value not matching any enumeration value
+
+static void
+diagnose_enumeration(const char *element, ParserOrUnparserState *pu)
+{
+    const Error error = {ERR_RESTR_ENUM, {.s = element}};
+    diagnose(&error, pu);
+}
+
 // Validate element's value matches a floating point enumeration
+// (linear scan of enums in any order)
 
 void
-validate_floatpt_enumeration(double number, size_t num_enums, double enums[], const char *element,
+validate_floatpt_enumeration(double number, size_t num_enums, const double enums[], const char *element,
                              ParserOrUnparserState *pu)
 {
     bool match_found = false;
@@ -96,26 +114,62 @@ validate_floatpt_enumeration(double number, size_t num_enums, double enums[], co
     if (!match_found)
     {
         // Number does not match any enumeration, so diagnose problem
-        Diagnostics *diagnostics = get_diagnostics();
-        const Error error = {ERR_RESTR_ENUM, {.s = element}};
+        diagnose_enumeration(element, pu);
+    }
+}
 
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+// Validate element's value matches a floating point enumeration
+// (binary search of enums sorted in ascending order)
+
+void
+validate_floatpt_enumeration_sorted(double number, size_t num_enums, const double enums[],
+                                    const char *element, ParserOrUnparserState *pu)
+{
+    // Find first enumeration not less than number
+    size_t low = 0;
+    size_t high = num_enums;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (enums[middle] < number)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low == num_enums || enums[low] != number)
+    {
+        // Number does not match any enumeration, so diagnose problem
+        diagnose_enumeration(element, pu);
     }
 }
 
+// Compare two hexBinary values by length first and then by bytes
+
+static int
+compare_hexbinary(const HexBinary *a, const HexBinary *b)
+{
+    if (a->lengthInBytes != b->lengthInBytes)
+    {
+        return a->lengthInBytes < b->lengthInBytes ? -1 : 1;
+    }
+    return a->lengthInBytes ? memcmp(a->array, b->array, a->lengthInBytes) : 0;
+}
+
 // Validate element's value matches a hexBinary enumeration
 // (matches the actual data bytes, not the hex digit characters)
 
 void
-validate_hexbinary_enumeration(const HexBinary *hexBinary, size_t num_enums, HexBinary enums[],
+validate_hexbinary_enumeration(const HexBinary *hexBinary, size_t num_enums, const HexBinary enums[],
                                const char *element, ParserOrUnparserState *pu)
 {
     bool match_found = false;
     for (size_t i = 0; !match_found && i < num_enums; i++)
     {
-        bool same_lengths = hexBinary->lengthInBytes == enums[i].lengthInBytes;
-        if (same_lengths && memcmp(hexBinary->array, enums[i].array, hexBinary->lengthInBytes) == 0)
+        if (compare_hexbinary(hexBinary, &enums[i]) == 0)
         {
             match_found = true;
         }
@@ -123,18 +177,45 @@ validate_hexbinary_enumeration(const HexBinary *hexBinary, size_t num_enums, Hex
     if (!match_found)
     {
         // HexBinary does not match any enumeration value, so report error
-        Diagnostics *diagnostics = get_diagnostics();
-        const Error error = {ERR_RESTR_ENUM, {.s = element}};
+        diagnose_enumeration(element, pu);
+    }
+}
+
+// Validate element's value matches a hexBinary enumeration (binary
+// search of enums sorted by length first and then by bytes, so only
+// enumerations with the same length get their bytes compared)
 
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+void
+validate_hexbinary_enumeration_sorted(const HexBinary *hexBinary, size_t num_enums, const HexBinary enums[],
+                                      const char *element, ParserOrUnparserState *pu)
+{
+    // Find first enumeration not less than hexBinary
+    size_t low = 0;
+    size_t high = num_enums;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (compare_hexbinary(&enums[middle], hexBinary) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low == num_enums || compare_hexbinary(&enums[low], hexBinary) != 0)
+    {
+        // HexBinary does not match any enumeration value, so report error
+        diagnose_enumeration(element, pu);
     }
 }
 
 // Validate element's value matches an integer enumeration
+// (linear scan of enums in any order)
 
 void
-validate_integer_enumeration(int64_t number, size_t num_enums, int64_t enums[], const char *element,
+validate_integer_enumeration(int64_t number, size_t num_enums, const int64_t enums[], const char *element,
                              ParserOrUnparserState *pu)
 {
     bool match_found = false;
@@ -148,11 +229,54 @@ validate_integer_enumeration(int64_t number, size_t num_enums, int64_t enums[],
     if (!match_found)
     {
         // Number does not match any enumeration value, so report error
-        Diagnostics *diagnostics = get_diagnostics();
-        const Error error = {ERR_RESTR_ENUM, {.s = element}};
+        diagnose_enumeration(element, pu);
+    }
+}
+
+// Validate element's value matches an integer enumeration (bit test
+// of a bitset whose bit i is set if min_enum + i is an enumeration)
+
+void
+validate_integer_enumeration_bitset(int64_t number, int64_t min_enum, size_t num_bits, const uint8_t bitset[],
+                                    const char *element, ParserOrUnparserState *pu)
+{
+    // Subtract as unsigned so numbers below min_enum wrap around to
+    // offsets too large to be in the bitset
+    const uint64_t offset = (uint64_t)number - (uint64_t)min_enum;
+    const bool match_found = offset < num_bits && ((bitset[offset / 8] >> (offset % 8)) & 1);
+    if (!match_found)
+    {
+        // Number does not match any enumeration value, so report error
+        diagnose_enumeration(element, pu);
+    }
+}
 
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+// Validate element's value matches an integer enumeration
+// (binary search of enums sorted in ascending order)
+
+void
+validate_integer_enumeration_sorted(int64_t number, size_t num_enums, const int64_t enums[],
+                                    const char *element, ParserOrUnparserState *pu)
+{
+    // Find first enumeration not less than number
+    size_t low = 0;
+    size_t high = num_enums;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (enums[middle] < number)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low == num_enums || enums[low] != number)
+    {
+        // Number does not match any enumeration value, so report error
+        diagnose_enumeration(element, pu);
     }
 }
 
@@ -165,10 +289,7 @@ validate_schema_range(bool within_range, const char *element, ParserOrUnparserSt
     // is evaluated in generated code and the result passed here
     if (!within_range)
     {
-        Diagnostics *diagnostics = get_diagnostics();
         const Error error = {ERR_RESTR_RANGE, {.s = element}};
-
-        add_diagnostic(diagnostics, &error);
-        pu->diagnostics = diagnostics;
+        diagnose(&error, pu);
     }
 }
@@ -22,10 +22,16 @@
 // clang-format off
 #include <stdbool.h>  // for bool
 #include <stddef.h>   // for size_t
-#include <stdint.h>   // for int64_t
-#include "infoset.h"  // for ParserOrUnparserState
+#include <stdint.h>   // for int64_t, uint8_t
+#include "infoset.h"  // for ParserOrUnparserState, HexBinary
 // clang-format on
 
+// Generated code wraps every recoverable validation (fixed values,
+// enumerations, ranges, and recoverable asserts) in #ifndef
+// DAFFODIL_NO_VALIDATION, so compiling with -DDAFFODIL_NO_VALIDATION
+// builds an executable which never checks them.  Array bounds and
+// fatal asserts are checked either way.
+
 // Validate element's array count is within its array bounds
 
 extern void validate_array_bounds(const char *name, size_t count, size_t minOccurs, size_t maxOccurs,
@@ -41,20 +47,50 @@ extern void validate_dfdl_assert(bool assertion, const char *expression, bool re
 extern void validate_fixed_attribute(bool same, const char *element, ParserOrUnparserState *pu);
 
 // Validate element's value matches a floating point enumeration
+// (linear scan of enums in any order)
+
+extern void validate_floatpt_enumeration(double number, size_t num_enums, const double enums[],
+                                         const char *element, ParserOrUnparserState *pu);
+
+// Validate element's value matches a floating point enumeration
+// (binary search of enums sorted in ascending order)
 
-extern void validate_floatpt_enumeration(double number, size_t num_enums, double enums[], const char *element,
-                                         ParserOrUnparserState *pu);
+extern void validate_floatpt_enumeration_sorted(double number, size_t num_enums, const double enums[],
+                                                const char *element, ParserOrUnparserState *pu);
 
 // Validate element's value matches a hexBinary enumeration
+// (linear scan of enums in any order)
+
+extern void validate_hexbinary_enumeration(const HexBinary *hexBinary, size_t num_enums,
+                                           const HexBinary enums[], const char *element,
+                                           ParserOrUnparserState *pu);
 
-extern void validate_hexbinary_enumeration(const HexBinary *hexBinary, size_t num_enums, HexBinary enums[],
-                                           const char *element, ParserOrUnparserState *pu);
+// Validate element's value matches a hexBinary enumeration (binary
+// search of enums sorted by length first and then by bytes)
+
+extern void validate_hexbinary_enumeration_sorted(const HexBinary *hexBinary, size_t num_enums,
+                                                  const HexBinary enums[], const char *element,
+                                                  ParserOrUnparserState *pu);
 
 // Validate element's value matches an integer enumeration
+// (linear scan of enums in any order)
 
-extern void validate_integer_enumeration(int64_t number, size_t num_enums, int64_t enums[],
+extern void validate_integer_enumeration(int64_t number, size_t num_enums, const int64_t enums[],
                                          const char *element, ParserOrUnparserState *pu);
 
+// Validate element's value matches an integer enumeration (bit test
+// of a bitset whose bit i is set if min_enum + i is an enumeration)
+
+extern void validate_integer_enumeration_bitset(int64_t number, int64_t min_enum, size_t num_bits,
+                                                const uint8_t bitset[], const char *element,
+                                                ParserOrUnparserState *pu);
+
+// Validate element's value matches an integer enumeration
+// (binary search of enums sorted in ascending order)
+
+extern void validate_integer_enumeration_sorted(int64_t number, size_t num_enums, const int64_t enums[],
+                                                const char *element, ParserOrUnparserState *pu);
+
 // Validate element's value fits within its schema's allowed range
 
 extern void validate_schema_range(bool within_range, const char *element, ParserOrUnparserState *pu);
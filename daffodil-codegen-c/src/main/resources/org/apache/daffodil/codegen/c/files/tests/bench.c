@@ -0,0 +1,720 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// auto-maintained by iwyu
+// clang-format off
+#include <stdbool.h>      // for bool, false, true
+#include <stddef.h>       // for size_t, NULL
+#include <stdint.h>       // for uint64_t, uint8_t, int64_t, int16_t, int32_t, int8_t, uint16_t, uint32_t
+#include <stdio.h>        // for printf, fclose, fmemopen, snprintf, FILE
+#include <stdlib.h>       // for exit, EXIT_FAILURE
+#include <string.h>       // for memcpy, strstr
+#include <time.h>         // for clock_gettime, timespec, CLOCK_MONOTONIC
+#include "errors.h"       // for Diagnostics
+#include "infoset.h"      // for PState, UState, HexBinary, ParserOrUnparserState
+#include "parsers.h"      // for parse_be_bool, parse_be_double, parse_be_float, parse_be_int16, ...
+#include "unparsers.h"    // for unparse_be_bool, unparse_be_double, unparse_be_float, unparse_be_int16, ...
+#include "validators.h"   // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, ...
+// clang-format on
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>    // for __rdtsc
+#endif
+
+// Micro-benchmarks for the bit-level primitives in libruntime.  Each
+// benchmark parses or unparses a 64 KiB memory buffer as back-to-back
+// fields (or runs a validator on a table of values) several times and
+// keeps its fastest run.  Results are printed as CSV rows:
+//
+//   benchmark,size,bit_offset,ops,ns_per_op,cycles_per_op
+//
+// where size is a field's width in bits (or the number of enums for a
+// validator), bit_offset is the bit position of the first field, and
+// cycles_per_op (time stamp counter cycles) is empty where no cycle
+// counter is available.  An optional argument runs only benchmarks
+// whose names contain it.
+
+// BENCH_BUFFER_SIZE - size of memory buffer read or written by each run
+
+#define BENCH_BUFFER_SIZE 65536
+
+// BENCH_RUNS - number of runs of each benchmark (fastest one is kept)
+
+#define BENCH_RUNS 5
+
+// BENCH_VALUES - number of values passed to validators in each run
+
+#define BENCH_VALUES 65536
+
+// Bench - one benchmark's name, parameters, and primitives
+
+typedef struct Bench Bench;
+
+typedef uint64_t (*ParseField)(size_t num_bits, PState *pstate);
+typedef void (*UnparseField)(uint64_t bits, size_t num_bits, UState *ustate);
+
+struct Bench
+{
+    char name[64];        // name of benchmark
+    size_t size;          // field's width in bits or number of enums
+    size_t bit_offset;    // bit position of first field
+    ParseField parse;     // parses one field (parse benchmarks only)
+    UnparseField unparse; // unparses one field (unparse benchmarks only)
+};
+
+// Measurement - fastest run of a benchmark
+
+typedef struct Measurement
+{
+    size_t ops;      // number of operations in run
+    uint64_t ns;     // nanoseconds taken by run
+    uint64_t cycles; // time stamp counter cycles taken by run
+} Measurement;
+
+// Input data, output buffer, and sink which keeps results alive
+
+static uint8_t input_data[BENCH_BUFFER_SIZE];
+static uint8_t output_data[BENCH_BUFFER_SIZE];
+static volatile uint64_t sink;
+
+// Read a monotonic clock in nanoseconds
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Read the time stamp counter, or 0 if there is none
+
+static uint64_t
+now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Start and stop timing a run
+
+static void
+start_timer(Measurement *m)
+{
+    m->cycles = now_cycles();
+    m->ns = now_ns();
+}
+
+static void
+stop_timer(Measurement *m, size_t ops)
+{
+    m->ns = now_ns() - m->ns;
+    m->cycles = now_cycles() - m->cycles;
+    m->ops = ops;
+}
+
+// Stop all benchmarks if a primitive failed
+
+static void
+exit_on_error(const Bench *bench, const ParserOrUnparserState *pu)
+{
+    if (pu->error)
+    {
+        fprintf(stderr, "%s: unexpected error %u\n", bench->name, (unsigned)pu->error->code);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Wrap each parse and unparse primitive to take and return its value's
+// bits as a uint64_t so we can call all of them the same way
+
+#define PARSE_FIELD(TYPE, FUNC)                                                                              \
+    static uint64_t bench_##FUNC(size_t num_bits, PState *pstate)                                            \
+    {                                                                                                        \
+        TYPE number = 0;                                                                                     \
+        FUNC(&number, num_bits, pstate);                                                                     \
+        uint64_t bits = 0;                                                                                   \
+        memcpy(&bits, &number, sizeof(number));                                                              \
+        return bits;                                                                                         \
+    }
+
+#define UNPARSE_FIELD(TYPE, FUNC)                                                                            \
+    static void bench_##FUNC(uint64_t bits, size_t num_bits, UState *ustate)                                 \
+    {                                                                                                        \
+        TYPE number = 0;                                                                                     \
+        memcpy(&number, &bits, sizeof(number));                                                              \
+        FUNC(number, num_bits, ustate);                                                                      \
+    }
+
+#define FIELD(TYPE, ENDIAN)                                                                                  \
+    PARSE_FIELD(TYPE##_t, parse_##ENDIAN##_##TYPE)                                                           \
+    UNPARSE_FIELD(TYPE##_t, unparse_##ENDIAN##_##TYPE)
+
+FIELD(int16, be)
+FIELD(int32, be)
+FIELD(int64, be)
+FIELD(int8, be)
+FIELD(uint16, be)
+FIELD(uint32, be)
+FIELD(uint64, be)
+FIELD(uint8, be)
+FIELD(int16, le)
+FIELD(int32, le)
+FIELD(int64, le)
+FIELD(int8, le)
+FIELD(uint16, le)
+FIELD(uint32, le)
+FIELD(uint64, le)
+FIELD(uint8, le)
+FIELD(int16, lsbf)
+FIELD(int32, lsbf)
+FIELD(int64, lsbf)
+FIELD(int8, lsbf)
+FIELD(uint16, lsbf)
+FIELD(uint32, lsbf)
+FIELD(uint64, lsbf)
+FIELD(uint8, lsbf)
+PARSE_FIELD(double, parse_be_double)
+PARSE_FIELD(float, parse_be_float)
+PARSE_FIELD(double, parse_le_double)
+PARSE_FIELD(float, parse_le_float)
+PARSE_FIELD(double, parse_lsbf_double)
+PARSE_FIELD(float, parse_lsbf_float)
+UNPARSE_FIELD(double, unparse_be_double)
+UNPARSE_FIELD(float, unparse_be_float)
+UNPARSE_FIELD(double, unparse_le_double)
+UNPARSE_FIELD(float, unparse_le_float)
+UNPARSE_FIELD(double, unparse_lsbf_double)
+UNPARSE_FIELD(float, unparse_lsbf_float)
+
+// Booleans need true and false representations too (an absent true
+// representation lets any bits other than false_rep parse as true)
+
+static uint64_t
+bench_parse_be_bool(size_t num_bits, PState *pstate)
+{
+    bool number = false;
+    parse_be_bool(&number, num_bits, -1, 0, pstate);
+    return number;
+}
+
+static uint64_t
+bench_parse_le_bool(size_t num_bits, PState *pstate)
+{
+    bool number = false;
+    parse_le_bool(&number, num_bits, -1, 0, pstate);
+    return number;
+}
+
+static uint64_t
+bench_parse_lsbf_bool(size_t num_bits, PState *pstate)
+{
+    bool number = false;
+    parse_lsbf_bool(&number, num_bits, -1, 0, pstate);
+    return number;
+}
+
+static void
+bench_unparse_be_bool(uint64_t bits, size_t num_bits, UState *ustate)
+{
+    unparse_be_bool(bits & 1, num_bits, 1, 0, ustate);
+}
+
+static void
+bench_unparse_le_bool(uint64_t bits, size_t num_bits, UState *ustate)
+{
+    unparse_le_bool(bits & 1, num_bits, 1, 0, ustate);
+}
+
+static void
+bench_unparse_lsbf_bool(uint64_t bits, size_t num_bits, UState *ustate)
+{
+    unparse_lsbf_bool(bits & 1, num_bits, 1, 0, ustate);
+}
+
+// Parse or unparse fields back to back after skipping bit_offset bits
+
+static void
+run_parse(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(input_data, sizeof(input_data), "r");
+    PState pstate = {.pu = {.stream = stream}};
+    uint8_t skip = 0;
+    if (bench->bit_offset)
+    {
+        parse_be_uint8(&skip, bench->bit_offset, &pstate);
+    }
+
+    const size_t ops = (sizeof(input_data) - 1) * 8 / bench->size;
+    uint64_t sum = 0;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        sum += bench->parse(bench->size, &pstate);
+    }
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &pstate.pu);
+    sink = sum;
+    fclose(stream);
+}
+
+static void
+run_unparse(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(output_data, sizeof(output_data), "w");
+    UState ustate = {.pu = {.stream = stream}};
+    if (bench->bit_offset)
+    {
+        unparse_be_uint8(0, bench->bit_offset, &ustate);
+    }
+
+    const size_t num_values = sizeof(input_data) / sizeof(uint64_t);
+    const size_t ops = (sizeof(output_data) - 1) * 8 / bench->size;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, input_data + (i % num_values) * sizeof(bits), sizeof(bits));
+        bench->unparse(bits, bench->size, &ustate);
+    }
+    flush_fragment_byte(0, &ustate);
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &ustate.pu);
+    fclose(stream);
+}
+
+// Parse or unparse hexBinary fields of size / 8 bytes back to back
+
+static void
+run_parse_hexBinary(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(input_data, sizeof(input_data), "r");
+    PState pstate = {.pu = {.stream = stream}};
+    HexBinary hexBinary = {output_data, bench->size / 8, false};
+
+    const size_t ops = sizeof(input_data) * 8 / bench->size;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        parse_hexBinary(&hexBinary, &pstate);
+    }
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &pstate.pu);
+    fclose(stream);
+}
+
+static void
+run_unparse_hexBinary(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(output_data, sizeof(output_data), "w");
+    UState ustate = {.pu = {.stream = stream}};
+    HexBinary hexBinary = {input_data, bench->size / 8, false};
+
+    const size_t ops = sizeof(output_data) * 8 / bench->size;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        unparse_hexBinary(hexBinary, &ustate);
+    }
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &ustate.pu);
+    fclose(stream);
+}
+
+// Parse or unparse alignment fill of size bits back to back after
+// skipping bit_offset bits
+
+static void
+run_parse_alignment(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(input_data, sizeof(input_data), "r");
+    PState pstate = {.pu = {.stream = stream}};
+    uint8_t skip = 0;
+    if (bench->bit_offset)
+    {
+        parse_be_uint8(&skip, bench->bit_offset, &pstate);
+    }
+
+    const size_t ops = (sizeof(input_data) - 1) * 8 / bench->size;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        parse_alignment_bits(pstate.pu.bitPos0b + bench->size, &pstate);
+    }
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &pstate.pu);
+    fclose(stream);
+}
+
+static void
+run_unparse_alignment(const Bench *bench, Measurement *m)
+{
+    FILE *stream = fmemopen(output_data, sizeof(output_data), "w");
+    UState ustate = {.pu = {.stream = stream}};
+    if (bench->bit_offset)
+    {
+        unparse_be_uint8(0, bench->bit_offset, &ustate);
+    }
+
+    const size_t ops = (sizeof(output_data) - 1) * 8 / bench->size;
+    start_timer(m);
+    for (size_t i = 0; i < ops; i++)
+    {
+        unparse_alignment_bits(ustate.pu.bitPos0b + bench->size, 0, &ustate);
+    }
+    flush_fragment_byte(0, &ustate);
+    stop_timer(m, ops);
+
+    exit_on_error(bench, &ustate.pu);
+    fclose(stream);
+}
+
+// Validate values of which half match one of size enums (0 to size -
+// 1) and half don't, so each run measures both hits and misses
+
+static void
+run_integer_enumeration(const Bench *bench, Measurement *m, int kind)
+{
+    static int64_t enums[256];
+    static uint8_t bitset[256 / 8];
+    for (size_t i = 0; i < bench->size; i++)
+    {
+        enums[i] = (int64_t)i;
+        bitset[i / 8] |= (uint8_t)(1 << (i % 8));
+    }
+
+    Diagnostics diagnostics = {0};
+    ParserOrUnparserState pu = {.diagnostics = &diagnostics};
+    start_timer(m);
+    for (size_t i = 0; i < BENCH_VALUES; i++)
+    {
+        const int64_t number = (int64_t)(i % (2 * bench->size));
+        switch (kind)
+        {
+        case 0:
+            validate_integer_enumeration(number, bench->size, enums, bench->name, &pu);
+            break;
+        case 1:
+            validate_integer_enumeration_sorted(number, bench->size, enums, bench->name, &pu);
+            break;
+        default:
+            validate_integer_enumeration_bitset(number, 0, bench->size, bitset, bench->name, &pu);
+            break;
+        }
+    }
+    stop_timer(m, BENCH_VALUES);
+    sink = diagnostics.total;
+}
+
+static void
+run_validate_integer_enumeration(const Bench *bench, Measurement *m)
+{
+    run_integer_enumeration(bench, m, 0);
+}
+
+static void
+run_validate_integer_enumeration_sorted(const Bench *bench, Measurement *m)
+{
+    run_integer_enumeration(bench, m, 1);
+}
+
+static void
+run_validate_integer_enumeration_bitset(const Bench *bench, Measurement *m)
+{
+    run_integer_enumeration(bench, m, 2);
+}
+
+static void
+run_floatpt_enumeration(const Bench *bench, Measurement *m, bool sorted)
+{
+    static double enums[256];
+    for (size_t i = 0; i < bench->size; i++)
+    {
+        enums[i] = (double)i;
+    }
+
+    Diagnostics diagnostics = {0};
+    ParserOrUnparserState pu = {.diagnostics = &diagnostics};
+    start_timer(m);
+    for (size_t i = 0; i < BENCH_VALUES; i++)
+    {
+        const double number = (double)(i % (2 * bench->size));
+        if (sorted)
+        {
+            validate_floatpt_enumeration_sorted(number, bench->size, enums, bench->name, &pu);
+        }
+        else
+        {
+            validate_floatpt_enumeration(number, bench->size, enums, bench->name, &pu);
+        }
+    }
+    stop_timer(m, BENCH_VALUES);
+    sink = diagnostics.total;
+}
+
+static void
+run_validate_floatpt_enumeration(const Bench *bench, Measurement *m)
+{
+    run_floatpt_enumeration(bench, m, false);
+}
+
+static void
+run_validate_floatpt_enumeration_sorted(const Bench *bench, Measurement *m)
+{
+    run_floatpt_enumeration(bench, m, true);
+}
+
+static void
+run_hexbinary_enumeration(const Bench *bench, Measurement *m, bool sorted)
+{
+    // Big-endian bytes of 0 to size - 1 are already sorted by bytes
+    static uint8_t bytes[256 * 2][2];
+    static HexBinary enums[256 * 2];
+    for (size_t i = 0; i < 2 * bench->size; i++)
+    {
+        bytes[i][0] = (uint8_t)(i >> 8);
+        bytes[i][1] = (uint8_t)i;
+        enums[i].array = bytes[i];
+        enums[i].lengthInBytes = 2;
+        enums[i].dynamic = false;
+    }
+
+    Diagnostics diagnostics = {0};
+    ParserOrUnparserState pu = {.diagnostics = &diagnostics};
+    start_timer(m);
+    for (size_t i = 0; i < BENCH_VALUES; i++)
+    {
+        const HexBinary *hexBinary = &enums[i % (2 * bench->size)];
+        if (sorted)
+        {
+            validate_hexbinary_enumeration_sorted(hexBinary, bench->size, enums, bench->name, &pu);
+        }
+        else
+        {
+            validate_hexbinary_enumeration(hexBinary, bench->size, enums, bench->name, &pu);
+        }
+    }
+    stop_timer(m, BENCH_VALUES);
+    sink = diagnostics.total;
+}
+
+static void
+run_validate_hexbinary_enumeration(const Bench *bench, Measurement *m)
+{
+    run_hexbinary_enumeration(bench, m, false);
+}
+
+static void
+run_validate_hexbinary_enumeration_sorted(const Bench *bench, Measurement *m)
+{
+    run_hexbinary_enumeration(bench, m, true);
+}
+
+// Validate array counts and ranges which pass half the time
+
+static void
+run_validate_array_bounds(const Bench *bench, Measurement *m)
+{
+    ParserOrUnparserState pu = {0};
+    size_t errors = 0;
+    start_timer(m);
+    for (size_t i = 0; i < BENCH_VALUES; i++)
+    {
+        validate_array_bounds(bench->name, i % 2, 1, 1, &pu);
+        errors += pu.error != NULL;
+        pu.error = NULL;
+    }
+    stop_timer(m, BENCH_VALUES);
+    sink = errors;
+}
+
+static void
+run_validate_schema_range(const Bench *bench, Measurement *m)
+{
+    Diagnostics diagnostics = {0};
+    ParserOrUnparserState pu = {.diagnostics = &diagnostics};
+    start_timer(m);
+    for (size_t i = 0; i < BENCH_VALUES; i++)
+    {
+        validate_schema_range(i % 2, bench->name, &pu);
+    }
+    stop_timer(m, BENCH_VALUES);
+    sink = diagnostics.total;
+}
+
+// Run a benchmark several times and print its fastest run
+
+typedef void (*RunBench)(const Bench *bench, Measurement *m);
+
+static const char *name_filter;
+
+static void
+measure(RunBench run, const Bench *bench)
+{
+    if (name_filter && !strstr(bench->name, name_filter))
+    {
+        return;
+    }
+
+    Measurement best = {0, UINT64_MAX, 0};
+    for (size_t i = 0; i < BENCH_RUNS; i++)
+    {
+        Measurement m = {0, 0, 0};
+        run(bench, &m);
+        if (m.ns < best.ns)
+        {
+            best = m;
+        }
+    }
+
+    printf("%s,%zu,%zu,%zu,%.3f,", bench->name, bench->size, bench->bit_offset, best.ops,
+           (double)best.ns / (double)best.ops);
+    if (best.cycles)
+    {
+        printf("%.3f", (double)best.cycles / (double)best.ops);
+    }
+    printf("\n");
+}
+
+// Describe each binary number primitive with its width in bits
+
+typedef struct Field
+{
+    const char *type;     // endianness and type in primitive's name
+    size_t num_bits;      // width of field in bits
+    ParseField parse;     // parses one field
+    UnparseField unparse; // unparses one field
+} Field;
+
+#define BENCH_FIELD(ENDIAN, TYPE, NUM_BITS)                                                                  \
+    {                                                                                                        \
+        #ENDIAN "_" #TYPE, NUM_BITS, bench_parse_##ENDIAN##_##TYPE, bench_unparse_##ENDIAN##_##TYPE          \
+    }
+
+static const Field fields[] = {
+    BENCH_FIELD(be, bool, 8),    BENCH_FIELD(be, bool, 32),  BENCH_FIELD(be, double, 64),
+    BENCH_FIELD(be, float, 32),  BENCH_FIELD(be, int16, 16), BENCH_FIELD(be, int32, 32),
+    BENCH_FIELD(be, int64, 64),  BENCH_FIELD(be, int8, 8),   BENCH_FIELD(be, uint16, 16),
+    BENCH_FIELD(be, uint32, 32), BENCH_FIELD(be, uint64, 64), BENCH_FIELD(be, uint8, 8),
+    BENCH_FIELD(le, bool, 8),    BENCH_FIELD(le, bool, 32),  BENCH_FIELD(le, double, 64),
+    BENCH_FIELD(le, float, 32),  BENCH_FIELD(le, int16, 16), BENCH_FIELD(le, int32, 32),
+    BENCH_FIELD(le, int64, 64),  BENCH_FIELD(le, int8, 8),   BENCH_FIELD(le, uint16, 16),
+    BENCH_FIELD(le, uint32, 32), BENCH_FIELD(le, uint64, 64), BENCH_FIELD(le, uint8, 8),
+    BENCH_FIELD(lsbf, bool, 8),    BENCH_FIELD(lsbf, bool, 32),  BENCH_FIELD(lsbf, double, 64),
+    BENCH_FIELD(lsbf, float, 32),  BENCH_FIELD(lsbf, int16, 16), BENCH_FIELD(lsbf, int32, 32),
+    BENCH_FIELD(lsbf, int64, 64),  BENCH_FIELD(lsbf, int8, 8),   BENCH_FIELD(lsbf, uint16, 16),
+    BENCH_FIELD(lsbf, uint32, 32), BENCH_FIELD(lsbf, uint64, 64), BENCH_FIELD(lsbf, uint8, 8),
+};
+
+// Run all benchmarks (or those whose names contain argv[1])
+
+int
+main(int argc, char *argv[])
+{
+    name_filter = argc > 1 ? argv[1] : NULL;
+
+    // Fill input with reproducible pseudorandom bytes
+    uint32_t state = 2463534242;
+    for (size_t i = 0; i < sizeof(input_data); i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        input_data[i] = (uint8_t)state;
+    }
+
+    printf("benchmark,size,bit_offset,ops,ns_per_op,cycles_per_op\n");
+
+    // Binary numbers at every width and bit offset
+    Bench bench = {"", 0, 0, NULL, NULL};
+    for (size_t i = 0; i < sizeof(fields) / sizeof(*fields); i++)
+    {
+        bench.size = fields[i].num_bits;
+        bench.parse = fields[i].parse;
+        bench.unparse = fields[i].unparse;
+        for (bench.bit_offset = 0; bench.bit_offset < 8; bench.bit_offset++)
+        {
+            snprintf(bench.name, sizeof(bench.name), "parse_%s", fields[i].type);
+            measure(run_parse, &bench);
+            snprintf(bench.name, sizeof(bench.name), "unparse_%s", fields[i].type);
+            measure(run_unparse, &bench);
+        }
+    }
+
+    // HexBinary at several sizes
+    const size_t hexBinary_sizes[] = {1, 16, 256, 4096};
+    bench.bit_offset = 0;
+    for (size_t i = 0; i < sizeof(hexBinary_sizes) / sizeof(*hexBinary_sizes); i++)
+    {
+        bench.size = hexBinary_sizes[i] * 8;
+        snprintf(bench.name, sizeof(bench.name), "parse_hexBinary");
+        measure(run_parse_hexBinary, &bench);
+        snprintf(bench.name, sizeof(bench.name), "unparse_hexBinary");
+        measure(run_unparse_hexBinary, &bench);
+    }
+
+    // Alignment fill of several widths at every bit offset
+    const size_t fill_sizes[] = {1, 7, 8, 32, 8192};
+    for (size_t i = 0; i < sizeof(fill_sizes) / sizeof(*fill_sizes); i++)
+    {
+        bench.size = fill_sizes[i];
+        for (bench.bit_offset = 0; bench.bit_offset < 8; bench.bit_offset++)
+        {
+            snprintf(bench.name, sizeof(bench.name), "parse_alignment_bits");
+            measure(run_parse_alignment, &bench);
+            snprintf(bench.name, sizeof(bench.name), "unparse_alignment_bits");
+            measure(run_unparse_alignment, &bench);
+        }
+    }
+
+    // Validators with small and large numbers of enums
+    const size_t enum_sizes[] = {16, 256};
+    bench.bit_offset = 0;
+    for (size_t i = 0; i < sizeof(enum_sizes) / sizeof(*enum_sizes); i++)
+    {
+        bench.size = enum_sizes[i];
+        snprintf(bench.name, sizeof(bench.name), "validate_integer_enumeration");
+        measure(run_validate_integer_enumeration, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_integer_enumeration_sorted");
+        measure(run_validate_integer_enumeration_sorted, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_integer_enumeration_bitset");
+        measure(run_validate_integer_enumeration_bitset, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_floatpt_enumeration");
+        measure(run_validate_floatpt_enumeration, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_floatpt_enumeration_sorted");
+        measure(run_validate_floatpt_enumeration_sorted, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_hexbinary_enumeration");
+        measure(run_validate_hexbinary_enumeration, &bench);
+        snprintf(bench.name, sizeof(bench.name), "validate_hexbinary_enumeration_sorted");
+        measure(run_validate_hexbinary_enumeration_sorted, &bench);
+    }
+    bench.size = 1;
+    snprintf(bench.name, sizeof(bench.name), "validate_array_bounds");
+    measure(run_validate_array_bounds, &bench);
+    snprintf(bench.name, sizeof(bench.name), "validate_schema_range");
+    measure(run_validate_schema_range, &bench);
+
+    return 0;
+}
@@ -22,11 +22,12 @@
 #include <criterion/stats.h>       // for CR_CHECKERROR_1
 #include <stdbool.h>               // for false, true, bool
 #include <stdint.h>                // for uint32_t, uint8_t, int16_t, int32_t, int64_t, int8_t, uint16_t, uint64_t
-#include <stdio.h>                 // for fclose, NULL, fflush, fmemopen, open_memstream, FILE, size_t
+#include <stdio.h>                 // for fclose, NULL, fflush, fmemopen, fread, fwrite, open_memstream, rewind, tmpfile, FILE, size_t
 #include <stdlib.h>                // for free
-#include "infoset.h"               // for UState, PState, ParserOrUnparserState
-#include "parsers.h"               // for parse_be_bool, parse_le_bool, parse_be_int16, parse_be_int32, parse_be_int64, parse_be_int8, parse_be_uint16, parse_be_uint32, parse_be_uint64, parse_be_uint8, parse_le_int16, parse_le_int32, parse_le_int64, parse_le_int8, parse_le_uint16, parse_le_uint32, parse_le_uint64, parse_le_uint8
-#include "unparsers.h"             // for unparse_be_bool, unparse_le_bool, flush_fragment_byte, unparse_be_int16, unparse_be_int32, unparse_be_int64, unparse_be_int8, unparse_be_uint16, unparse_be_uint32, unparse_be_uint64, unparse_be_uint8, unparse_le_int16, unparse_le_int32, unparse_le_int64, unparse_le_int8, unparse_le_uint16, unparse_le_uint32, unparse_le_uint64, unparse_le_uint8
+#include <string.h>                // for memcmp
+#include "infoset.h"               // for UState, PState, ParserOrUnparserState, HexBinary
+#include "parsers.h"               // for parse_alignment_bits, parse_read_ahead, parse_skip_bits, parse_be_bool, parse_le_bool, parse_be_int16, parse_be_int32, parse_be_int64, parse_be_int8, parse_be_uint16, parse_be_uint32, parse_be_uint64, parse_be_uint8, parse_le_int16, parse_le_int32, parse_le_int64, parse_le_int8, parse_le_uint16, parse_le_uint32, parse_le_uint64, parse_le_uint8, parse_lsbf_bool, parse_lsbf_int16, parse_lsbf_int32, parse_lsbf_int64, parse_lsbf_int8, parse_lsbf_uint16, parse_lsbf_uint32, parse_lsbf_uint64, parse_lsbf_uint8
+#include "unparsers.h"             // for unparse_alignment_bits, unparse_be_bool, unparse_hexBinary, unparse_le_bool, flush_fragment_byte, unparse_be_int16, unparse_be_int32, unparse_be_int64, unparse_be_int8, unparse_be_uint16, unparse_be_uint32, unparse_be_uint64, unparse_be_uint8, unparse_le_int16, unparse_le_int32, unparse_le_int64, unparse_le_int8, unparse_le_uint16, unparse_le_uint32, unparse_le_uint64, unparse_le_uint8, unparse_lsbf_bool, unparse_lsbf_int16, unparse_lsbf_int32, unparse_lsbf_int64, unparse_lsbf_int8, unparse_lsbf_uint16, unparse_lsbf_uint32, unparse_lsbf_uint64, unparse_lsbf_uint8
 // clang-format on
 
 Test(bits, be_bool_24)
@@ -35,7 +36,7 @@ Test(bits, be_bool_24)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true24_rep = 076543210; // 0b_111_110_101_100_011_010_001_000
     uint32_t false_rep = 0;
 
@@ -54,7 +55,7 @@ Test(bits, be_bool_24)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true_rep correctly
     bool number = false;
@@ -76,7 +77,7 @@ Test(bits, be_bool_4)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true4_rep = 012; // 0b_1_010
     uint32_t false_rep = 015; // 0b_1_101
 
@@ -100,7 +101,7 @@ Test(bits, be_bool_4)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true4_rep, false_rep correctly
     bool number = false;
@@ -129,7 +130,7 @@ Test(bits, be_bool_7_7)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true7_rep = 0146; // 0b_1_100_110
     uint32_t false_rep = 0157; // 0b_1_101_111
 
@@ -164,7 +165,7 @@ Test(bits, be_bool_7_7)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true7_rep, false_rep correctly
     bool number = false;
@@ -193,7 +194,7 @@ Test(bits, be_bool_9_7)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true9_rep = 0747; // 0b_111_100_111
     uint32_t true7_rep = 0167; //   0b_1_110_111
     uint32_t false_rep = 0;
@@ -219,7 +220,7 @@ Test(bits, be_bool_9_7)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true9_rep, true7_rep correctly
     bool number = false;
@@ -248,7 +249,7 @@ Test(bits, be_signed_integers)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
 
     // Write 8 integers to the buffer
     const int8_t int1 = -1; // a signed 1-bit integer can only be 0 or -1
@@ -278,7 +279,7 @@ Test(bits, be_signed_integers)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Read 8 integers from the buffer
     int8_t tin1 = 0;
@@ -322,7 +323,7 @@ Test(bits, be_unsigned_integers)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
 
     // Write 8 integers to the buffer
     const uint8_t uint1 = 1; // an unsigned 1-bit integer can only be 0 or 1
@@ -352,7 +353,7 @@ Test(bits, be_unsigned_integers)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Read 8 integers from the buffer
     uint8_t tniu1 = 0;
@@ -396,7 +397,7 @@ Test(bits, le_bool_24)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true24_rep = 076543210; // 0b_111_110_101_100_011_010_001_000
     uint32_t false_rep = 0;
 
@@ -415,7 +416,7 @@ Test(bits, le_bool_24)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads 11111010, 11000100, 11001000
     bool number = false;
@@ -437,7 +438,7 @@ Test(bits, le_bool_4_4)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true4_rep = 012; // 0b_1_010
     uint32_t false_rep = 015; // 0b_1_101
 
@@ -461,7 +462,7 @@ Test(bits, le_bool_4_4)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true4_rep, false_rep correctly
     bool number = false;
@@ -490,7 +491,7 @@ Test(bits, le_bool_7_7)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true7_rep = 0146; // 0b_1_100_110
     uint32_t false_rep = 0157; // 0b_1_101_111
 
@@ -525,7 +526,7 @@ Test(bits, le_bool_7_7)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true7_rep, false_rep correctly
     bool number = false;
@@ -554,7 +555,7 @@ Test(bits, le_bool_9_7)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
     uint32_t true9_rep = 0747; // 0b_111_100_111
     uint32_t true7_rep = 0167; //   0b_1_110_111
     uint32_t false_rep = 0;
@@ -580,7 +581,7 @@ Test(bits, le_bool_9_7)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Verify that pstate reads true9_rep, true7_rep correctly
     bool number = false;
@@ -609,7 +610,7 @@ Test(bits, le_signed_integers)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
 
     // Write 8 integers to the buffer
     const int8_t int1 = -1; // a signed 1-bit integer can only be 0 or -1
@@ -639,7 +640,7 @@ Test(bits, le_signed_integers)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Read 8 integers from the buffer
     int8_t tin1 = 0;
@@ -683,7 +684,7 @@ Test(bits, le_unsigned_integers)
     char *buffer = NULL;
     size_t size = 0;
     FILE *stream = open_memstream(&buffer, &size);
-    UState ustate = {{stream, 0, NULL, NULL}, 0, 0};
+    UState ustate = {.pu = {.stream = stream}};
 
     // Write 8 integers to the buffer
     const uint8_t uint1 = 1; // an unsigned 1-bit integer can only be 0 or 1
@@ -713,7 +714,7 @@ Test(bits, le_unsigned_integers)
     // Reopen stream for reading from same dynamic buffer
     fclose(stream);
     stream = fmemopen(buffer, size, "r");
-    PState pstate = {{stream, 0, NULL, NULL}, 0, 0};
+    PState pstate = {.pu = {.stream = stream}};
 
     // Read 8 integers from the buffer
     uint8_t tniu1 = 0;
@@ -750,3 +751,339 @@ Test(bits, le_unsigned_integers)
     fclose(stream);
     free(buffer);
 }
+
+Test(bits, lsbf_bool_7_7)
+{
+    // Open memory stream for writing to dynamic buffer
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    UState ustate = {.pu = {.stream = stream}};
+    uint32_t true7_rep = 0146; // 0b_1_100_110
+    uint32_t false_rep = 0157; // 0b_1_101_111
+
+    // Verify that ustate writes 11100110 (bits fill each byte from its low end)
+    unparse_lsbf_bool(true, 7, true7_rep, false_rep, &ustate);
+    fflush(stream);
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 7), "ustate should advance 7 bits");
+    cr_expect(eq(u8, ustate.unwritBits, 0146), "ustate should hold 0b_01_100_110");
+    cr_expect(eq(u8, ustate.numUnwritBits, 7), "ustate should buffer 7 bits");
+    cr_expect(eq(sz, size, 0), "stream should be empty");
+    unparse_lsbf_bool(false, 7, true7_rep, false_rep, &ustate);
+    fflush(stream);
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 14), "ustate should advance 7 bits");
+    cr_expect(eq(u8, ustate.unwritBits, 067), "ustate should hold 0b_00_110_111");
+    cr_expect(eq(u8, ustate.numUnwritBits, 6), "ustate should buffer 6 bits");
+    cr_expect(eq(sz, size, 1), "stream should have 1 byte");
+    cr_expect(eq(u8, buffer[0], 0346), "stream should hold 0b_11_100_110");
+
+    // Verify that flushing ustate writes 00110111 (fill bits go in high end)
+    const uint8_t fill_byte = '\0';
+    flush_fragment_byte(fill_byte, &ustate);
+    fflush(stream);
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 20), "ustate should advance 6 bits");
+    cr_expect(eq(u8, ustate.numUnwritBits, 0), "ustate should be empty");
+    cr_expect(eq(sz, size, 2), "stream should have 2 bytes");
+    cr_expect(eq(u8, buffer[1], 067), "stream should hold 0b_00_110_111");
+
+    // Reopen stream for reading from same dynamic buffer
+    fclose(stream);
+    stream = fmemopen(buffer, size, "r");
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Verify that pstate reads true7_rep, false_rep correctly
+    bool number = false;
+    parse_lsbf_bool(&number, 7, true7_rep, false_rep, &pstate);
+    cr_expect(eq(int, number, true), "boolean number should be true");
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 7), "pstate should advance 7 bits");
+    cr_expect(eq(u8, pstate.unreadBits, 01), "pstate should hold 0b_00_000_001");
+    cr_expect(eq(u8, pstate.numUnreadBits, 1), "pstate should buffer 1 bit");
+    number = true;
+    parse_lsbf_bool(&number, 7, true7_rep, false_rep, &pstate);
+    cr_expect(eq(int, number, false), "boolean number should be false");
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 14), "pstate should advance 7 bits");
+    cr_expect(eq(u8, pstate.unreadBits, 0), "pstate should hold 0b_00_000_000");
+    cr_expect(eq(u8, pstate.numUnreadBits, 2), "pstate should buffer 2 bits");
+
+    // Close stream and free dynamic buffer
+    fclose(stream);
+    free(buffer);
+}
+
+Test(bits, lsbf_signed_integers)
+{
+    // Open memory stream for writing to dynamic buffer
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    UState ustate = {.pu = {.stream = stream}};
+
+    // Write 8 integers to the buffer
+    const int8_t int1 = -1; // a signed 1-bit integer can only be 0 or -1
+    const int8_t int7 = 7;
+    const int16_t int9 = -9;
+    const int16_t int15 = 15;
+    const int32_t int17 = -17;
+    const int32_t int31 = 31;
+    const int64_t int33 = -33;
+    const int64_t int63 = 63;
+    unparse_lsbf_int8(int1, 1, &ustate);
+    unparse_lsbf_int8(int7, 7, &ustate);
+    unparse_lsbf_int16(int9, 9, &ustate);
+    unparse_lsbf_int16(int15, 15, &ustate);
+    unparse_lsbf_int32(int17, 17, &ustate);
+    unparse_lsbf_int32(int31, 31, &ustate);
+    unparse_lsbf_int64(int33, 33, &ustate);
+    unparse_lsbf_int64(int63, 63, &ustate);
+    fflush(stream);
+
+    // Verify that these 8 integers were packed into 176 bits as expected
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 176), "ustate should advance 176 bits");
+    cr_expect(eq(sz, size, 22), "stream should have 22 bytes");
+    cr_expect(eq(u8, ustate.numUnwritBits, 0), "ustate should be empty");
+
+    // Reopen stream for reading from same dynamic buffer
+    fclose(stream);
+    stream = fmemopen(buffer, size, "r");
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Read 8 integers from the buffer
+    int8_t tin1 = 0;
+    int8_t tin7 = 0;
+    int16_t tin9 = 0;
+    int16_t tin15 = 0;
+    int32_t tin17 = 0;
+    int32_t tin31 = 0;
+    int64_t tin33 = 0;
+    int64_t tin63 = 0;
+    parse_lsbf_int8(&tin1, 1, &pstate);
+    parse_lsbf_int8(&tin7, 7, &pstate);
+    parse_lsbf_int16(&tin9, 9, &pstate);
+    parse_lsbf_int16(&tin15, 15, &pstate);
+    parse_lsbf_int32(&tin17, 17, &pstate);
+    parse_lsbf_int32(&tin31, 31, &pstate);
+    parse_lsbf_int64(&tin33, 33, &pstate);
+    parse_lsbf_int64(&tin63, 63, &pstate);
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 176), "pstate should advance 176 bits");
+    cr_expect(eq(u8, pstate.numUnreadBits, 0), "pstate should be empty");
+
+    // Verify that these 8 integers are the same integers originally written
+    cr_expect(eq(i8, int1, tin1), "numbers should be the same");
+    cr_expect(eq(i8, int7, tin7), "numbers should be the same");
+    cr_expect(eq(i16, int9, tin9), "numbers should be the same");
+    cr_expect(eq(i16, int15, tin15), "numbers should be the same");
+    cr_expect(eq(i32, int17, tin17), "numbers should be the same");
+    cr_expect(eq(i32, int31, tin31), "numbers should be the same");
+    cr_expect(eq(i64, int33, tin33), "numbers should be the same");
+    cr_expect(eq(i64, int63, tin63), "numbers should be the same");
+
+    // Close stream and free dynamic buffer
+    fclose(stream);
+    free(buffer);
+}
+
+Test(bits, lsbf_unsigned_integers)
+{
+    // Open memory stream for writing to dynamic buffer
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    UState ustate = {.pu = {.stream = stream}};
+
+    // Write 8 integers to the buffer
+    const uint8_t uint1 = 1; // an unsigned 1-bit integer can only be 0 or 1
+    const uint8_t uint7 = 7;
+    const uint16_t uint9 = 9;
+    const uint16_t uint15 = 15;
+    const uint32_t uint17 = 17;
+    const uint32_t uint31 = 31;
+    const uint64_t uint33 = 33;
+    const uint64_t uint63 = 63;
+    unparse_lsbf_uint8(uint1, 1, &ustate);
+    unparse_lsbf_uint8(uint7, 7, &ustate);
+    unparse_lsbf_uint16(uint9, 9, &ustate);
+    unparse_lsbf_uint16(uint15, 15, &ustate);
+    unparse_lsbf_uint32(uint17, 17, &ustate);
+    unparse_lsbf_uint32(uint31, 31, &ustate);
+    unparse_lsbf_uint64(uint33, 33, &ustate);
+    unparse_lsbf_uint64(uint63, 63, &ustate);
+    fflush(stream);
+
+    // Verify that these 8 integers were packed into 176 bits as expected
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 176), "ustate should advance 176 bits");
+    cr_expect(eq(sz, size, 22), "stream should have 22 bytes");
+    cr_expect(eq(u8, ustate.numUnwritBits, 0), "ustate should be empty");
+
+    // Reopen stream for reading from same dynamic buffer
+    fclose(stream);
+    stream = fmemopen(buffer, size, "r");
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Read 8 integers from the buffer
+    uint8_t tniu1 = 0;
+    uint8_t tniu7 = 0;
+    uint16_t tniu9 = 0;
+    uint16_t tniu15 = 0;
+    uint32_t tniu17 = 0;
+    uint32_t tniu31 = 0;
+    uint64_t tniu33 = 0;
+    uint64_t tniu63 = 0;
+    parse_lsbf_uint8(&tniu1, 1, &pstate);
+    parse_lsbf_uint8(&tniu7, 7, &pstate);
+    parse_lsbf_uint16(&tniu9, 9, &pstate);
+    parse_lsbf_uint16(&tniu15, 15, &pstate);
+    parse_lsbf_uint32(&tniu17, 17, &pstate);
+    parse_lsbf_uint32(&tniu31, 31, &pstate);
+    parse_lsbf_uint64(&tniu33, 33, &pstate);
+    parse_lsbf_uint64(&tniu63, 63, &pstate);
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 176), "pstate should advance 176 bits");
+    cr_expect(eq(u8, pstate.numUnreadBits, 0), "pstate should be empty");
+
+    // Verify that these 8 integers are the same integers originally written
+    cr_expect(eq(u8, uint1, tniu1), "numbers should be the same");
+    cr_expect(eq(u8, uint7, tniu7), "numbers should be the same");
+    cr_expect(eq(u16, uint9, tniu9), "numbers should be the same");
+    cr_expect(eq(u16, uint15, tniu15), "numbers should be the same");
+    cr_expect(eq(u32, uint17, tniu17), "numbers should be the same");
+    cr_expect(eq(u32, uint31, tniu31), "numbers should be the same");
+    cr_expect(eq(u64, uint33, tniu33), "numbers should be the same");
+    cr_expect(eq(u64, uint63, tniu63), "numbers should be the same");
+
+    // Close stream and free dynamic buffer
+    fclose(stream);
+    free(buffer);
+}
+
+Test(bits, alignment_bits_5000)
+{
+    // Open memory stream for writing to dynamic buffer
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    UState ustate = {.pu = {.stream = stream}};
+    const uint8_t fill_byte = 0245; // 0b_10_100_101
+
+    // Verify that ustate writes 3 bits, 5000 bytes of fill bits, and 5 bits
+    unparse_be_uint8(05, 3, &ustate);
+    unparse_alignment_bits(5000 * 8 + 3, fill_byte, &ustate);
+    unparse_be_uint8(06, 5, &ustate);
+    fflush(stream);
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, 5001 * 8), "ustate should advance 5001 bytes");
+    cr_expect(eq(u8, ustate.numUnwritBits, 0), "ustate should be empty");
+    cr_expect(eq(sz, size, 5001), "stream should have 5001 bytes");
+    cr_expect(eq(u8, buffer[0], 0264), "stream should hold 0b_10_110_100");
+    cr_expect(eq(u8, buffer[4999], 0264), "stream should hold 0b_10_110_100");
+    cr_expect(eq(u8, buffer[5000], 0246), "stream should hold 0b_10_100_110");
+
+    // Reopen stream for reading from same dynamic buffer
+    fclose(stream);
+    stream = fmemopen(buffer, size, "r");
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Verify that pstate skips the fill bits and reads the numbers correctly
+    uint8_t number = 0;
+    parse_be_uint8(&number, 3, &pstate);
+    cr_expect(eq(u8, number, 05), "number should be 5");
+    parse_alignment_bits(5000 * 8 + 3, &pstate);
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 5000 * 8 + 3), "pstate should skip 5000 bytes");
+    cr_expect(eq(u8, pstate.numUnreadBits, 5), "pstate should buffer 5 bits");
+    parse_be_uint8(&number, 5, &pstate);
+    cr_expect(eq(u8, number, 06), "number should be 6");
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+
+    // Verify that pstate can't skip past the end of the stream
+    parse_alignment_bits(5002 * 8, &pstate);
+    cr_expect(ne(ptr, (void *)pstate.pu.error, 0), "pstate should have an error");
+
+    // Close stream and free dynamic buffer
+    fclose(stream);
+    free(buffer);
+}
+
+Test(bits, hexBinary_direct)
+{
+    // Open temporary file for writing through its file descriptor
+    FILE *stream = tmpfile();
+    UState ustate = {.pu = {.stream = stream}};
+    static uint8_t payload[100000];
+    for (size_t i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+    HexBinary hexBinary = {payload, sizeof(payload), false};
+
+    // Verify that ustate keeps a large payload in order between numbers
+    unparse_be_uint8(07, 8, &ustate);
+    unparse_hexBinary(hexBinary, &ustate);
+    unparse_be_uint8(011, 8, &ustate);
+    fflush(stream);
+    cr_expect(eq(ptr, (void *)ustate.pu.error, 0), "ustate should have no error");
+    cr_expect(eq(sz, ustate.pu.bitPos0b, (sizeof(payload) + 2) * 8), "ustate should advance 100002 bytes");
+
+    // Read back the temporary file
+    static uint8_t buffer[sizeof(payload) + 3];
+    rewind(stream);
+    size_t size = fread(buffer, 1, sizeof(buffer), stream);
+    cr_expect(eq(sz, size, sizeof(payload) + 2), "stream should have 100002 bytes");
+    cr_expect(eq(u8, buffer[0], 07), "stream should hold 7 first");
+    cr_expect(eq(int, memcmp(buffer + 1, payload, sizeof(payload)), 0), "stream should hold payload");
+    cr_expect(eq(u8, buffer[sizeof(payload) + 1], 011), "stream should hold 9 last");
+
+    // Close stream
+    fclose(stream);
+}
+
+Test(bits, missing_bytes)
+{
+    // Open memory stream for reading 3 bytes
+    uint8_t buffer[3] = {1, 2, 3};
+    FILE *stream = fmemopen(buffer, sizeof(buffer), "r");
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Verify that pstate remembers how many more bytes a read ahead needed
+    parse_read_ahead(64, &pstate);
+    cr_expect(ne(ptr, (void *)pstate.pu.error, 0), "pstate should have an error");
+    cr_expect(eq(sz, pstate.numMissingBytes, 5), "pstate should miss 5 bytes");
+
+    // Verify that pstate remembers how many more bytes a number needed
+    uint32_t number = 0;
+    pstate.pu.error = NULL;
+    parse_be_uint32(&number, 32, &pstate);
+    cr_expect(ne(ptr, (void *)pstate.pu.error, 0), "pstate should have an error");
+    cr_expect(eq(sz, pstate.numMissingBytes, 1), "pstate should miss 1 byte");
+
+    // Close stream
+    fclose(stream);
+}
+
+Test(bits, skip_missing_bytes)
+{
+    // Open temporary file holding 5000 bytes
+    FILE *stream = tmpfile();
+    static uint8_t buffer[5000];
+    fwrite(buffer, 1, sizeof(buffer), stream);
+    rewind(stream);
+    PState pstate = {.pu = {.stream = stream}};
+
+    // Verify that pstate remembers exactly how many more bytes a skip
+    // needed even when it seeks past the end of the file
+    parse_skip_bits(3, &pstate);
+    parse_skip_bits(6000 * 8, &pstate);
+    cr_expect(ne(ptr, (void *)pstate.pu.error, 0), "pstate should have an error");
+    cr_expect(eq(sz, pstate.numMissingBytes, 1001), "pstate should miss 1001 bytes");
+    cr_expect(eq(sz, pstate.pu.bitPos0b, 3), "pstate should not advance");
+
+    // Close stream
+    fclose(stream);
+}
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include <criterion/criterion.h>   // for CR_VA_HEAD_HELPER_2, CRI_IF_DEFINED_NODEFER_2, CR_VA_TAIL_HELPER_2, CRITERION_APPLY_3, CRI_IF_DEFINED_2, CR_VA_HEAD_HELPER_1, Test
+#include <criterion/new/assert.h>  // for CRI_ASSERT_OP_VAR_TAGGED, CRI_ASSERT_OP_TYPE_TAGGED, CRI_ASSERT_OP_VAL_TAGGED, CRI_ASSERT_TEST_TAG_sz, cr_user_sz_tostr, CRI_ASSERT_OP_MKNODE_TAGGED, CRI_ASSERT_OP_NAME_TAGGED, CRI_ASSERT_TEST_TAG_ptr, cr_user_ptr_tostr, CRI_ASSERT_MKLIST_2, CRI_ASSERT_SPECIFIER_OP1, CRI_ASSERT_SPECIFIER_eq, CRI_ASSERT_SPEC_OPLEN_2, CRI_ASSERT_TEST_SPECIFIER_eq, cr_expect, CRI_ASSERT_TYPE_TAG_ID_sz, cr_user_sz_eq, CRI_ASSERT_TYPE_TAG_sz, CRI_ASSERT_TYPE_TAG_ID_ptr, cr_user_ptr_eq, CRI_ASSERT_TEST_TAGC_sz, CRI_ASSERT_TYPE_TAG_ptr, CRI_ASSERT_TEST_TAGC_ptr, CRI_ASSERT_TEST_TAG_int, cr_user_int_tostr, CRI_ASSERT_TYPE_TAG_ID_int, cr_user_int_eq, CRI_ASSERT_TYPE_TAG_int, CRI_ASSERT_SPECIFIER_ne, CRI_ASSERT_TEST_SPECIFIER_ne, cr_user_ptr_ne, cr_user_sz_ne
+#include <criterion/stats.h>       // for CR_CHECKERROR_1
+#include <pthread.h>               // for pthread_create, pthread_join, pthread_t
+#include <stdbool.h>               // for false, true
+#include <stdio.h>                 // for fclose, open_memstream, NULL, FILE, size_t
+#include <stdlib.h>                // for free
+#include <string.h>                // for strstr, strlen
+#include "errors.h"                // for Diagnostics, Error, add_diagnostic, get_diagnostics, merge_diagnostics, print_diagnostics, reset_diagnostics, ERR_RESTR_ENUM, ERR_RESTR_RANGE, LIMIT_DIAGNOSTICS
+// clang-format on
+
+// Print diagnostics to a dynamic buffer which caller must free
+
+static char *
+print_to_buffer(const Diagnostics *diagnostics)
+{
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    print_diagnostics(diagnostics, stream);
+    fclose(stream);
+    return buffer;
+}
+
+Test(errors, aggregate_diagnostics)
+{
+    static Diagnostics diagnostics;
+    const Error range_a = {ERR_RESTR_RANGE, {.s = "a"}};
+    const Error range_b = {ERR_RESTR_RANGE, {.s = "b"}};
+    const Error enum_a = {ERR_RESTR_ENUM, {.s = "a"}};
+
+    // Verify that diagnostics keep the first errors in full detail
+    for (size_t i = 0; i < LIMIT_DIAGNOSTICS; i++)
+    {
+        cr_expect(add_diagnostic(&diagnostics, i % 2 ? &range_b : &range_a),
+                  "diagnostics should keep first errors");
+    }
+    cr_expect(eq(sz, diagnostics.length, LIMIT_DIAGNOSTICS), "diagnostics should be full");
+
+    // Verify that diagnostics only count errors after they're full
+    for (size_t i = 0; i < 50; i++)
+    {
+        cr_expect(!add_diagnostic(&diagnostics, &range_a), "diagnostics should count errors");
+    }
+    cr_expect(!add_diagnostic(&diagnostics, &enum_a), "diagnostics should count errors");
+    cr_expect(!add_diagnostic(&diagnostics, NULL), "diagnostics should ignore no error");
+    cr_expect(eq(sz, diagnostics.length, LIMIT_DIAGNOSTICS), "diagnostics should stay full");
+    cr_expect(eq(sz, diagnostics.total, LIMIT_DIAGNOSTICS + 51), "diagnostics should count all errors");
+
+    // Verify that diagnostics summarize the errors they didn't keep and
+    // count all errors by code and element
+    char *buffer = print_to_buffer(&diagnostics);
+    cr_expect(ne(ptr, strstr(buffer, "51 more diagnostics not shown"), NULL), "should summarize errors");
+    cr_expect(ne(ptr, strstr(buffer, "     100 x value of element 'a' is outside"), NULL),
+              "should count range errors of a");
+    cr_expect(ne(ptr, strstr(buffer, "      50 x value of element 'b' is outside"), NULL),
+              "should count range errors of b");
+    cr_expect(ne(ptr, strstr(buffer, "       1 x value of element 'a' does not match any"), NULL),
+              "should count enumeration errors of a");
+    free(buffer);
+}
+
+Test(errors, reset_diagnostics)
+{
+    static Diagnostics diagnostics;
+    const Error range_a = {ERR_RESTR_RANGE, {.s = "a"}};
+    const Error range_b = {ERR_RESTR_RANGE, {.s = "b"}};
+
+    // Verify that a reset removes all errors
+    for (size_t i = 0; i < LIMIT_DIAGNOSTICS + 10; i++)
+    {
+        add_diagnostic(&diagnostics, &range_a);
+    }
+    reset_diagnostics(&diagnostics);
+    cr_expect(eq(sz, diagnostics.length, 0), "diagnostics should be empty");
+    cr_expect(eq(sz, diagnostics.total, 0), "diagnostics should have no errors");
+    char *buffer = print_to_buffer(&diagnostics);
+    cr_expect(eq(sz, strlen(buffer), 0), "diagnostics should print nothing");
+    free(buffer);
+
+    // Verify that counts start over after a reset
+    for (size_t i = 0; i < LIMIT_DIAGNOSTICS; i++)
+    {
+        add_diagnostic(&diagnostics, &range_b);
+    }
+    add_diagnostic(&diagnostics, &range_b);
+    cr_expect(eq(sz, diagnostics.total, LIMIT_DIAGNOSTICS + 1), "diagnostics should count new errors");
+    buffer = print_to_buffer(&diagnostics);
+    cr_expect(ne(ptr, strstr(buffer, "1 more diagnostics not shown"), NULL), "should summarize new errors");
+    cr_expect(ne(ptr, strstr(buffer, "     101 x value of element 'b' is outside"), NULL),
+              "should count new errors of b");
+    cr_expect(eq(ptr, strstr(buffer, "element 'a'"), NULL), "should not count old errors of a");
+    free(buffer);
+}
+
+Test(errors, merge_diagnostics)
+{
+    static Diagnostics diagnostics;
+    static Diagnostics from;
+    const Error range_a = {ERR_RESTR_RANGE, {.s = "a"}};
+    const Error range_b = {ERR_RESTR_RANGE, {.s = "b"}};
+
+    // Verify that merging adds errors kept in full detail and errors
+    // only counted
+    add_diagnostic(&diagnostics, &range_a);
+    for (size_t i = 0; i < LIMIT_DIAGNOSTICS + 10; i++)
+    {
+        add_diagnostic(&from, i % 2 ? &range_b : &range_a);
+    }
+    merge_diagnostics(&diagnostics, &from);
+    cr_expect(eq(sz, diagnostics.length, LIMIT_DIAGNOSTICS), "diagnostics should be full");
+    cr_expect(eq(sz, diagnostics.total, LIMIT_DIAGNOSTICS + 11), "diagnostics should count all errors");
+    char *buffer = print_to_buffer(&diagnostics);
+    cr_expect(ne(ptr, strstr(buffer, "11 more diagnostics not shown"), NULL), "should summarize errors");
+    cr_expect(ne(ptr, strstr(buffer, "      56 x value of element 'a' is outside"), NULL),
+              "should count range errors of a");
+    cr_expect(ne(ptr, strstr(buffer, "      55 x value of element 'b' is outside"), NULL),
+              "should count range errors of b");
+    free(buffer);
+
+    // Verify that merging no diagnostics changes nothing
+    reset_diagnostics(&from);
+    merge_diagnostics(&diagnostics, &from);
+    merge_diagnostics(&diagnostics, NULL);
+    cr_expect(eq(sz, diagnostics.total, LIMIT_DIAGNOSTICS + 11), "diagnostics should keep their errors");
+}
+
+// Add a diagnostic to the calling thread's diagnostics and return them
+
+static void *
+diagnose_in_thread(void *arg)
+{
+    (void)arg;
+    const Error range_a = {ERR_RESTR_RANGE, {.s = "a"}};
+    Diagnostics *diagnostics = get_diagnostics();
+    add_diagnostic(diagnostics, &range_a);
+    return diagnostics;
+}
+
+Test(errors, thread_diagnostics)
+{
+    // Verify that each thread gets its own diagnostics
+    Diagnostics *diagnostics = get_diagnostics();
+    reset_diagnostics(diagnostics);
+    pthread_t thread;
+    void *other = NULL;
+    cr_expect(eq(int, pthread_create(&thread, NULL, diagnose_in_thread, NULL), 0), "thread should start");
+    pthread_join(thread, &other);
+    cr_expect(ne(ptr, other, (void *)diagnostics), "thread should have its own diagnostics");
+    cr_expect(eq(sz, diagnostics->total, 0), "thread should not add to our diagnostics");
+}
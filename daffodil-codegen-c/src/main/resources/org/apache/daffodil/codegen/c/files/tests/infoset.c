@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include <criterion/criterion.h>   // for CR_VA_HEAD_HELPER_2, CRI_IF_DEFINED_NODEFER_2, CR_VA_TAIL_HELPER_2, CRITERION_APPLY_3, CRI_IF_DEFINED_2, CR_VA_HEAD_HELPER_1, Test
+#include <criterion/new/assert.h>  // for CRI_ASSERT_OP_VAR_TAGGED, CRI_ASSERT_OP_TYPE_TAGGED, CRI_ASSERT_OP_VAL_TAGGED, CRI_ASSERT_TEST_TAG_sz, cr_user_sz_tostr, CRI_ASSERT_OP_MKNODE_TAGGED, CRI_ASSERT_OP_NAME_TAGGED, CRI_ASSERT_TEST_TAG_ptr, cr_user_ptr_tostr, CRI_ASSERT_MKLIST_2, CRI_ASSERT_SPECIFIER_OP1, CRI_ASSERT_SPECIFIER_eq, CRI_ASSERT_SPEC_OPLEN_2, CRI_ASSERT_TEST_SPECIFIER_eq, cr_expect, CRI_ASSERT_TYPE_TAG_ID_sz, cr_user_sz_eq, CRI_ASSERT_TYPE_TAG_sz, CRI_ASSERT_TYPE_TAG_ID_ptr, cr_user_ptr_eq, CRI_ASSERT_TYPE_TAG_ptr
+#include <criterion/stats.h>       // for CR_CHECKERROR_1
+#include <stddef.h>                // for offsetof, size_t, NULL
+#include <stdlib.h>                // for malloc
+#include "infoset.h"               // for switch_choice, InfosetBase, ERD, HexBinary, String, CHOICE, COMPLEX, PRIMITIVE_HEXBINARY, PRIMITIVE_STRING
+// clang-format on
+
+// Choice element whose branches hold a dynamic hexBinary and a string
+// in the same union like a generated choice element's branches
+
+typedef struct bytes_
+{
+    InfosetBase _base;
+    HexBinary bytes;
+} bytes_;
+
+typedef struct text_
+{
+    InfosetBase _base;
+    String text;
+} text_;
+
+typedef struct choice_
+{
+    InfosetBase _base;
+    size_t _choice;
+    union
+    {
+        bytes_ bytes;
+        text_ text;
+    };
+} choice_;
+
+static const ERD bytes_value_ERD = {
+    {NULL, "bytes", NULL}, PRIMITIVE_HEXBINARY, 0, NULL, NULL, NULL, NULL, {NULL},
+};
+
+static const ERD text_value_ERD = {
+    {NULL, "text", NULL}, PRIMITIVE_STRING, 0, NULL, NULL, NULL, NULL, {NULL},
+};
+
+static const size_t bytes_childrenOffsets[1] = {offsetof(bytes_, bytes)};
+static const ERD *const bytes_childrenERDs[1] = {&bytes_value_ERD};
+static const ERD bytes_ERD = {
+    {NULL, "bytes", NULL}, COMPLEX, 1, bytes_childrenOffsets, bytes_childrenERDs, NULL, NULL, {NULL},
+};
+
+static const size_t text_childrenOffsets[1] = {offsetof(text_, text)};
+static const ERD *const text_childrenERDs[1] = {&text_value_ERD};
+static const ERD text_ERD = {
+    {NULL, "text", NULL}, COMPLEX, 1, text_childrenOffsets, text_childrenERDs, NULL, NULL, {NULL},
+};
+
+static const ERD _choice_ERD = {
+    {NULL, "_choice", NULL}, CHOICE, 0, NULL, NULL, NULL, NULL, {NULL},
+};
+
+static const size_t choice_childrenOffsets[3] = {
+    offsetof(choice_, _choice),
+    offsetof(choice_, bytes),
+    offsetof(choice_, text),
+};
+static const ERD *const choice_childrenERDs[3] = {&_choice_ERD, &bytes_ERD, &text_ERD};
+static const ERD choice_ERD = {
+    {NULL, "choice", NULL}, COMPLEX, 2, choice_childrenOffsets, choice_childrenERDs, NULL, NULL, {NULL},
+};
+
+Test(infoset, switch_choice)
+{
+    choice_ instance = {{&choice_ERD, NULL}, 0, {{{NULL, NULL}, {NULL, 0, false}}}};
+
+    // Verify that the first switch starts the branch from zeroed storage
+    switch_choice(&instance._base, &instance._choice, 1, sizeof(instance));
+    cr_expect(eq(sz, instance._choice, 1), "choice should hold the bytes branch");
+    instance.bytes._base.erd = &bytes_ERD;
+    instance.bytes.bytes.dynamic = true;
+    instance.bytes.bytes.array = malloc(8);
+    instance.bytes.bytes.lengthInBytes = 8;
+
+    // Verify that staying on the same branch keeps its storage
+    void *array = instance.bytes.bytes.array;
+    switch_choice(&instance._base, &instance._choice, 1, sizeof(instance));
+    cr_expect(eq(ptr, instance.bytes.bytes.array, array), "bytes branch should keep its storage");
+    cr_expect(eq(sz, instance.bytes.bytes.lengthInBytes, 8), "bytes branch should keep its length");
+
+    // Verify that switching frees the old branch's storage and gives
+    // the new branch none of the old branch's bytes as its pointers
+    switch_choice(&instance._base, &instance._choice, 2, sizeof(instance));
+    cr_expect(eq(sz, instance._choice, 2), "choice should hold the text branch");
+    cr_expect(eq(ptr, instance.text.text.chars, NULL), "text branch should have no characters");
+    cr_expect(eq(sz, instance.text.text.length, 0), "text branch should be empty");
+    cr_expect(eq(sz, instance.text.text.capacity, 0), "text branch should have no capacity");
+
+    // Verify that switching back gives the old branch no storage either
+    instance.text._base.erd = &text_ERD;
+    switch_choice(&instance._base, &instance._choice, 1, sizeof(instance));
+    cr_expect(eq(ptr, instance.bytes.bytes.array, NULL), "bytes branch should have no array");
+    cr_expect(eq(sz, instance.bytes.bytes.lengthInBytes, 0), "bytes branch should be empty");
+}
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include <criterion/criterion.h>   // for CR_VA_HEAD_HELPER_2, CRI_IF_DEFINED_NODEFER_2, CR_VA_TAIL_HELPER_2, CRITERION_APPLY_3, CRI_IF_DEFINED_2, CR_VA_HEAD_HELPER_1, Test
+#include <criterion/new/assert.h>  // for CRI_ASSERT_OP_VAR_TAGGED, CRI_ASSERT_OP_TYPE_TAGGED, CRI_ASSERT_OP_VAL_TAGGED, CRI_ASSERT_TEST_TAG_sz, cr_user_sz_tostr, CRI_ASSERT_OP_MKNODE_TAGGED, CRI_ASSERT_OP_NAME_TAGGED, CRI_ASSERT_TEST_TAG_int, cr_user_int_tostr, CRI_ASSERT_TEST_TAG_u64, cr_user_u64_tostr, CRI_ASSERT_TEST_TAG_ptr, cr_user_ptr_tostr, CRI_ASSERT_MKLIST_2, CRI_ASSERT_SPECIFIER_OP1, CRI_ASSERT_SPECIFIER_eq, CRI_ASSERT_SPEC_OPLEN_2, CRI_ASSERT_TEST_SPECIFIER_eq, cr_expect, CRI_ASSERT_TYPE_TAG_ID_sz, cr_user_sz_eq, CRI_ASSERT_TYPE_TAG_sz, CRI_ASSERT_TYPE_TAG_ID_int, cr_user_int_eq, CRI_ASSERT_TYPE_TAG_int, CRI_ASSERT_TYPE_TAG_ID_u64, cr_user_u64_eq, CRI_ASSERT_TYPE_TAG_u64, CRI_ASSERT_TYPE_TAG_ID_ptr, cr_user_ptr_eq, CRI_ASSERT_TYPE_TAG_ptr, CRI_ASSERT_SPECIFIER_ne, CRI_ASSERT_TEST_SPECIFIER_ne, cr_user_ptr_ne
+#include <criterion/stats.h>       // for CR_CHECKERROR_1
+#include <stdint.h>                // for uint64_t
+#include <stdio.h>                 // for fclose, open_memstream, NULL, FILE, size_t
+#include <stdlib.h>                // for free
+#include <string.h>                // for strstr
+#include "errors.h"                // for LIMIT_PROFILE_ELEMENTS
+#include "infoset.h"               // for ERD, ParserOrUnparserState, ARRAY, COMPLEX, PRIMITIVE_INT32
+#include "profiler.h"              // for ProfileTable, ProfileEntry, ProfileSample, add_profile, get_profile, print_profile, profile_enter, profile_exit, profile_field
+// clang-format on
+
+static const ERD record_ERD = {{NULL, "record", NULL}, COMPLEX, 0, NULL, NULL, NULL, NULL, {NULL}};
+static const ERD child_ERD = {{NULL, "child", NULL}, COMPLEX, 0, NULL, NULL, NULL, NULL, {NULL}};
+static const ERD field_ERD = {{NULL, "field", NULL}, PRIMITIVE_INT32, 0, NULL, NULL, NULL, NULL, {NULL}};
+static const ERD stray_ERD = {{NULL, "stray", NULL}, PRIMITIVE_INT32, 0, NULL, NULL, NULL, NULL, {NULL}};
+static const ERD items_ERD = {{NULL, "items", NULL}, ARRAY, 0, NULL, NULL, NULL, NULL, {NULL}};
+
+// Find an element's entry in a table without claiming a free entry
+
+static const ProfileEntry *
+lookup(const ProfileTable *table, const ERD *erd)
+{
+    for (size_t i = 0; i < LIMIT_PROFILE_ELEMENTS; i++)
+    {
+        if (table->entries[i].erd == erd) return &table->entries[i];
+    }
+    return NULL;
+}
+
+Test(profiler, sample_elements)
+{
+    ParserOrUnparserState pu = {NULL, 0, NULL, NULL};
+    ProfileSample record;
+    ProfileSample child;
+
+    // Sample a record whose simple field occurs before and after a
+    // complex child, plus a field outside any sampled function
+    profile_field(&stray_ERD);
+    profile_enter(&record, &record_ERD, &pu);
+    pu.bitPos0b += 8;
+    profile_field(&field_ERD);
+    profile_enter(&child, &child_ERD, &pu);
+    pu.bitPos0b += 16;
+    profile_exit(&child);
+    pu.bitPos0b += 4;
+    profile_field(&field_ERD);
+    profile_exit(&record);
+
+    // Verify that each element gets its calls and bits
+    const ProfileTable *profile = get_profile();
+    const ProfileEntry *recordEntry = lookup(profile, &record_ERD);
+    const ProfileEntry *childEntry = lookup(profile, &child_ERD);
+    const ProfileEntry *fieldEntry = lookup(profile, &field_ERD);
+    cr_expect(ne(ptr, (void *)recordEntry, NULL), "record should be sampled");
+    cr_expect(ne(ptr, (void *)childEntry, NULL), "child should be sampled");
+    cr_expect(ne(ptr, (void *)fieldEntry, NULL), "field should be sampled");
+    cr_expect(eq(ptr, (void *)lookup(profile, &stray_ERD), NULL), "stray field should not be sampled");
+    if (!recordEntry || !childEntry || !fieldEntry) return;
+    cr_expect(eq(u64, recordEntry->calls, 1), "record should be called once");
+    cr_expect(eq(u64, recordEntry->bits, 28), "record should span all bits");
+    cr_expect(eq(u64, childEntry->calls, 1), "child should be called once");
+    cr_expect(eq(u64, childEntry->bits, 16), "child should span its bits");
+    cr_expect(eq(u64, fieldEntry->calls, 2), "field should be sampled twice");
+    cr_expect(eq(u64, fieldEntry->bits, 12), "field should span bits outside the child");
+
+    // Verify that the record's own cycles leave out its nested elements
+    cr_expect(eq(u64, fieldEntry->selfCycles, fieldEntry->cycles), "field should nest nothing");
+    cr_expect(eq(u64, recordEntry->selfCycles + childEntry->cycles + fieldEntry->cycles, recordEntry->cycles),
+              "record's own cycles should leave out its nested elements");
+}
+
+Test(profiler, add_profile)
+{
+    static ProfileTable table;
+    static ProfileTable sum;
+
+    // Verify that adding a table twice adds each entry's samples twice
+    table.entries[3] = (ProfileEntry){&field_ERD, 2, 64, 100, 60};
+    table.entries[7] = (ProfileEntry){&items_ERD, 1, 128, 50, 50};
+    table.count = 2;
+    table.dropped = 1;
+    add_profile(&sum, &table);
+    add_profile(&sum, &table);
+    const ProfileEntry *entry = lookup(&sum, &field_ERD);
+    cr_expect(ne(ptr, (void *)entry, NULL), "sum should have the field's entry");
+    if (entry)
+    {
+        cr_expect(eq(u64, entry->calls, 4), "sum should add calls");
+        cr_expect(eq(u64, entry->bits, 128), "sum should add bits");
+        cr_expect(eq(u64, entry->cycles, 200), "sum should add cycles");
+        cr_expect(eq(u64, entry->selfCycles, 120), "sum should add self cycles");
+    }
+    cr_expect(eq(sz, sum.count, 2), "sum should have one entry per element");
+    cr_expect(eq(u64, sum.dropped, 2), "sum should add dropped samples");
+}
+
+Test(profiler, full_profile)
+{
+    static const ERD erds[LIMIT_PROFILE_ELEMENTS + 1];
+    static ProfileTable table;
+    static ProfileTable extra;
+    static ProfileTable sum;
+
+    // Verify that a full table finds the entries it has and drops the
+    // samples of elements which find no free entry
+    for (size_t i = 0; i < LIMIT_PROFILE_ELEMENTS; i++)
+    {
+        table.entries[i] = (ProfileEntry){&erds[i], 1, 8, 10, 10};
+    }
+    table.count = LIMIT_PROFILE_ELEMENTS;
+    extra.entries[0] = (ProfileEntry){&erds[LIMIT_PROFILE_ELEMENTS], 3, 24, 30, 30};
+    extra.entries[1] = (ProfileEntry){&erds[0], 1, 8, 10, 10};
+    extra.count = 2;
+    add_profile(&sum, &table);
+    add_profile(&sum, &extra);
+    cr_expect(eq(sz, sum.count, LIMIT_PROFILE_ELEMENTS), "sum should be full");
+    cr_expect(eq(u64, sum.dropped, 3), "sum should drop the extra element's samples");
+    const ProfileEntry *entry = lookup(&sum, &erds[0]);
+    cr_expect(ne(ptr, (void *)entry, NULL), "sum should have the first element's entry");
+    if (entry)
+    {
+        cr_expect(eq(u64, entry->calls, 2), "full sum should still add calls");
+    }
+}
+
+Test(profiler, print_profile)
+{
+    static ProfileTable table;
+    char *buffer = NULL;
+    size_t size = 0;
+
+    // Verify that elements print with most self cycles first, arrays
+    // print with [], and dropped samples get reported
+    table.entries[9] = (ProfileEntry){&items_ERD, 1, 64, 400, 100};
+    table.entries[2] = (ProfileEntry){&field_ERD, 3, 96, 300, 300};
+    table.count = 2;
+    table.dropped = 4;
+    FILE *stream = open_memstream(&buffer, &size);
+    print_profile(&table, stream);
+    fclose(stream);
+    const char *field = strstr(buffer, "field ");
+    const char *items = strstr(buffer, "items[] ");
+    cr_expect(ne(ptr, (void *)field, NULL), "should print the field");
+    cr_expect(ne(ptr, (void *)items, NULL), "should print the array with []");
+    cr_expect(eq(int, field && items && field < items, 1), "should print most self cycles first");
+    cr_expect(ne(ptr, strstr(buffer, " 75.00%"), NULL), "should print the field's share");
+    cr_expect(ne(ptr, strstr(buffer, " 25.00%"), NULL), "should print the array's share");
+    cr_expect(ne(ptr, strstr(buffer, "(4 samples dropped"), NULL), "should report dropped samples");
+    free(buffer);
+}
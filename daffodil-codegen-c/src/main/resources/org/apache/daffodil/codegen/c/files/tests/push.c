@@ -0,0 +1,357 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// auto-maintained by iwyu
+// clang-format off
+#include <criterion/criterion.h>   // for CR_VA_HEAD_HELPER_2, CRI_IF_DEFINED_NODEFER_2, CR_VA_TAIL_HELPER_2, CRITERION_APPLY_3, CRI_IF_DEFINED_2, CR_VA_HEAD_HELPER_1, Test
+#include <criterion/new/assert.h>  // for CRI_ASSERT_OP_VAR_TAGGED, CRI_ASSERT_OP_TYPE_TAGGED, CRI_ASSERT_OP_VAL_TAGGED, CRI_ASSERT_TEST_TAG_int, cr_user_int_tostr, CRI_ASSERT_OP_MKNODE_TAGGED, CRI_ASSERT_OP_NAME_TAGGED, CRI_ASSERT_TEST_TAG_sz, cr_user_sz_tostr, CRI_ASSERT_MKLIST_2, CRI_ASSERT_SPECIFIER_OP1, CRI_ASSERT_SPECIFIER_eq, CRI_ASSERT_SPEC_OPLEN_2, CRI_ASSERT_TEST_SPECIFIER_eq, cr_expect, CRI_ASSERT_TYPE_TAG_ID_int, cr_user_int_eq, CRI_ASSERT_TYPE_TAG_int, CRI_ASSERT_TYPE_TAG_ID_sz, cr_user_sz_eq, CRI_ASSERT_TYPE_TAG_sz, CRI_ASSERT_TEST_TAG_u8, CRI_ASSERT_TEST_TAG_u16, CRI_ASSERT_TEST_TAG_i32, CRI_ASSERT_TEST_TAG_u32
+#include <criterion/stats.h>       // for CR_CHECKERROR_1
+#include <stdint.h>                // for uint8_t, int32_t, uint16_t, uint32_t
+#include <stdio.h>                 // for fclose, fmemopen, FILE, NULL, size_t
+#include <stdlib.h>                // for rand, srand
+#include <string.h>                // for memset
+#include "errors.h"                // for Error, Diagnostics, add_diagnostic, ERR_PUSH_UNALIGNED, ERR_RESTR_RANGE, ERR_STREAM_EOF
+#include "infoset.h"               // for InfosetBase, PState, ERD, String, Delimiters, parse_record, ERDParseSelf, COMPLEX
+#include "parsers.h"               // for parse_delimited_string, parse_delimiter, parse_lsbf_int32, parse_lsbf_skip_bits, parse_lsbf_uint16, parse_lsbf_uint32, parse_lsbf_uint8
+#include "push.h"                  // for PushParser, push_data, push_parse, push_end, push_free, PUSH_NEED_MORE_DATA, PUSH_RECORD, PUSH_END, PUSH_ERROR
+// clang-format on
+
+// Infoset which extras.c's get_infoset returns
+
+extern InfosetBase *test_infoset;
+
+// Record with the same fields as lsbf.dfdl.xsd's record (76 bits) and
+// the same filter as lsbf.tdml's lsbf_filterC test, optionally followed
+// by fill bits up to a byte boundary since push parsers need records
+// ending on byte boundaries
+
+typedef struct lsbf_
+{
+    InfosetBase _base;
+    uint8_t a;
+    uint8_t b;
+    uint16_t c;
+    int32_t d;
+    uint32_t e;
+    uint8_t f;
+} lsbf_;
+
+static void
+lsbf_parseFields(lsbf_ *instance, size_t num_fill_bits, PState *pstate)
+{
+    parse_lsbf_uint8(&instance->a, 3, pstate);
+    if (pstate->pu.error) return;
+    parse_lsbf_uint8(&instance->b, 5, pstate);
+    if (pstate->pu.error) return;
+    parse_lsbf_uint16(&instance->c, 12, pstate);
+    if (pstate->pu.error) return;
+    pstate->filteredOut = !(instance->c == 2748);
+    if (pstate->filteredOut)
+    {
+        parse_lsbf_skip_bits(56 + num_fill_bits, pstate);
+        return;
+    }
+    parse_lsbf_int32(&instance->d, 20, pstate);
+    if (pstate->pu.error) return;
+    parse_lsbf_uint32(&instance->e, 32, pstate);
+    if (pstate->pu.error) return;
+    parse_lsbf_uint8(&instance->f, 4, pstate);
+    if (pstate->pu.error) return;
+    parse_lsbf_skip_bits(num_fill_bits, pstate);
+}
+
+static void
+lsbf_parseSelf(lsbf_ *instance, PState *pstate)
+{
+    lsbf_parseFields(instance, 4, pstate);
+}
+
+static void
+lsbf76_parseSelf(lsbf_ *instance, PState *pstate)
+{
+    lsbf_parseFields(instance, 0, pstate);
+}
+
+static const ERD lsbf_ERD = {
+    {
+        "lsbf", // namedQName.prefix
+        "record", // namedQName.local
+        "urn:lsbf", // namedQName.ns
+    },
+    COMPLEX, // typeCode
+    0, // numChildren
+    NULL,
+    NULL,
+    (ERDParseSelf)&lsbf_parseSelf,
+    NULL,
+    {.initChoice = NULL}
+};
+
+static const ERD lsbf76_ERD = {
+    {
+        "lsbf", // namedQName.prefix
+        "record", // namedQName.local
+        "urn:lsbf", // namedQName.ns
+    },
+    COMPLEX, // typeCode
+    0, // numChildren
+    NULL,
+    NULL,
+    (ERDParseSelf)&lsbf76_parseSelf,
+    NULL,
+    {.initChoice = NULL}
+};
+
+static lsbf_ infoset;
+
+// Line of delimited text which counts how many times it gets parsed and
+// adds a validation diagnostic each time
+
+typedef struct line_
+{
+    InfosetBase _base;
+    String text;
+} line_;
+
+static const char *const newline_strings[1] = {"\n"};
+static const Delimiters newline = {"%NL;", newline_strings, 1, "\n", -1, -1};
+static size_t num_line_parses;
+
+static void
+line_parseSelf(line_ *instance, PState *pstate)
+{
+    static const Error error = {ERR_RESTR_RANGE, {.s = "text"}};
+    num_line_parses++;
+    add_diagnostic(pstate->pu.diagnostics, &error);
+    parse_delimited_string(&instance->text, &newline, pstate);
+    if (pstate->pu.error) return;
+    parse_delimiter(&newline, pstate);
+}
+
+static const ERD line_ERD = {
+    {
+        NULL, // namedQName.prefix
+        "line", // namedQName.local
+        NULL, // namedQName.ns
+    },
+    COMPLEX, // typeCode
+    0, // numChildren
+    NULL,
+    NULL,
+    (ERDParseSelf)&line_parseSelf,
+    NULL,
+    {.initChoice = NULL}
+};
+
+static line_ line;
+
+// lsbf.dat's record (which passes the filter) and the same record with
+// c = 1 (which doesn't), each filled up to 80 bits
+
+static const uint8_t passing[10] = {0x8d, 0xbc, 0x7a, 0xfc, 0xfc, 0x00, 0x5e, 0xd0, 0xb2, 0x09};
+static const uint8_t filtered[10] = {0x8d, 0x01, 0x70, 0xfc, 0xfc, 0x00, 0x5e, 0xd0, 0xb2, 0x09};
+
+// Parse a record from a stream in one shot and return a copy of it
+
+static lsbf_
+parse_one_shot(const uint8_t *bytes, size_t length)
+{
+    FILE *stream = fmemopen((void *)bytes, length, "r");
+    PState pstate = {.pu = {.stream = stream}};
+    infoset._base.erd = &lsbf_ERD;
+    test_infoset = &infoset._base;
+    parse_record(test_infoset, &pstate);
+    fclose(stream);
+    cr_expect(eq(ptr, (void *)pstate.pu.error, 0), "pstate should have no error");
+    return infoset;
+}
+
+// Verify that a pushed record has the same infoset as a one-shot parse
+
+static void
+expect_same_record(const InfosetBase *record, const lsbf_ *expected)
+{
+    const lsbf_ *actual = (const lsbf_ *)record;
+    cr_expect(eq(ptr, (void *)actual, &infoset), "push parser should fill the test infoset");
+    cr_expect(eq(u8, actual->a, expected->a), "a should match the one-shot parse");
+    cr_expect(eq(u8, actual->b, expected->b), "b should match the one-shot parse");
+    cr_expect(eq(u16, actual->c, expected->c), "c should match the one-shot parse");
+    cr_expect(eq(i32, actual->d, expected->d), "d should match the one-shot parse");
+    cr_expect(eq(u32, actual->e, expected->e), "e should match the one-shot parse");
+    cr_expect(eq(u8, actual->f, expected->f), "f should match the one-shot parse");
+}
+
+// Push a record in chunks ending at the given offsets and verify that
+// the parser needs more data until the last chunk completes the record
+
+static void
+push_chunks(const size_t *ends, size_t num_chunks, const lsbf_ *expected)
+{
+    PushParser parser = {0};
+    InfosetBase *record = NULL;
+    size_t start = 0;
+    for (size_t i = 0; i < num_chunks; i++)
+    {
+        push_data(&parser, passing + start, ends[i] - start);
+        start = ends[i];
+        const enum PushStatus status = push_parse(&parser, &record);
+        if (i + 1 < num_chunks)
+        {
+            cr_expect(eq(int, status, PUSH_NEED_MORE_DATA), "parser should need more data");
+            cr_expect(eq(int, parser.numNeeded > ends[i], 1), "parser should need bytes not pushed yet");
+        }
+        else
+        {
+            cr_expect(eq(int, status, PUSH_RECORD), "parser should parse the record");
+            expect_same_record(record, expected);
+        }
+    }
+    push_end(&parser);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_END), "parser should end");
+    cr_expect(eq(ptr, (void *)parser.error, 0), "parser should have no error");
+    push_free(&parser);
+}
+
+Test(push, one_byte_chunks)
+{
+    // Verify that pushing one byte at a time parses the same record
+    const lsbf_ expected = parse_one_shot(passing, sizeof(passing));
+    cr_expect(eq(u16, expected.c, 2748), "c should be 2748");
+    size_t ends[sizeof(passing)];
+    for (size_t i = 0; i < sizeof(passing); i++)
+    {
+        ends[i] = i + 1;
+    }
+    push_chunks(ends, sizeof(passing), &expected);
+}
+
+Test(push, random_chunks)
+{
+    // Verify that pushing chunks split at random points parses the
+    // same record each time
+    const lsbf_ expected = parse_one_shot(passing, sizeof(passing));
+    srand(47);
+    for (int trial = 0; trial < 100; trial++)
+    {
+        size_t ends[sizeof(passing)];
+        size_t num_chunks = 0;
+        for (size_t end = 1; end < sizeof(passing); end++)
+        {
+            if (rand() % 3 == 0) ends[num_chunks++] = end;
+        }
+        ends[num_chunks++] = sizeof(passing);
+        push_chunks(ends, num_chunks, &expected);
+    }
+}
+
+Test(push, filtered_record)
+{
+    infoset._base.erd = &lsbf_ERD;
+    test_infoset = &infoset._base;
+    PushParser parser = {0};
+    InfosetBase *record = NULL;
+
+    // Verify that the parser skips a filtered record without returning
+    // it and needs more data until the next record is complete
+    push_data(&parser, filtered, sizeof(filtered));
+    push_data(&parser, passing, 5);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_NEED_MORE_DATA), "parser should need more data");
+    cr_expect(eq(sz, parser.numParsed, sizeof(filtered)), "parser should skip the filtered record");
+    push_data(&parser, passing + 5, sizeof(passing) - 5);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_RECORD), "parser should parse the record");
+    cr_expect(eq(u16, ((lsbf_ *)record)->c, 2748), "parser should return the passing record");
+
+    // Verify that a filtered record at the end returns no record
+    push_data(&parser, filtered, sizeof(filtered));
+    push_end(&parser);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_END), "parser should end");
+    cr_expect(eq(ptr, (void *)parser.error, 0), "parser should have no error");
+    push_free(&parser);
+}
+
+Test(push, end_incomplete_record)
+{
+    infoset._base.erd = &lsbf_ERD;
+    test_infoset = &infoset._base;
+    PushParser parser = {0};
+    InfosetBase *record = NULL;
+
+    // Verify that ending the data in the middle of a record fails
+    push_data(&parser, passing, sizeof(passing) - 1);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_NEED_MORE_DATA), "parser should need more data");
+    cr_expect(eq(sz, parser.numNeeded, sizeof(passing)), "parser should need the whole record");
+    push_end(&parser);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_ERROR), "parser should fail");
+    cr_expect(ne(ptr, (void *)parser.error, 0), "parser should have an error");
+    if (parser.error)
+    {
+        cr_expect(eq(int, parser.error->code, ERR_STREAM_EOF), "parser should hit the end of data");
+    }
+    push_free(&parser);
+}
+
+Test(push, end_unaligned_record)
+{
+    infoset._base.erd = &lsbf76_ERD;
+    test_infoset = &infoset._base;
+    PushParser parser = {0};
+    InfosetBase *record = NULL;
+
+    // Verify that a record which doesn't end on a byte boundary fails
+    push_data(&parser, passing, sizeof(passing));
+    push_end(&parser);
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_ERROR), "parser should fail");
+    cr_expect(ne(ptr, (void *)parser.error, 0), "parser should have an error");
+    if (parser.error)
+    {
+        cr_expect(eq(int, parser.error->code, ERR_PUSH_UNALIGNED), "record should be unaligned");
+        cr_expect(eq(i64, parser.error->arg.d64, 76), "record should end at bit 76");
+    }
+    push_free(&parser);
+}
+
+Test(push, delimited_record)
+{
+    line._base.erd = &line_ERD;
+    test_infoset = &line._base;
+    num_line_parses = 0;
+    Diagnostics diagnostics = {0};
+    PushParser parser = {.diagnostics = &diagnostics};
+    InfosetBase *record = NULL;
+
+    // Verify that pushing a long line one byte at a time parses it only
+    // O(log n) times instead of once per byte
+    char text[1000];
+    memset(text, 'x', sizeof(text));
+    text[sizeof(text) - 1] = '\n';
+    size_t num_records = 0;
+    for (size_t i = 0; i < sizeof(text); i++)
+    {
+        push_data(&parser, (const uint8_t *)text + i, 1);
+        if (push_parse(&parser, &record) == PUSH_RECORD) num_records++;
+    }
+    push_end(&parser);
+    if (push_parse(&parser, &record) == PUSH_RECORD) num_records++;
+    cr_expect(eq(sz, num_records, 1), "parser should parse the line once it ends");
+    cr_expect(eq(sz, line.text.length, sizeof(text) - 1), "line should have all of its text");
+    cr_expect(eq(int, num_line_parses <= 16, 1), "parser should retry the line few times");
+
+    // Verify that the retries which needed more data left no diagnostics
+    cr_expect(eq(sz, diagnostics.total, 1), "parser should add the line's diagnostic once");
+    cr_expect(eq(int, push_parse(&parser, &record), PUSH_END), "parser should end");
+    push_free(&parser);
+}
@@ -18,12 +18,20 @@
 package org.apache.daffodil.codegen.c
 
 import java.io.File
+import java.io.IOException
 import java.net.JarURLConnection
+import java.nio.charset.StandardCharsets
 import java.nio.file.Files
 import java.nio.file.Path
 import java.nio.file.Paths
+import java.security.MessageDigest
+import scala.concurrent.Await
+import scala.concurrent.ExecutionContext.Implicits.global
+import scala.concurrent.Future
+import scala.concurrent.duration.Duration
 import scala.jdk.CollectionConverters.*
 import scala.util.Properties.isWin
+import scala.util.Try
 
 import org.apache.daffodil.api
 import org.apache.daffodil.codegen.c.generators.AlignmentFillCodeGenerator
@@ -32,8 +40,11 @@ import org.apache.daffodil.codegen.c.generators.BinaryBooleanCodeGenerator
 import org.apache.daffodil.codegen.c.generators.BinaryFloatCodeGenerator
 import org.apache.daffodil.codegen.c.generators.BinaryIntegerKnownLengthCodeGenerator
 import org.apache.daffodil.codegen.c.generators.CodeGeneratorState
+import org.apache.daffodil.codegen.c.generators.DelimitedTextCodeGenerator
 import org.apache.daffodil.codegen.c.generators.HexBinaryCodeGenerator
 import org.apache.daffodil.core.dsom.Root
+import org.apache.daffodil.core.dsom.SequenceTermBase
+import org.apache.daffodil.core.dsom.Term
 import org.apache.daffodil.core.grammar.Gram
 import org.apache.daffodil.core.grammar.Prod
 import org.apache.daffodil.core.grammar.SeqComp
@@ -48,20 +59,29 @@ import org.apache.daffodil.core.grammar.primitives.CaptureContentLengthStart
 import org.apache.daffodil.core.grammar.primitives.CaptureValueLengthEnd
 import org.apache.daffodil.core.grammar.primitives.CaptureValueLengthStart
 import org.apache.daffodil.core.grammar.primitives.ChoiceCombinator
+import org.apache.daffodil.core.grammar.primitives.DelimiterStackCombinatorChoice
+import org.apache.daffodil.core.grammar.primitives.DelimiterStackCombinatorElement
+import org.apache.daffodil.core.grammar.primitives.DelimiterStackCombinatorSequence
 import org.apache.daffodil.core.grammar.primitives.ElementCombinator
 import org.apache.daffodil.core.grammar.primitives.ElementParseAndUnspecifiedLength
 import org.apache.daffodil.core.grammar.primitives.ElementUnused
 import org.apache.daffodil.core.grammar.primitives.HexBinaryLengthPrefixed
 import org.apache.daffodil.core.grammar.primitives.HexBinarySpecifiedLength
+import org.apache.daffodil.core.grammar.primitives.Initiator
+import org.apache.daffodil.core.grammar.primitives.MandatoryTextAlignment
 import org.apache.daffodil.core.grammar.primitives.OrderedSequence
 import org.apache.daffodil.core.grammar.primitives.RepOrderedExactlyNSequenceChild
 import org.apache.daffodil.core.grammar.primitives.RepOrderedExpressionOccursCountSequenceChild
 import org.apache.daffodil.core.grammar.primitives.RepOrderedWithMinMaxSequenceChild
 import org.apache.daffodil.core.grammar.primitives.RightFill
 import org.apache.daffodil.core.grammar.primitives.ScalarOrderedSequenceChild
+import org.apache.daffodil.core.grammar.primitives.SequenceSeparator
 import org.apache.daffodil.core.grammar.primitives.SpecifiedLengthExplicit
 import org.apache.daffodil.core.grammar.primitives.SpecifiedLengthImplicit
 import org.apache.daffodil.core.grammar.primitives.SpecifiedLengthPrefixed
+import org.apache.daffodil.core.grammar.primitives.StringDelimitedEndOfData
+import org.apache.daffodil.core.grammar.primitives.Terminator
+import org.apache.daffodil.lib.iapi.CBuildProfile
 import org.apache.daffodil.lib.iapi.WarnID
 import org.apache.daffodil.lib.schema.annotation.props.gen.FailureType
 import org.apache.daffodil.lib.schema.annotation.props.gen.TestKind
@@ -128,6 +148,11 @@ class DaffodilCCodeGenerator(root: Root) extends api.CodeGenerator {
     val codeHeaderText = cgState.generateCodeHeader
     val codeFileText = cgState.generateCodeFile
 
+    // Make the Makefile build with the same profile as compileCode
+    val makefile = codeDir / "Makefile"
+    val buildProfile = s"BUILD = ${root.tunable.cBuildProfile}"
+    os.write.over(makefile, os.read(makefile).replace("BUILD = debug", buildProfile))
+
     // Write the generated C code into our code subdirectory
     val generatedVersionHeader = codeDir / "libcli" / "daffodil_version.h"
     val generatedCodeHeader = codeDir / "libruntime" / "generated_code.h"
@@ -143,6 +168,14 @@ class DaffodilCCodeGenerator(root: Root) extends api.CodeGenerator {
   /**
    * Compiles any C files inside the given code directory.  Returns the path
    * of the newly built executable in order to run it in a TDML test.
+   *
+   * Only the generated code differs from schema to schema, so we compile
+   * the other C files only once into a cache of object files (see
+   * objectCacheDir) and compile just the generated code for each schema.
+   * Compilations run in parallel and then a final command links all the
+   * object files into the executable.  The cBuildProfile tunable picks
+   * the compilation flags; its pgo profile bypasses the cache since it
+   * compiles every C file twice, before and after profiling.
    */
   override def compileCode(codeDir: Path): Path = {
     val codeDirOsPath = os.Path(codeDir)
@@ -152,21 +185,101 @@ class DaffodilCCodeGenerator(root: Root) extends api.CodeGenerator {
     try {
       // Assemble the compilation command line arguments
       val command = pickCommand
-      val cFlags = Seq("-std=gnu11")
+      val profile = root.tunable.cBuildProfile
+      val profileFlags = profile match {
+        case CBuildProfile.Debug => Seq("-g")
+        case CBuildProfile.Release | CBuildProfile.Pgo => Seq("-O3", "-flto=auto")
+      }
+      val cFlags = Seq("-std=gnu11") ++ profileFlags
       val includes = Seq("-Ilibcli", "-Ilibruntime")
-      val absFiles = os.walk(codeDirOsPath, skip = _.last == "tests").filter(_.ext == "c")
-      val relFiles = Seq("libcli/*.c", "libruntime/*.c")
-      val libs = Seq("-lmxml")
+      val libs = Seq("-lmxml", "-lpthread")
 
-      // Run the compilation command within the code directory
-      if (command.nonEmpty) {
-        val result = os
-          .proc(command, cFlags, includes, if (isWin) relFiles else absFiles, libs, "-o", exe)
-          .call(cwd = codeDirOsPath, stderr = os.Pipe)
-        if (result.chunks.nonEmpty) {
-          // Report any compilation output as a warning
-          warning(result.toString())
+      // Returns any output of a command run within the code directory
+      def run(proc: os.proc): Option[String] = {
+        val result = proc.call(cwd = codeDirOsPath, stderr = os.Pipe)
+        if (result.chunks.nonEmpty) Some(result.toString()) else None
+      }
+      def objFile(dir: os.Path, cFile: os.RelPath): os.Path =
+        dir / (cFile.segments.mkString("_").stripSuffix(".c") + ".o")
+
+      // Compiles C files into object files in the given directories in
+      // parallel, waiting for every compilation to finish before reporting
+      // any error, and returns any compilation output
+      def compile(files: Seq[(os.RelPath, os.Path)], flags: Seq[String]): Seq[String] = {
+        val compilations = files.map { case (cFile, dir) =>
+          val args = Seq("-c", cFile.toString, "-o", objFile(dir, cFile).toString)
+          Future(Try(run(os.proc(command, cFlags, flags, includes, args))))
         }
+        Await.result(Future.sequence(compilations), Duration.Inf).flatMap(_.get)
+      }
+
+      // Links object files into the executable and returns any output
+      def link(objFiles: Seq[os.Path], flags: Seq[String]): Seq[String] =
+        run(os.proc(command, cFlags, flags, objFiles.map(_.toString), libs, "-o", exe)).toSeq
+
+      // Run the compilation commands within the code directory
+      if (command.nonEmpty) {
+        val cFiles = os
+          .walk(codeDirOsPath, skip = _.last == "tests")
+          .filter(_.ext == "c")
+          .map(_.relativeTo(codeDirOsPath))
+          .sortBy(_.toString)
+        val outputs =
+          if (profile == CBuildProfile.Pgo) {
+            // Build an instrumented executable, run it to collect a profile,
+            // and then rebuild it using that profile
+            val pgoDir = codeDirOsPath / "pgo"
+            os.remove.all(pgoDir)
+            os.makeDir(pgoDir)
+            val objFiles = cFiles.map(objFile(pgoDir, _))
+            val generateFlags = Seq(s"-fprofile-generate=$pgoDir")
+            val instrumentOutputs =
+              compile(cFiles.map((_, pgoDir)), generateFlags) ++ link(objFiles, generateFlags)
+            val useFlags = trainExecutable(exe, pgoDir)
+            instrumentOutputs ++ compile(cFiles.map((_, pgoDir)), useFlags) ++
+              link(objFiles, useFlags)
+          } else {
+            // Compile the generated code while compiling the other C files
+            // into a new build directory only if the cache has none of their
+            // objects yet
+            val (generatedFiles, staticFiles) = cFiles.partition(_.last == "generated_code.c")
+            val cacheDir = objectCacheDir(codeDirOsPath, command ++ cFlags ++ includes)
+            val maybeBuildDir =
+              if (os.exists(cacheDir)) None
+              else {
+                val cacheRoot = cacheDir / os.up
+                os.makeDir.all(cacheRoot)
+                Some(os.temp.dir(dir = cacheRoot, prefix = cacheDir.last, deleteOnExit = false))
+              }
+
+            try {
+              val compileOutputs = compile(
+                generatedFiles.map((_, codeDirOsPath)) ++
+                  maybeBuildDir.toSeq.flatMap { dir => staticFiles.map((_, dir)) },
+                Nil
+              )
+
+              // Fill the cache unless another compilation filled it first
+              maybeBuildDir.foreach { dir =>
+                try {
+                  os.move(dir, cacheDir, atomicMove = true)
+                } catch {
+                  case _: IOException if os.exists(cacheDir) =>
+                }
+              }
+
+              // Link the generated code's and the cache's objects
+              val objFiles = generatedFiles.map(objFile(codeDirOsPath, _)) ++
+                staticFiles.map(objFile(cacheDir, _))
+              compileOutputs ++ link(objFiles, Nil)
+            } finally {
+              maybeBuildDir.foreach(os.remove.all(_))
+              pruneObjectCache(cacheDir)
+            }
+          }
+
+        // Report any compilation output as a warning
+        outputs.foreach { output => warning("%s", output) }
       }
     } catch {
       // Report any subprocess termination error as an error
@@ -185,6 +298,130 @@ class DaffodilCCodeGenerator(root: Root) extends api.CodeGenerator {
     exe.toNIO
   }
 
+  /**
+   * Runs an instrumented executable on synthetic data generated from the
+   * schema, ignoring any errors since even a partial profile is useful.
+   * Returns the flags which make the compiler use the collected profile,
+   * merging clang's raw profiles first (gcc reads its own profiles as is).
+   */
+  private def trainExecutable(exe: os.Path, pgoDir: os.Path): Seq[String] = {
+    val data = pgoDir / "train.dat"
+    os.proc(exe, "-n", "1000", "-o", data, "generate-data")
+      .call(cwd = pgoDir / os.up, check = false, stderr = os.Pipe)
+    os.proc(exe, "-S", "-I", "null", "parse", data)
+      .call(cwd = pgoDir / os.up, check = false, stderr = os.Pipe)
+
+    val rawProfiles = os.list(pgoDir).filter(_.ext == "profraw").map(_.toString)
+    if (rawProfiles.nonEmpty) {
+      try {
+        os.proc("llvm-profdata", "merge", "-o", pgoDir / "default.profdata", rawProfiles)
+          .call(cwd = pgoDir, stderr = os.Pipe)
+      } catch {
+        case e @ (_: IOException | _: os.SubprocessException) =>
+          warning("Unable to merge profiles with llvm-profdata: %s", Misc.getSomeMessage(e).get)
+      }
+    }
+
+    if (rawProfiles.isEmpty || os.exists(pgoDir / "default.profdata"))
+      Seq(s"-fprofile-use=$pgoDir")
+    else
+      Nil
+  }
+
+  /**
+   * Returns the directory which caches object files compiled from all
+   * the C files except the generated code.  Names the directory after a
+   * hash of the compilation command, the compiler's version (see
+   * compilerVersion), and the names and contents of those C files and
+   * their headers, so changing any of them (including upgrading the
+   * compiler) leads to another directory instead of stale object files
+   * the new compiler might not link with.  Puts the directory inside
+   * the cObjectCacheDir tunable's directory, or else inside a per-user
+   * cache directory (see objectCacheRoot).
+   */
+  private def objectCacheDir(codeDir: os.Path, command: Seq[String]): os.Path = {
+    val digest = MessageDigest.getInstance("SHA-256")
+    digest.update(command.mkString("\u0000").getBytes(StandardCharsets.UTF_8))
+    digest.update(s"\u0000$compilerVersion".getBytes(StandardCharsets.UTF_8))
+    os
+      .walk(codeDir, skip = _.last == "tests")
+      .filter { p => (p.ext == "c" || p.ext == "h") && !p.last.startsWith("generated_code.") }
+      .map(_.relativeTo(codeDir))
+      .sortBy(_.toString)
+      .foreach { file =>
+        digest.update(s"\u0000$file\u0000".getBytes(StandardCharsets.UTF_8))
+        digest.update(os.read.bytes(codeDir / file))
+      }
+    val key = Misc.bytes2Hex(digest.digest()).take(32).toLowerCase
+    objectCacheRoot / key
+  }
+
+  /**
+   * Returns the output of the compiler's --version option, which names
+   * the compiler's version and target, or an empty string if the
+   * compiler cannot tell us.  Runs the compiler only once per generator.
+   */
+  private lazy val compilerVersion: String = {
+    try {
+      os.proc(pickCommand, "--version")
+        .call(check = false, mergeErrIntoOut = true)
+        .out
+        .text()
+    } catch {
+      case _: IOException => ""
+    }
+  }
+
+  /**
+   * Returns the directory holding all cached object file directories:
+   * the cObjectCacheDir tunable if set, else daffodil-c inside the user's
+   * cache directory ($XDG_CACHE_HOME, %LOCALAPPDATA%, or ~/.cache), so
+   * users sharing a machine never load each other's object files.
+   */
+  private lazy val objectCacheRoot: os.Path = {
+    val tunableDir = root.tunable.cObjectCacheDir
+    val dir =
+      if (tunableDir.nonEmpty) Paths.get(tunableDir)
+      else {
+        val cacheHome = Seq("XDG_CACHE_HOME", "LOCALAPPDATA")
+          .flatMap(sys.env.get)
+          .find(_.nonEmpty)
+          .map(Paths.get(_))
+          .getOrElse(Paths.get(System.getProperty("user.home"), ".cache"))
+        cacheHome.resolve("daffodil-c")
+      }
+    os.Path(dir.toAbsolutePath)
+  }
+
+  /**
+   * Bounds the object cache by removing all but the most recently used
+   * directories, skipping any directory used within the last hour in
+   * case another compilation is still linking against it.  Marks the
+   * given directory as just used first.  Removing the whole cache is
+   * always safe; the next compilation simply fills it again.
+   */
+  private def pruneObjectCache(cacheDir: os.Path): Unit = {
+    val now = System.currentTimeMillis()
+    try {
+      if (os.exists(cacheDir)) os.mtime.set(cacheDir, now)
+      os.list(objectCacheRoot)
+        .filter(os.isDir(_))
+        .map { dir => (dir, os.mtime(dir)) }
+        .sortBy { case (_, mtime) => -mtime }
+        .drop(maxObjectCacheDirs)
+        .foreach { case (dir, mtime) =>
+          if (now - mtime > objectCacheMinAgeMillis) os.remove.all(dir)
+        }
+    } catch {
+      // Another compilation may be pruning the same directories
+      case _: IOException =>
+    }
+  }
+
+  // Bounds on the object cache (see pruneObjectCache)
+  private val maxObjectCacheDirs = 8
+  private val objectCacheMinAgeMillis = 60L * 60 * 1000
+
   /**
    * Searches for any available C compilation command on the system.
    * Tries to find the command given by `CC` if `CC` exists in the
@@ -256,6 +493,7 @@ object DaffodilCCodeGenerator
   with BinaryBooleanCodeGenerator
   with BinaryIntegerKnownLengthCodeGenerator
   with BinaryFloatCodeGenerator
+  with DelimitedTextCodeGenerator
   with HexBinaryCodeGenerator {
 
   /**
@@ -286,12 +524,19 @@ object DaffodilCCodeGenerator
       case g: CaptureValueLengthEnd => noop(g)
       case g: CaptureValueLengthStart => noop(g)
       case g: ChoiceCombinator => choiceCombinator(g, cgState)
+      case g: DelimiterStackCombinatorChoice => delimiterStackCombinator(g.ch, g.body, cgState)
+      case g: DelimiterStackCombinatorElement => delimiterStackCombinator(g.e, g.body, cgState)
+      case g: DelimiterStackCombinatorSequence =>
+        delimiterStackCombinator(g.sq, g.body, cgState)
       case g: ElementCombinator => elementCombinator(g, cgState)
       case g: ElementParseAndUnspecifiedLength =>
         elementParseAndUnspecifiedLengthGenerateCode(g, cgState)
       case g: ElementUnused => noop(g)
       case g: HexBinaryLengthPrefixed => hexBinaryLengthPrefixedGenerateCode(g.e, cgState)
       case g: HexBinarySpecifiedLength => hexBinarySpecifiedLengthGenerateCode(g.e, cgState)
+      case g: Initiator =>
+        delimiterGenerateCode(g.e, g.e.initiatorParseEv, g.e.initiatorUnparseEv, cgState)
+      case g: MandatoryTextAlignment => mandatoryTextAlignmentGenerateCode(g, cgState)
       case g: OrderedSequence => orderedSequenceGenerateCode(g, cgState)
       case g: Prod => prod(g, cgState)
       case g: RepOrderedExactlyNSequenceChild => repOrderedExactlyNSequenceChild(g, cgState)
@@ -301,9 +546,14 @@ object DaffodilCCodeGenerator
       case g: RightFill => noop(g)
       case g: ScalarOrderedSequenceChild => scalarOrderedSequenceChild(g, cgState)
       case g: SeqComp => seqCompGenerateCode(g, cgState)
+      case g: SequenceSeparator =>
+        delimiterGenerateCode(g.s, g.s.separatorParseEv, g.s.separatorUnparseEv, cgState)
       case g: SpecifiedLengthExplicit => specifiedLengthExplicit(g, cgState)
       case g: SpecifiedLengthImplicit => specifiedLengthImplicit(g, cgState)
       case g: SpecifiedLengthPrefixed => specifiedLengthPrefixed(g, cgState)
+      case g: StringDelimitedEndOfData => stringDelimitedGenerateCode(g, cgState)
+      case g: Terminator =>
+        delimiterGenerateCode(g.e, g.e.terminatorParseEv, g.e.terminatorUnparseEv, cgState)
       case _ => gram.SDE("Code generation not supported for: %s", Misc.getNameFromClass(gram))
     }
   }
@@ -316,25 +566,41 @@ object DaffodilCCodeGenerator
     cgState.addAfterSwitchStatements() // switch statements for choices
   }
 
+  private def delimiterStackCombinator(
+    term: Term,
+    body: Gram,
+    cgState: CodeGeneratorState
+  ): Unit = {
+    // Let delimited text inside the term end at the term's separators and terminator too
+    cgState.pushDelimiters(terminatingDelimiters(term))
+    DaffodilCCodeGenerator.generateCode(body, cgState)
+    cgState.popDelimiters()
+  }
+
   private def elementCombinator(g: ElementCombinator, cgState: CodeGeneratorState): Unit = {
-    cgState.pushElement(g.context)
-    DaffodilCCodeGenerator.generateCode(g.subComb, cgState)
-    // Also generate code for the element's assert statements
-    g.context.assertStatements.foreach { assert =>
-      assert.testKind match {
-        case TestKind.Pattern =>
-          g.SDW(
-            WarnID.IgnoreDFDLProperty,
-            "Code generation not supported for dfdl:assert pattern stmts"
-          )
-        case TestKind.Expression =>
-          val name = g.name
-          val exprText = assert.testTxt
-          val recoverable = assert.failureType == FailureType.RecoverableError
-          assertStatementGenerateCode(name, exprText, recoverable, cgState)
+    // Skip over a projected out element's data without generating any of its code
+    if (cgState.isProjectedOut(g.context)) {
+      cgState.addSkipStatements(g.context)
+    } else {
+      cgState.pushElement(g.context)
+      DaffodilCCodeGenerator.generateCode(g.subComb, cgState)
+      // Also generate code for the element's assert statements
+      g.context.assertStatements.foreach { assert =>
+        assert.testKind match {
+          case TestKind.Pattern =>
+            g.SDW(
+              WarnID.IgnoreDFDLProperty,
+              "Code generation not supported for dfdl:assert pattern stmts"
+            )
+          case TestKind.Expression =>
+            val name = g.name
+            val exprText = assert.testTxt
+            val recoverable = assert.failureType == FailureType.RecoverableError
+            assertStatementGenerateCode(name, exprText, recoverable, cgState)
+        }
       }
+      cgState.popElement(g.context)
     }
-    cgState.popElement(g.context)
   }
 
   private def elementParseAndUnspecifiedLengthGenerateCode(
@@ -352,11 +618,23 @@ object DaffodilCCodeGenerator
     g: OrderedSequence,
     cgState: CodeGeneratorState
   ): Unit = {
-    for (gram <- g.sequenceChildren) {
+    val sq = g.context.asInstanceOf[SequenceTermBase]
+    for ((gram, i) <- g.sequenceChildren.zipWithIndex) {
+      // Separators go before, between, or after children which always occur once
+      if (sq.hasSeparator && !gram.isInstanceOf[ScalarOrderedSequenceChild])
+        gram.SDE("Arrays and optional elements in sequences with separators are not supported.")
+      val hasSeparatorBefore = sq.hasPrefixSep || (sq.hasInfixSep && i > 0)
+      if (hasSeparatorBefore) separatorGenerateCode(sq, cgState)
       DaffodilCCodeGenerator.generateCode(gram, cgState)
+      if (sq.hasPostfixSep) separatorGenerateCode(sq, cgState)
     }
   }
 
+  private def separatorGenerateCode(sq: SequenceTermBase, cgState: CodeGeneratorState): Unit = {
+    DaffodilCCodeGenerator.generateCode(sq.sequenceSeparatorMTA, cgState)
+    DaffodilCCodeGenerator.generateCode(sq.sequenceSeparator, cgState)
+  }
+
   private def prod(g: Prod, cgState: CodeGeneratorState): Unit = {
     if (g.guard) DaffodilCCodeGenerator.generateCode(g.gram, cgState)
   }
@@ -17,26 +17,47 @@
 
 package org.apache.daffodil.codegen.c.generators
 
+import org.apache.daffodil.core.dsom.Term
 import org.apache.daffodil.core.grammar.primitives.AlignmentFill
+import org.apache.daffodil.core.grammar.primitives.MandatoryTextAlignment
 
 trait AlignmentFillCodeGenerator {
 
   // Generate C code to parse/unparse alignment fill bytes until an
   // alignment boundary is reached
   def alignmentFillGenerateCode(g: AlignmentFill, cgState: CodeGeneratorState): Unit = {
+    alignToGenerateCode(g.e, g.alignment.intValue, cgState)
+  }
+
+  // Generate C code to parse/unparse fill bytes until text or a
+  // delimiter starts on its encoding's alignment boundary
+  def mandatoryTextAlignmentGenerateCode(
+    g: MandatoryTextAlignment,
+    cgState: CodeGeneratorState
+  ): Unit = {
+    alignToGenerateCode(g.e, g.alignmentInBits, cgState)
+  }
+
+  private def alignToGenerateCode(
+    e: Term,
+    alignmentInBits: Int,
+    cgState: CodeGeneratorState
+  ): Unit = {
     val indent1 = if (cgState.hasChoice) INDENT else NO_INDENT
     val indent2 = if (cgState.hasArray) INDENT else NO_INDENT
-    val alignmentInBits = g.alignment
-    val octalFillByte = g.e.fillByteEv.constValue.toByte.toInt.toOctalString
+    val octalFillByte = e.fillByteEv.constValue.toByte.toInt.toOctalString
+    val order = bitOrderPrefix(e)
     val initERDStatement = ""
     val parseStatement =
       s"""$indent1$indent2    // Align to closest alignment
-         |$indent1$indent2    parse_align_to($alignmentInBits, pstate);
+         |$indent1$indent2    parse_${order}align_to($alignmentInBits, pstate);
          |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
     val unparseStatement =
       s"""$indent1$indent2    // Align to closest alignment
-         |$indent1$indent2    unparse_align_to($alignmentInBits, '\\$octalFillByte', ustate);
+         |$indent1$indent2    unparse_${order}align_to($alignmentInBits, '\\$octalFillByte', ustate);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    // Alignment fill's length depends on where the previous element ended
+    cgState.addVariableLength()
   }
 }
@@ -22,7 +22,8 @@ package org.apache.daffodil.codegen.c.generators
 //   { ../../foo/x eq 2 } as used in empty sequences
 //   { . eq 2 } as used in simple elements
 //
-// Anything else likely won't produce valid C code at this time.
+// Anything else likely won't produce valid C code at this time.  Random
+// data will satisfy only assertions which compare a field to a number.
 
 trait AssertStatementGenerateCode {
 
@@ -43,14 +44,26 @@ trait AssertStatementGenerateCode {
     // Handle assertion expressions with "." as used in simple elements
     val cExpr = cgState.cExpression(modifiedExpr).replaceFirst("^\\. ", s"instance->$name ")
 
+    // Only recoverable assertions may be compiled out; fatal assertions always run
+    val wrap: String => String = if (recoverable) recoverableValidation else identity
     val initERDStatement = ""
-    val parseStatement =
+    val parseStatement = wrap(
       s"""$indent    validate_dfdl_assert($cExpr, "$exprText", $recoverable, &pstate->pu);
          |$indent    if (pstate->pu.error) return;""".stripMargin
-    val unparseStatement =
+    )
+    val unparseStatement = wrap(
       s"""$indent    validate_dfdl_assert($cExpr, "$exprText", $recoverable, &ustate->pu);
          |$indent    if (ustate->pu.error) return;""".stripMargin
+    )
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+
+    // Make random data satisfy assertions which compare a field to a number
+    val equality = """^(.+) == ([-+]?[0-9][0-9.eE+-]*)$""".r
+    cExpr match {
+      case equality(field, number) =>
+        cgState.addRandomizeStatement(s"$indent    $field = $number;")
+      case _ =>
+    }
   }
 
 }
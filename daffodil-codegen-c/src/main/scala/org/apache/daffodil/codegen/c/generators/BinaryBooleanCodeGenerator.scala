@@ -19,7 +19,6 @@ package org.apache.daffodil.codegen.c.generators
 
 import org.apache.daffodil.core.dsom.ElementBase
 import org.apache.daffodil.lib.exceptions.Assert
-import org.apache.daffodil.lib.schema.annotation.props.gen.ByteOrder
 
 import passera.unsigned.ULong
 
@@ -53,8 +52,7 @@ trait BinaryBooleanCodeGenerator extends BinaryValueCodeGenerator {
     val indent2 = if (deref.nonEmpty) INDENT else NO_INDENT
     val localName = cgState.cName(e)
     val field = s"instance->$localName$deref"
-    val conv = if (e.byteOrderEv.constValue eq ByteOrder.BigEndian) "be" else "le"
-    val function = s"${conv}_$primType"
+    val function = s"${bitByteOrder(e)}_$primType"
 
     val trueRep = if (e.binaryBooleanTrueRep.isDefined) e.binaryBooleanTrueRep.getULong else -1
     val falseRep = e.binaryBooleanFalseRep
@@ -68,5 +66,7 @@ trait BinaryBooleanCodeGenerator extends BinaryValueCodeGenerator {
       s"""$indent1$indent2    unparse_$function($field, $lengthInBits, $unparseTrueRep, $falseRep, ustate);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    // Keep read check since booleans can fail to match their representations
+    cgState.addStaticLength(lengthInBits)
   }
 }
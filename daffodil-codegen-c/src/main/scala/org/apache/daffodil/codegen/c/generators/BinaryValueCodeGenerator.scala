@@ -17,15 +17,25 @@
 
 package org.apache.daffodil.codegen.c.generators
 
+import java.math.RoundingMode
+import scala.util.Try
+
 import org.apache.daffodil.core.dsom.ElementBase
 import org.apache.daffodil.lib.schema.annotation.props.gen.BitOrder
 import org.apache.daffodil.lib.schema.annotation.props.gen.ByteOrder
 import org.apache.daffodil.lib.util.Maybe.Nope
 import org.apache.daffodil.runtime1.dpath.NodeInfo.PrimType
+import org.apache.daffodil.runtime1.dpath.NodeInfo.PrimType.PrimNumeric
 
 // Base trait which provides common code to generate C code for primitive value elements
 trait BinaryValueCodeGenerator {
 
+  // Largest span of integer enumeration values to validate with a bitset (128 bytes)
+  private val MAX_ENUM_BITSET_BITS = 1024
+
+  // Range of random real numbers when a schema doesn't restrict their range
+  private val DEFAULT_RANDOM_DOUBLE_RANGE = "1000000.0"
+
   // Generate C code for a primitive value element differently depending on how many times the element occurs.
   // Intended to be called by other traits which extend this trait, not directly by DaffodilCCodeGenerator.
   def binaryValueGenerateCode(
@@ -36,14 +46,17 @@ trait BinaryValueCodeGenerator {
   ): Unit = {
     // For the time being this is a very limited back end.
     // So there are some restrictions to enforce.
-    e.schemaDefinitionUnless(
-      e.bitOrder eq BitOrder.MostSignificantBitFirst,
-      "Only dfdl:bitOrder 'mostSignificantBitFirst' is supported."
-    )
     e.schemaDefinitionUnless(
       e.maybeByteOrderEv == Nope || e.byteOrderEv.isConstant,
       "Runtime dfdl:byteOrder expressions not supported."
     )
+    val isLsbf = e.bitOrder eq BitOrder.LeastSignificantBitFirst
+    val isBigEndian =
+      e.maybeByteOrderEv != Nope && (e.byteOrderEv.constValue eq ByteOrder.BigEndian)
+    e.schemaDefinitionUnless(
+      !(isLsbf && isBigEndian),
+      "dfdl:bitOrder 'leastSignificantBitFirst' requires dfdl:byteOrder 'littleEndian'."
+    )
 
     // Call the given partially applied function values with their remaining unbound argument (deref)
     val deref = if (cgState.hasArray) "[i]" else ""
@@ -96,6 +109,9 @@ trait BinaryValueCodeGenerator {
       // Call another function which can be redefined differently if necessary
       valueValidateRange(e, deref, minEndpoint, maxEndpoint, cgState)
     }
+
+    // Generate a random value which satisfies the element's restrictions
+    valueRandomize(e, deref, cgState)
   }
 
   // Generate C code to parse and unparse a primitive value element.  Will be replaced by
@@ -111,17 +127,26 @@ trait BinaryValueCodeGenerator {
     val indent2 = if (deref.nonEmpty) INDENT else NO_INDENT
     val localName = cgState.cName(e)
     val field = s"instance->$localName$deref"
-    val conv = if (e.byteOrderEv.constValue eq ByteOrder.BigEndian) "be" else "le"
-    val function = s"${conv}_$primType"
+    val function = s"${bitByteOrder(e)}_$primType"
 
     val initERDStatement = ""
-    val parseStatement =
-      s"""$indent1$indent2    parse_$function(&$field, $lengthInBits, pstate);
-         |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
+    val parseStatement = s"$indent1$indent2    parse_$function(&$field, $lengthInBits, pstate);"
+    val readCheck = s"$indent1$indent2    if (pstate->pu.error) return;"
     val unparseStatement =
       s"""$indent1$indent2    unparse_$function($field, $lengthInBits, ustate);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    // Reading numbers can fail only if their data can't be read ahead
+    cgState.addStaticLength(lengthInBits)
+    cgState.addReadCheck(readCheck)
+  }
+
+  // Get the bit and byte order part of the names of the parse and unparse functions for a
+  // primitive value element (leastSignificantBitFirst data is always little-endian)
+  protected def bitByteOrder(e: ElementBase): String = {
+    if (e.bitOrder eq BitOrder.LeastSignificantBitFirst) "lsbf"
+    else if (e.byteOrderEv.constValue eq ByteOrder.BigEndian) "be"
+    else "le"
   }
 
   // Generate C code to validate a primitive element against its fixed value.  Will be replaced by
@@ -138,16 +163,21 @@ trait BinaryValueCodeGenerator {
     val fixed = e.fixedValueAsString
 
     val initERDStatement = ""
-    val parseStatement =
+    val parseStatement = recoverableValidation(
       s"""$indent1$indent2    validate_fixed_attribute($field == $fixed, "$localName", &pstate->pu);
          |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
-    val unparseStatement =
+    )
+    val unparseStatement = recoverableValidation(
       s"""$indent1$indent2    validate_fixed_attribute($field == $fixed, "$localName", &ustate->pu);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    )
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
   }
 
   // Generate C code to validate a primitive element matches one of its enumeration values.
+  // Picks a lookup strategy per element: a bitset for dense small integer domains, a sorted
+  // table searched with binary search otherwise, or a linear scan if the values can't be
+  // sorted at codegen time.  HexBinary tables are sorted by length first, then by bytes.
   private def valueValidateEnumeration(
     e: ElementBase,
     deref: String,
@@ -158,43 +188,90 @@ trait BinaryValueCodeGenerator {
     val indent2 = if (deref.nonEmpty) INDENT else NO_INDENT
     val localName = cgState.cName(e)
     val field = s"instance->$localName$deref"
+    val enumsArray = s"enums_$localName"
 
-    // Extra initialization only for hexBinary enumerations
-    val arraysName = s"arrays_$localName"
-    val hexEnums = enums.zipWithIndex.map { case (s, index) =>
-      s"{$arraysName[$index], ${s.length / 2}, false}"
-    }
-    val hexEnumsInit = enums.map(_.grouped(2).map("0x" + _).mkString("{", ", ", "}"))
-    val hexEnumsLenMax = enums.map(_.length / 2).max
-    val arraysInit =
-      s"""$indent1$indent2    uint8_t $arraysName[][$hexEnumsLenMax] = ${hexEnumsInit.mkString(
-          "{",
-          ", ",
-          "}"
-        )};\n"""
-
-    val (enumsInit, extraInit, primType, valType, fieldArg) = e.optPrimType.get match {
-      case PrimType.Double | PrimType.Float => (enums, "", "double", "floatpt", field)
-      case PrimType.HexBinary => (hexEnums, arraysInit, "HexBinary", "hexbinary", s"&$field")
-      case _ => (enums, "", "int64_t", "integer", field)
-    }
+    // Static tables are initialized only once instead of on every call
+    def tableInit(cType: String, values: Seq[String]): String =
+      s"""$indent1$indent2    static const $cType $enumsArray[] = ${values.mkString("{", ", ", "}")};\n"""
 
-    // Initialization for all enumerations
-    val enumsArray = s"enums_$localName"
-    val varsInit = extraInit +
-      s"""$indent1$indent2    $primType $enumsArray[] = ${enumsInit.mkString(
-          "{",
-          ", ",
-          "}"
-        )};\n"""
+    val (varsInit, validateCall) = e.optPrimType.get match {
+      case PrimType.Double | PrimType.Float =>
+        val doubles = enums.map(s => Try(s.trim.toDouble).toOption)
+        if (doubles.forall(_.exists(!_.isNaN))) {
+          val sorted =
+            enums.zip(doubles.flatten).sortBy(_._2)(Ordering.Double.TotalOrdering).map(_._1)
+          (
+            tableInit("double", sorted),
+            s"validate_floatpt_enumeration_sorted($field, ${enums.length}, $enumsArray"
+          )
+        } else {
+          (
+            tableInit("double", enums),
+            s"validate_floatpt_enumeration($field, ${enums.length}, $enumsArray"
+          )
+        }
+      case PrimType.HexBinary =>
+        // Sort uppercase hex digits to sort same as unsigned bytes
+        val sorted = enums.map(_.toUpperCase).sortBy(s => (s.length, s))
+        val arraysName = s"arrays_$localName"
+        val hexEnums = sorted.zipWithIndex.map { case (s, index) =>
+          s"{$arraysName[$index], ${s.length / 2}, false}"
+        }
+        val hexEnumsInit = sorted.map(_.grouped(2).map("0x" + _).mkString("{", ", ", "}"))
+        val hexEnumsLenMax = sorted.map(_.length / 2).max
+        val arraysInit =
+          s"""$indent1$indent2    static uint8_t $arraysName[][$hexEnumsLenMax] = ${hexEnumsInit.mkString(
+              "{",
+              ", ",
+              "}"
+            )};\n"""
+        (
+          arraysInit + tableInit("HexBinary", hexEnums),
+          s"validate_hexbinary_enumeration_sorted(&$field, ${enums.length}, $enumsArray"
+        )
+      case _ =>
+        // Convert values the same way C converts them to int64_t
+        val longs = enums.map(s => Try(BigInt(s.trim).toLong).toOption)
+        if (longs.forall(_.isDefined)) {
+          val min = longs.flatten.min
+          val numBits = BigInt(longs.flatten.max) - BigInt(min) + BigInt(1)
+          if (numBits <= BigInt(MAX_ENUM_BITSET_BITS)) {
+            val bitset = new Array[Int]((numBits.toInt + 7) / 8)
+            longs.flatten.foreach { v =>
+              val bit = (BigInt(v) - BigInt(min)).toInt
+              bitset(bit / 8) = bitset(bit / 8) | (1 << (bit % 8))
+            }
+            val minEnum = if (min == Long.MinValue) "INT64_MIN" else min.toString
+            (
+              tableInit("uint8_t", bitset.toSeq.map(b => f"0x$b%02X")),
+              s"validate_integer_enumeration_bitset($field, $minEnum, $numBits, $enumsArray"
+            )
+          } else {
+            val sorted = enums.zip(longs.flatten).sortBy(_._2).map(_._1)
+            (
+              tableInit("int64_t", sorted),
+              s"validate_integer_enumeration_sorted($field, ${enums.length}, $enumsArray"
+            )
+          }
+        } else {
+          (
+            tableInit("int64_t", enums),
+            s"validate_integer_enumeration($field, ${enums.length}, $enumsArray"
+          )
+        }
+    }
 
     val initERDStatement = ""
-    val parseStatement = varsInit +
-      s"""$indent1$indent2    validate_${valType}_enumeration($fieldArg, ${enums.length}, $enumsArray, "$localName", &pstate->pu);
-         |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
-    val unparseStatement = varsInit +
-      s"""$indent1$indent2    validate_${valType}_enumeration($fieldArg, ${enums.length}, $enumsArray, "$localName", &ustate->pu);
-         |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    val parseStatement = recoverableValidation(
+      varsInit +
+        s"""$indent1$indent2    $validateCall, "$localName", &pstate->pu);
+           |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
+    )
+    val unparseStatement = recoverableValidation(
+      varsInit +
+        s"""$indent1$indent2    $validateCall, "$localName", &ustate->pu);
+           |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    )
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
   }
 
@@ -220,12 +297,124 @@ trait BinaryValueCodeGenerator {
         s"""$field $maxEndpoint"""
 
     val initERDStatement = ""
-    val parseStatement =
+    val parseStatement = recoverableValidation(
       s"""$indent1$indent2    validate_schema_range($comparison, "$localName", &pstate->pu);
          |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
-    val unparseStatement =
+    )
+    val unparseStatement = recoverableValidation(
       s"""$indent1$indent2    validate_schema_range($comparison, "$localName", &ustate->pu);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    )
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
   }
+
+  // Generate C code to fill a primitive value element with a random value which satisfies its
+  // fixed value, enumerations, or range.  HexBinary elements get their random bytes when their
+  // storage is allocated, so only their fixed values or enumerations need code here.
+  private def valueRandomize(
+    e: ElementBase,
+    deref: String,
+    cgState: CodeGeneratorState
+  ): Unit = {
+    val indent = (if (cgState.hasChoice) INDENT else NO_INDENT) +
+      (if (deref.nonEmpty) INDENT else NO_INDENT)
+    val localName = cgState.cName(e)
+    val field = s"instance->$localName$deref"
+    val restriction = e.typeDef.optRestriction
+    val enums = restriction
+      .filter(_.hasEnumeration)
+      .map(_.enumerations.map(_.enumValueRaw))
+      .getOrElse(Seq.empty)
+    val hasFixed = e.hasFixedValue && e.fixedValueAsString.nonEmpty
+
+    // Pick one value from a static table of values
+    def pickValue(cType: String, values: Seq[String]): String =
+      s"""$indent    static const $cType enums_$localName[] = ${values.mkString("{", ", ", "}")};
+         |$indent    $field = enums_$localName[random_index(${values.length}, rstate)];""".stripMargin
+
+    val randomizeStatement = e.optPrimType.get match {
+      case PrimType.HexBinary if hasFixed =>
+        val bytes = e.fixedValueAsString.grouped(2).map("0x" + _).toSeq
+        s"""$indent    random_hexBinary_copy(&$field, (const uint8_t[]){${bytes.mkString(", ")}}, ${bytes.length}, rstate);
+           |$indent    if (rstate->error) return;""".stripMargin
+      case PrimType.HexBinary if enums.nonEmpty =>
+        val arraysName = s"arrays_$localName"
+        val lengthsName = s"lengths_$localName"
+        val lengths = enums.map(_.length / 2)
+        val arraysInit = enums.map(_.grouped(2).map("0x" + _).mkString("{", ", ", "}"))
+        s"""$indent    static const uint8_t $arraysName[][${lengths.max.max(1)}] = ${arraysInit.mkString("{", ", ", "}")};
+           |$indent    static const size_t $lengthsName[] = ${lengths.mkString("{", ", ", "}")};
+           |$indent    const size_t _r_$localName = random_index(${enums.length}, rstate);
+           |$indent    random_hexBinary_copy(&$field, $arraysName[_r_$localName], $lengthsName[_r_$localName], rstate);
+           |$indent    if (rstate->error) return;""".stripMargin
+      case PrimType.HexBinary =>
+        ""
+      case _ if hasFixed =>
+        s"$indent    $field = ${e.fixedValueAsString};"
+      case PrimType.Boolean =>
+        s"$indent    $field = random_int(0, 1, rstate);"
+      case PrimType.Double | PrimType.Float =>
+        if (enums.nonEmpty) {
+          pickValue("double", enums)
+        } else {
+          val min = restriction
+            .collect {
+              case r if r.hasMinInclusive => r.minInclusiveValue.toString
+              case r if r.hasMinExclusive => r.minExclusiveValue.toString
+            }
+            .getOrElse(s"-$DEFAULT_RANDOM_DOUBLE_RANGE")
+          val max = restriction
+            .collect {
+              case r if r.hasMaxInclusive => r.maxInclusiveValue.toString
+              case r if r.hasMaxExclusive => r.maxExclusiveValue.toString
+            }
+            .getOrElse(DEFAULT_RANDOM_DOUBLE_RANGE)
+          // An exclusive endpoint may be returned only with negligible probability
+          s"$indent    $field = random_double($min, $max, rstate);"
+        }
+      case _ =>
+        val isSigned = e.primType.asInstanceOf[PrimNumeric].isSigned
+        if (enums.nonEmpty) {
+          pickValue(if (isSigned) "int64_t" else "uint64_t", enums)
+        } else {
+          // Intersect the ranges of the element's length, its type, and its schema facets
+          val typeBits = e.optPrimType.get match {
+            case PrimType.Byte | PrimType.UnsignedByte => 8L
+            case PrimType.Short | PrimType.UnsignedShort => 16L
+            case PrimType.Int | PrimType.UnsignedInt => 32L
+            case _ => 64L
+          }
+          val lengthInBits = e.elementLengthInBitsEv.constValue.get.min(typeBits).toInt
+          val typeMin = if (isSigned) -(BigInt(1) << (lengthInBits - 1)) else BigInt(0)
+          val typeMax =
+            if (isSigned) (BigInt(1) << (lengthInBits - 1)) - 1
+            else (BigInt(1) << lengthInBits) - 1
+          val facetMin = restriction.collect {
+            case r if r.hasMinInclusive =>
+              BigInt(r.minInclusiveValue.setScale(0, RoundingMode.CEILING).toBigInteger)
+            case r if r.hasMinExclusive =>
+              BigInt(r.minExclusiveValue.setScale(0, RoundingMode.FLOOR).toBigInteger) + 1
+          }
+          val facetMax = restriction.collect {
+            case r if r.hasMaxInclusive =>
+              BigInt(r.maxInclusiveValue.setScale(0, RoundingMode.FLOOR).toBigInteger)
+            case r if r.hasMaxExclusive =>
+              BigInt(r.maxExclusiveValue.setScale(0, RoundingMode.CEILING).toBigInteger) - 1
+          }
+          val min = facetMin.fold(typeMin)(_.max(typeMin))
+          val max = facetMax.fold(typeMax)(_.min(typeMax)).max(min)
+          val function = if (isSigned) "random_int" else "random_uint"
+          s"$indent    $field = $function(${cLiteral(min)}, ${cLiteral(max)}, rstate);"
+        }
+    }
+    cgState.addRandomizeStatement(randomizeStatement)
+  }
+
+  // Convert a 64-bit integer to a C literal without causing gcc warnings
+  private def cLiteral(n: BigInt): String = {
+    if (n == BigInt(Long.MinValue)) "INT64_MIN"
+    else if (n == (BigInt(1) << 64) - 1) "UINT64_MAX"
+    else if (n > BigInt(Long.MaxValue)) s"${n}u"
+    else n.toString
+  }
 }
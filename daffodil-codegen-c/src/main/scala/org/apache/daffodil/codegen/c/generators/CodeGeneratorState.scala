@@ -24,22 +24,57 @@ import org.apache.daffodil.core.dsom.Choice
 import org.apache.daffodil.core.dsom.ElementBase
 import org.apache.daffodil.core.dsom.GlobalComplexTypeDef
 import org.apache.daffodil.core.dsom.GlobalElementDecl
+import org.apache.daffodil.core.dsom.ModelGroup
 import org.apache.daffodil.core.dsom.SchemaComponent
+import org.apache.daffodil.core.dsom.Term
 import org.apache.daffodil.lib.cookers.ChoiceBranchKeyCooker
 import org.apache.daffodil.lib.iapi.WarnID
+import org.apache.daffodil.lib.schema.annotation.props.gen.LengthKind
 import org.apache.daffodil.lib.schema.annotation.props.gen.OccursCountKind
+import org.apache.daffodil.lib.schema.annotation.props.gen.Representation
+import org.apache.daffodil.lib.schema.annotation.props.gen.TestKind
 import org.apache.daffodil.runtime1.dpath.NodeInfo.PrimType
+import org.apache.daffodil.runtime1.processors.ExplicitLengthEv
 
 /**
  * Builds up the state of generated code.
  */
 class CodeGeneratorState(private val root: ElementBase) {
+  // Longest length of data which parsers can read ahead at once (LIMIT_READ_AHEAD bytes)
+  private val MAX_READ_AHEAD_BITS = 4096L * 8
+  // Most elements an array can store inline in its parent's struct (larger or unbounded
+  // arrays store their elements out of line in storage allocated from an arena instead)
+  private val MAX_INLINE_OCCURS = 256
+  // Most elements to generate for an unbounded array beyond its minOccurs
+  private val MAX_RANDOM_UNBOUNDED_OCCURS = 16
+
   private val elementsAlreadySeen = mutable.Map[String, ElementBase]()
   private val structs = new mutable.Stack[ComplexCGState]()
   private val prototypes = mutable.ArrayBuffer[String]()
   private val erds = mutable.ArrayBuffer[String]()
   private val finalStructs = mutable.ArrayBuffer[String]()
   private val finalImplementation = mutable.ArrayBuffer[String]()
+  // Delimiters which can end delimited text in each enclosing term (innermost last)
+  private val delimiterScopes = mutable.ArrayBuffer[Seq[String]]()
+  // Names of static Delimiters definitions keyed by their contents
+  private val delimiters = mutable.Map[Seq[String], String]()
+  // Local names of the elements enclosing the current element (outermost first)
+  private val elementNames = mutable.ArrayBuffer[String]()
+  // Infoset paths to keep from the cProjection tunable (all paths are kept if empty)
+  private val projection = root.tunable.cProjection.split("\\s+").toSeq
+    .map(_.split('/').toSeq.filter(_.nonEmpty).map(_.split(':').last))
+    .filter(_.nonEmpty)
+  // Expression from the cFilter tunable which each record must pass to be kept (if any)
+  private val filterExpr = root.tunable.cFilter.trim.stripPrefix("{").stripSuffix("}").trim
+  // Root's children containing the fields the filter references which haven't been parsed yet
+  private val filterFields = mutable.Set[String]() ++= filterRootChildren
+  // Where the filter goes in the root's parserStatements and the static length parsed before it
+  private var filterPosition = -1
+  private var filterStaticLengthInBits = 0L
+  // Where the current child of the root starts in the root's parserStatements, and where
+  // the children which framing can skip start and end along with their data's lengths
+  private var rootChildStart = 0
+  private val rootChildSkips = mutable.ArrayBuffer[(Int, Int, Long)]()
 
   // Push a dummy topmost state to simplify code
   structs.push(new ComplexCGState(cStructName(root), root))
@@ -50,17 +85,83 @@ class CodeGeneratorState(private val root: ElementBase) {
   // Returns true if the generator is currently processing a choice
   def hasChoice: Boolean = structs.nonEmpty && structs.top.initChoiceStatements.nonEmpty
 
+  // Returns true if the current element will be stored in any enclosing choice's union
+  def isInsideChoice: Boolean = structs.exists(_.initChoiceStatements.nonEmpty)
+
+  // Starts a term whose separators and terminator can end delimited text inside it
+  def pushDelimiters(delimiters: Seq[String]): Unit = {
+    delimiterScopes += delimiters
+  }
+
+  // Finishes a term whose separators and terminator can end delimited text inside it
+  def popDelimiters(): Unit = {
+    delimiterScopes.remove(delimiterScopes.length - 1)
+  }
+
+  // Returns all delimiters which can end delimited text at this point (innermost first)
+  def delimitersInScope: Seq[String] = delimiterScopes.reverseIterator.flatten.toSeq
+
+  // Returns true if the element lies outside every projected path and its data can be
+  // skipped without being decoded because it has a fixed length and contains no element
+  // which a length, occursCount, choice dispatch key, or assert expression references
+  def isProjectedOut(context: ElementBase): Boolean = {
+    val path = elementNames.toSeq :+ context.name
+    val isOnProjection = projection.exists { p => p.startsWith(path) || path.startsWith(p) }
+    val isOffProjection = projection.nonEmpty && !isOnProjection
+    lazy val lengthInBits = context.maybeFixedLengthInBits
+    lazy val fixedLengthInBits = if (lengthInBits.isDefined) lengthInBits.get else 0L
+    isOffProjection && canSkipData(context, fixedLengthInBits)
+  }
+
+  // Returns true if the element's data has the given (nonzero) length and can be skipped
+  // without being decoded because nothing frames or pads the data and no length,
+  // occursCount, choice dispatch key, assert, or filter expression references its fields
+  private def canSkipData(context: ElementBase, lengthInBits: Long): Boolean = {
+    val hasNoFraming = !context.hasInitiator && !context.hasTerminator
+    val isSkippable = context.isKnownToBeAligned && context.hasNoSkipRegions
+    val isPlainScalar = context.isScalar && !hasChoice && !hasArray
+    val canSkip = lengthInBits > 0 && hasNoFraming && isSkippable && isPlainScalar
+    canSkip && !elementNamesInside(context).exists(referencedNames.contains)
+  }
+
+  // Returns true if the element is a child of the root outside of any choice
+  private def isRootChild(context: ElementBase): Boolean =
+    context != root && structs.top.context == root && !hasChoice
+
+  // Skips (or fills) a projected out element's data instead of parsing (or unparsing) it,
+  // leaving the element out of its parent's struct and ERD (and thus out of the infoset)
+  def addSkipStatements(context: ElementBase): Unit = {
+    val lengthInBits = context.maybeFixedLengthInBits.get
+    val order = bitOrderPrefix(context)
+    val octalFillByte = context.fillByteEv.constValue.toByte.toInt.toOctalString
+    structs.top.parserStatements += s"    parse_${order}skip_bits($lengthInBits, pstate);"
+    structs.top.unparserStatements +=
+      s"""    unparse_${order}alignment_bits(ustate->pu.bitPos0b + $lengthInBits, '\\$octalFillByte', ustate);
+         |    if (ustate->pu.error) return;""".stripMargin
+    // Skipping can fail only if the element's data can't be read ahead
+    addStaticLength(lengthInBits)
+    addReadCheck("    if (pstate->pu.error) return;")
+  }
+
   // Starts generating an element
   def pushElement(context: ElementBase): Unit = {
+    elementNames += context.name
+    if (isRootChild(context)) rootChildStart = structs.top.parserStatements.length
+
     // Generate a choice statement case if the element is in a choice element
     if (hasChoice) {
       val position = context.position
-      structs.top.initChoiceStatements ++= ChoiceBranchKeyCooker
+      val keys = ChoiceBranchKeyCooker
         .convertConstant(context.choiceBranchKey, context, forUnparse = false)
-        .map { key => s"    case $key:" }
-      structs.top.initChoiceStatements += s"        instance->_choice = $position;"
+      structs.top.initChoiceStatements ++= keys.map { key => s"    case $key:" }
+      // Switching branches frees and zeroes the storage which the branches share
+      structs.top.initChoiceStatements +=
+        s"        switch_choice(&instance->_base, &instance->_choice, $position, sizeof(*instance));"
       structs.top.parserStatements += s"    case $position:"
       structs.top.unparserStatements += s"    case $position:"
+      structs.top.randomizeStatements += s"    case $position:"
+      structs.top.resetStatements += s"    case $position:"
+      structs.top.choiceKeys ++= keys.headOption
     }
 
     if (context.isComplexType || context == root) {
@@ -85,15 +186,41 @@ class CodeGeneratorState(private val root: ElementBase) {
 
   // Finishes generating an element
   def popElement(context: ElementBase): Unit = {
+    elementNames.remove(elementNames.length - 1)
+    // Length of the element's data if known statically (otherwise 0)
+    var dataLengthInBits = 0L
+
     if (context.isComplexType) {
-      // Calculate padding if complex element has an explicit length
-      if (context.maybeFixedLengthInBits.isDefined && context.maybeFixedLengthInBits.get > 0) {
+      // Get the complex element's length (or its first elements' length if the rest of its
+      // length isn't known statically) before we finish generating the complex element
+      val hasExplicitLength =
+        context.maybeFixedLengthInBits.isDefined && context.maybeFixedLengthInBits.get > 0
+      val hasStaticLength = hasExplicitLength || structs.top.hasStaticLength
+      val lengthInBits =
+        if (hasExplicitLength) context.maybeFixedLengthInBits.get
+        else structs.top.staticLengthInBits
+
+      // Filter the record where the filter's fields have been parsed (or else at its end)
+      if (context == root && filterExpr.nonEmpty) {
+        val skipLength =
+          if (filterPosition < 0) ""
+          else if (hasExplicitLength) "end_bitPos0b - pstate->pu.bitPos0b"
+          else if (hasStaticLength) (lengthInBits - filterStaticLengthInBits).toString
+          else ""
+        if (filterPosition < 0) addFilterPosition()
+        structs.top.parserStatements(filterPosition) = filterStatement(context, skipLength)
+      }
+
+      // Skip (or fill) any bits the complex element's explicit length leaves unused here
+      // instead of in its ElementUnused and RightFill grams (which we treat as no-ops)
+      if (hasExplicitLength) {
+        val order = bitOrderPrefix(context)
         structs.top.parserStatements +=
-          s"""    parse_alignment_bits(end_bitPos0b, pstate);
+          s"""    parse_${order}alignment_bits(end_bitPos0b, pstate);
              |    if (pstate->pu.error) return;""".stripMargin
         val octalFillByte = context.fillByteEv.constValue.toByte.toInt.toOctalString
         structs.top.unparserStatements +=
-          s"""    unparse_alignment_bits(end_bitPos0b, '\\$octalFillByte', ustate);
+          s"""    unparse_${order}alignment_bits(end_bitPos0b, '\\$octalFillByte', ustate);
              |    if (ustate->pu.error) return;""".stripMargin
       }
 
@@ -105,6 +232,9 @@ class CodeGeneratorState(private val root: ElementBase) {
         addImplementation(context)
       }
       structs.pop()
+      addStaticLength(lengthInBits)
+      if (!hasStaticLength) addVariableLength()
+      if (hasStaticLength) dataLengthInBits = lengthInBits
 
       // Generate statements for parsing complex elements
       val indent1 = if (hasChoice) INDENT else NO_INDENT
@@ -122,10 +252,15 @@ class CodeGeneratorState(private val root: ElementBase) {
       structs.top.unparserStatements +=
         s"""$indent1$indent2    ${C}_unparseSelf(&instance->$e$deref, ustate);
            |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+      structs.top.randomizeStatements +=
+        s"""$indent1$indent2    ${C}_randomize(&instance->$e$deref, rstate);
+           |$indent1$indent2    if (rstate->error) return;""".stripMargin
+      structs.top.resetStatements += s"$indent1$indent2    ${C}_reset(&instance->$e$deref);"
     } else if (context == root) {
       // Treat a simple type root element as a hybrid of simple and complex types
       addFieldDeclaration(context) // struct member for element
       addComputations(context) // offset, ERD computations
+      addResetStatement(context) // statement clearing element's value
       addSimpleTypeERD(context) // ERD static initializer
       addStruct(context) // struct definition
       addImplementation(context)
@@ -135,6 +270,16 @@ class CodeGeneratorState(private val root: ElementBase) {
       if (elementNotSeenYet(context, cStructName(context))) {
         addSimpleTypeERD(context) // ERD static initializer
       }
+      addResetStatement(context) // statement clearing element's value
+      dataLengthInBits = simpleLengthInBits(context)
+
+      // Sample the simple element's statements, which run inline in its parent's functions
+      val indent1 = if (hasChoice) INDENT else NO_INDENT
+      val indent2 = if (hasArray) INDENT else NO_INDENT
+      val erd = erdName(context)
+      structs.top.fieldSamples += structs.top.parserStatements.length
+      structs.top.parserStatements += s"$indent1$indent2    PROFILE_FIELD(&$erd);"
+      structs.top.unparserStatements += s"$indent1$indent2    PROFILE_FIELD(&$erd);"
     }
 
     // Link the element into its parent element
@@ -147,9 +292,67 @@ class CodeGeneratorState(private val root: ElementBase) {
       structs.top.initChoiceStatements += break
       structs.top.parserStatements += break
       structs.top.unparserStatements += break
+      structs.top.randomizeStatements += break
+      structs.top.resetStatements += break
+    }
+
+    if (isRootChild(context)) {
+      // Let framing skip over the child's data (along with any skipped child before it)
+      // if nothing needs its fields
+      if (canSkipData(context, dataLengthInBits)) {
+        val end = structs.top.parserStatements.length
+        rootChildSkips.lastOption match {
+          case Some((start, lastEnd, lengthInBits)) if lastEnd == rootChildStart =>
+            rootChildSkips(rootChildSkips.length - 1) =
+              (start, end, lengthInBits + dataLengthInBits)
+          case _ =>
+            rootChildSkips += ((rootChildStart, end, dataLengthInBits))
+        }
+      }
+
+      // Filter the record as soon as the root has parsed all the fields the filter references
+      if (filterExpr.nonEmpty && filterPosition < 0) {
+        filterFields -= context.name
+        if (filterFields.isEmpty) addFilterPosition()
+      }
     }
   }
 
+  // Reserves a place for the filter in the root's parserStatements at this point
+  private def addFilterPosition(): Unit = {
+    filterPosition = structs.top.parserStatements.length
+    filterStaticLengthInBits = structs.top.staticLengthInBits
+    structs.top.parserStatements += ""
+  }
+
+  // Returns C statements which evaluate the filter and skip the given length (if
+  // any) to the end of the record without parsing the rest of it if the filter fails
+  private def filterStatement(context: ElementBase, skipLength: String): String = {
+    val order = bitOrderPrefix(context)
+    val skipStatements =
+      if (skipLength.nonEmpty && skipLength != "0")
+        s"""
+           |    if (pstate->filteredOut)
+           |    {
+           |        parse_${order}skip_bits($skipLength, pstate);
+           |        return;
+           |    }""".stripMargin
+      else
+        ""
+    s"""    // Mark the record if it doesn't pass the filter
+       |    pstate->filteredOut = !(${cExpression(filterExpr)});$skipStatements""".stripMargin
+  }
+
+  // Returns the local names of the root's children whose fields the filter references
+  private def filterRootChildren: Set[String] = {
+    val field = """/[\p{L}_][\p{L}:_\-.0-9/]*""".r
+    field
+      .findAllIn(filterExpr)
+      .map(_.split('/').toSeq.filter(_.nonEmpty).map(_.split(':').last))
+      .collect { case steps if steps.length > 1 => steps(1) }
+      .toSet
+  }
+
   // Starts generating a reoccurring element (array element)
   def pushArray(context: SchemaComponent): Unit = {
     val C = structs.top.C
@@ -172,10 +375,12 @@ class CodeGeneratorState(private val root: ElementBase) {
     val declarations = structs.top.declarations
     val offsetComputations = structs.top.offsetComputations
     val erdComputations = structs.top.erdComputations
+    val lengthInBits = arrayLengthInBits(e)
     structs.pop()
     structs.top.declarations ++= declarations
     structs.top.offsetComputations ++= offsetComputations
     structs.top.erdComputations ++= erdComputations
+    if (lengthInBits > 0) addStaticLength(lengthInBits) else addVariableLength()
 
     // Now call the array's methods instead of the array's element's methods
     val indent = if (hasChoice) INDENT else NO_INDENT
@@ -191,10 +396,17 @@ class CodeGeneratorState(private val root: ElementBase) {
     structs.top.unparserStatements +=
       s"""$indent    ${arrayName}_unparseSelf(instance, ustate);
          |$indent    if (ustate->pu.error) return;""".stripMargin
+    structs.top.randomizeStatements +=
+      s"""$indent    ${arrayName}_randomize(instance, rstate);
+         |$indent    if (rstate->error) return;""".stripMargin
+    structs.top.resetStatements += s"$indent    ${arrayName}_reset(instance);"
   }
 
   // Generates choice member/ERD and switch statements for a choice group
   def addBeforeSwitchStatements(): Unit = {
+    // The choice's length depends on which branch gets parsed
+    addVariableLength()
+
     val context = structs.top.context
     val erd = erdName(context)
     val dispatchField = choiceDispatchField(context)
@@ -240,6 +452,12 @@ class CodeGeneratorState(private val root: ElementBase) {
            |
            |    switch (instance->_choice)
            |    {""".stripMargin
+      val randomizeStatement =
+        s"""    rstate->error = instance->_base.erd->initChoice(&instance->_base);
+           |    if (rstate->error) return;
+           |
+           |    switch (instance->_choice)
+           |    {""".stripMargin
 
       // Prevent redundant definitions on reused types
       if (elementNotSeenYet(context, erd)) {
@@ -251,6 +469,9 @@ class CodeGeneratorState(private val root: ElementBase) {
       structs.top.initChoiceStatements += initChoiceStatement
       structs.top.parserStatements += parseStatement
       structs.top.unparserStatements += unparseStatement
+      structs.top.choiceKeysPosition = structs.top.randomizeStatements.length
+      structs.top.randomizeStatements += randomizeStatement
+      structs.top.choiceResetPosition = structs.top.resetStatements.length
     }
   }
 
@@ -279,11 +500,33 @@ class CodeGeneratorState(private val root: ElementBase) {
            |        ustate->pu.error = &error;
            |        return;
            |    }""".stripMargin
+      val randomizeStatement = s"""    }"""
+      // Pick one of the branches' keys before initChoice picks the branch to randomize
+      val dispatchField = choiceDispatchField(structs.top.context)
+      val keys = structs.top.choiceKeys
+      val randomizeKeyStatement =
+        s"""    static const int64_t keys[] = ${keys.mkString("{", ", ", "}")};
+           |    $dispatchField = keys[random_index(${keys.length}, rstate)];
+           |""".stripMargin
 
       structs.top.declarations += declaration
       structs.top.initChoiceStatements += initChoiceStatement
       structs.top.parserStatements += parseStatement
       structs.top.unparserStatements += unparseStatement
+      structs.top.randomizeStatements
+        .insert(structs.top.choiceKeysPosition, randomizeKeyStatement)
+      structs.top.randomizeStatements += randomizeStatement
+      // Join the switch's reset statements into one statement so reversing them keeps it whole
+      // (keeping _choice lets initChoice tell whether the next record takes another branch)
+      val position = structs.top.choiceResetPosition
+      val caseStatements = structs.top.resetStatements.drop(position)
+      val resetStatement =
+        s"""    switch (instance->_choice)
+           |    {
+           |${caseStatements.mkString("\n")}
+           |    }""".stripMargin
+      structs.top.resetStatements.remove(position, caseStatements.length)
+      structs.top.resetStatements += resetStatement
     }
   }
 
@@ -304,6 +547,73 @@ class CodeGeneratorState(private val root: ElementBase) {
     if (unparseStatement.nonEmpty) structs.top.unparserStatements += unparseStatement
   }
 
+  // Adds a C statement to fill a primitive value element with a random value
+  def addRandomizeStatement(randomizeStatement: String): Unit = {
+    if (randomizeStatement.nonEmpty) structs.top.randomizeStatements += randomizeStatement
+  }
+
+  // Adds a static definition of delimiters (and escape characters) to match in data
+  // unless an identical definition exists already, and returns its C name
+  def addDelimiters(
+    schemaName: String,
+    strings: Seq[String],
+    candidates: String,
+    escapeChar: String,
+    escapeEscapeChar: String
+  ): String = {
+    val key = Seq(schemaName, candidates, escapeChar, escapeEscapeChar) ++ strings
+    delimiters.getOrElseUpdate(
+      key, {
+        val name = s"delimiters_${delimiters.size + 1}"
+        val initStrings = if (strings.isEmpty) "NULL" else strings.mkString(", ")
+        erds +=
+          s"""static const char *const ${name}_strings[] = {$initStrings};
+             |static const Delimiters $name = {
+             |    $schemaName, // name
+             |    ${name}_strings, ${strings.length}, // strings, numStrings
+             |    $candidates, // candidates
+             |    $escapeChar, $escapeEscapeChar // escapeChar, escapeEscapeChar
+             |};
+             |""".stripMargin
+        name
+      }
+    )
+  }
+
+  // Adds a C statement to clear a simple element's value (except hexBinary and string
+  // elements, which keep their storage so parsing the next infoset can reuse it)
+  private def addResetStatement(context: ElementBase): Unit = {
+    val primType = getPrimType(context)
+    if (primType != PrimType.HexBinary && primType != PrimType.String) {
+      val indent1 = if (hasChoice) INDENT else NO_INDENT
+      val indent2 = if (hasArray) INDENT else NO_INDENT
+      val deref = if (hasArray) "[i]" else ""
+      structs.top.resetStatements += s"$indent1$indent2    instance->${cName(context)}$deref = 0;"
+    }
+  }
+
+  // Adds the length of an element's data which is known statically to the length
+  // of data which can be read ahead before parsing the current complex element
+  def addStaticLength(lengthInBits: Long): Unit = {
+    if (structs.top.hasStaticLength) structs.top.staticLengthInBits += lengthInBits
+  }
+
+  // Stops adding any more lengths to the length of data which can be read ahead
+  // because the next element's length will be known only at runtime
+  def addVariableLength(): Unit = {
+    structs.top.hasStaticLength = false
+  }
+
+  // Adds a C statement checking for a read error after parsing an element whose length
+  // was just added, which we can leave out if that element's data will be read ahead
+  def addReadCheck(readCheck: String): Unit = {
+    if (structs.top.hasStaticLength) {
+      val position = structs.top.parserStatements.length
+      structs.top.readChecks += (position -> structs.top.staticLengthInBits)
+    }
+    structs.top.parserStatements += readCheck
+  }
+
   // Generates a C header to define the Daffodil version
   def generateVersionHeader: String = {
     val daffodil = this.getClass.getPackage.getImplementationTitle
@@ -331,7 +641,7 @@ class CodeGeneratorState(private val root: ElementBase) {
          |#include <stdbool.h>  // for bool
          |#include <stddef.h>   // for size_t
          |#include <stdint.h>   // for uint8_t, int16_t, int32_t, int64_t, uint32_t, int8_t, uint16_t, uint64_t
-         |#include "infoset.h"  // for InfosetBase, HexBinary
+         |#include "infoset.h"  // for InfosetBase, HexBinary, String
          |// clang-format on
          |
          |// Define schema version (will be empty if schema did not define any version string)
@@ -357,13 +667,17 @@ class CodeGeneratorState(private val root: ElementBase) {
       s"""// auto-maintained by iwyu
          |// clang-format off
          |#include "generated_code.h"
-         |#include <stdbool.h>    // for false, bool, true
-         |#include <stddef.h>     // for NULL, size_t
-         |#include <string.h>     // for memcmp, memset
-         |#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-         |#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-         |#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-         |#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+         |#include <stdbool.h>     // for false, bool, true
+         |#include <stddef.h>      // for NULL, size_t
+         |#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+         |#include <string.h>      // for memcmp
+         |#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+         |#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+         |#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+         |#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+         |#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+         |#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+         |#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
          |// clang-format on
          |
          |// Declare prototypes for easier compilation
@@ -380,24 +694,49 @@ class CodeGeneratorState(private val root: ElementBase) {
          |// Initialize, parse, and unparse nodes of the infoset
          |
          |$finalImplementation
-         |// Get an infoset (optionally clearing it first) for parsing/walking
+         |// Get an infoset (optionally clearing it first) for parsing/walking.
+         |// Each thread gets its own infoset.
          |
          |InfosetBase *
          |get_infoset(bool clear_infoset)
          |{
-         |    static $rootName infoset;
+         |    static _Thread_local $rootName infoset;
+         |    static _Thread_local bool initialized;
          |
          |    if (clear_infoset)
          |    {
-         |        // If your infoset contains hexBinary prefixed length elements,
-         |        // you may want to walk infoset first to free their malloc'ed
-         |        // storage - we are not handling that case for now...
-         |        memset(&infoset, 0, sizeof(infoset));
-         |        ${rootName}_initERD(&infoset, (InfosetBase *)&infoset);
+         |        // Initialize the infoset's ERD and parent pointers only once,
+         |        // then clear only the values which the last parse filled in
+         |        if (initialized)
+         |        {
+         |            ${rootName}_reset(&infoset);
+         |        }
+         |        else
+         |        {
+         |            ${rootName}_initERD(&infoset, (InfosetBase *)&infoset);
+         |            initialized = true;
+         |        }
          |    }
          |
          |    return &infoset._base;
          |}
+         |
+         |// Frame a record by parsing only the fields needed to find where it
+         |// ends and skipping over the rest of its data for building an index
+         |
+         |void
+         |frame_record(InfosetBase *infoset, PState *pstate)
+         |{
+         |    ${rootName}_frameSelf(($rootName *)infoset, pstate);
+         |}
+         |
+         |// Fill an infoset with random values for generating data
+         |
+         |void
+         |randomize_infoset(InfosetBase *infoset, RState *rstate)
+         |{
+         |    ${rootName}_randomize(($rootName *)infoset, rstate);
+         |}
          |""".stripMargin
     code.replace("\r\n", "\n").replace("\n", System.lineSeparator)
   }
@@ -540,11 +879,26 @@ class CodeGeneratorState(private val root: ElementBase) {
   // Generates a complex element's initERD, parseSelf, unparseSelf functions
   private def addImplementation(context: ElementBase): Unit = {
     val C = cStructName(context)
+    val erd = erdName(context)
     val initERDStatements = structs.top.initERDStatements.mkString("\n")
     val initChoiceStatements = structs.top.initChoiceStatements.mkString("\n")
+    // Clear fields in reverse order so arrays get cleared before the fields holding their sizes
+    val resetStatements =
+      if (structs.top.resetStatements.nonEmpty)
+        structs.top.resetStatements.reverse.mkString("\n")
+      else
+        s"""    // Empty struct, but need to prevent compiler warnings
+         |    UNUSED(instance);""".stripMargin
+    val readAheadLengthInBits =
+      if (context.isComplexType && context.maybeFixedLengthInBits.isDefined)
+        context.maybeFixedLengthInBits.get.min(MAX_READ_AHEAD_BITS)
+      else if (structs.top.staticLengthInBits <= MAX_READ_AHEAD_BITS)
+        structs.top.staticLengthInBits
+      else
+        0L
     val parserStatements =
       if (structs.top.parserStatements.nonEmpty)
-        structs.top.parserStatements.mkString("\n")
+        readAheadStatements(readAheadLengthInBits).mkString("\n")
       else
         s"""    // Empty struct, but need to prevent compiler warnings
          |    UNUSED(instance);
@@ -556,6 +910,13 @@ class CodeGeneratorState(private val root: ElementBase) {
         s"""    // Empty struct, but need to prevent compiler warnings
          |    UNUSED(instance);
          |    UNUSED(ustate);""".stripMargin
+    val randomizeStatements =
+      if (structs.top.randomizeStatements.nonEmpty)
+        structs.top.randomizeStatements.mkString("\n")
+      else
+        s"""    // Empty struct, but need to prevent compiler warnings
+         |    UNUSED(instance);
+         |    UNUSED(rstate);""".stripMargin
     val prototypeInitChoice =
       if (hasChoice)
         s"static const Error *${C}_initChoice($C *instance);\n"
@@ -572,28 +933,63 @@ class CodeGeneratorState(private val root: ElementBase) {
          |""".stripMargin
       else
         ""
+    val prototypeFrameSelf =
+      if (context == root)
+        s"\nstatic void ${C}_frameSelf($C *instance, PState *pstate);"
+      else
+        ""
+    val implementFrameSelf =
+      if (context == root) {
+        val framerStatements =
+          if (structs.top.parserStatements.nonEmpty)
+            this.framerStatements(readAheadLengthInBits).mkString("\n")
+          else
+            parserStatements
+        s"""
+           |static void
+           |${C}_frameSelf($C *instance, PState *pstate)
+           |{
+           |$framerStatements
+           |}
+           |""".stripMargin
+      } else
+        ""
     val prototypeFunctions =
       s"""${prototypeInitChoice}static void ${C}_parseSelf($C *instance, PState *pstate);
-         |static void ${C}_unparseSelf(const $C *instance, UState *ustate);""".stripMargin
+         |static void ${C}_unparseSelf(const $C *instance, UState *ustate);$prototypeFrameSelf""".stripMargin
     val functions =
       s"""static void
          |${C}_initERD($C *instance, InfosetBase *parent)
          |{
          |$initERDStatements
          |}
+         |
+         |static void
+         |${C}_reset($C *instance)
+         |{
+         |$resetStatements
+         |}
          |$implementInitChoice
          |static void
+         |${C}_randomize($C *instance, RState *rstate)
+         |{
+         |$randomizeStatements
+         |}
+         |
+         |static void
          |${C}_parseSelf($C *instance, PState *pstate)
          |{
+         |    PROFILE_ELEMENT(&$erd, &pstate->pu);
          |$parserStatements
          |}
          |
          |static void
          |${C}_unparseSelf(const $C *instance, UState *ustate)
          |{
+         |    PROFILE_ELEMENT(&$erd, &ustate->pu);
          |$unparserStatements
          |}
-         |""".stripMargin
+         |$implementFrameSelf""".stripMargin
 
     prototypes += prototypeFunctions
     finalImplementation += functions
@@ -620,6 +1016,7 @@ class CodeGeneratorState(private val root: ElementBase) {
       case PrimType.Double => "PRIMITIVE_DOUBLE"
       case PrimType.Float => "PRIMITIVE_FLOAT"
       case PrimType.HexBinary => "PRIMITIVE_HEXBINARY"
+      case PrimType.String => "PRIMITIVE_STRING"
       case PrimType.Short => "PRIMITIVE_INT16"
       case PrimType.Int => "PRIMITIVE_INT32"
       case PrimType.Long => "PRIMITIVE_INT64"
@@ -669,6 +1066,7 @@ class CodeGeneratorState(private val root: ElementBase) {
         case PrimType.Double => "double     "
         case PrimType.Float => "float      "
         case PrimType.HexBinary => "HexBinary  "
+        case PrimType.String => "String     "
         case PrimType.Short => "int16_t    "
         case PrimType.Int => "int32_t    "
         case PrimType.Long => "int64_t    "
@@ -684,31 +1082,38 @@ class CodeGeneratorState(private val root: ElementBase) {
     }
     val e = cName(child)
     val arraySize = arrayMaxOccurs(child)
-    val arrayDef = if (arraySize > 0) s"[$arraySize]" else ""
+    val outOfLine = hasOutOfLineStorage(child)
+    val arrayDef = if (arraySize > 0 && !outOfLine) s"[$arraySize]" else ""
+    val pointer = if (outOfLine) "*" else ""
     val indent = if (hasChoice) INDENT else NO_INDENT
-    val declaration = s"$indent    $definition $e$arrayDef;"
+    val declaration = s"$indent    $definition $pointer$e$arrayDef;"
 
     structs.top.declarations += declaration
 
     // Add an array member to store a fixed length hexBinary element if needed
-    if (
-      child.isSimpleType && child.isFixedLength && child.optPrimType.get == PrimType.HexBinary
-      && child.maybeFixedLengthInBits.get > 0
-    ) {
+    if (hasFixedLengthHexBinary(child)) {
       val fixedLength = child.maybeFixedLengthInBits.get / 8
-      val declaration2 = s"$indent    uint8_t     _a_$e$arrayDef[$fixedLength];"
+      val declaration2 =
+        if (outOfLine) s"$indent    uint8_t     (*_a_$e)[$fixedLength];"
+        else s"$indent    uint8_t     _a_$e$arrayDef[$fixedLength];"
       structs.top.declarations += declaration2
     }
+
+    // Add a member to store how many elements an out-of-line array can hold
+    if (outOfLine) {
+      val declaration3 = s"$indent    size_t      _c_$e; // capacity of $e's storage"
+      structs.top.declarations += declaration3
+    }
   }
 
   // Adds an element's ERD & offset to its parent element's children ERD & offset computations.
   private def addComputations(child: ElementBase): Unit = {
     val C = structs.top.C
     val e = cName(child)
-    val hasArray = arrayMaxOccurs(child) > 0
+    val hasArray = arrayMaxOccurs(child) != 0
     val arrayName = s"array_${cStructName(child)}$C"
     val erd = if (hasArray) s"${arrayName}ERD" else erdName(child)
-    val deref = if (hasArray) "[0]" else ""
+    val deref = if (hasArray && !hasOutOfLineStorage(child)) "[0]" else ""
     val offsetComputation =
       s"    (const char *)&${C}_compute_offsets.$e$deref - (const char *)&${C}_compute_offsets"
     val erdComputation = s"    &$erd"
@@ -716,22 +1121,31 @@ class CodeGeneratorState(private val root: ElementBase) {
     structs.top.erdComputations += erdComputation
   }
 
-  // Generates an array's ERD, childrenOffsets, childrenERDs, initERD, parseSelf, unparseSelf, getArraySize
+  // Generates an array's ERD, childrenOffsets, childrenERDs, initERD, parseSelf, unparseSelf,
+  // getArraySize, and reserve (if the array stores its elements out of line)
   private def addArrayImplementation(elem: ElementBase): Unit = {
     val C = structs.top.C
     val e = cName(elem)
     val arrayName = s"array_${cStructName(elem)}$C"
     val erd = erdName(elem)
-    val maxOccurs = elem.maxOccurs
+    val maxOccurs = if (elem.maxOccurs < 0) "SIZE_MAX" else elem.maxOccurs.toString
     val minOccurs = elem.minOccurs
     val qNameInit = defineQNameInit(elem)
+    val outOfLine = hasOutOfLineStorage(elem)
 
     // Add the array's ERD, childrenOffsets, childrenERDs
+    val childOffset =
+      if (outOfLine)
+        s"sizeof(*${arrayName}_compute_offsets.$e)"
+      else
+        s"(const char *)&${arrayName}_compute_offsets.$e[1] - (const char *)&${arrayName}_compute_offsets.$e[0]"
+    val reserveArray =
+      if (outOfLine) s", .reserveArray = (ReserveArray)&${arrayName}_reserve" else ""
     val arrayERD =
       s"""static const $C ${arrayName}_compute_offsets;
          |
          |static const size_t ${arrayName}_childrenOffsets[1] = {
-         |    (const char *)&${arrayName}_compute_offsets.$e[1] - (const char *)&${arrayName}_compute_offsets.$e[0]
+         |    $childOffset
          |};
          |
          |static const ERD *const ${arrayName}_childrenERDs[1] = {
@@ -746,30 +1160,74 @@ class CodeGeneratorState(private val root: ElementBase) {
          |    ${arrayName}_childrenERDs,
          |    (ERDParseSelf)&${arrayName}_parseSelf,
          |    (ERDUnparseSelf)&${arrayName}_unparseSelf,
-         |    {.getArraySize = (GetArraySize)&${arrayName}_getArraySize}
+         |    {.getArraySize = (GetArraySize)&${arrayName}_getArraySize$reserveArray}
          |};
          |""".stripMargin
     erds += arrayERD
 
     // Add the array's initERD, parseSelf, unparseSelf, getArraySize functions
+    val capacity = if (outOfLine) s"instance->_c_$e" else maxOccurs
     val initERDStatements =
       if (structs.top.initERDStatements.nonEmpty)
         s"""    UNUSED(parent);
-         |    for (size_t i = 0; i < $maxOccurs; i++)
+         |    for (size_t i = 0; i < $capacity; i++)
          |    {
          |${structs.top.initERDStatements.mkString("\n")}
          |    }""".stripMargin
       else
         s"""    UNUSED(instance);
          |    UNUSED(parent);""".stripMargin
+    // Clear only the elements which the last parse filled in
+    val resetStatements =
+      if (structs.top.resetStatements.nonEmpty)
+        s"""    const size_t arraySize = ${arrayName}_getArraySize(instance);
+         |    const size_t numElements = arraySize < $capacity ? arraySize : $capacity;
+         |
+         |    for (size_t i = 0; i < numElements; i++)
+         |    {
+         |${structs.top.resetStatements.mkString("\n")}
+         |    }""".stripMargin
+      else
+        "    UNUSED(instance);"
+    val lengthInBits = arrayLengthInBits(elem)
+    val readAheadLengthInBits = if (lengthInBits <= MAX_READ_AHEAD_BITS) lengthInBits else 0L
+    val readAheadStatement =
+      if (readAheadLengthInBits > 0)
+        s"""    parse_read_ahead($readAheadLengthInBits, pstate);
+           |    if (pstate->pu.error) return;
+           |""".stripMargin
+      else
+        ""
+    // Every element's read checks are redundant if the whole array gets read ahead
+    val elementStatements =
+      if (readAheadLengthInBits > 0)
+        structs.top.parserStatements.zipWithIndex
+          .filterNot { case (_, i) => structs.top.readChecks.contains(i) }
+          .map(_._1)
+      else
+        structs.top.parserStatements
+    val parseReserveStatement =
+      if (outOfLine)
+        s"""    pstate->pu.error = ${arrayName}_reserve(instance, arraySize);
+           |    if (pstate->pu.error) return;
+           |""".stripMargin
+      else
+        ""
+    val randomizeReserveStatement =
+      if (outOfLine)
+        s"""
+           |    rstate->error = ${arrayName}_reserve(instance, arraySize);
+           |    if (rstate->error) return;""".stripMargin
+      else
+        ""
     val parserStatements =
-      s"""    const size_t arraySize = ${arrayName}_getArraySize(instance);
+      s"""$readAheadStatement    const size_t arraySize = ${arrayName}_getArraySize(instance);
          |    validate_array_bounds("$arrayName", arraySize, $minOccurs, $maxOccurs, &pstate->pu);
          |    if (pstate->pu.error) return;
-         |
+         |$parseReserveStatement
          |    for (size_t i = 0; i < arraySize; i++)
          |    {
-         |${structs.top.parserStatements.mkString("\n")}
+         |${elementStatements.mkString("\n")}
          |    }""".stripMargin
     val unparserStatements =
       s"""    const size_t arraySize = ${arrayName}_getArraySize(instance);
@@ -780,12 +1238,64 @@ class CodeGeneratorState(private val root: ElementBase) {
          |    {
          |${structs.top.unparserStatements.mkString("\n")}
          |    }""".stripMargin
+    val randomizeStatements =
+      s"""${randomArraySize(elem, arrayName)}$randomizeReserveStatement
+         |
+         |    for (size_t i = 0; i < arraySize; i++)
+         |    {
+         |${structs.top.randomizeStatements.mkString("\n")}
+         |    }""".stripMargin
     val arraySizeStatements = getOccursCount(elem)
+    // Both the elements and any fixed length hexBinary elements' bytes need storage
+    val storages = if (hasFixedLengthHexBinary(elem)) Seq(e, s"_a_$e") else Seq(e)
+    val growStatements = storages.map { a =>
+      s"        void *new_$a = arena_grow(instance->$a, capacity, newCapacity, sizeof(*instance->$a));"
+    }
+    val failedCondition = storages.map(a => s"!new_$a").mkString(" || ")
+    val assignStatements = storages.map(a => s"        instance->$a = new_$a;")
+    val reserveStatements =
+      s"""    static Error error = {ERR_ARRAY_ALLOC, {0}};
+         |
+         |    const size_t capacity = instance->_c_$e;
+         |    if (count > capacity)
+         |    {
+         |        // Grow storage geometrically so growing one element at a time stays cheap
+         |        const size_t newCapacity = count > 2 * capacity ? count : 2 * capacity;
+         |${growStatements.mkString("\n")}
+         |        if ($failedCondition)
+         |        {
+         |            error.arg.d64 = (int64_t)count;
+         |            return &error;
+         |        }
+         |${assignStatements.mkString("\n")}
+         |        instance->_c_$e = newCapacity;
+         |
+         |        // Moving elements means initializing any pointers to or within them again
+         |        ${arrayName}_initERD(instance, NULL);
+         |    }
+         |
+         |    return NULL;""".stripMargin
+    val prototypeReserve =
+      if (outOfLine)
+        s"\nstatic const Error *${arrayName}_reserve($C *instance, size_t count);"
+      else
+        ""
+    val implementReserve =
+      if (outOfLine)
+        s"""
+         |static const Error *
+         |${arrayName}_reserve($C *instance, size_t count)
+         |{
+         |$reserveStatements
+         |}
+         |""".stripMargin
+      else
+        ""
 
     val prototypeFunctions =
       s"""static void ${arrayName}_parseSelf($C *instance, PState *pstate);
          |static void ${arrayName}_unparseSelf(const $C *instance, UState *ustate);
-         |static size_t ${arrayName}_getArraySize(const $C *instance);""".stripMargin
+         |static size_t ${arrayName}_getArraySize(const $C *instance);$prototypeReserve""".stripMargin
     val functions =
       s"""static void
          |${arrayName}_initERD($C *instance, InfosetBase *parent)
@@ -794,28 +1304,97 @@ class CodeGeneratorState(private val root: ElementBase) {
          |}
          |
          |static void
+         |${arrayName}_reset($C *instance)
+         |{
+         |$resetStatements
+         |}
+         |
+         |static void
          |${arrayName}_parseSelf($C *instance, PState *pstate)
          |{
+         |    PROFILE_ELEMENT(&${arrayName}ERD, &pstate->pu);
          |$parserStatements
          |}
          |
          |static void
          |${arrayName}_unparseSelf(const $C *instance, UState *ustate)
          |{
+         |    PROFILE_ELEMENT(&${arrayName}ERD, &ustate->pu);
          |$unparserStatements
          |}
          |
+         |static void
+         |${arrayName}_randomize($C *instance, RState *rstate)
+         |{
+         |$randomizeStatements
+         |}
+         |
          |static size_t
          |${arrayName}_getArraySize(const $C *instance)
          |{
          |$arraySizeStatements
          |}
-         |""".stripMargin
+         |$implementReserve""".stripMargin
 
     prototypes += prototypeFunctions
     finalImplementation += functions
   }
 
+  // Returns the complex element's parser statements, reading ahead the given length
+  // of data first with a single bounds check and leaving out the read checks which
+  // become redundant because their elements' data lies within the read ahead data
+  private def readAheadStatements(lengthInBits: Long): Seq[String] = {
+    if (lengthInBits > 0) {
+      val readAheadStatement =
+        s"""    parse_read_ahead($lengthInBits, pstate);
+           |    if (pstate->pu.error) return;""".stripMargin
+      val statements = structs.top.parserStatements.zipWithIndex
+        .filterNot { case (_, i) => structs.top.readChecks.get(i).exists(_ <= lengthInBits) }
+        .map(_._1)
+      readAheadStatement +: statements.toSeq
+    } else {
+      structs.top.parserStatements.toSeq
+    }
+  }
+
+  // Returns the root's parser statements without the filter or simple elements' samples
+  // and with each child which framing can skip parsed by skipping over its data instead,
+  // letting an index find where each record ends without parsing most of the record's fields
+  private def framerStatements(lengthInBits: Long): Seq[String] = {
+    val order = bitOrderPrefix(root)
+    val statements = structs.top.parserStatements.zipWithIndex.flatMap { case (statement, i) =>
+      val isReadCheck = structs.top.readChecks.get(i).exists(_ <= lengthInBits)
+      val isFieldSample = structs.top.fieldSamples.contains(i)
+      rootChildSkips.find { case (start, end, _) => start <= i && i < end } match {
+        case Some((start, _, dataLengthInBits)) if i == start =>
+          Seq(s"""    parse_${order}skip_bits($dataLengthInBits, pstate);
+                 |    if (pstate->pu.error) return;""".stripMargin)
+        case Some(_) => Seq()
+        case None if i == filterPosition || isReadCheck || isFieldSample => Seq()
+        case None => Seq(statement)
+      }
+    }
+    val readAheadStatement =
+      if (lengthInBits > 0)
+        Seq(s"""    parse_read_ahead($lengthInBits, pstate);
+               |    if (pstate->pu.error) return;""".stripMargin)
+      else
+        Seq()
+    // Skipping every child which reads the instance leaves it unused
+    val usesInstance = statements.exists("\\binstance\\b".r.findFirstIn(_).nonEmpty)
+    val unusedStatement = if (usesInstance) Seq() else Seq("    UNUSED(instance);")
+    unusedStatement ++ readAheadStatement ++ statements.toSeq
+  }
+
+  // Returns the length of an array's data if the array has a fixed number of elements
+  // with statically known lengths, otherwise returns zero
+  private def arrayLengthInBits(e: ElementBase): Long = {
+    if (e.occursCountKind == OccursCountKind.Fixed && structs.top.hasStaticLength)
+      e.maxOccurs * structs.top.staticLengthInBits
+    else
+      0L
+  }
+
   // Converts a choiceDispatchKey expression into a C struct dot notation
   // to access the C struct field containing the key's runtime value.
   private def choiceDispatchField(context: ElementBase): String = {
@@ -904,6 +1483,7 @@ class CodeGeneratorState(private val root: ElementBase) {
           case _ => e.SDE("Floating point lengths other than 32 or 64 bits are not supported.")
         }
       case PrimType.HexBinary => PrimType.HexBinary
+      case PrimType.String => PrimType.String
       case PrimType.Byte | PrimType.Short | PrimType.Int | PrimType.Long | PrimType.Integer =>
         lengthInBits match {
           case n if n <= 8 => PrimType.Byte
@@ -939,16 +1519,16 @@ class CodeGeneratorState(private val root: ElementBase) {
   }
 
   // Returns the given element's maxOccurs if it is an array element
-  // with a finite maxOccurs > 0, otherwise returns zero for scalar
-  // elements and array elements with unbounded maxOccurs (we don't
-  // support unbounded arrays in C right now)
+  // with a finite maxOccurs > 0, -1 if it is an array element with an
+  // unbounded maxOccurs (which needs an occursCount expression to give
+  // its size), otherwise returns zero for scalar elements
   private def arrayMaxOccurs(e: ElementBase): Int = {
     val arrayMaxOccurs = e.occursCountKind match {
       case OccursCountKind.Fixed if e.maxOccurs > 1 => e.maxOccurs
       case OccursCountKind.Fixed if e.maxOccurs == 1 => 0
       case OccursCountKind.Implicit if e.minOccurs == 1 && e.maxOccurs == 1 => 0
       case OccursCountKind.Implicit if e.maxOccurs > 0 => e.maxOccurs
-      case OccursCountKind.Expression if e.maxOccurs > 0 => e.maxOccurs
+      case OccursCountKind.Expression if e.maxOccurs > 0 || e.maxOccurs == -1 => e.maxOccurs
       case _ =>
         e.SDE(
           "occursCountKind %s minOccurs %d maxOccurs %d is not supported in C code generator",
@@ -960,6 +1540,20 @@ class CodeGeneratorState(private val root: ElementBase) {
     arrayMaxOccurs
   }
 
+  // Returns true if the given element is an array element which stores its elements
+  // out of line because it may have too many elements to store them inline
+  private def hasOutOfLineStorage(e: ElementBase): Boolean = {
+    val maxOccurs = arrayMaxOccurs(e)
+    maxOccurs < 0 || maxOccurs > MAX_INLINE_OCCURS
+  }
+
+  // Returns true if the given element is a fixed length hexBinary element
+  // which needs an array member to store its bytes
+  private def hasFixedLengthHexBinary(e: ElementBase): Boolean = {
+    val isHexBinary = e.isSimpleType && e.optPrimType.get == PrimType.HexBinary
+    isHexBinary && e.isFixedLength && e.maybeFixedLengthInBits.get > 0
+  }
+
   // Returns the code needed to get the size of an array of elements, which
   // may be either a constant (maxOccurs) or an expression (occursCount)
   // which accesses a particular C struct field.
@@ -969,17 +1563,7 @@ class CodeGeneratorState(private val root: ElementBase) {
         s"""    UNUSED(instance);
            |    return ${e.maxOccurs};""".stripMargin
       case OccursCountKind.Expression =>
-        // Extract expression from {...} in element's occursCount attribute
-        val expr = e.occursCountExpr.prettyExpr
-          .filterNot(_.isWhitespace)
-          .stripPrefix("{")
-          .stripSuffix("}")
-          .stripPrefix("xs:long(")
-          .stripSuffix(")")
-        // Convert expression to a C struct field access, stripping the first up
-        // path (if any) because an occursCount's parent is the same struct while
-        // a choiceDispatchKey's parent is an enclosing struct.
-        val fieldAccess = cStructFieldAccess(expr.stripPrefix("../"))
+        val fieldAccess = occursCountFieldAccess(e)
         // Generate the rest of the code needed to access the field
         if (fieldAccess.startsWith("instance"))
           s"""    return $fieldAccess;"""
@@ -997,6 +1581,36 @@ class CodeGeneratorState(private val root: ElementBase) {
     occursCount
   }
 
+  // Returns the C struct field access which holds an array's occursCount
+  private def occursCountFieldAccess(e: ElementBase): String = {
+    // Extract expression from {...} in element's occursCount attribute
+    val expr = e.occursCountExpr.prettyExpr
+      .filterNot(_.isWhitespace)
+      .stripPrefix("{")
+      .stripSuffix("}")
+      .stripPrefix("xs:long(")
+      .stripSuffix(")")
+    // Convert expression to a C struct field access, stripping the first up
+    // path (if any) because an occursCount's parent is the same struct while
+    // a choiceDispatchKey's parent is an enclosing struct.
+    val fieldAccess = cStructFieldAccess(expr.stripPrefix("../"))
+    fieldAccess
+  }
+
+  // Returns the code needed to pick a random size for an array of elements and
+  // store that size in the occursCount field which the array's size depends on
+  private def randomArraySize(e: ElementBase, arrayName: String): String = {
+    e.occursCountKind match {
+      case OccursCountKind.Expression =>
+        val maxOccurs =
+          if (e.maxOccurs < 0) e.minOccurs + MAX_RANDOM_UNBOUNDED_OCCURS else e.maxOccurs
+        s"""    const size_t arraySize = random_uint(${e.minOccurs}, $maxOccurs, rstate);
+           |    ${occursCountFieldAccess(e)} = arraySize;""".stripMargin
+      case _ =>
+        s"""    const size_t arraySize = ${arrayName}_getArraySize(instance);"""
+    }
+  }
+
   // Returns the notation needed to access a C struct field.  We make some simplifying
   // assumptions to make generating the field access easier:
   // - the expression contains only a relative or absolute path, nothing else (e.g.,
@@ -1048,10 +1662,69 @@ class CodeGeneratorState(private val root: ElementBase) {
     notation
   }
 
+  // Returns the local names of an element and all of the elements inside it
+  private def elementNamesInside(context: ElementBase): Set[String] = {
+    def namesInside(term: Term): Set[String] = term match {
+      case e: ElementBase if e.isComplexType => namesInside(e.complexType.modelGroup) + e.name
+      case e: ElementBase => Set(e.name)
+      case mg: ModelGroup => mg.groupMembers.flatMap(namesInside).toSet
+      case _ => Set.empty
+    }
+    namesInside(context)
+  }
+
+  // Local names of all elements which expressions reference in order to parse or unparse
+  // data (we compare only local names, so we may keep more elements than necessary)
+  private lazy val referencedNames: Set[String] = {
+    val exprs = mutable.ArrayBuffer[String]()
+    def addExprs(term: Term): Unit = {
+      val asserts = term.assertStatements.filter(_.testKind == TestKind.Expression)
+      exprs ++= asserts.map(_.testTxt)
+      term match {
+        case e: ElementBase =>
+          // An element's asserts may also refer to the element itself as "."
+          if (asserts.nonEmpty) exprs += e.name
+          if (e.maybeLengthEv.isDefined) {
+            e.maybeLengthEv.get match {
+              case ev: ExplicitLengthEv => exprs += ev.expr.toBriefXML()
+              case _ =>
+            }
+          }
+          if (!e.isScalar && e.occursCountKind == OccursCountKind.Expression)
+            exprs += e.occursCountExpr.prettyExpr
+          if (e.isComplexType) addExprs(e.complexType.modelGroup)
+        case mg: ModelGroup =>
+          mg match {
+            case choice: Choice if choice.isDirectDispatch =>
+              exprs += choice.choiceDispatchKeyEv.expr.toBriefXML()
+            case _ =>
+          }
+          mg.groupMembers.foreach(addExprs)
+        case _ =>
+      }
+    }
+    addExprs(root)
+    // The filter's fields must be parsed too
+    exprs += filterExpr
+    // Keep only the local name of each prefixed name in each expression
+    val name = """(?:[\p{L}_][\p{L}_\-.0-9]*:)?([\p{L}_][\p{L}_\-.0-9]*)""".r
+    exprs.flatMap { expr => name.findAllMatchIn(expr).map(_.group(1)) }.toSet
+  }
+
+  // Returns the length of a simple element's data if known statically, otherwise 0
+  private def simpleLengthInBits(e: ElementBase): Long = {
+    val isImplicitBinary =
+      e.lengthKind == LengthKind.Implicit && e.representation == Representation.Binary
+    if (e.maybeFixedLengthInBits.isDefined) e.maybeFixedLengthInBits.get
+    else if (isImplicitBinary) getLengthInBits(e)
+    else 0L
+  }
+
   // Gets length from explicit length declaration if any, otherwise from base type's implicit length
   private def getLengthInBits(e: ElementBase): Long = {
-    // Skip HexBinary elements since some of them won't have a constant length
-    if (e.optPrimType.get == PrimType.HexBinary)
+    // Skip HexBinary and String elements since some of them won't have a constant length
+    val primType = e.optPrimType.get
+    if (primType == PrimType.HexBinary || primType == PrimType.String)
       0
     else {
       e.schemaDefinitionUnless(
@@ -1079,4 +1752,18 @@ class ComplexCGState(
   val initChoiceStatements: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
   val parserStatements: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
   val unparserStatements: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
+  val randomizeStatements: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
+  // First key of each choice branch and where to pick one of them in randomizeStatements
+  val choiceKeys: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
+  var choiceKeysPosition: Int = 0
+  // Statements clearing fields which parsing fills in and where a choice's switch starts in them
+  val resetStatements: mutable.ArrayBuffer[String] = mutable.ArrayBuffer[String]()
+  var choiceResetPosition: Int = 0
+  // Length of data parsed before the first element whose length isn't known statically
+  var staticLengthInBits: Long = 0
+  var hasStaticLength: Boolean = true
+  // Positions of read checks in parserStatements and their elements' end positions
+  val readChecks: mutable.Map[Int, Long] = mutable.Map[Int, Long]()
+  // Positions of simple elements' profiling statements in parserStatements
+  val fieldSamples: mutable.Set[Int] = mutable.Set[Int]()
 }
@@ -0,0 +1,295 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.apache.daffodil.codegen.c.generators
+
+import java.nio.charset.Charset
+import java.nio.charset.StandardCharsets
+
+import org.apache.daffodil.core.dsom.ElementBase
+import org.apache.daffodil.core.dsom.SequenceTermBase
+import org.apache.daffodil.core.dsom.Term
+import org.apache.daffodil.core.grammar.primitives.StringDelimitedEndOfData
+import org.apache.daffodil.lib.iapi.WarnID
+import org.apache.daffodil.lib.schema.annotation.props.gen.BitOrder
+import org.apache.daffodil.lib.schema.annotation.props.gen.EscapeKind
+import org.apache.daffodil.lib.schema.annotation.props.gen.TextTrimKind
+import org.apache.daffodil.runtime1.processors.CharDelim
+import org.apache.daffodil.runtime1.processors.Delimiter
+import org.apache.daffodil.runtime1.processors.DelimiterParseEv
+import org.apache.daffodil.runtime1.processors.DelimiterUnparseEv
+import org.apache.daffodil.runtime1.processors.ESDelim
+import org.apache.daffodil.runtime1.processors.NLDelim
+
+trait DelimitedTextCodeGenerator {
+
+  // Longest random string to generate for a delimited text element
+  private val MAX_RANDOM_STRING_LENGTH = 16
+
+  // Generate C code to parse and unparse a delimited text element ending before the first
+  // delimiter of any enclosing term or at end of data
+  def stringDelimitedGenerateCode(
+    g: StringDelimitedEndOfData,
+    cgState: CodeGeneratorState
+  ): Unit = {
+    val e = g.e
+    val charset = textCharset(e)
+    e.schemaDefinitionWhen(
+      e.textTrimKind == TextTrimKind.PadChar,
+      "dfdl:textTrimKind 'padChar' is not supported."
+    )
+    e.schemaDefinitionWhen(
+      cgState.isInsideChoice,
+      "Delimited text elements inside choices are not supported."
+    )
+    if (e.hasFixedValue || e.typeDef.optRestriction.isDefined)
+      e.SDW(
+        WarnID.IgnoreDFDLProperty,
+        "Validation of xs:string elements is not supported, ignoring their facets."
+      )
+
+    // Get the escape characters (if any) which let text contain delimiters
+    val (escapeChar, escapeEscapeChar) = e.optionEscapeScheme match {
+      case Some(es) =>
+        e.schemaDefinitionUnless(
+          es.escapeKind == EscapeKind.EscapeCharacter,
+          "Only dfdl:escapeKind 'escapeCharacter' is supported."
+        )
+        if (es.optionExtraEscapedCharactersEv.isDefined)
+          e.SDW(WarnID.IgnoreDFDLProperty, "Ignoring dfdl:extraEscapedCharacters.")
+        val ecEv = es.escapeCharacterEv
+        e.schemaDefinitionUnless(
+          ecEv.isConstant,
+          "Runtime dfdl:escapeCharacter expressions are not supported."
+        )
+        val ec: Option[Byte] = Some(escapeByte(e, ecEv.constValue, charset))
+        val eec: Option[Byte] = if (es.optionEscapeEscapeCharacterEv.isDefined) {
+          val eecEv = es.optionEscapeEscapeCharacterEv.get
+          e.schemaDefinitionUnless(
+            eecEv.isConstant,
+            "Runtime dfdl:escapeEscapeCharacter expressions are not supported."
+          )
+          Some(escapeByte(e, eecEv.constValue, charset))
+        } else None
+        (ec, eec)
+      case None => (None, None)
+    }
+
+    // Text ends at any delimiter in scope except an empty one (%ES;)
+    val strings = cgState.delimitersInScope
+      .flatMap(delimiterAlternatives(e, _))
+      .distinct
+      .flatMap(encode(e, _, charset))
+      .filter(_.nonEmpty)
+    val delimiters = addDelimiters(
+      cgState.delimitersInScope.mkString(" "),
+      strings,
+      escapeChar.toSeq ++ escapeEscapeChar,
+      escapeChar,
+      escapeEscapeChar,
+      cgState
+    )
+
+    val indent1 = if (cgState.hasChoice) INDENT else NO_INDENT
+    val indent2 = if (cgState.hasArray) INDENT else NO_INDENT
+    val deref = if (cgState.hasArray) "[i]" else ""
+    val field = s"instance->${cgState.cName(e)}$deref"
+    val initERDStatement = ""
+    val parseStatement =
+      s"""$indent1$indent2    parse_delimited_string(&$field, &$delimiters, pstate);
+         |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
+    val unparseStatement =
+      s"""$indent1$indent2    unparse_delimited_string(&$field, &$delimiters, ustate);
+         |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    val randomizeStatement =
+      s"""$indent1$indent2    random_string(&$field, &$delimiters, $MAX_RANDOM_STRING_LENGTH, rstate);
+         |$indent1$indent2    if (rstate->error) return;""".stripMargin
+    cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    cgState.addRandomizeStatement(randomizeStatement)
+    // Delimited text's length is known only after scanning it
+    cgState.addVariableLength()
+  }
+
+  // Generate C code to parse and unparse an initiator, separator, or terminator
+  def delimiterGenerateCode(
+    term: Term,
+    parseEv: DelimiterParseEv,
+    unparseEv: DelimiterUnparseEv,
+    cgState: CodeGeneratorState
+  ): Unit = {
+    val charset = textCharset(term)
+    term.schemaDefinitionUnless(
+      parseEv.isConstant && unparseEv.isConstant,
+      "Runtime delimiter expressions are not supported."
+    )
+    term.schemaDefinitionWhen(term.ignoreCaseBool, "dfdl:ignoreCase 'yes' is not supported.")
+    val lookingFor = parseEv.constValue.map(_.lookingFor).toSeq
+    val strings = lookingFor.flatMap(delimiterAlternatives(term, _)).distinct
+    val delimiters = addDelimiters(
+      lookingFor.mkString(" "),
+      strings.flatMap(encode(term, _, charset)),
+      Seq.empty,
+      None,
+      None,
+      cgState
+    )
+    val unparseText = unparseEv.constValue.head.unparseValue
+    val unparseBytes = encode(term, unparseText, charset).getOrElse(
+      term.SDE("Delimiter '%s' can't be encoded in %s.", unparseText, charset.name)
+    )
+    val unparseValue = cString(unparseBytes)
+
+    val indent1 = if (cgState.hasChoice) INDENT else NO_INDENT
+    val indent2 = if (cgState.hasArray) INDENT else NO_INDENT
+    val initERDStatement = ""
+    val parseStatement =
+      s"""$indent1$indent2    parse_delimiter(&$delimiters, pstate);
+         |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
+    val unparseStatement =
+      s"""$indent1$indent2    unparse_delimiter($unparseValue, ustate);
+         |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    // A delimiter's length depends on which alternative the data contains
+    cgState.addVariableLength()
+  }
+
+  // Returns the delimiters which can end delimited text inside the given term
+  def terminatingDelimiters(term: Term): Seq[String] = {
+    val separators = term match {
+      case sq: SequenceTermBase if sq.hasSeparator =>
+        delimiterLookingFor(sq, sq.separatorParseEv)
+      case _ => Seq.empty
+    }
+    val terminators =
+      if (term.hasTerminator) delimiterLookingFor(term, term.terminatorParseEv)
+      else Seq.empty
+    separators ++ terminators
+  }
+
+  // Returns each delimiter (as written in the schema, but with entities other than
+  // character classes replaced) which a constant delimiter property can match
+  private def delimiterLookingFor(term: Term, parseEv: DelimiterParseEv): Seq[String] = {
+    term.schemaDefinitionUnless(
+      parseEv.isConstant,
+      "Runtime delimiter expressions are not supported."
+    )
+    term.schemaDefinitionWhen(term.ignoreCaseBool, "dfdl:ignoreCase 'yes' is not supported.")
+    parseEv.constValue.map(_.lookingFor).toSeq
+  }
+
+  // Expands a delimiter's character class entities into all the strings it can match
+  private def delimiterAlternatives(term: Term, lookingFor: String): Seq[String] = {
+    val delimiter = new Delimiter()
+    delimiter.compileDelimiter(lookingFor, ignoreCase = false)
+    delimiter.delimBuf.foldLeft(Seq("")) { (prefixes, delim) =>
+      val choices = delim match {
+        case c: CharDelim => Seq(c.char.toString)
+        case _: NLDelim => Seq("\r\n", "\n", "\r", "\u0085", "\u2028")
+        case _: ESDelim => Seq("")
+        case _ =>
+          term.SDE(
+            "Delimiter '%s' is not supported (only %%NL; and %%ES; entities are).",
+            lookingFor
+          )
+      }
+      for (prefix <- prefixes; choice <- choices) yield prefix + choice
+    }
+  }
+
+  // Returns the charset of a term's text, which must encode each character which can
+  // begin a delimiter as a single byte so C code can scan text one byte at a time
+  private def textCharset(term: Term): Charset = {
+    term.schemaDefinitionUnless(
+      term.isKnownEncoding,
+      "Runtime dfdl:encoding expressions are not supported."
+    )
+    term.schemaDefinitionUnless(
+      term.defaultBitOrder eq BitOrder.MostSignificantBitFirst,
+      "Only dfdl:bitOrder 'mostSignificantBitFirst' is supported."
+    )
+    term.knownEncodingName match {
+      case "US-ASCII" => StandardCharsets.US_ASCII
+      case "UTF-8" => StandardCharsets.UTF_8
+      case name =>
+        term.SDE("Only US-ASCII and UTF-8 text encodings are supported, not %s.", name)
+    }
+  }
+
+  // Encodes text unless the charset can't encode it (such as NEL or LS in US-ASCII)
+  // and checks it doesn't contain a NUL, which C strings can't hold
+  private def encode(term: Term, text: String, charset: Charset): Option[Array[Byte]] = {
+    if (charset.newEncoder.canEncode(text)) {
+      val bytes = text.getBytes(charset)
+      term.schemaDefinitionWhen(
+        bytes.contains(0),
+        "Delimiters containing NUL are not supported."
+      )
+      Some(bytes)
+    } else {
+      None
+    }
+  }
+
+  // Returns the single byte which encodes an escape character
+  private def escapeByte(e: ElementBase, escape: String, charset: Charset): Byte = {
+    val bytes = encode(e, escape, charset).getOrElse(Array.empty[Byte])
+    e.schemaDefinitionUnless(
+      bytes.length == 1,
+      "Escape character '%s' must be encoded as one byte.",
+      escape
+    )
+    bytes.head
+  }
+
+  // Adds a static definition of delimiters to match and returns its C name
+  private def addDelimiters(
+    name: String,
+    strings: Seq[Array[Byte]],
+    escapes: Seq[Byte],
+    escapeChar: Option[Byte],
+    escapeEscapeChar: Option[Byte],
+    cgState: CodeGeneratorState
+  ): String = {
+    // Match the longest alternatives first, keeping the order of alternatives of equal length
+    val nonEmpty = strings.filter(_.nonEmpty).sortBy(-_.length)
+    val sorted = nonEmpty ++ strings.filter(_.isEmpty).take(1)
+    val candidates = (nonEmpty.map(_.head) ++ escapes).distinct.toArray
+    cgState.addDelimiters(
+      cString(name.getBytes(StandardCharsets.UTF_8)),
+      sorted.map(cString),
+      cString(candidates),
+      escapeChar.fold("-1")(b => cChar(b)),
+      escapeEscapeChar.fold("-1")(b => cChar(b))
+    )
+  }
+
+  // Returns a C string literal holding the given bytes
+  private def cString(bytes: Array[Byte]): String =
+    bytes.map(cByte).mkString("\"", "", "\"")
+
+  // Returns a C character constant holding the given byte
+  private def cChar(byte: Byte): String =
+    if (byte == '\'') "'\\''" else s"'${cByte(byte)}'"
+
+  // Returns a byte as it would appear inside a C string literal
+  private def cByte(byte: Byte): String = {
+    val c = byte & 0xff
+    if (c == '"' || c == '\\') s"\\${c.toChar}"
+    else if (c >= 0x20 && c < 0x7f && c != '?') c.toChar.toString
+    else "\\%03o".format(c)
+  }
+}
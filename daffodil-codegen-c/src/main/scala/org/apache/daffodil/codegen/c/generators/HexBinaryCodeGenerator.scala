@@ -18,12 +18,14 @@
 package org.apache.daffodil.codegen.c.generators
 
 import org.apache.daffodil.core.dsom.ElementBase
-import org.apache.daffodil.lib.schema.annotation.props.gen.ByteOrder
 import org.apache.daffodil.runtime1.dpath.NodeInfo.PrimType
 import org.apache.daffodil.runtime1.processors.ExplicitLengthEv
 
 trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
 
+  // Longest random hexBinary value to generate when a schema doesn't fix its length
+  private val MAX_RANDOM_HEXBINARY_BYTES = 64L
+
   // Generate C code to parse and unparse a hexBinary prefixed length element
   def hexBinaryLengthPrefixedGenerateCode(e: ElementBase, cgState: CodeGeneratorState): Unit = {
     val addField = hexBinaryPrefixedLengthAddField(e, _, cgState)
@@ -63,10 +65,8 @@ trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
     }
     val intLen = e.prefixedLengthElementDecl.elementLengthInBitsEv.constValue.get
     val primType = s"$intType$intLen"
-    val conv =
-      if (e.prefixedLengthElementDecl.byteOrderEv.constValue == ByteOrder.BigEndian) "be"
-      else "le"
-    val function = s"${conv}_$primType"
+    val function = s"${bitByteOrder(e.prefixedLengthElementDecl)}_$primType"
+    val order = bitOrderPrefix(e)
     val lenVar = s"_l_$localName"
 
     val initERDStatement =
@@ -77,14 +77,22 @@ trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
          |$indent1$indent2    if (pstate->pu.error) return;
          |$indent1$indent2    alloc_hexBinary(&$field, $lenVar, pstate);
          |$indent1$indent2    if (pstate->pu.error) return;
-         |$indent1$indent2    parse_hexBinary(&$field, pstate);
+         |$indent1$indent2    parse_${order}hexBinary(&$field, pstate);
          |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
     val unparseStatement =
       s"""$indent1$indent2    unparse_$function($field.lengthInBytes, $intLen, ustate);
          |$indent1$indent2    if (ustate->pu.error) return;
-         |$indent1$indent2    unparse_hexBinary($field, ustate);
+         |$indent1$indent2    unparse_${order}hexBinary($field, ustate);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    val maxBytes = BigInt(2).pow(if (intType == "int") intLen.toInt - 1 else intLen.toInt) - 1
+    val randomizeStatement =
+      s"""$indent1$indent2    random_hexBinary_alloc(&$field, random_uint(0, ${maxBytes.min(BigInt(MAX_RANDOM_HEXBINARY_BYTES))}, rstate), rstate);
+         |$indent1$indent2    if (rstate->error) return;""".stripMargin
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    cgState.addRandomizeStatement(randomizeStatement)
+    // Only the length prefix's length is known statically
+    cgState.addStaticLength(intLen)
+    cgState.addVariableLength()
   }
 
   private def hexBinarySpecifiedLengthAddField(
@@ -104,19 +112,24 @@ trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
         -1
     val primType = s"size_t"
     val lenVar = s"_l_$localName"
-    val expression =
+    val order = bitOrderPrefix(e)
+    val lengthExpr =
       if (e.elementLengthInBitsEv.isConstant)
-        e.elementLengthInBitsEv.constValue.get.toString
-      else {
-        val expr = e.elementLengthInBitsEv.lengthEv
+        ""
+      else
+        e.elementLengthInBitsEv.lengthEv
           .asInstanceOf[ExplicitLengthEv]
           .expr
           .toBriefXML()
           .stripPrefix("'{")
           .stripSuffix("}'")
           .trim()
+    val expression =
+      if (e.elementLengthInBitsEv.isConstant)
+        e.elementLengthInBitsEv.constValue.get.toString
+      else {
         // Convert DFDL expression to a C expression
-        val cExpr = cgState.cExpression(expr)
+        val cExpr = cgState.cExpression(lengthExpr)
         cExpr
       }
 
@@ -133,18 +146,38 @@ trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
         s"""$indent1$indent2    $field.dynamic = true;""".stripMargin
     val parseStatement =
       if (specifiedLength >= 0)
-        s"""$indent1$indent2    parse_hexBinary(&$field, pstate);
-           |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
+        s"$indent1$indent2    parse_${order}hexBinary(&$field, pstate);"
       else
         s"""$indent1$indent2    $primType $lenVar = $expression;
            |$indent1$indent2    alloc_hexBinary(&$field, $lenVar, pstate);
            |$indent1$indent2    if (pstate->pu.error) return;
-           |$indent1$indent2    parse_hexBinary(&$field, pstate);
+           |$indent1$indent2    parse_${order}hexBinary(&$field, pstate);
            |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
     val unparseStatement =
-      s"""$indent1$indent2    unparse_hexBinary($field, ustate);
+      s"""$indent1$indent2    unparse_${order}hexBinary($field, ustate);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    // Store a random length in the field the length expression depends on if possible
+    val lengthField = """^((\.\./)+|/)[\p{L}_][\p{L}:_\-.0-9/]*$"""
+    val randomizeStatement =
+      if (specifiedLength > 0)
+        s"$indent1$indent2    random_hexBinary(&$field, rstate);"
+      else if (specifiedLength == 0)
+        ""
+      else if (lengthExpr.matches(lengthField))
+        s"""$indent1$indent2    random_hexBinary_alloc(&$field, random_uint(0, $MAX_RANDOM_HEXBINARY_BYTES, rstate), rstate);
+           |$indent1$indent2    if (rstate->error) return;
+           |$indent1$indent2    $expression = $field.lengthInBytes;""".stripMargin
+      else
+        s"""$indent1$indent2    random_hexBinary_alloc(&$field, $expression, rstate);
+           |$indent1$indent2    if (rstate->error) return;""".stripMargin
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
+    cgState.addRandomizeStatement(randomizeStatement)
+    if (specifiedLength >= 0) {
+      cgState.addStaticLength(specifiedLength)
+      cgState.addReadCheck(s"$indent1$indent2    if (pstate->pu.error) return;")
+    } else {
+      cgState.addVariableLength()
+    }
   }
 
   // Generate C code to validate a hexBinary element against its fixed value
@@ -161,14 +194,16 @@ trait HexBinaryCodeGenerator extends BinaryValueCodeGenerator {
     val array = e.fixedValueAsString.grouped(2).mkString("0x", ", 0x", "")
 
     val initERDStatement = ""
-    val parseStatement =
+    val parseStatement = recoverableValidation(
       s"""$indent1$indent2    uint8_t $fixed[] = {$array};
          |$indent1$indent2    validate_fixed_attribute(memcmp($field.array, $fixed, sizeof($fixed)) == 0, "$localName", &pstate->pu);
          |$indent1$indent2    if (pstate->pu.error) return;""".stripMargin
-    val unparseStatement =
+    )
+    val unparseStatement = recoverableValidation(
       s"""$indent1$indent2    uint8_t $fixed[] = {$array};
          |$indent1$indent2    validate_fixed_attribute(memcmp($field.array, $fixed, sizeof($fixed)) == 0, "$localName", &ustate->pu);
          |$indent1$indent2    if (ustate->pu.error) return;""".stripMargin
+    )
     cgState.addSimpleTypeStatements(initERDStatement, parseStatement, unparseStatement)
   }
 }
@@ -17,9 +17,22 @@
 
 package org.apache.daffodil.codegen.c
 
+import org.apache.daffodil.core.dsom.Term
+import org.apache.daffodil.lib.schema.annotation.props.gen.BitOrder
+
 // Define constants to be used by all generators
 
 package object generators {
   val INDENT = "    "
   val NO_INDENT = ""
+
+  // Wrap statements performing a recoverable validation (one which only adds a diagnostic)
+  // so that compiling with -DDAFFODIL_NO_VALIDATION leaves them out of the executable
+  def recoverableValidation(statements: String): String =
+    "#ifndef DAFFODIL_NO_VALIDATION\n" + statements + "\n#endif"
+
+  // Get the prefix of the names of functions which parse and unparse bits differently in
+  // leastSignificantBitFirst bit order (e.g., parse_lsbf_hexBinary and parse_lsbf_align_to)
+  def bitOrderPrefix(term: Term): String =
+    if (term.defaultBitOrder eq BitOrder.LeastSignificantBitFirst) "lsbf_" else ""
 }
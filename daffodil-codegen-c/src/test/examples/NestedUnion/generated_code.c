@@ -1,13 +1,17 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "generated_code.h"
-#include <stdbool.h>    // for false, bool, true
-#include <stddef.h>     // for NULL, size_t
-#include <string.h>     // for memcmp, memset
-#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+#include <stdbool.h>     // for false, bool, true
+#include <stddef.h>      // for NULL, size_t
+#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+#include <string.h>      // for memcmp
+#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
 // clang-format on
 
 // Declare prototypes for easier compilation
@@ -21,6 +25,7 @@ static void data_NestedUnionType__parseSelf(data_NestedUnionType_ *instance, PSt
 static void data_NestedUnionType__unparseSelf(const data_NestedUnionType_ *instance, UState *ustate);
 static void NestedUnion__parseSelf(NestedUnion_ *instance, PState *pstate);
 static void NestedUnion__unparseSelf(const NestedUnion_ *instance, UState *ustate);
+static void NestedUnion__frameSelf(NestedUnion_ *instance, PState *pstate);
 
 // Define schema version (will be empty if schema did not define any version string)
 
@@ -231,30 +236,58 @@ foo_data_NestedUnionType__initERD(foo_data_NestedUnionType_ *instance, InfosetBa
     instance->_base.parent = parent;
 }
 
+static void
+foo_data_NestedUnionType__reset(foo_data_NestedUnionType_ *instance)
+{
+    instance->c = 0;
+    instance->b = 0;
+    instance->a = 0;
+}
+
+static void
+foo_data_NestedUnionType__randomize(foo_data_NestedUnionType_ *instance, RState *rstate)
+{
+    instance->a = random_int(-2147483648, 2147483647, rstate);
+    instance->a = 1;
+    instance->b = random_int(-2147483648, 2147483647, rstate);
+    instance->c = random_int(-2147483648, 2147483647, rstate);
+}
+
 static void
 foo_data_NestedUnionType__parseSelf(foo_data_NestedUnionType_ *instance, PState *pstate)
 {
-    parse_be_int32(&instance->a, 32, pstate);
+    PROFILE_ELEMENT(&foo_data_NestedUnionType_ERD, &pstate->pu);
+    parse_read_ahead(96, pstate);
     if (pstate->pu.error) return;
+    parse_be_int32(&instance->a, 32, pstate);
+#ifndef DAFFODIL_NO_VALIDATION
     validate_dfdl_assert(instance->a == 1, "{ . eq 1 }", true, &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&a_FooType_ERD);
     parse_be_int32(&instance->b, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&b_FooType_ERD);
     parse_be_int32(&instance->c, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&c_FooType_ERD);
 }
 
 static void
 foo_data_NestedUnionType__unparseSelf(const foo_data_NestedUnionType_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&foo_data_NestedUnionType_ERD, &ustate->pu);
     unparse_be_int32(instance->a, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_dfdl_assert(instance->a == 1, "{ . eq 1 }", true, &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&a_FooType_ERD);
     unparse_be_int32(instance->b, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&b_FooType_ERD);
     unparse_be_int32(instance->c, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&c_FooType_ERD);
 }
 
 static void
@@ -264,30 +297,54 @@ bar_data_NestedUnionType__initERD(bar_data_NestedUnionType_ *instance, InfosetBa
     instance->_base.parent = parent;
 }
 
+static void
+bar_data_NestedUnionType__reset(bar_data_NestedUnionType_ *instance)
+{
+    instance->z = 0;
+    instance->y = 0;
+    instance->x = 0;
+}
+
+static void
+bar_data_NestedUnionType__randomize(bar_data_NestedUnionType_ *instance, RState *rstate)
+{
+    instance->x = random_double(-1000000.0, 1000000.0, rstate);
+    instance->y = random_double(-1000000.0, 1000000.0, rstate);
+    instance->y = 5.5;
+    instance->z = random_double(-1000000.0, 1000000.0, rstate);
+}
+
 static void
 bar_data_NestedUnionType__parseSelf(bar_data_NestedUnionType_ *instance, PState *pstate)
 {
-    parse_be_double(&instance->x, 64, pstate);
+    PROFILE_ELEMENT(&bar_data_NestedUnionType_ERD, &pstate->pu);
+    parse_read_ahead(192, pstate);
     if (pstate->pu.error) return;
+    parse_be_double(&instance->x, 64, pstate);
+    PROFILE_FIELD(&x_BarType_ERD);
     parse_be_double(&instance->y, 64, pstate);
-    if (pstate->pu.error) return;
     validate_dfdl_assert(instance->y == 5.5, "{ . eq 5.5 }", false, &pstate->pu);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&y_BarType_ERD);
     parse_be_double(&instance->z, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&z_BarType_ERD);
 }
 
 static void
 bar_data_NestedUnionType__unparseSelf(const bar_data_NestedUnionType_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&bar_data_NestedUnionType_ERD, &ustate->pu);
     unparse_be_double(instance->x, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&x_BarType_ERD);
     unparse_be_double(instance->y, 64, ustate);
     if (ustate->pu.error) return;
     validate_dfdl_assert(instance->y == 5.5, "{ . eq 5.5 }", false, &ustate->pu);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&y_BarType_ERD);
     unparse_be_double(instance->z, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&z_BarType_ERD);
 }
 
 static void
@@ -297,6 +354,20 @@ data_NestedUnionType__initERD(data_NestedUnionType_ *instance, InfosetBase *pare
     instance->_base.parent = parent;
 }
 
+static void
+data_NestedUnionType__reset(data_NestedUnionType_ *instance)
+{
+    switch (instance->_choice)
+    {
+    case 1:
+        foo_data_NestedUnionType__reset(&instance->foo);
+        break;
+    case 2:
+        bar_data_NestedUnionType__reset(&instance->bar);
+        break;
+    }
+}
+
 static const Error *
 data_NestedUnionType__initChoice(data_NestedUnionType_ *instance)
 {
@@ -307,12 +378,12 @@ data_NestedUnionType__initChoice(data_NestedUnionType_ *instance)
     {
     case 1:
     case 2:
-        instance->_choice = 1;
+        switch_choice(&instance->_base, &instance->_choice, 1, sizeof(*instance));
         foo_data_NestedUnionType__initERD(&instance->foo, (InfosetBase *)instance);
         break;
     case 3:
     case 4:
-        instance->_choice = 2;
+        switch_choice(&instance->_base, &instance->_choice, 2, sizeof(*instance));
         bar_data_NestedUnionType__initERD(&instance->bar, (InfosetBase *)instance);
         break;
     default:
@@ -323,9 +394,32 @@ data_NestedUnionType__initChoice(data_NestedUnionType_ *instance)
     return NULL;
 }
 
+static void
+data_NestedUnionType__randomize(data_NestedUnionType_ *instance, RState *rstate)
+{
+    static const int64_t keys[] = {1, 3};
+    ((NestedUnion_ *)instance->_base.parent)->tag = keys[random_index(2, rstate)];
+
+    rstate->error = instance->_base.erd->initChoice(&instance->_base);
+    if (rstate->error) return;
+
+    switch (instance->_choice)
+    {
+    case 1:
+        foo_data_NestedUnionType__randomize(&instance->foo, rstate);
+        if (rstate->error) return;
+        break;
+    case 2:
+        bar_data_NestedUnionType__randomize(&instance->bar, rstate);
+        if (rstate->error) return;
+        break;
+    }
+}
+
 static void
 data_NestedUnionType__parseSelf(data_NestedUnionType_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&data_NestedUnionType_ERD, &pstate->pu);
     static Error error = {ERR_CHOICE_KEY, {0}};
 
     pstate->pu.error = instance->_base.erd->initChoice(&instance->_base);
@@ -352,6 +446,7 @@ data_NestedUnionType__parseSelf(data_NestedUnionType_ *instance, PState *pstate)
 static void
 data_NestedUnionType__unparseSelf(const data_NestedUnionType_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&data_NestedUnionType_ERD, &ustate->pu);
     static Error error = {ERR_CHOICE_KEY, {0}};
 
     ustate->pu.error = instance->_base.erd->initChoice(&instance->_base);
@@ -383,11 +478,29 @@ NestedUnion__initERD(NestedUnion_ *instance, InfosetBase *parent)
     data_NestedUnionType__initERD(&instance->data, (InfosetBase *)instance);
 }
 
+static void
+NestedUnion__reset(NestedUnion_ *instance)
+{
+    data_NestedUnionType__reset(&instance->data);
+    instance->tag = 0;
+}
+
+static void
+NestedUnion__randomize(NestedUnion_ *instance, RState *rstate)
+{
+    instance->tag = random_int(-2147483648, 2147483647, rstate);
+    data_NestedUnionType__randomize(&instance->data, rstate);
+    if (rstate->error) return;
+}
+
 static void
 NestedUnion__parseSelf(NestedUnion_ *instance, PState *pstate)
 {
-    parse_be_int32(&instance->tag, 32, pstate);
+    PROFILE_ELEMENT(&NestedUnion_ERD, &pstate->pu);
+    parse_read_ahead(32, pstate);
     if (pstate->pu.error) return;
+    parse_be_int32(&instance->tag, 32, pstate);
+    PROFILE_FIELD(&tag_NestedUnionType_ERD);
     data_NestedUnionType__parseSelf(&instance->data, pstate);
     if (pstate->pu.error) return;
 }
@@ -395,27 +508,64 @@ NestedUnion__parseSelf(NestedUnion_ *instance, PState *pstate)
 static void
 NestedUnion__unparseSelf(const NestedUnion_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&NestedUnion_ERD, &ustate->pu);
     unparse_be_int32(instance->tag, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&tag_NestedUnionType_ERD);
     data_NestedUnionType__unparseSelf(&instance->data, ustate);
     if (ustate->pu.error) return;
 }
 
-// Get an infoset (optionally clearing it first) for parsing/walking
+static void
+NestedUnion__frameSelf(NestedUnion_ *instance, PState *pstate)
+{
+    parse_read_ahead(32, pstate);
+    if (pstate->pu.error) return;
+    parse_be_int32(&instance->tag, 32, pstate);
+    data_NestedUnionType__parseSelf(&instance->data, pstate);
+    if (pstate->pu.error) return;
+}
+
+// Get an infoset (optionally clearing it first) for parsing/walking.
+// Each thread gets its own infoset.
 
 InfosetBase *
 get_infoset(bool clear_infoset)
 {
-    static NestedUnion_ infoset;
+    static _Thread_local NestedUnion_ infoset;
+    static _Thread_local bool initialized;
 
     if (clear_infoset)
     {
-        // If your infoset contains hexBinary prefixed length elements,
-        // you may want to walk infoset first to free their malloc'ed
-        // storage - we are not handling that case for now...
-        memset(&infoset, 0, sizeof(infoset));
-        NestedUnion__initERD(&infoset, (InfosetBase *)&infoset);
+        // Initialize the infoset's ERD and parent pointers only once,
+        // then clear only the values which the last parse filled in
+        if (initialized)
+        {
+            NestedUnion__reset(&infoset);
+        }
+        else
+        {
+            NestedUnion__initERD(&infoset, (InfosetBase *)&infoset);
+            initialized = true;
+        }
     }
 
     return &infoset._base;
 }
+
+// Frame a record by parsing only the fields needed to find where it
+// ends and skipping over the rest of its data for building an index
+
+void
+frame_record(InfosetBase *infoset, PState *pstate)
+{
+    NestedUnion__frameSelf((NestedUnion_ *)infoset, pstate);
+}
+
+// Fill an infoset with random values for generating data
+
+void
+randomize_infoset(InfosetBase *infoset, RState *rstate)
+{
+    NestedUnion__randomize((NestedUnion_ *)infoset, rstate);
+}
@@ -1,13 +1,17 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "generated_code.h"
-#include <stdbool.h>    // for false, bool, true
-#include <stddef.h>     // for NULL, size_t
-#include <string.h>     // for memcmp, memset
-#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+#include <stdbool.h>     // for false, bool, true
+#include <stddef.h>      // for NULL, size_t
+#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+#include <string.h>      // for memcmp
+#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
 // clang-format on
 
 // Declare prototypes for easier compilation
@@ -37,6 +41,7 @@ static void fixed_ex_nums__parseSelf(fixed_ex_nums_ *instance, PState *pstate);
 static void fixed_ex_nums__unparseSelf(const fixed_ex_nums_ *instance, UState *ustate);
 static void ex_nums__parseSelf(ex_nums_ *instance, PState *pstate);
 static void ex_nums__unparseSelf(const ex_nums_ *instance, UState *ustate);
+static void ex_nums__frameSelf(ex_nums_ *instance, PState *pstate);
 
 // Define schema version (will be empty if schema did not define any version string)
 
@@ -841,9 +846,24 @@ array_be_boolean_array_ex_nums_array_ex_nums__initERD(array_ex_nums_ *instance,
     UNUSED(parent);
 }
 
+static void
+array_be_boolean_array_ex_nums_array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    const size_t arraySize = array_be_boolean_array_ex_nums_array_ex_nums__getArraySize(instance);
+    const size_t numElements = arraySize < 2 ? arraySize : 2;
+
+    for (size_t i = 0; i < numElements; i++)
+    {
+        instance->be_boolean[i] = 0;
+    }
+}
+
 static void
 array_be_boolean_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_be_boolean_array_ex_nums_array_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(64, pstate);
+    if (pstate->pu.error) return;
     const size_t arraySize = array_be_boolean_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_boolean_array_ex_nums_array_ex_nums_", arraySize, 2, 2, &pstate->pu);
     if (pstate->pu.error) return;
@@ -852,12 +872,14 @@ array_be_boolean_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance
     {
         parse_be_bool(&instance->be_boolean[i], 32, -1, 0, pstate);
         if (pstate->pu.error) return;
+        PROFILE_FIELD(&be_boolean_array_ex_nums_ERD);
     }
 }
 
 static void
 array_be_boolean_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_be_boolean_array_ex_nums_array_ex_nums_ERD, &ustate->pu);
     const size_t arraySize = array_be_boolean_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_boolean_array_ex_nums_array_ex_nums_", arraySize, 2, 2, &ustate->pu);
     if (ustate->pu.error) return;
@@ -866,6 +888,18 @@ array_be_boolean_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *
     {
         unparse_be_bool(instance->be_boolean[i], 32, ~0, 0, ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&be_boolean_array_ex_nums_ERD);
+    }
+}
+
+static void
+array_be_boolean_array_ex_nums_array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_be_boolean_array_ex_nums_array_ex_nums__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        instance->be_boolean[i] = random_int(0, 1, rstate);
     }
 }
 
@@ -883,9 +917,24 @@ array_be_float_array_ex_nums_array_ex_nums__initERD(array_ex_nums_ *instance, In
     UNUSED(parent);
 }
 
+static void
+array_be_float_array_ex_nums_array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    const size_t arraySize = array_be_float_array_ex_nums_array_ex_nums__getArraySize(instance);
+    const size_t numElements = arraySize < 3 ? arraySize : 3;
+
+    for (size_t i = 0; i < numElements; i++)
+    {
+        instance->be_float[i] = 0;
+    }
+}
+
 static void
 array_be_float_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_be_float_array_ex_nums_array_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(96, pstate);
+    if (pstate->pu.error) return;
     const size_t arraySize = array_be_float_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_float_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &pstate->pu);
     if (pstate->pu.error) return;
@@ -893,13 +942,14 @@ array_be_float_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance,
     for (size_t i = 0; i < arraySize; i++)
     {
         parse_be_float(&instance->be_float[i], 32, pstate);
-        if (pstate->pu.error) return;
+        PROFILE_FIELD(&be_float_array_ex_nums_ERD);
     }
 }
 
 static void
 array_be_float_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_be_float_array_ex_nums_array_ex_nums_ERD, &ustate->pu);
     const size_t arraySize = array_be_float_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_float_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &ustate->pu);
     if (ustate->pu.error) return;
@@ -908,6 +958,18 @@ array_be_float_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *in
     {
         unparse_be_float(instance->be_float[i], 32, ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&be_float_array_ex_nums_ERD);
+    }
+}
+
+static void
+array_be_float_array_ex_nums_array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_be_float_array_ex_nums_array_ex_nums__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        instance->be_float[i] = random_double(-1000000.0, 1000000.0, rstate);
     }
 }
 
@@ -925,9 +987,24 @@ array_be_int16_array_ex_nums_array_ex_nums__initERD(array_ex_nums_ *instance, In
     UNUSED(parent);
 }
 
+static void
+array_be_int16_array_ex_nums_array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    const size_t arraySize = array_be_int16_array_ex_nums_array_ex_nums__getArraySize(instance);
+    const size_t numElements = arraySize < 3 ? arraySize : 3;
+
+    for (size_t i = 0; i < numElements; i++)
+    {
+        instance->be_int16[i] = 0;
+    }
+}
+
 static void
 array_be_int16_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_be_int16_array_ex_nums_array_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(48, pstate);
+    if (pstate->pu.error) return;
     const size_t arraySize = array_be_int16_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_int16_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &pstate->pu);
     if (pstate->pu.error) return;
@@ -935,13 +1012,14 @@ array_be_int16_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance,
     for (size_t i = 0; i < arraySize; i++)
     {
         parse_be_int16(&instance->be_int16[i], 16, pstate);
-        if (pstate->pu.error) return;
+        PROFILE_FIELD(&be_int16_array_ex_nums_ERD);
     }
 }
 
 static void
 array_be_int16_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_be_int16_array_ex_nums_array_ex_nums_ERD, &ustate->pu);
     const size_t arraySize = array_be_int16_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_be_int16_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &ustate->pu);
     if (ustate->pu.error) return;
@@ -950,6 +1028,18 @@ array_be_int16_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *in
     {
         unparse_be_int16(instance->be_int16[i], 16, ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&be_int16_array_ex_nums_ERD);
+    }
+}
+
+static void
+array_be_int16_array_ex_nums_array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_be_int16_array_ex_nums_array_ex_nums__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        instance->be_int16[i] = random_int(-32768, 32767, rstate);
     }
 }
 
@@ -972,9 +1062,18 @@ array_hexBinary2_array_ex_nums_array_ex_nums__initERD(array_ex_nums_ *instance,
     }
 }
 
+static void
+array_hexBinary2_array_ex_nums_array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    UNUSED(instance);
+}
+
 static void
 array_hexBinary2_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_hexBinary2_array_ex_nums_array_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(48, pstate);
+    if (pstate->pu.error) return;
     const size_t arraySize = array_hexBinary2_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_hexBinary2_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &pstate->pu);
     if (pstate->pu.error) return;
@@ -982,13 +1081,14 @@ array_hexBinary2_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance
     for (size_t i = 0; i < arraySize; i++)
     {
         parse_hexBinary(&instance->hexBinary2[i], pstate);
-        if (pstate->pu.error) return;
+        PROFILE_FIELD(&hexBinary2_array_ex_nums_ERD);
     }
 }
 
 static void
 array_hexBinary2_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_hexBinary2_array_ex_nums_array_ex_nums_ERD, &ustate->pu);
     const size_t arraySize = array_hexBinary2_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_hexBinary2_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &ustate->pu);
     if (ustate->pu.error) return;
@@ -997,6 +1097,18 @@ array_hexBinary2_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *
     {
         unparse_hexBinary(instance->hexBinary2[i], ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&hexBinary2_array_ex_nums_ERD);
+    }
+}
+
+static void
+array_hexBinary2_array_ex_nums_array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_hexBinary2_array_ex_nums_array_ex_nums__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        random_hexBinary(&instance->hexBinary2[i], rstate);
     }
 }
 
@@ -1017,9 +1129,16 @@ array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__initERD(array_ex_nums_ *ins
     }
 }
 
+static void
+array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    UNUSED(instance);
+}
+
 static void
 array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_hexBinaryPrefixed_array_ex_nums_array_ex_nums_ERD, &pstate->pu);
     const size_t arraySize = array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_hexBinaryPrefixed_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &pstate->pu);
     if (pstate->pu.error) return;
@@ -1033,12 +1152,14 @@ array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__parseSelf(array_ex_nums_ *i
         if (pstate->pu.error) return;
         parse_hexBinary(&instance->hexBinaryPrefixed[i], pstate);
         if (pstate->pu.error) return;
+        PROFILE_FIELD(&hexBinaryPrefixed_array_ex_nums_ERD);
     }
 }
 
 static void
 array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_hexBinaryPrefixed_array_ex_nums_array_ex_nums_ERD, &ustate->pu);
     const size_t arraySize = array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__getArraySize(instance);
     validate_array_bounds("array_hexBinaryPrefixed_array_ex_nums_array_ex_nums_", arraySize, 3, 3, &ustate->pu);
     if (ustate->pu.error) return;
@@ -1049,6 +1170,19 @@ array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__unparseSelf(const array_ex_
         if (ustate->pu.error) return;
         unparse_hexBinary(instance->hexBinaryPrefixed[i], ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&hexBinaryPrefixed_array_ex_nums_ERD);
+    }
+}
+
+static void
+array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        random_hexBinary_alloc(&instance->hexBinaryPrefixed[i], random_uint(0, 64, rstate), rstate);
+        if (rstate->error) return;
     }
 }
 
@@ -1071,9 +1205,37 @@ array_ex_nums__initERD(array_ex_nums_ *instance, InfosetBase *parent)
     array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__initERD(instance, parent);
 }
 
+static void
+array_ex_nums__reset(array_ex_nums_ *instance)
+{
+    array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__reset(instance);
+    array_hexBinary2_array_ex_nums_array_ex_nums__reset(instance);
+    array_be_int16_array_ex_nums_array_ex_nums__reset(instance);
+    array_be_float_array_ex_nums_array_ex_nums__reset(instance);
+    array_be_boolean_array_ex_nums_array_ex_nums__reset(instance);
+}
+
+static void
+array_ex_nums__randomize(array_ex_nums_ *instance, RState *rstate)
+{
+    array_be_boolean_array_ex_nums_array_ex_nums__randomize(instance, rstate);
+    if (rstate->error) return;
+    array_be_float_array_ex_nums_array_ex_nums__randomize(instance, rstate);
+    if (rstate->error) return;
+    array_be_int16_array_ex_nums_array_ex_nums__randomize(instance, rstate);
+    if (rstate->error) return;
+    array_hexBinary2_array_ex_nums_array_ex_nums__randomize(instance, rstate);
+    if (rstate->error) return;
+    array_hexBinaryPrefixed_array_ex_nums_array_ex_nums__randomize(instance, rstate);
+    if (rstate->error) return;
+}
+
 static void
 array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(256, pstate);
+    if (pstate->pu.error) return;
     array_be_boolean_array_ex_nums_array_ex_nums__parseSelf(instance, pstate);
     if (pstate->pu.error) return;
     array_be_float_array_ex_nums_array_ex_nums__parseSelf(instance, pstate);
@@ -1089,6 +1251,7 @@ array_ex_nums__parseSelf(array_ex_nums_ *instance, PState *pstate)
 static void
 array_ex_nums__unparseSelf(const array_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_ex_nums_ERD, &ustate->pu);
     array_be_boolean_array_ex_nums_array_ex_nums__unparseSelf(instance, ustate);
     if (ustate->pu.error) return;
     array_be_float_array_ex_nums_array_ex_nums__unparseSelf(instance, ustate);
@@ -1112,39 +1275,85 @@ bigEndian_ex_nums__initERD(bigEndian_ex_nums_ *instance, InfosetBase *parent)
     instance->hexBinaryPrefixed.dynamic = true;
 }
 
+static void
+bigEndian_ex_nums__reset(bigEndian_ex_nums_ *instance)
+{
+    instance->be_uint31 = 0;
+    instance->be_uint8 = 0;
+    instance->be_uint64 = 0;
+    instance->be_uint32 = 0;
+    instance->be_uint16 = 0;
+    instance->be_int17 = 0;
+    instance->be_int8 = 0;
+    instance->be_int64 = 0;
+    instance->be_int32 = 0;
+    instance->be_int16 = 0;
+    instance->be_float = 0;
+    instance->be_double = 0;
+    instance->be_boolean = 0;
+    instance->be_bool16 = 0;
+}
+
+static void
+bigEndian_ex_nums__randomize(bigEndian_ex_nums_ *instance, RState *rstate)
+{
+    instance->be_bool16 = random_int(0, 1, rstate);
+    instance->be_boolean = random_int(0, 1, rstate);
+    instance->be_double = random_double(-1000000.0, 1000000.0, rstate);
+    instance->be_float = random_double(-1000000.0, 1000000.0, rstate);
+    instance->be_int16 = random_int(-32768, 32767, rstate);
+    instance->be_int32 = random_int(-2147483648, 2147483647, rstate);
+    instance->be_int64 = random_int(INT64_MIN, 9223372036854775807, rstate);
+    instance->be_int8 = random_int(-128, 127, rstate);
+    instance->be_int17 = random_int(-65536, 65535, rstate);
+    instance->be_uint16 = random_uint(0, 65535, rstate);
+    instance->be_uint32 = random_uint(0, 4294967295, rstate);
+    instance->be_uint64 = random_uint(0, UINT64_MAX, rstate);
+    instance->be_uint8 = random_uint(0, 255, rstate);
+    instance->be_uint31 = random_uint(0, 2147483647, rstate);
+    random_hexBinary(&instance->hexBinary4, rstate);
+    random_hexBinary_alloc(&instance->hexBinaryPrefixed, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+}
+
 static void
 bigEndian_ex_nums__parseSelf(bigEndian_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&bigEndian_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(480, pstate);
+    if (pstate->pu.error) return;
     parse_be_bool(&instance->be_bool16, 16, 16, 0, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_bool16_bigEndian_ex_nums_ERD);
     parse_be_bool(&instance->be_boolean, 32, -1, 0, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_boolean_bigEndian_ex_nums_ERD);
     parse_be_double(&instance->be_double, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_double_bigEndian_ex_nums_ERD);
     parse_be_float(&instance->be_float, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_float_bigEndian_ex_nums_ERD);
     parse_be_int16(&instance->be_int16, 16, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_int16_bigEndian_ex_nums_ERD);
     parse_be_int32(&instance->be_int32, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_int32_bigEndian_ex_nums_ERD);
     parse_be_int64(&instance->be_int64, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_int64_bigEndian_ex_nums_ERD);
     parse_be_int8(&instance->be_int8, 8, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_int8_bigEndian_ex_nums_ERD);
     parse_be_int32(&instance->be_int17, 17, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_int17_bigEndian_ex_nums_ERD);
     parse_be_uint16(&instance->be_uint16, 16, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_uint16_bigEndian_ex_nums_ERD);
     parse_be_uint32(&instance->be_uint32, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_uint32_bigEndian_ex_nums_ERD);
     parse_be_uint64(&instance->be_uint64, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_uint64_bigEndian_ex_nums_ERD);
     parse_be_uint8(&instance->be_uint8, 8, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_uint8_bigEndian_ex_nums_ERD);
     parse_be_uint32(&instance->be_uint31, 31, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&be_uint31_bigEndian_ex_nums_ERD);
     parse_hexBinary(&instance->hexBinary4, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&hexBinary4_bigEndian_ex_nums_ERD);
     uint16_t _l_hexBinaryPrefixed;
     parse_be_uint16(&_l_hexBinaryPrefixed, 16, pstate);
     if (pstate->pu.error) return;
@@ -1152,45 +1361,63 @@ bigEndian_ex_nums__parseSelf(bigEndian_ex_nums_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->hexBinaryPrefixed, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&hexBinaryPrefixed_bigEndian_ex_nums_ERD);
 }
 
 static void
 bigEndian_ex_nums__unparseSelf(const bigEndian_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&bigEndian_ex_nums_ERD, &ustate->pu);
     unparse_be_bool(instance->be_bool16, 16, 16, 0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_bool16_bigEndian_ex_nums_ERD);
     unparse_be_bool(instance->be_boolean, 32, ~0, 0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_boolean_bigEndian_ex_nums_ERD);
     unparse_be_double(instance->be_double, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_double_bigEndian_ex_nums_ERD);
     unparse_be_float(instance->be_float, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_float_bigEndian_ex_nums_ERD);
     unparse_be_int16(instance->be_int16, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_int16_bigEndian_ex_nums_ERD);
     unparse_be_int32(instance->be_int32, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_int32_bigEndian_ex_nums_ERD);
     unparse_be_int64(instance->be_int64, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_int64_bigEndian_ex_nums_ERD);
     unparse_be_int8(instance->be_int8, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_int8_bigEndian_ex_nums_ERD);
     unparse_be_int32(instance->be_int17, 17, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_int17_bigEndian_ex_nums_ERD);
     unparse_be_uint16(instance->be_uint16, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_uint16_bigEndian_ex_nums_ERD);
     unparse_be_uint32(instance->be_uint32, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_uint32_bigEndian_ex_nums_ERD);
     unparse_be_uint64(instance->be_uint64, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_uint64_bigEndian_ex_nums_ERD);
     unparse_be_uint8(instance->be_uint8, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_uint8_bigEndian_ex_nums_ERD);
     unparse_be_uint32(instance->be_uint31, 31, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&be_uint31_bigEndian_ex_nums_ERD);
     unparse_hexBinary(instance->hexBinary4, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&hexBinary4_bigEndian_ex_nums_ERD);
     unparse_be_uint16(instance->hexBinaryPrefixed.lengthInBytes, 16, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->hexBinaryPrefixed, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&hexBinaryPrefixed_bigEndian_ex_nums_ERD);
 }
 
 static void
@@ -1204,39 +1431,84 @@ littleEndian_ex_nums__initERD(littleEndian_ex_nums_ *instance, InfosetBase *pare
     instance->hexBinaryPrefixed.dynamic = true;
 }
 
+static void
+littleEndian_ex_nums__reset(littleEndian_ex_nums_ *instance)
+{
+    instance->le_uint10 = 0;
+    instance->le_uint8 = 0;
+    instance->le_uint64 = 0;
+    instance->le_uint32 = 0;
+    instance->le_uint16 = 0;
+    instance->le_int46 = 0;
+    instance->le_int8 = 0;
+    instance->le_int64 = 0;
+    instance->le_int32 = 0;
+    instance->le_int16 = 0;
+    instance->le_float = 0;
+    instance->le_double = 0;
+    instance->le_boolean = 0;
+    instance->le_bool16 = 0;
+}
+
+static void
+littleEndian_ex_nums__randomize(littleEndian_ex_nums_ *instance, RState *rstate)
+{
+    instance->le_bool16 = random_int(0, 1, rstate);
+    instance->le_boolean = random_int(0, 1, rstate);
+    instance->le_double = random_double(-1000000.0, 1000000.0, rstate);
+    instance->le_float = random_double(-1000000.0, 1000000.0, rstate);
+    instance->le_int16 = random_int(-32768, 32767, rstate);
+    instance->le_int32 = random_int(-2147483648, 2147483647, rstate);
+    instance->le_int64 = random_int(INT64_MIN, 9223372036854775807, rstate);
+    instance->le_int8 = random_int(-128, 127, rstate);
+    instance->le_int46 = random_int(-35184372088832, 35184372088831, rstate);
+    instance->le_uint16 = random_uint(0, 65535, rstate);
+    instance->le_uint32 = random_uint(0, 4294967295, rstate);
+    instance->le_uint64 = random_uint(0, UINT64_MAX, rstate);
+    instance->le_uint8 = random_uint(0, 255, rstate);
+    instance->le_uint10 = random_uint(0, 1023, rstate);
+    random_hexBinary_alloc(&instance->hexBinaryPrefixed, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+}
+
 static void
 littleEndian_ex_nums__parseSelf(littleEndian_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&littleEndian_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(456, pstate);
+    if (pstate->pu.error) return;
     parse_le_bool(&instance->le_bool16, 16, 16, 0, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_bool16_littleEndian_ex_nums_ERD);
     parse_le_bool(&instance->le_boolean, 32, -1, 0, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_boolean_littleEndian_ex_nums_ERD);
     parse_le_double(&instance->le_double, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_double_littleEndian_ex_nums_ERD);
     parse_le_float(&instance->le_float, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_float_littleEndian_ex_nums_ERD);
     parse_le_int16(&instance->le_int16, 16, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_int16_littleEndian_ex_nums_ERD);
     parse_le_int32(&instance->le_int32, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_int32_littleEndian_ex_nums_ERD);
     parse_le_int64(&instance->le_int64, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_int64_littleEndian_ex_nums_ERD);
     parse_le_int8(&instance->le_int8, 8, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_int8_littleEndian_ex_nums_ERD);
     parse_le_int64(&instance->le_int46, 46, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_int46_littleEndian_ex_nums_ERD);
     parse_le_uint16(&instance->le_uint16, 16, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_uint16_littleEndian_ex_nums_ERD);
     parse_le_uint32(&instance->le_uint32, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_uint32_littleEndian_ex_nums_ERD);
     parse_le_uint64(&instance->le_uint64, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_uint64_littleEndian_ex_nums_ERD);
     parse_le_uint8(&instance->le_uint8, 8, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_uint8_littleEndian_ex_nums_ERD);
     parse_le_uint16(&instance->le_uint10, 10, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&le_uint10_littleEndian_ex_nums_ERD);
     parse_hexBinary(&instance->hexBinary0, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&hexBinary0_littleEndian_ex_nums_ERD);
     uint16_t _l_hexBinaryPrefixed;
     parse_le_uint16(&_l_hexBinaryPrefixed, 16, pstate);
     if (pstate->pu.error) return;
@@ -1244,45 +1516,63 @@ littleEndian_ex_nums__parseSelf(littleEndian_ex_nums_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->hexBinaryPrefixed, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&hexBinaryPrefixed_littleEndian_ex_nums_ERD);
 }
 
 static void
 littleEndian_ex_nums__unparseSelf(const littleEndian_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&littleEndian_ex_nums_ERD, &ustate->pu);
     unparse_le_bool(instance->le_bool16, 16, 16, 0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_bool16_littleEndian_ex_nums_ERD);
     unparse_le_bool(instance->le_boolean, 32, ~0, 0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_boolean_littleEndian_ex_nums_ERD);
     unparse_le_double(instance->le_double, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_double_littleEndian_ex_nums_ERD);
     unparse_le_float(instance->le_float, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_float_littleEndian_ex_nums_ERD);
     unparse_le_int16(instance->le_int16, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_int16_littleEndian_ex_nums_ERD);
     unparse_le_int32(instance->le_int32, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_int32_littleEndian_ex_nums_ERD);
     unparse_le_int64(instance->le_int64, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_int64_littleEndian_ex_nums_ERD);
     unparse_le_int8(instance->le_int8, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_int8_littleEndian_ex_nums_ERD);
     unparse_le_int64(instance->le_int46, 46, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_int46_littleEndian_ex_nums_ERD);
     unparse_le_uint16(instance->le_uint16, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_uint16_littleEndian_ex_nums_ERD);
     unparse_le_uint32(instance->le_uint32, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_uint32_littleEndian_ex_nums_ERD);
     unparse_le_uint64(instance->le_uint64, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_uint64_littleEndian_ex_nums_ERD);
     unparse_le_uint8(instance->le_uint8, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_uint8_littleEndian_ex_nums_ERD);
     unparse_le_uint16(instance->le_uint10, 10, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&le_uint10_littleEndian_ex_nums_ERD);
     unparse_hexBinary(instance->hexBinary0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&hexBinary0_littleEndian_ex_nums_ERD);
     unparse_le_uint16(instance->hexBinaryPrefixed.lengthInBytes, 16, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->hexBinaryPrefixed, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&hexBinaryPrefixed_littleEndian_ex_nums_ERD);
 }
 
 static void
@@ -1299,36 +1589,80 @@ fixed_ex_nums__initERD(fixed_ex_nums_ *instance, InfosetBase *parent)
     instance->hexBinaryPrefixed_ab.dynamic = true;
 }
 
+static void
+fixed_ex_nums__reset(fixed_ex_nums_ *instance)
+{
+    instance->int_32 = 0;
+    instance->float_1_5 = 0;
+    instance->double_3 = 0;
+    instance->boolean_true = 0;
+    instance->boolean_false = 0;
+}
+
+static void
+fixed_ex_nums__randomize(fixed_ex_nums_ *instance, RState *rstate)
+{
+    instance->boolean_false = false;
+    instance->boolean_true = true;
+    instance->double_3 = 3.0;
+    instance->float_1_5 = 1.5;
+    instance->int_32 = 32;
+    random_hexBinary(&instance->hexBinary_deadbeef, rstate);
+    random_hexBinary_copy(&instance->hexBinary_deadbeef, (const uint8_t[]){0xDE, 0xAD, 0xBE, 0xEF}, 4, rstate);
+    if (rstate->error) return;
+    random_hexBinary_alloc(&instance->hexBinaryPrefixed_ab, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+    random_hexBinary_copy(&instance->hexBinaryPrefixed_ab, (const uint8_t[]){0xAB}, 1, rstate);
+    if (rstate->error) return;
+}
+
 static void
 fixed_ex_nums__parseSelf(fixed_ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&fixed_ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(232, pstate);
+    if (pstate->pu.error) return;
     parse_be_bool(&instance->boolean_false, 32, -1, 0, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->boolean_false == false, "boolean_false", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&boolean_false_fixed_ex_nums_ERD);
     parse_be_bool(&instance->boolean_true, 32, -1, 0, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->boolean_true == true, "boolean_true", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&boolean_true_fixed_ex_nums_ERD);
     parse_be_double(&instance->double_3, 64, pstate);
-    if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->double_3 == 3.0, "double_3", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&double_3_fixed_ex_nums_ERD);
     parse_be_float(&instance->float_1_5, 32, pstate);
-    if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->float_1_5 == 1.5, "float_1_5", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&float_1_5_fixed_ex_nums_ERD);
     parse_be_int32(&instance->int_32, 32, pstate);
-    if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->int_32 == 32, "int_32", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&int_32_fixed_ex_nums_ERD);
     parse_hexBinary(&instance->hexBinary_deadbeef, pstate);
-    if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     uint8_t hexBinary_deadbeef_fixed[] = {0xDE, 0xAD, 0xBE, 0xEF};
     validate_fixed_attribute(memcmp(instance->hexBinary_deadbeef.array, hexBinary_deadbeef_fixed, sizeof(hexBinary_deadbeef_fixed)) == 0, "hexBinary_deadbeef", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&hexBinary_deadbeef_fixed_ex_nums_ERD);
     parse_hexBinary(&instance->hexBinary0, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&hexBinary0_fixed_ex_nums_ERD);
     int8_t _l_hexBinaryPrefixed_ab;
     parse_be_int8(&_l_hexBinaryPrefixed_ab, 8, pstate);
     if (pstate->pu.error) return;
@@ -1336,48 +1670,74 @@ fixed_ex_nums__parseSelf(fixed_ex_nums_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->hexBinaryPrefixed_ab, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     uint8_t hexBinaryPrefixed_ab_fixed[] = {0xAB};
     validate_fixed_attribute(memcmp(instance->hexBinaryPrefixed_ab.array, hexBinaryPrefixed_ab_fixed, sizeof(hexBinaryPrefixed_ab_fixed)) == 0, "hexBinaryPrefixed_ab", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&hexBinaryPrefixed_ab_fixed_ex_nums_ERD);
 }
 
 static void
 fixed_ex_nums__unparseSelf(const fixed_ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&fixed_ex_nums_ERD, &ustate->pu);
     unparse_be_bool(instance->boolean_false, 32, ~0, 0, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->boolean_false == false, "boolean_false", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&boolean_false_fixed_ex_nums_ERD);
     unparse_be_bool(instance->boolean_true, 32, ~0, 0, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->boolean_true == true, "boolean_true", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&boolean_true_fixed_ex_nums_ERD);
     unparse_be_double(instance->double_3, 64, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->double_3 == 3.0, "double_3", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&double_3_fixed_ex_nums_ERD);
     unparse_be_float(instance->float_1_5, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->float_1_5 == 1.5, "float_1_5", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&float_1_5_fixed_ex_nums_ERD);
     unparse_be_int32(instance->int_32, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_fixed_attribute(instance->int_32 == 32, "int_32", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&int_32_fixed_ex_nums_ERD);
     unparse_hexBinary(instance->hexBinary_deadbeef, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     uint8_t hexBinary_deadbeef_fixed[] = {0xDE, 0xAD, 0xBE, 0xEF};
     validate_fixed_attribute(memcmp(instance->hexBinary_deadbeef.array, hexBinary_deadbeef_fixed, sizeof(hexBinary_deadbeef_fixed)) == 0, "hexBinary_deadbeef", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&hexBinary_deadbeef_fixed_ex_nums_ERD);
     unparse_hexBinary(instance->hexBinary0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&hexBinary0_fixed_ex_nums_ERD);
     unparse_be_int8(instance->hexBinaryPrefixed_ab.lengthInBytes, 8, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->hexBinaryPrefixed_ab, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     uint8_t hexBinaryPrefixed_ab_fixed[] = {0xAB};
     validate_fixed_attribute(memcmp(instance->hexBinaryPrefixed_ab.array, hexBinaryPrefixed_ab_fixed, sizeof(hexBinaryPrefixed_ab_fixed)) == 0, "hexBinaryPrefixed_ab", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&hexBinaryPrefixed_ab_fixed_ex_nums_ERD);
 }
 
 static void
@@ -1391,9 +1751,34 @@ ex_nums__initERD(ex_nums_ *instance, InfosetBase *parent)
     fixed_ex_nums__initERD(&instance->fixed, (InfosetBase *)instance);
 }
 
+static void
+ex_nums__reset(ex_nums_ *instance)
+{
+    fixed_ex_nums__reset(&instance->fixed);
+    littleEndian_ex_nums__reset(&instance->littleEndian);
+    bigEndian_ex_nums__reset(&instance->bigEndian);
+    array_ex_nums__reset(&instance->array);
+}
+
+static void
+ex_nums__randomize(ex_nums_ *instance, RState *rstate)
+{
+    array_ex_nums__randomize(&instance->array, rstate);
+    if (rstate->error) return;
+    bigEndian_ex_nums__randomize(&instance->bigEndian, rstate);
+    if (rstate->error) return;
+    littleEndian_ex_nums__randomize(&instance->littleEndian, rstate);
+    if (rstate->error) return;
+    fixed_ex_nums__randomize(&instance->fixed, rstate);
+    if (rstate->error) return;
+}
+
 static void
 ex_nums__parseSelf(ex_nums_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&ex_nums_ERD, &pstate->pu);
+    parse_read_ahead(256, pstate);
+    if (pstate->pu.error) return;
     array_ex_nums__parseSelf(&instance->array, pstate);
     if (pstate->pu.error) return;
     bigEndian_ex_nums__parseSelf(&instance->bigEndian, pstate);
@@ -1407,6 +1792,7 @@ ex_nums__parseSelf(ex_nums_ *instance, PState *pstate)
 static void
 ex_nums__unparseSelf(const ex_nums_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&ex_nums_ERD, &ustate->pu);
     array_ex_nums__unparseSelf(&instance->array, ustate);
     if (ustate->pu.error) return;
     bigEndian_ex_nums__unparseSelf(&instance->bigEndian, ustate);
@@ -1417,21 +1803,61 @@ ex_nums__unparseSelf(const ex_nums_ *instance, UState *ustate)
     if (ustate->pu.error) return;
 }
 
-// Get an infoset (optionally clearing it first) for parsing/walking
+static void
+ex_nums__frameSelf(ex_nums_ *instance, PState *pstate)
+{
+    parse_read_ahead(256, pstate);
+    if (pstate->pu.error) return;
+    array_ex_nums__parseSelf(&instance->array, pstate);
+    if (pstate->pu.error) return;
+    bigEndian_ex_nums__parseSelf(&instance->bigEndian, pstate);
+    if (pstate->pu.error) return;
+    littleEndian_ex_nums__parseSelf(&instance->littleEndian, pstate);
+    if (pstate->pu.error) return;
+    fixed_ex_nums__parseSelf(&instance->fixed, pstate);
+    if (pstate->pu.error) return;
+}
+
+// Get an infoset (optionally clearing it first) for parsing/walking.
+// Each thread gets its own infoset.
 
 InfosetBase *
 get_infoset(bool clear_infoset)
 {
-    static ex_nums_ infoset;
+    static _Thread_local ex_nums_ infoset;
+    static _Thread_local bool initialized;
 
     if (clear_infoset)
     {
-        // If your infoset contains hexBinary prefixed length elements,
-        // you may want to walk infoset first to free their malloc'ed
-        // storage - we are not handling that case for now...
-        memset(&infoset, 0, sizeof(infoset));
-        ex_nums__initERD(&infoset, (InfosetBase *)&infoset);
+        // Initialize the infoset's ERD and parent pointers only once,
+        // then clear only the values which the last parse filled in
+        if (initialized)
+        {
+            ex_nums__reset(&infoset);
+        }
+        else
+        {
+            ex_nums__initERD(&infoset, (InfosetBase *)&infoset);
+            initialized = true;
+        }
     }
 
     return &infoset._base;
 }
+
+// Frame a record by parsing only the fields needed to find where it
+// ends and skipping over the rest of its data for building an index
+
+void
+frame_record(InfosetBase *infoset, PState *pstate)
+{
+    ex_nums__frameSelf((ex_nums_ *)infoset, pstate);
+}
+
+// Fill an infoset with random values for generating data
+
+void
+randomize_infoset(InfosetBase *infoset, RState *rstate)
+{
+    ex_nums__randomize((ex_nums_ *)infoset, rstate);
+}
@@ -1,13 +1,17 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "generated_code.h"
-#include <stdbool.h>    // for false, bool, true
-#include <stddef.h>     // for NULL, size_t
-#include <string.h>     // for memcmp, memset
-#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+#include <stdbool.h>     // for false, bool, true
+#include <stddef.h>      // for NULL, size_t
+#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+#include <string.h>      // for memcmp
+#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
 // clang-format on
 
 // Declare prototypes for easier compilation
@@ -16,6 +20,7 @@ static void padhexbinary_padtest__parseSelf(padhexbinary_padtest_ *instance, PSt
 static void padhexbinary_padtest__unparseSelf(const padhexbinary_padtest_ *instance, UState *ustate);
 static void padtest__parseSelf(padtest_ *instance, PState *pstate);
 static void padtest__unparseSelf(const padtest_ *instance, UState *ustate);
+static void padtest__frameSelf(padtest_ *instance, PState *pstate);
 
 // Define schema version (will be empty if schema did not define any version string)
 
@@ -105,9 +110,26 @@ padhexbinary_padtest__initERD(padhexbinary_padtest_ *instance, InfosetBase *pare
     instance->opaque.dynamic = true;
 }
 
+static void
+padhexbinary_padtest__reset(padhexbinary_padtest_ *instance)
+{
+    // Empty struct, but need to prevent compiler warnings
+    UNUSED(instance);
+}
+
+static void
+padhexbinary_padtest__randomize(padhexbinary_padtest_ *instance, RState *rstate)
+{
+    random_hexBinary_alloc(&instance->opaque, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+}
+
 static void
 padhexbinary_padtest__parseSelf(padhexbinary_padtest_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&padhexbinary_padtest_ERD, &pstate->pu);
+    parse_read_ahead(32, pstate);
+    if (pstate->pu.error) return;
     uint32_t _l_opaque;
     parse_be_uint32(&_l_opaque, 32, pstate);
     if (pstate->pu.error) return;
@@ -115,6 +137,7 @@ padhexbinary_padtest__parseSelf(padhexbinary_padtest_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->opaque, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&opaque_padhexbinary_ERD);
     // Align to closest alignment
     parse_align_to(32, pstate);
     if (pstate->pu.error) return;
@@ -123,10 +146,12 @@ padhexbinary_padtest__parseSelf(padhexbinary_padtest_ *instance, PState *pstate)
 static void
 padhexbinary_padtest__unparseSelf(const padhexbinary_padtest_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&padhexbinary_padtest_ERD, &ustate->pu);
     unparse_be_uint32(instance->opaque.lengthInBytes, 32, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->opaque, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&opaque_padhexbinary_ERD);
     // Align to closest alignment
     unparse_align_to(32, '\0', ustate);
     if (ustate->pu.error) return;
@@ -140,39 +165,96 @@ padtest__initERD(padtest_ *instance, InfosetBase *parent)
     padhexbinary_padtest__initERD(&instance->padhexbinary, (InfosetBase *)instance);
 }
 
+static void
+padtest__reset(padtest_ *instance)
+{
+    instance->after = 0;
+    padhexbinary_padtest__reset(&instance->padhexbinary);
+}
+
+static void
+padtest__randomize(padtest_ *instance, RState *rstate)
+{
+    padhexbinary_padtest__randomize(&instance->padhexbinary, rstate);
+    if (rstate->error) return;
+    instance->after = random_uint(0, 4294967295, rstate);
+}
+
 static void
 padtest__parseSelf(padtest_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&padtest_ERD, &pstate->pu);
+    parse_read_ahead(32, pstate);
+    if (pstate->pu.error) return;
     padhexbinary_padtest__parseSelf(&instance->padhexbinary, pstate);
     if (pstate->pu.error) return;
     parse_be_uint32(&instance->after, 32, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&after_padtest_ERD);
 }
 
 static void
 padtest__unparseSelf(const padtest_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&padtest_ERD, &ustate->pu);
     padhexbinary_padtest__unparseSelf(&instance->padhexbinary, ustate);
     if (ustate->pu.error) return;
     unparse_be_uint32(instance->after, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&after_padtest_ERD);
+}
+
+static void
+padtest__frameSelf(padtest_ *instance, PState *pstate)
+{
+    parse_read_ahead(32, pstate);
+    if (pstate->pu.error) return;
+    padhexbinary_padtest__parseSelf(&instance->padhexbinary, pstate);
+    if (pstate->pu.error) return;
+    parse_skip_bits(32, pstate);
+    if (pstate->pu.error) return;
 }
 
-// Get an infoset (optionally clearing it first) for parsing/walking
+// Get an infoset (optionally clearing it first) for parsing/walking.
+// Each thread gets its own infoset.
 
 InfosetBase *
 get_infoset(bool clear_infoset)
 {
-    static padtest_ infoset;
+    static _Thread_local padtest_ infoset;
+    static _Thread_local bool initialized;
 
     if (clear_infoset)
     {
-        // If your infoset contains hexBinary prefixed length elements,
-        // you may want to walk infoset first to free their malloc'ed
-        // storage - we are not handling that case for now...
-        memset(&infoset, 0, sizeof(infoset));
-        padtest__initERD(&infoset, (InfosetBase *)&infoset);
+        // Initialize the infoset's ERD and parent pointers only once,
+        // then clear only the values which the last parse filled in
+        if (initialized)
+        {
+            padtest__reset(&infoset);
+        }
+        else
+        {
+            padtest__initERD(&infoset, (InfosetBase *)&infoset);
+            initialized = true;
+        }
     }
 
     return &infoset._base;
 }
+
+// Frame a record by parsing only the fields needed to find where it
+// ends and skipping over the rest of its data for building an index
+
+void
+frame_record(InfosetBase *infoset, PState *pstate)
+{
+    padtest__frameSelf((padtest_ *)infoset, pstate);
+}
+
+// Fill an infoset with random values for generating data
+
+void
+randomize_infoset(InfosetBase *infoset, RState *rstate)
+{
+    padtest__randomize((padtest_ *)infoset, rstate);
+}
@@ -1,19 +1,24 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "generated_code.h"
-#include <stdbool.h>    // for false, bool, true
-#include <stddef.h>     // for NULL, size_t
-#include <string.h>     // for memcmp, memset
-#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+#include <stdbool.h>     // for false, bool, true
+#include <stddef.h>      // for NULL, size_t
+#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+#include <string.h>      // for memcmp
+#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
 // clang-format on
 
 // Declare prototypes for easier compilation
 
 static void simple__parseSelf(simple_ *instance, PState *pstate);
 static void simple__unparseSelf(const simple_ *instance, UState *ustate);
+static void simple__frameSelf(simple_ *instance, PState *pstate);
 
 // Define schema version (will be empty if schema did not define any version string)
 
@@ -553,19 +558,135 @@ simple__initERD(simple_ *instance, InfosetBase *parent)
     instance->enum_hexBinaryPrefixed.dynamic = true;
 }
 
+static void
+simple__reset(simple_ *instance)
+{
+    instance->range_unsignedShort = 0;
+    instance->range_unsignedLong = 0;
+    instance->range_unsignedInt = 0;
+    instance->range_unsignedByte = 0;
+    instance->range_short = 0;
+    instance->range_nonNegativeInteger = 0;
+    instance->range_long = 0;
+    instance->range_integer = 0;
+    instance->range_int = 0;
+    instance->range_float = 0;
+    instance->range_double = 0;
+    instance->range_byte = 0;
+    instance->enum_unsignedShort = 0;
+    instance->enum_unsignedLong = 0;
+    instance->enum_unsignedInt = 0;
+    instance->enum_unsignedByte = 0;
+    instance->enum_short = 0;
+    instance->enum_nonNegativeInteger = 0;
+    instance->enum_long = 0;
+    instance->enum_integer = 0;
+    instance->enum_int = 0;
+    instance->enum_float = 0;
+    instance->enum_double = 0;
+    instance->enum_byte = 0;
+    instance->simple_unsignedShort = 0;
+    instance->simple_unsignedLong = 0;
+    instance->simple_unsignedInt = 0;
+    instance->simple_unsignedByte = 0;
+    instance->simple_short = 0;
+    instance->simple_nonNegativeInteger = 0;
+    instance->simple_long = 0;
+    instance->simple_integer = 0;
+    instance->simple_int = 0;
+    instance->simple_float = 0;
+    instance->simple_double = 0;
+    instance->simple_byte = 0;
+    instance->simple_boolean = 0;
+}
+
+static void
+simple__randomize(simple_ *instance, RState *rstate)
+{
+    instance->simple_boolean = random_int(0, 1, rstate);
+    instance->simple_byte = random_int(-128, 127, rstate);
+    instance->simple_double = random_double(-1000000.0, 1000000.0, rstate);
+    instance->simple_float = random_double(-1000000.0, 1000000.0, rstate);
+    random_hexBinary(&instance->simple_hexBinary, rstate);
+    random_hexBinary_alloc(&instance->simple_hexBinaryPrefixed, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+    instance->simple_int = random_int(-2147483648, 2147483647, rstate);
+    instance->simple_integer = random_int(-2147483648, 2147483647, rstate);
+    instance->simple_long = random_int(INT64_MIN, 9223372036854775807, rstate);
+    instance->simple_nonNegativeInteger = random_uint(0, 4294967295, rstate);
+    instance->simple_short = random_int(-32768, 32767, rstate);
+    instance->simple_unsignedByte = random_uint(0, 255, rstate);
+    instance->simple_unsignedInt = random_uint(0, 4294967295, rstate);
+    instance->simple_unsignedLong = random_uint(0, UINT64_MAX, rstate);
+    instance->simple_unsignedShort = random_uint(0, 65535, rstate);
+    static const int64_t enums_enum_byte[] = {1, 2};
+    instance->enum_byte = enums_enum_byte[random_index(2, rstate)];
+    static const double enums_enum_double[] = {1.0, 2.0};
+    instance->enum_double = enums_enum_double[random_index(2, rstate)];
+    static const double enums_enum_float[] = {1.0, 2.0};
+    instance->enum_float = enums_enum_float[random_index(2, rstate)];
+    random_hexBinary(&instance->enum_hexBinary, rstate);
+    static const uint8_t arrays_enum_hexBinary[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const size_t lengths_enum_hexBinary[] = {4, 4};
+    const size_t _r_enum_hexBinary = random_index(2, rstate);
+    random_hexBinary_copy(&instance->enum_hexBinary, arrays_enum_hexBinary[_r_enum_hexBinary], lengths_enum_hexBinary[_r_enum_hexBinary], rstate);
+    if (rstate->error) return;
+    random_hexBinary_alloc(&instance->enum_hexBinaryPrefixed, random_uint(0, 64, rstate), rstate);
+    if (rstate->error) return;
+    static const uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const size_t lengths_enum_hexBinaryPrefixed[] = {4, 4};
+    const size_t _r_enum_hexBinaryPrefixed = random_index(2, rstate);
+    random_hexBinary_copy(&instance->enum_hexBinaryPrefixed, arrays_enum_hexBinaryPrefixed[_r_enum_hexBinaryPrefixed], lengths_enum_hexBinaryPrefixed[_r_enum_hexBinaryPrefixed], rstate);
+    if (rstate->error) return;
+    static const int64_t enums_enum_int[] = {1, 2};
+    instance->enum_int = enums_enum_int[random_index(2, rstate)];
+    static const int64_t enums_enum_integer[] = {1, 2};
+    instance->enum_integer = enums_enum_integer[random_index(2, rstate)];
+    static const int64_t enums_enum_long[] = {1, 2};
+    instance->enum_long = enums_enum_long[random_index(2, rstate)];
+    static const uint64_t enums_enum_nonNegativeInteger[] = {1, 2};
+    instance->enum_nonNegativeInteger = enums_enum_nonNegativeInteger[random_index(2, rstate)];
+    static const int64_t enums_enum_short[] = {1, 2};
+    instance->enum_short = enums_enum_short[random_index(2, rstate)];
+    static const uint64_t enums_enum_unsignedByte[] = {1, 2};
+    instance->enum_unsignedByte = enums_enum_unsignedByte[random_index(2, rstate)];
+    static const uint64_t enums_enum_unsignedInt[] = {1, 2};
+    instance->enum_unsignedInt = enums_enum_unsignedInt[random_index(2, rstate)];
+    static const uint64_t enums_enum_unsignedLong[] = {1, 2};
+    instance->enum_unsignedLong = enums_enum_unsignedLong[random_index(2, rstate)];
+    static const uint64_t enums_enum_unsignedShort[] = {1, 2};
+    instance->enum_unsignedShort = enums_enum_unsignedShort[random_index(2, rstate)];
+    instance->range_byte = random_int(1, 100, rstate);
+    instance->range_double = random_double(1.0, 2.0, rstate);
+    instance->range_float = random_double(0.0, 1.0, rstate);
+    instance->range_int = random_int(1, 1, rstate);
+    instance->range_integer = random_int(1, 2, rstate);
+    instance->range_long = random_int(1, 2, rstate);
+    instance->range_nonNegativeInteger = random_uint(1, 2, rstate);
+    instance->range_short = random_int(1, 2, rstate);
+    instance->range_unsignedByte = random_uint(1, 2, rstate);
+    instance->range_unsignedInt = random_uint(1, 2, rstate);
+    instance->range_unsignedLong = random_uint(1, 2, rstate);
+    instance->range_unsignedShort = random_uint(1, 2, rstate);
+}
+
 static void
 simple__parseSelf(simple_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&simple_ERD, &pstate->pu);
+    parse_read_ahead(184, pstate);
+    if (pstate->pu.error) return;
     parse_be_bool(&instance->simple_boolean, 32, 1, 0, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_boolean_simple_ERD);
     parse_be_int8(&instance->simple_byte, 8, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_byte_simple_ERD);
     parse_be_double(&instance->simple_double, 64, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_double_simple_ERD);
     parse_be_float(&instance->simple_float, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_float_simple_ERD);
     parse_hexBinary(&instance->simple_hexBinary, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_hexBinary_simple_ERD);
     uint16_t _l_simple_hexBinaryPrefixed;
     parse_be_uint16(&_l_simple_hexBinaryPrefixed, 16, pstate);
     if (pstate->pu.error) return;
@@ -573,45 +694,67 @@ simple__parseSelf(simple_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->simple_hexBinaryPrefixed, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_hexBinaryPrefixed_simple_ERD);
     parse_be_int32(&instance->simple_int, 32, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_int_simple_ERD);
     parse_be_int32(&instance->simple_integer, 32, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_integer_simple_ERD);
     parse_be_int64(&instance->simple_long, 64, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_long_simple_ERD);
     parse_be_uint32(&instance->simple_nonNegativeInteger, 32, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_nonNegativeInteger_simple_ERD);
     parse_be_int16(&instance->simple_short, 16, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_short_simple_ERD);
     parse_be_uint8(&instance->simple_unsignedByte, 8, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedByte_simple_ERD);
     parse_be_uint32(&instance->simple_unsignedInt, 32, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedInt_simple_ERD);
     parse_be_uint64(&instance->simple_unsignedLong, 64, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedLong_simple_ERD);
     parse_be_uint16(&instance->simple_unsignedShort, 16, pstate);
     if (pstate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedShort_simple_ERD);
     parse_be_int8(&instance->enum_byte, 8, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_byte[] = {1, 2};
-    validate_integer_enumeration(instance->enum_byte, 2, enums_enum_byte, "enum_byte", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_byte[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_byte, 1, 2, enums_enum_byte, "enum_byte", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_byte_simple_ERD);
     parse_be_double(&instance->enum_double, 64, pstate);
     if (pstate->pu.error) return;
-    double enums_enum_double[] = {1.0, 2.0};
-    validate_floatpt_enumeration(instance->enum_double, 2, enums_enum_double, "enum_double", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const double enums_enum_double[] = {1.0, 2.0};
+    validate_floatpt_enumeration_sorted(instance->enum_double, 2, enums_enum_double, "enum_double", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_double_simple_ERD);
     parse_be_float(&instance->enum_float, 32, pstate);
     if (pstate->pu.error) return;
-    double enums_enum_float[] = {1.0, 2.0};
-    validate_floatpt_enumeration(instance->enum_float, 2, enums_enum_float, "enum_float", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const double enums_enum_float[] = {1.0, 2.0};
+    validate_floatpt_enumeration_sorted(instance->enum_float, 2, enums_enum_float, "enum_float", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_float_simple_ERD);
     parse_hexBinary(&instance->enum_hexBinary, pstate);
     if (pstate->pu.error) return;
-    uint8_t arrays_enum_hexBinary[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
-    HexBinary enums_enum_hexBinary[] = {{arrays_enum_hexBinary[0], 4, false}, {arrays_enum_hexBinary[1], 4, false}};
-    validate_hexbinary_enumeration(&instance->enum_hexBinary, 2, enums_enum_hexBinary, "enum_hexBinary", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static uint8_t arrays_enum_hexBinary[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const HexBinary enums_enum_hexBinary[] = {{arrays_enum_hexBinary[0], 4, false}, {arrays_enum_hexBinary[1], 4, false}};
+    validate_hexbinary_enumeration_sorted(&instance->enum_hexBinary, 2, enums_enum_hexBinary, "enum_hexBinary", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_hexBinary_simple_ERD);
     uint16_t _l_enum_hexBinaryPrefixed;
     parse_be_uint16(&_l_enum_hexBinaryPrefixed, 16, pstate);
     if (pstate->pu.error) return;
@@ -619,279 +762,497 @@ simple__parseSelf(simple_ *instance, PState *pstate)
     if (pstate->pu.error) return;
     parse_hexBinary(&instance->enum_hexBinaryPrefixed, pstate);
     if (pstate->pu.error) return;
-    uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
-    HexBinary enums_enum_hexBinaryPrefixed[] = {{arrays_enum_hexBinaryPrefixed[0], 4, false}, {arrays_enum_hexBinaryPrefixed[1], 4, false}};
-    validate_hexbinary_enumeration(&instance->enum_hexBinaryPrefixed, 2, enums_enum_hexBinaryPrefixed, "enum_hexBinaryPrefixed", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const HexBinary enums_enum_hexBinaryPrefixed[] = {{arrays_enum_hexBinaryPrefixed[0], 4, false}, {arrays_enum_hexBinaryPrefixed[1], 4, false}};
+    validate_hexbinary_enumeration_sorted(&instance->enum_hexBinaryPrefixed, 2, enums_enum_hexBinaryPrefixed, "enum_hexBinaryPrefixed", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_hexBinaryPrefixed_simple_ERD);
     parse_be_int32(&instance->enum_int, 32, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_int[] = {1, 2};
-    validate_integer_enumeration(instance->enum_int, 2, enums_enum_int, "enum_int", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_int[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_int, 1, 2, enums_enum_int, "enum_int", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_int_simple_ERD);
     parse_be_int32(&instance->enum_integer, 32, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_integer[] = {1, 2};
-    validate_integer_enumeration(instance->enum_integer, 2, enums_enum_integer, "enum_integer", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_integer[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_integer, 1, 2, enums_enum_integer, "enum_integer", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_integer_simple_ERD);
     parse_be_int64(&instance->enum_long, 64, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_long[] = {1, 2};
-    validate_integer_enumeration(instance->enum_long, 2, enums_enum_long, "enum_long", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_long[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_long, 1, 2, enums_enum_long, "enum_long", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_long_simple_ERD);
     parse_be_uint32(&instance->enum_nonNegativeInteger, 32, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_nonNegativeInteger[] = {1, 2};
-    validate_integer_enumeration(instance->enum_nonNegativeInteger, 2, enums_enum_nonNegativeInteger, "enum_nonNegativeInteger", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_nonNegativeInteger[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_nonNegativeInteger, 1, 2, enums_enum_nonNegativeInteger, "enum_nonNegativeInteger", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_nonNegativeInteger_simple_ERD);
     parse_be_int16(&instance->enum_short, 16, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_short[] = {1, 2};
-    validate_integer_enumeration(instance->enum_short, 2, enums_enum_short, "enum_short", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_short[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_short, 1, 2, enums_enum_short, "enum_short", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_short_simple_ERD);
     parse_be_uint8(&instance->enum_unsignedByte, 8, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_unsignedByte[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedByte, 2, enums_enum_unsignedByte, "enum_unsignedByte", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedByte[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedByte, 1, 2, enums_enum_unsignedByte, "enum_unsignedByte", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedByte_simple_ERD);
     parse_be_uint32(&instance->enum_unsignedInt, 32, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_unsignedInt[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedInt, 2, enums_enum_unsignedInt, "enum_unsignedInt", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedInt[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedInt, 1, 2, enums_enum_unsignedInt, "enum_unsignedInt", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedInt_simple_ERD);
     parse_be_uint64(&instance->enum_unsignedLong, 64, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_unsignedLong[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedLong, 2, enums_enum_unsignedLong, "enum_unsignedLong", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedLong[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedLong, 1, 2, enums_enum_unsignedLong, "enum_unsignedLong", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedLong_simple_ERD);
     parse_be_uint16(&instance->enum_unsignedShort, 16, pstate);
     if (pstate->pu.error) return;
-    int64_t enums_enum_unsignedShort[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedShort, 2, enums_enum_unsignedShort, "enum_unsignedShort", &pstate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedShort[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedShort, 1, 2, enums_enum_unsignedShort, "enum_unsignedShort", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedShort_simple_ERD);
     parse_be_int8(&instance->range_byte, 8, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_byte > 0 && instance->range_byte <= 100, "range_byte", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_byte_simple_ERD);
     parse_be_double(&instance->range_double, 64, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_double >= 1.0 && instance->range_double <= 2.0, "range_double", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_double_simple_ERD);
     parse_be_float(&instance->range_float, 32, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_float > 0.0 && instance->range_float < 1.0, "range_float", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_float_simple_ERD);
     parse_be_int32(&instance->range_int, 32, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_int >= 1 && instance->range_int < 2, "range_int", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_int_simple_ERD);
     parse_be_int32(&instance->range_integer, 32, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_integer >= 1 && instance->range_integer <= 2, "range_integer", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_integer_simple_ERD);
     parse_be_int64(&instance->range_long, 64, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_long >= 1 && instance->range_long <= 2, "range_long", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_long_simple_ERD);
     parse_be_uint32(&instance->range_nonNegativeInteger, 32, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_nonNegativeInteger >= 1 && instance->range_nonNegativeInteger <= 2, "range_nonNegativeInteger", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_nonNegativeInteger_simple_ERD);
     parse_be_int16(&instance->range_short, 16, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_short >= 1 && instance->range_short <= 2, "range_short", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_short_simple_ERD);
     parse_be_uint8(&instance->range_unsignedByte, 8, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedByte >= 1 && instance->range_unsignedByte <= 2, "range_unsignedByte", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedByte_simple_ERD);
     parse_be_uint32(&instance->range_unsignedInt, 32, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedInt >= 1 && instance->range_unsignedInt <= 2, "range_unsignedInt", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedInt_simple_ERD);
     parse_be_uint64(&instance->range_unsignedLong, 64, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedLong >= 1 && instance->range_unsignedLong <= 2, "range_unsignedLong", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedLong_simple_ERD);
     parse_be_uint16(&instance->range_unsignedShort, 16, pstate);
     if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedShort >= 1 && instance->range_unsignedShort <= 2, "range_unsignedShort", &pstate->pu);
     if (pstate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedShort_simple_ERD);
 }
 
 static void
 simple__unparseSelf(const simple_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&simple_ERD, &ustate->pu);
     unparse_be_bool(instance->simple_boolean, 32, 1, 0, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_boolean_simple_ERD);
     unparse_be_int8(instance->simple_byte, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_byte_simple_ERD);
     unparse_be_double(instance->simple_double, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_double_simple_ERD);
     unparse_be_float(instance->simple_float, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_float_simple_ERD);
     unparse_hexBinary(instance->simple_hexBinary, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_hexBinary_simple_ERD);
     unparse_be_uint16(instance->simple_hexBinaryPrefixed.lengthInBytes, 16, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->simple_hexBinaryPrefixed, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_hexBinaryPrefixed_simple_ERD);
     unparse_be_int32(instance->simple_int, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_int_simple_ERD);
     unparse_be_int32(instance->simple_integer, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_integer_simple_ERD);
     unparse_be_int64(instance->simple_long, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_long_simple_ERD);
     unparse_be_uint32(instance->simple_nonNegativeInteger, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_nonNegativeInteger_simple_ERD);
     unparse_be_int16(instance->simple_short, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_short_simple_ERD);
     unparse_be_uint8(instance->simple_unsignedByte, 8, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedByte_simple_ERD);
     unparse_be_uint32(instance->simple_unsignedInt, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedInt_simple_ERD);
     unparse_be_uint64(instance->simple_unsignedLong, 64, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedLong_simple_ERD);
     unparse_be_uint16(instance->simple_unsignedShort, 16, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&simple_unsignedShort_simple_ERD);
     unparse_be_int8(instance->enum_byte, 8, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_byte[] = {1, 2};
-    validate_integer_enumeration(instance->enum_byte, 2, enums_enum_byte, "enum_byte", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_byte[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_byte, 1, 2, enums_enum_byte, "enum_byte", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_byte_simple_ERD);
     unparse_be_double(instance->enum_double, 64, ustate);
     if (ustate->pu.error) return;
-    double enums_enum_double[] = {1.0, 2.0};
-    validate_floatpt_enumeration(instance->enum_double, 2, enums_enum_double, "enum_double", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const double enums_enum_double[] = {1.0, 2.0};
+    validate_floatpt_enumeration_sorted(instance->enum_double, 2, enums_enum_double, "enum_double", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_double_simple_ERD);
     unparse_be_float(instance->enum_float, 32, ustate);
     if (ustate->pu.error) return;
-    double enums_enum_float[] = {1.0, 2.0};
-    validate_floatpt_enumeration(instance->enum_float, 2, enums_enum_float, "enum_float", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const double enums_enum_float[] = {1.0, 2.0};
+    validate_floatpt_enumeration_sorted(instance->enum_float, 2, enums_enum_float, "enum_float", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_float_simple_ERD);
     unparse_hexBinary(instance->enum_hexBinary, ustate);
     if (ustate->pu.error) return;
-    uint8_t arrays_enum_hexBinary[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
-    HexBinary enums_enum_hexBinary[] = {{arrays_enum_hexBinary[0], 4, false}, {arrays_enum_hexBinary[1], 4, false}};
-    validate_hexbinary_enumeration(&instance->enum_hexBinary, 2, enums_enum_hexBinary, "enum_hexBinary", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static uint8_t arrays_enum_hexBinary[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const HexBinary enums_enum_hexBinary[] = {{arrays_enum_hexBinary[0], 4, false}, {arrays_enum_hexBinary[1], 4, false}};
+    validate_hexbinary_enumeration_sorted(&instance->enum_hexBinary, 2, enums_enum_hexBinary, "enum_hexBinary", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_hexBinary_simple_ERD);
     unparse_be_uint16(instance->enum_hexBinaryPrefixed.lengthInBytes, 16, ustate);
     if (ustate->pu.error) return;
     unparse_hexBinary(instance->enum_hexBinaryPrefixed, ustate);
     if (ustate->pu.error) return;
-    uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
-    HexBinary enums_enum_hexBinaryPrefixed[] = {{arrays_enum_hexBinaryPrefixed[0], 4, false}, {arrays_enum_hexBinaryPrefixed[1], 4, false}};
-    validate_hexbinary_enumeration(&instance->enum_hexBinaryPrefixed, 2, enums_enum_hexBinaryPrefixed, "enum_hexBinaryPrefixed", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const HexBinary enums_enum_hexBinaryPrefixed[] = {{arrays_enum_hexBinaryPrefixed[0], 4, false}, {arrays_enum_hexBinaryPrefixed[1], 4, false}};
+    validate_hexbinary_enumeration_sorted(&instance->enum_hexBinaryPrefixed, 2, enums_enum_hexBinaryPrefixed, "enum_hexBinaryPrefixed", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_hexBinaryPrefixed_simple_ERD);
     unparse_be_int32(instance->enum_int, 32, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_int[] = {1, 2};
-    validate_integer_enumeration(instance->enum_int, 2, enums_enum_int, "enum_int", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_int[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_int, 1, 2, enums_enum_int, "enum_int", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_int_simple_ERD);
     unparse_be_int32(instance->enum_integer, 32, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_integer[] = {1, 2};
-    validate_integer_enumeration(instance->enum_integer, 2, enums_enum_integer, "enum_integer", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_integer[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_integer, 1, 2, enums_enum_integer, "enum_integer", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_integer_simple_ERD);
     unparse_be_int64(instance->enum_long, 64, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_long[] = {1, 2};
-    validate_integer_enumeration(instance->enum_long, 2, enums_enum_long, "enum_long", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_long[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_long, 1, 2, enums_enum_long, "enum_long", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_long_simple_ERD);
     unparse_be_uint32(instance->enum_nonNegativeInteger, 32, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_nonNegativeInteger[] = {1, 2};
-    validate_integer_enumeration(instance->enum_nonNegativeInteger, 2, enums_enum_nonNegativeInteger, "enum_nonNegativeInteger", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_nonNegativeInteger[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_nonNegativeInteger, 1, 2, enums_enum_nonNegativeInteger, "enum_nonNegativeInteger", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_nonNegativeInteger_simple_ERD);
     unparse_be_int16(instance->enum_short, 16, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_short[] = {1, 2};
-    validate_integer_enumeration(instance->enum_short, 2, enums_enum_short, "enum_short", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_short[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_short, 1, 2, enums_enum_short, "enum_short", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_short_simple_ERD);
     unparse_be_uint8(instance->enum_unsignedByte, 8, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_unsignedByte[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedByte, 2, enums_enum_unsignedByte, "enum_unsignedByte", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedByte[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedByte, 1, 2, enums_enum_unsignedByte, "enum_unsignedByte", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedByte_simple_ERD);
     unparse_be_uint32(instance->enum_unsignedInt, 32, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_unsignedInt[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedInt, 2, enums_enum_unsignedInt, "enum_unsignedInt", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedInt[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedInt, 1, 2, enums_enum_unsignedInt, "enum_unsignedInt", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedInt_simple_ERD);
     unparse_be_uint64(instance->enum_unsignedLong, 64, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_unsignedLong[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedLong, 2, enums_enum_unsignedLong, "enum_unsignedLong", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedLong[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedLong, 1, 2, enums_enum_unsignedLong, "enum_unsignedLong", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedLong_simple_ERD);
     unparse_be_uint16(instance->enum_unsignedShort, 16, ustate);
     if (ustate->pu.error) return;
-    int64_t enums_enum_unsignedShort[] = {1, 2};
-    validate_integer_enumeration(instance->enum_unsignedShort, 2, enums_enum_unsignedShort, "enum_unsignedShort", &ustate->pu);
+#ifndef DAFFODIL_NO_VALIDATION
+    static const uint8_t enums_enum_unsignedShort[] = {0x03};
+    validate_integer_enumeration_bitset(instance->enum_unsignedShort, 1, 2, enums_enum_unsignedShort, "enum_unsignedShort", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&enum_unsignedShort_simple_ERD);
     unparse_be_int8(instance->range_byte, 8, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_byte > 0 && instance->range_byte <= 100, "range_byte", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_byte_simple_ERD);
     unparse_be_double(instance->range_double, 64, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_double >= 1.0 && instance->range_double <= 2.0, "range_double", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_double_simple_ERD);
     unparse_be_float(instance->range_float, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_float > 0.0 && instance->range_float < 1.0, "range_float", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_float_simple_ERD);
     unparse_be_int32(instance->range_int, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_int >= 1 && instance->range_int < 2, "range_int", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_int_simple_ERD);
     unparse_be_int32(instance->range_integer, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_integer >= 1 && instance->range_integer <= 2, "range_integer", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_integer_simple_ERD);
     unparse_be_int64(instance->range_long, 64, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_long >= 1 && instance->range_long <= 2, "range_long", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_long_simple_ERD);
     unparse_be_uint32(instance->range_nonNegativeInteger, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_nonNegativeInteger >= 1 && instance->range_nonNegativeInteger <= 2, "range_nonNegativeInteger", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_nonNegativeInteger_simple_ERD);
     unparse_be_int16(instance->range_short, 16, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_short >= 1 && instance->range_short <= 2, "range_short", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_short_simple_ERD);
     unparse_be_uint8(instance->range_unsignedByte, 8, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedByte >= 1 && instance->range_unsignedByte <= 2, "range_unsignedByte", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedByte_simple_ERD);
     unparse_be_uint32(instance->range_unsignedInt, 32, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedInt >= 1 && instance->range_unsignedInt <= 2, "range_unsignedInt", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedInt_simple_ERD);
     unparse_be_uint64(instance->range_unsignedLong, 64, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedLong >= 1 && instance->range_unsignedLong <= 2, "range_unsignedLong", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedLong_simple_ERD);
     unparse_be_uint16(instance->range_unsignedShort, 16, ustate);
     if (ustate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
     validate_schema_range(instance->range_unsignedShort >= 1 && instance->range_unsignedShort <= 2, "range_unsignedShort", &ustate->pu);
     if (ustate->pu.error) return;
+#endif
+    PROFILE_FIELD(&range_unsignedShort_simple_ERD);
+}
+
+static void
+simple__frameSelf(simple_ *instance, PState *pstate)
+{
+    parse_read_ahead(184, pstate);
+    if (pstate->pu.error) return;
+    parse_skip_bits(168, pstate);
+    if (pstate->pu.error) return;
+    uint16_t _l_simple_hexBinaryPrefixed;
+    parse_be_uint16(&_l_simple_hexBinaryPrefixed, 16, pstate);
+    if (pstate->pu.error) return;
+    alloc_hexBinary(&instance->simple_hexBinaryPrefixed, _l_simple_hexBinaryPrefixed, pstate);
+    if (pstate->pu.error) return;
+    parse_hexBinary(&instance->simple_hexBinaryPrefixed, pstate);
+    if (pstate->pu.error) return;
+    parse_skip_bits(432, pstate);
+    if (pstate->pu.error) return;
+    uint16_t _l_enum_hexBinaryPrefixed;
+    parse_be_uint16(&_l_enum_hexBinaryPrefixed, 16, pstate);
+    if (pstate->pu.error) return;
+    alloc_hexBinary(&instance->enum_hexBinaryPrefixed, _l_enum_hexBinaryPrefixed, pstate);
+    if (pstate->pu.error) return;
+    parse_hexBinary(&instance->enum_hexBinaryPrefixed, pstate);
+    if (pstate->pu.error) return;
+#ifndef DAFFODIL_NO_VALIDATION
+    static uint8_t arrays_enum_hexBinaryPrefixed[][4] = {{0x11, 0x22, 0x33, 0x44}, {0xAA, 0xBB, 0xCC, 0xDD}};
+    static const HexBinary enums_enum_hexBinaryPrefixed[] = {{arrays_enum_hexBinaryPrefixed[0], 4, false}, {arrays_enum_hexBinaryPrefixed[1], 4, false}};
+    validate_hexbinary_enumeration_sorted(&instance->enum_hexBinaryPrefixed, 2, enums_enum_hexBinaryPrefixed, "enum_hexBinaryPrefixed", &pstate->pu);
+    if (pstate->pu.error) return;
+#endif
+    parse_skip_bits(696, pstate);
+    if (pstate->pu.error) return;
 }
 
-// Get an infoset (optionally clearing it first) for parsing/walking
+// Get an infoset (optionally clearing it first) for parsing/walking.
+// Each thread gets its own infoset.
 
 InfosetBase *
 get_infoset(bool clear_infoset)
 {
-    static simple_ infoset;
+    static _Thread_local simple_ infoset;
+    static _Thread_local bool initialized;
 
     if (clear_infoset)
     {
-        // If your infoset contains hexBinary prefixed length elements,
-        // you may want to walk infoset first to free their malloc'ed
-        // storage - we are not handling that case for now...
-        memset(&infoset, 0, sizeof(infoset));
-        simple__initERD(&infoset, (InfosetBase *)&infoset);
+        // Initialize the infoset's ERD and parent pointers only once,
+        // then clear only the values which the last parse filled in
+        if (initialized)
+        {
+            simple__reset(&infoset);
+        }
+        else
+        {
+            simple__initERD(&infoset, (InfosetBase *)&infoset);
+            initialized = true;
+        }
     }
 
     return &infoset._base;
 }
+
+// Frame a record by parsing only the fields needed to find where it
+// ends and skipping over the rest of its data for building an index
+
+void
+frame_record(InfosetBase *infoset, PState *pstate)
+{
+    simple__frameSelf((simple_ *)infoset, pstate);
+}
+
+// Fill an infoset with random values for generating data
+
+void
+randomize_infoset(InfosetBase *infoset, RState *rstate)
+{
+    simple__randomize((simple_ *)infoset, rstate);
+}
@@ -1,13 +1,17 @@
 // auto-maintained by iwyu
 // clang-format off
 #include "generated_code.h"
-#include <stdbool.h>    // for false, bool, true
-#include <stddef.h>     // for NULL, size_t
-#include <string.h>     // for memcmp, memset
-#include "errors.h"     // for Error, PState, UState, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
-#include "parsers.h"    // for alloc_hexBinary, parse_hexBinary, parse_be_float, parse_be_int16, parse_be_bool32, parse_be_bool16, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool32, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_bool8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_bool16, parse_le_bool8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64
-#include "unparsers.h"  // for unparse_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool32, unparse_be_bool16, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool32, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_bool8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_bool16, unparse_le_bool8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64
-#include "validators.h" // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration, validate_integer_enumeration, validate_schema_range
+#include <stdbool.h>     // for false, bool, true
+#include <stddef.h>      // for NULL, size_t
+#include <stdint.h>      // for int64_t, uint8_t, INT64_MIN, SIZE_MAX, UINT64_MAX
+#include <string.h>      // for memcmp
+#include "errors.h"      // for Error, PState, UState, ERR_ARRAY_ALLOC, ERR_CHOICE_KEY, Error::(anonymous), UNUSED
+#include "infoset.h"     // for arena_grow, switch_choice, InfosetBase, Delimiters, ERD, ReserveArray
+#include "parsers.h"     // for alloc_hexBinary, parse_delimited_string, parse_delimiter, parse_hexBinary, parse_lsbf_hexBinary, parse_be_float, parse_be_int16, parse_be_bool, parse_be_int32, parse_be_uint16, parse_be_uint32, parse_le_bool, parse_le_int64, parse_le_uint16, parse_le_uint8, parse_be_double, parse_be_int64, parse_be_int8, parse_be_uint64, parse_be_uint8, parse_le_double, parse_le_float, parse_le_int16, parse_le_int32, parse_le_int8, parse_le_uint32, parse_le_uint64, parse_lsbf_int32, parse_lsbf_uint32
+#include "profiler.h"    // for PROFILE_ELEMENT, PROFILE_FIELD
+#include "randomizers.h"  // for random_double, random_hexBinary, random_hexBinary_alloc, random_hexBinary_copy, random_index, random_int, random_string, random_uint, RState
+#include "unparsers.h"   // for unparse_delimited_string, unparse_delimiter, unparse_hexBinary, unparse_lsbf_hexBinary, unparse_be_float, unparse_be_int16, unparse_be_bool, unparse_be_int32, unparse_be_uint16, unparse_be_uint32, unparse_le_bool, unparse_le_int64, unparse_le_uint16, unparse_le_uint8, unparse_be_double, unparse_be_int64, unparse_be_int8, unparse_be_uint64, unparse_be_uint8, unparse_le_double, unparse_le_float, unparse_le_int16, unparse_le_int32, unparse_le_int8, unparse_le_uint32, unparse_le_uint64, unparse_lsbf_int32, unparse_lsbf_uint32
+#include "validators.h"  // for validate_array_bounds, validate_fixed_attribute, validate_floatpt_enumeration_sorted, validate_hexbinary_enumeration_sorted, validate_integer_enumeration_bitset, validate_schema_range
 // clang-format on
 
 // Declare prototypes for easier compilation
@@ -20,6 +24,7 @@ static void array_after_expressionType_expressionElement__unparseSelf(const expr
 static size_t array_after_expressionType_expressionElement__getArraySize(const expressionElement_ *instance);
 static void expressionElement__parseSelf(expressionElement_ *instance, PState *pstate);
 static void expressionElement__unparseSelf(const expressionElement_ *instance, UState *ustate);
+static void expressionElement__frameSelf(expressionElement_ *instance, PState *pstate);
 
 // Define schema version (will be empty if schema did not define any version string)
 
@@ -157,9 +162,22 @@ array_variablelen_expressionType_expressionElement__initERD(expressionElement_ *
     UNUSED(parent);
 }
 
+static void
+array_variablelen_expressionType_expressionElement__reset(expressionElement_ *instance)
+{
+    const size_t arraySize = array_variablelen_expressionType_expressionElement__getArraySize(instance);
+    const size_t numElements = arraySize < 16 ? arraySize : 16;
+
+    for (size_t i = 0; i < numElements; i++)
+    {
+        instance->variablelen[i] = 0;
+    }
+}
+
 static void
 array_variablelen_expressionType_expressionElement__parseSelf(expressionElement_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_variablelen_expressionType_expressionElement_ERD, &pstate->pu);
     const size_t arraySize = array_variablelen_expressionType_expressionElement__getArraySize(instance);
     validate_array_bounds("array_variablelen_expressionType_expressionElement_", arraySize, 0, 16, &pstate->pu);
     if (pstate->pu.error) return;
@@ -168,12 +186,14 @@ array_variablelen_expressionType_expressionElement__parseSelf(expressionElement_
     {
         parse_be_uint32(&instance->variablelen[i], 32, pstate);
         if (pstate->pu.error) return;
+        PROFILE_FIELD(&variablelen_expressionType_ERD);
     }
 }
 
 static void
 array_variablelen_expressionType_expressionElement__unparseSelf(const expressionElement_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_variablelen_expressionType_expressionElement_ERD, &ustate->pu);
     const size_t arraySize = array_variablelen_expressionType_expressionElement__getArraySize(instance);
     validate_array_bounds("array_variablelen_expressionType_expressionElement_", arraySize, 0, 16, &ustate->pu);
     if (ustate->pu.error) return;
@@ -182,6 +202,19 @@ array_variablelen_expressionType_expressionElement__unparseSelf(const expression
     {
         unparse_be_uint32(instance->variablelen[i], 32, ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&variablelen_expressionType_ERD);
+    }
+}
+
+static void
+array_variablelen_expressionType_expressionElement__randomize(expressionElement_ *instance, RState *rstate)
+{
+    const size_t arraySize = random_uint(0, 16, rstate);
+    instance->variablelen_size = arraySize;
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        instance->variablelen[i] = random_uint(0, 4294967295, rstate);
     }
 }
 
@@ -198,9 +231,24 @@ array_after_expressionType_expressionElement__initERD(expressionElement_ *instan
     UNUSED(parent);
 }
 
+static void
+array_after_expressionType_expressionElement__reset(expressionElement_ *instance)
+{
+    const size_t arraySize = array_after_expressionType_expressionElement__getArraySize(instance);
+    const size_t numElements = arraySize < 2 ? arraySize : 2;
+
+    for (size_t i = 0; i < numElements; i++)
+    {
+        instance->after[i] = 0;
+    }
+}
+
 static void
 array_after_expressionType_expressionElement__parseSelf(expressionElement_ *instance, PState *pstate)
 {
+    PROFILE_ELEMENT(&array_after_expressionType_expressionElement_ERD, &pstate->pu);
+    parse_read_ahead(64, pstate);
+    if (pstate->pu.error) return;
     const size_t arraySize = array_after_expressionType_expressionElement__getArraySize(instance);
     validate_array_bounds("array_after_expressionType_expressionElement_", arraySize, 2, 2, &pstate->pu);
     if (pstate->pu.error) return;
@@ -208,13 +256,14 @@ array_after_expressionType_expressionElement__parseSelf(expressionElement_ *inst
     for (size_t i = 0; i < arraySize; i++)
     {
         parse_be_uint32(&instance->after[i], 32, pstate);
-        if (pstate->pu.error) return;
+        PROFILE_FIELD(&after_expressionType_ERD);
     }
 }
 
 static void
 array_after_expressionType_expressionElement__unparseSelf(const expressionElement_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&array_after_expressionType_expressionElement_ERD, &ustate->pu);
     const size_t arraySize = array_after_expressionType_expressionElement__getArraySize(instance);
     validate_array_bounds("array_after_expressionType_expressionElement_", arraySize, 2, 2, &ustate->pu);
     if (ustate->pu.error) return;
@@ -223,6 +272,18 @@ array_after_expressionType_expressionElement__unparseSelf(const expressionElemen
     {
         unparse_be_uint32(instance->after[i], 32, ustate);
         if (ustate->pu.error) return;
+        PROFILE_FIELD(&after_expressionType_ERD);
+    }
+}
+
+static void
+array_after_expressionType_expressionElement__randomize(expressionElement_ *instance, RState *rstate)
+{
+    const size_t arraySize = array_after_expressionType_expressionElement__getArraySize(instance);
+
+    for (size_t i = 0; i < arraySize; i++)
+    {
+        instance->after[i] = random_uint(0, 4294967295, rstate);
     }
 }
 
@@ -242,13 +303,36 @@ expressionElement__initERD(expressionElement_ *instance, InfosetBase *parent)
     array_after_expressionType_expressionElement__initERD(instance, parent);
 }
 
+static void
+expressionElement__reset(expressionElement_ *instance)
+{
+    array_after_expressionType_expressionElement__reset(instance);
+    array_variablelen_expressionType_expressionElement__reset(instance);
+    instance->variablelen_size = 0;
+    instance->before = 0;
+}
+
+static void
+expressionElement__randomize(expressionElement_ *instance, RState *rstate)
+{
+    instance->before = random_uint(0, 4294967295, rstate);
+    instance->variablelen_size = random_uint(0, 4294967295, rstate);
+    array_variablelen_expressionType_expressionElement__randomize(instance, rstate);
+    if (rstate->error) return;
+    array_after_expressionType_expressionElement__randomize(instance, rstate);
+    if (rstate->error) return;
+}
+
 static void
 expressionElement__parseSelf(expressionElement_ *instance, PState *pstate)
 {
-    parse_be_uint32(&instance->before, 32, pstate);
+    PROFILE_ELEMENT(&expressionElement_ERD, &pstate->pu);
+    parse_read_ahead(64, pstate);
     if (pstate->pu.error) return;
+    parse_be_uint32(&instance->before, 32, pstate);
+    PROFILE_FIELD(&before_expressionType_ERD);
     parse_be_uint32(&instance->variablelen_size, 32, pstate);
-    if (pstate->pu.error) return;
+    PROFILE_FIELD(&variablelen_size_expressionType_ERD);
     array_variablelen_expressionType_expressionElement__parseSelf(instance, pstate);
     if (pstate->pu.error) return;
     array_after_expressionType_expressionElement__parseSelf(instance, pstate);
@@ -258,31 +342,73 @@ expressionElement__parseSelf(expressionElement_ *instance, PState *pstate)
 static void
 expressionElement__unparseSelf(const expressionElement_ *instance, UState *ustate)
 {
+    PROFILE_ELEMENT(&expressionElement_ERD, &ustate->pu);
     unparse_be_uint32(instance->before, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&before_expressionType_ERD);
     unparse_be_uint32(instance->variablelen_size, 32, ustate);
     if (ustate->pu.error) return;
+    PROFILE_FIELD(&variablelen_size_expressionType_ERD);
     array_variablelen_expressionType_expressionElement__unparseSelf(instance, ustate);
     if (ustate->pu.error) return;
     array_after_expressionType_expressionElement__unparseSelf(instance, ustate);
     if (ustate->pu.error) return;
 }
 
-// Get an infoset (optionally clearing it first) for parsing/walking
+static void
+expressionElement__frameSelf(expressionElement_ *instance, PState *pstate)
+{
+    parse_read_ahead(64, pstate);
+    if (pstate->pu.error) return;
+    parse_skip_bits(32, pstate);
+    if (pstate->pu.error) return;
+    parse_be_uint32(&instance->variablelen_size, 32, pstate);
+    array_variablelen_expressionType_expressionElement__parseSelf(instance, pstate);
+    if (pstate->pu.error) return;
+    array_after_expressionType_expressionElement__parseSelf(instance, pstate);
+    if (pstate->pu.error) return;
+}
+
+// Get an infoset (optionally clearing it first) for parsing/walking.
+// Each thread gets its own infoset.
 
 InfosetBase *
 get_infoset(bool clear_infoset)
 {
-    static expressionElement_ infoset;
+    static _Thread_local expressionElement_ infoset;
+    static _Thread_local bool initialized;
 
     if (clear_infoset)
     {
-        // If your infoset contains hexBinary prefixed length elements,
-        // you may want to walk infoset first to free their malloc'ed
-        // storage - we are not handling that case for now...
-        memset(&infoset, 0, sizeof(infoset));
-        expressionElement__initERD(&infoset, (InfosetBase *)&infoset);
+        // Initialize the infoset's ERD and parent pointers only once,
+        // then clear only the values which the last parse filled in
+        if (initialized)
+        {
+            expressionElement__reset(&infoset);
+        }
+        else
+        {
+            expressionElement__initERD(&infoset, (InfosetBase *)&infoset);
+            initialized = true;
+        }
     }
 
     return &infoset._base;
 }
+
+// Frame a record by parsing only the fields needed to find where it
+// ends and skipping over the rest of its data for building an index
+
+void
+frame_record(InfosetBase *infoset, PState *pstate)
+{
+    expressionElement__frameSelf((expressionElement_ *)infoset, pstate);
+}
+
+// Fill an infoset with random values for generating data
+
+void
+randomize_infoset(InfosetBase *infoset, RState *rstate)
+{
+    expressionElement__randomize((expressionElement_ *)infoset, rstate);
+}
@@ -6,7 +6,7 @@
 #include <stdbool.h>  // for bool
 #include <stddef.h>   // for size_t
 #include <stdint.h>   // for uint8_t, int16_t, int32_t, int64_t, uint32_t, int8_t, uint16_t, uint64_t
-#include "infoset.h"  // for InfosetBase, HexBinary
+#include "infoset.h"  // for InfosetBase, HexBinary, String
 // clang-format on
 
 // Define schema version (will be empty if schema did not define any version string)
@@ -0,0 +1,295 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package org.apache.daffodil.codegen.c
+
+import scala.jdk.CollectionConverters.*
+
+import org.apache.daffodil.core.compiler.Compiler
+import org.apache.daffodil.lib.iapi.TDMLImplementation
+
+import org.junit.AfterClass
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+/**
+ * Builds executables from the test schemas and checks command line
+ * behavior which TDML tests can't reach since they parse and unparse
+ * only one infoset at a time through the serve subcommand
+ */
+object TestDaffodilCExecutable {
+  val rootDir = if (os.exists(os.pwd / "src")) os.pwd / os.up else os.pwd
+  val schemaDir =
+    rootDir / os.RelPath("daffodil-codegen-c/src/test/resources/org/apache/daffodil/codegen/c")
+  val dataDir = schemaDir / "data"
+  val tempDir: os.Path =
+    os.temp.dir(dir = null, prefix = TDMLImplementation.DaffodilC.toString)
+
+  // Generates C code from a schema and compiles it into an executable
+  def build(
+    schema: String,
+    optRootName: Option[String] = None,
+    tunables: Map[String, String] = Map.empty
+  ): os.Path = {
+    val pf =
+      Compiler().withTunables(tunables).compileFile((schemaDir / schema).toIO, optRootName)
+    assert(!pf.isError, pf.getDiagnostics.asScala.map(_.getMessage()).mkString("\n"))
+    val cg = pf.forLanguage("c")
+    val codeDir = cg.generateCode(os.temp.dir(dir = tempDir).toString)
+    val exe = os.Path(cg.compileCode(codeDir))
+    assert(!cg.isError, cg.getDiagnostics.asScala.map(_.getMessage()).mkString("\n"))
+    exe
+  }
+
+  // Runs an executable within the temporary directory and returns its
+  // result without checking its exit code
+  def run(exe: os.Path, args: String*): os.CommandResult =
+    os.proc(exe, args).call(cwd = tempDir, check = false, stderr = os.Pipe)
+
+  // Runs an executable and returns its standard output after checking
+  // it succeeded
+  def output(exe: os.Path, args: String*): String = {
+    val result = run(exe, args*)
+    assertEquals(result.err.text(), 0, result.exitCode)
+    result.out.text()
+  }
+
+  // Writes a stream of three padtest records to a temporary file
+  def padtestStream(): os.Path = os.temp(
+    os.read.bytes(dataDir / "padtest.00.dat") ++ os.read.bytes(dataDir / "padtest.01.dat") ++
+      os.read.bytes(dataDir / "padtest.16.dat"),
+    dir = tempDir
+  )
+
+  // Input backends which read files the same way on this machine (the
+  // uring backend falls back to mmap where io_uring_setup fails, e.g.,
+  // with ENOSYS on kernels without io_uring, so it's worth comparing
+  // only on kernels which have io_uring and don't disable it)
+  lazy val ioBackends: Seq[String] = {
+    val disabled = os.root / "proc" / "sys" / "kernel" / "io_uring_disabled"
+    val hasIoUring = os.exists(disabled) && os.read(disabled).trim != "2"
+    if (hasIoUring) Seq("stdio", "mmap", "uring") else Seq("stdio", "mmap")
+  }
+
+  lazy val exNums: os.Path = build("ex_nums.dfdl.xsd")
+  lazy val nestedUnion: os.Path = build("nested.dfdl.xsd", Some("NestedUnion"))
+  lazy val padtest: os.Path = build("padtest.dfdl.xsd")
+  lazy val simple: os.Path = build("simple.dfdl.xsd", Some("simple"))
+  lazy val variablelen: os.Path = build("variablelen.dfdl.xsd", Some("expressionElement"))
+
+  // Writes a stream of random ex_nums records larger than both the
+  // uring backend's 1 MiB input buffers and the --async output queue
+  // to a temporary file
+  lazy val exNumsStream: os.Path = {
+    val data = os.temp(dir = tempDir)
+    output(exNums, "-n", "4000", "-R", "7", "-o", data.toString, "generate-data")
+    assert(os.size(data) > (1 << 20), s"${os.size(data)} bytes")
+    data
+  }
+
+  @AfterClass def shutDown(): Unit = {
+    os.remove.all(tempDir)
+  }
+}
+
+class TestDaffodilCExecutable {
+  import TestDaffodilCExecutable.*
+
+  // Checks CSV output has a header row and one row per infoset
+  @Test def test_csv(): Unit = {
+    val csv = output(padtest, "-I", "csv", "parse", (dataDir / "padtest.16.dat").toString)
+    assertEquals("padhexbinary.opaque,after\n31323334353637383930414243444546,17\n", csv)
+  }
+
+  // Checks TSV output from a stream of infosets has one row per infoset
+  @Test def test_tsv_stream(): Unit = {
+    val data = padtestStream()
+    val tsv = output(padtest, "-I", "tsv", "-S", "parse", data.toString)
+    assertEquals(
+      "padhexbinary.opaque\tafter\n\t1\n31\t2\n31323334353637383930414243444546\t17\n",
+      tsv
+    )
+  }
+
+  // Checks CSV header qualifies each column's name with its element's
+  // path so elements with the same name get unique columns
+  @Test def test_csv_unique_columns(): Unit = {
+    val rows = output(exNums, "-I", "csv", "parse", (dataDir / "ex_nums.dat").toString)
+      .split('\n')
+    assertEquals(2, rows.length)
+    val header = rows(0).split(',').toSeq
+    assertEquals(header.distinct, header)
+    assert(header.contains("littleEndian.hexBinary0"), header.mkString(","))
+    assert(header.contains("fixed.hexBinary0"), header.mkString(","))
+    assertEquals(header.length, rows(1).split(",", -1).length)
+  }
+
+  // Checks threads running warmups and timed iterations report only
+  // the timed records and bytes
+  @Test def test_performance_threads(): Unit = {
+    val data = padtestStream()
+    val args = Seq("-t", "2", "-N", "3", "--warmup", "2", "-S", "-I", "null")
+    val report = output(padtest, (args ++ Seq("performance", data.toString))*)
+    assert(report.startsWith("threads: 2, iterations: 3, records: 9, bytes: 132\n"), report)
+  }
+
+  // Checks random records generated from each example schema parse
+  // back with validation on and no errors
+  @Test def test_generate_data_round_trip(): Unit = {
+    Seq(exNums, nestedUnion, padtest, simple, variablelen).foreach { exe =>
+      val data = os.temp(dir = tempDir)
+      output(exe, "-n", "20", "-R", "7", "-o", data.toString, "generate-data")
+      val xml = output(exe, "-S", "-V", "daffodil", "parse", data.toString)
+      assertEquals(exe.toString, 20, xml.split("<\\?xml ").length - 1)
+    }
+  }
+
+  // Checks compiling another schema hits the object cache while
+  // compiling with other flags misses it
+  @Test def test_object_cache(): Unit = {
+    val cacheDir = os.temp.dir(dir = tempDir)
+    val tunables = Map("cObjectCacheDir" -> cacheDir.toString)
+    def entries = os.list(cacheDir).filter(os.isDir(_))
+
+    build("padtest.dfdl.xsd", tunables = tunables)
+    assertEquals(1, entries.length)
+    val objFile = entries.head / "libruntime_infoset.o"
+    val objMtime = os.mtime(objFile)
+
+    build("simple.dfdl.xsd", Some("simple"), tunables)
+    assertEquals(1, entries.length)
+    assertEquals(objMtime, os.mtime(objFile))
+
+    build("padtest.dfdl.xsd", tunables = tunables + ("cBuildProfile" -> "release"))
+    assertEquals(2, entries.length)
+  }
+
+  // Checks resetting the infoset between records in a stream leaves
+  // nothing behind, so each record's infoset is the same as when it's
+  // parsed alone (the shorter array must not keep the longer one's
+  // elements)
+  @Test def test_reset_between_records(): Unit = {
+    val files = Seq("variablelen.16.dat", "variablelen.01.dat", "variablelen.16.dat")
+    val bytes = files.map { file => os.read.bytes(dataDir / file) }.reduce(_ ++ _)
+    val data = os.temp(bytes, dir = tempDir)
+    val infosets = output(variablelen, "-S", "parse", data.toString).split('\u0000').toSeq
+    val expected = files.map { file => output(variablelen, "parse", (dataDir / file).toString) }
+    assertEquals(expected, infosets)
+  }
+
+  // Checks records taking different branches of a choice in a stream
+  // each parse the same as when parsed alone (switching branches must
+  // not leave the old branch's storage in the new branch)
+  @Test def test_choice_branches_between_records(): Unit = {
+    val files = Seq("nested.union.foo.dat", "nested.union.bar.dat", "nested.union.foo.dat")
+    val bytes = files.map { file => os.read.bytes(dataDir / file) }.reduce(_ ++ _)
+    val data = os.temp(bytes, dir = tempDir)
+    val infosets = output(nestedUnion, "-S", "parse", data.toString).split('\u0000').toSeq
+    val expected = files.map { file => output(nestedUnion, "parse", (dataDir / file).toString) }
+    assertEquals(expected, infosets)
+  }
+
+  // Checks a record failing the filter writes nothing (not even a NUL
+  // separator) and skips its remaining bits so the next record parses
+  // from where the filtered record ends
+  @Test def test_filtered_out_record(): Unit = {
+    val lsbf = build("lsbf.dfdl.xsd", tunables = Map("cFilter" -> "{ /record/c eq 2748 }"))
+    val xml = output(lsbf, "-S", "parse", (dataDir / "lsbf.filtered.dat").toString)
+    assertEquals(output(lsbf, "parse", (dataDir / "lsbf.dat").toString), xml)
+  }
+
+  // Checks asking for a record past the end of the index fails before
+  // writing the CSV header
+  @Test def test_record_past_index(): Unit = {
+    val data = padtestStream()
+    output(padtest, "index", data.toString)
+    val result = run(padtest, "-i", "4", "-I", "csv", "parse", data.toString)
+    assertEquals(1, result.exitCode)
+    assertEquals("", result.out.text())
+    assertEquals("record 4 not found in index file\n", result.err.text())
+  }
+
+  // Checks a record range running past the last record parses the
+  // records it has and warns where the range ended
+  @Test def test_record_range_truncated(): Unit = {
+    val data = padtestStream()
+    output(padtest, "index", data.toString)
+    val result = run(padtest, "-i", "2-5", "-I", "csv", "parse", data.toString)
+    assertEquals(0, result.exitCode)
+    assertEquals(output(padtest, "-i", "2-3", "-I", "csv", "parse", data.toString), result.out.text())
+    assertEquals(
+      "warning: record range ends early at record 3, the last record in infile\n",
+      result.err.text()
+    )
+  }
+
+  // Checks every input backend indexes and parses the same records
+  // from a file larger than one of the uring backend's 1 MiB buffers,
+  // both reading the whole file and seeking to records past its first
+  // buffer using its index
+  @Test def test_io_backends(): Unit = {
+    val data = exNumsStream
+    val indexes = ioBackends.map { io =>
+      val index = os.temp(dir = tempDir)
+      output(exNums, "--io", io, "-o", index.toString, "index", data.toString)
+      os.read.bytes(index).toSeq
+    }
+    indexes.foreach { index => assertEquals(indexes.head, index) }
+    output(exNums, "index", data.toString)
+
+    val argsList =
+      Seq(Seq("-S", "-I", "csv"), Seq("-i", "3500-3502"), Seq("-i", "2", "-I", "csv"))
+    argsList.foreach { args =>
+      val outputs = ioBackends.map { io =>
+        output(exNums, (Seq("--io", io) ++ args ++ Seq("parse", data.toString))*)
+      }
+      outputs.foreach { out => assertEquals(args.mkString(" "), outputs.head, out) }
+    }
+  }
+
+  // Checks writing through the --async output queue gives the same
+  // output as writing directly, even when the output fills the queue
+  // several times over
+  @Test def test_async_output(): Unit = {
+    val data = exNumsStream
+    val csvArgs = Seq("-S", "-I", "csv", "parse", data.toString)
+    val csv = output(exNums, csvArgs*)
+    assert(csv.length > 4 * (1 << 18), s"${csv.length} bytes")
+    assertEquals(csv, output(exNums, ("--async" +: csvArgs)*))
+
+    val generateArgs = Seq("-n", "4000", "-R", "7", "generate-data")
+    val generated = run(exNums, generateArgs*).out.bytes.toSeq
+    assertEquals(os.read.bytes(data).toSeq, generated)
+    assertEquals(generated, run(exNums, ("--async" +: generateArgs)*).out.bytes.toSeq)
+  }
+
+  // Checks a parse which fails partway still writes every record
+  // before the failing one through the --async output queue since
+  // exiting closes the queue's stream
+  @Test def test_async_output_error_exit(): Unit = {
+    val truncated = os.read.bytes(dataDir / "ex_nums.dat").take(10)
+    val data = os.temp(os.read.bytes(exNumsStream) ++ truncated, dir = tempDir)
+    val args = Seq("-S", "-I", "csv", "parse", data.toString)
+    val direct = run(exNums, args*)
+    val async = run(exNums, ("--async" +: args)*)
+    assertEquals(1, direct.exitCode)
+    assertEquals(1, async.exitCode)
+    assertEquals(direct.err.text(), async.err.text())
+    assertEquals(4001, direct.out.text().count(_ == '\n'))
+    assertEquals(direct.out.text(), async.out.text())
+  }
+}
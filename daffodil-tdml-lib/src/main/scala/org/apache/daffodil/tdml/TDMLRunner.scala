@@ -610,6 +610,7 @@ class DFDLTestSuite private[tdml] (
 
   def cleanUp(): Unit = {
     GlobalTDMLCompileResultCache.cache.setEntriesFinished(globalTDMLCompileResultCacheKeys)
+    embeddedCompileResultCache.clear()
   }
 
 }
@@ -3062,7 +3063,25 @@ case class TDMLCompileResultCache(entryExpireDurationSeconds: Option[Long]) {
     val keysToRemove = cache.filterNot { case (k, v) =>
       v.optExpireTimeMillis.forall(now < _)
     }.keys
-    keysToRemove.foreach(cache.remove)
+    keysToRemove.foreach(removeEntry)
+  }
+
+  // Removes an entry and closes any of its processors which hold resources
+  // outside the JVM (e.g., a child process) since nothing else will use them
+  private def removeEntry(key: TDMLCompileResultCacheKey): Unit = {
+    cache.remove(key).foreach { value =>
+      value.compileResultMap.values.foreach {
+        case Right((_, processor: AutoCloseable)) => processor.close()
+        case _ =>
+      }
+    }
+  }
+
+  /**
+   * Removes all entries from the cache, closing their processors
+   */
+  def clear(): Unit = this.synchronized {
+    cache.keys.toSeq.foreach(removeEntry)
   }
 
   def setEntriesFinished(keys: mutable.Set[TDMLCompileResultCacheKey]): Unit =
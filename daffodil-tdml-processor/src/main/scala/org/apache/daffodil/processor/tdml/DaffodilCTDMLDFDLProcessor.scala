@@ -17,9 +17,12 @@
 
 package org.apache.daffodil.processor.tdml
 
-import java.io.FileNotFoundException
+import java.io.ByteArrayInputStream
+import java.io.EOFException
+import java.io.IOException
 import java.io.InputStream
 import java.io.OutputStream
+import java.nio.charset.StandardCharsets
 import scala.jdk.CollectionConverters.*
 import scala.xml.Node
 import scala.xml.XML
@@ -117,8 +120,12 @@ final class DaffodilCTDMLDFDLProcessorFactory(compiler: Compiler)
  * A TDMLDFDL processor which runs an executable built from C code for
  * a given DFDL schema.  Deals with TDML XML infosets, feeding to the
  * executable, returning the output created by the executable, etc.
+ * Closing the processor stops its executable (the TDML runner closes
+ * it when it removes the processor from its compile result cache).
  */
-final class DaffodilCTDMLDFDLProcessor(executable: os.Path) extends TDMLDFDLProcessor {
+final class DaffodilCTDMLDFDLProcessor(executable: os.Path)
+  extends TDMLDFDLProcessor
+  with AutoCloseable {
 
   // We don't pass any options to the executable
   override type R = DaffodilCTDMLDFDLProcessor
@@ -127,43 +134,45 @@ final class DaffodilCTDMLDFDLProcessor(executable: os.Path) extends TDMLDFDLProc
   override def withValidation(validation: String): R = this
   override def withExternalDFDLVariables(externalVarBindings: Seq[Binding]): R = this
 
+  // Runs the executable only once for all of this schema's test cases
+  // (the worker doesn't start the executable until the first request)
+  private val worker = new DaffodilCTDMLWorker(executable)
+
+  // Stops the executable if it's running
+  override def close(): Unit = worker.close()
+
   // Parses the input stream to an infoset and returns a TDMLParseResult
   // containing the infoset with any errors and diagnostics.
   //
-  // We save the input stream to an input file and run the executable in a
-  // subprocess.  The executable will parse data from the input file and write an
-  // infoset to an output file.  We return the infoset with any errors and
-  // diagnostics messages written by the executable on its standard error and/or
-  // output.
+  // We send the input stream to the executable in a parse request.  The
+  // executable will parse the data and answer with an infoset.  We return the
+  // infoset with any errors and diagnostics messages written by the executable
+  // in its response.
   override def parse(input: InputStream, lengthLimitInBits: Long): TDMLParseResult = {
-    // Write the input to an input file to let the executable parse it
-    val tempDir = os.temp.dir(dir = null, prefix = TDMLImplementation.DaffodilC.toString)
-    val infile = tempDir / "infile"
-    val outfile = tempDir / "outfile"
-    os.write(infile, input)
-
-    // Verify the input file has the correct size TDML runner said it would
-    val inputSizeInBits = os.size(infile) * 8
+    // Verify the input has the correct size TDML runner said it would
+    val data = input.readAllBytes()
+    val inputSizeInBits = data.length.toLong * 8
     assert(
       inputSizeInBits == lengthLimitInBits,
-      s"$infile has $inputSizeInBits bits, but needed $lengthLimitInBits bits"
+      s"input has $inputSizeInBits bits, but needed $lengthLimitInBits bits"
     )
 
-    // Parse the input file using the executable and capture its exit status
+    // Parse the input using the executable and capture its status
     val parseResult =
       try {
-        // Darwin and MSYS2 support only "daffodil -o outfile parse infile" (all getopt options must come first)
-        val result = os
-          .proc(executable, "-o", outfile, "parse", infile)
-          .call(cwd = tempDir, stderr = os.Pipe)
-        val messages = if (result.chunks.nonEmpty) result.toString() else ""
-        new DaffodilCTDMLParseResult(lengthLimitInBits, outfile, Success, messages)
+        val response = worker.request("parse", data)
+        val infoset = response.bytes
+        if (response.ok) {
+          new DaffodilCTDMLParseResult(lengthLimitInBits, infoset, Success, response.messages)
+        } else {
+          val parseError = new ParseError(Nope, Nope, Nope, Maybe("%s"), response.messages)
+          new DaffodilCTDMLParseResult(lengthLimitInBits, infoset, Failure(parseError))
+        }
       } catch {
-        case e: os.SubprocessException =>
+        case e: IOException =>
           val parseError = new ParseError(Nope, Nope, Maybe(e), Nope)
-          new DaffodilCTDMLParseResult(lengthLimitInBits, outfile, Failure(parseError))
-      } finally {
-        os.remove.all(tempDir)
+          val infoset = Array.emptyByteArray
+          new DaffodilCTDMLParseResult(lengthLimitInBits, infoset, Failure(parseError))
       }
 
     parseResult
@@ -172,35 +181,28 @@ final class DaffodilCTDMLDFDLProcessor(executable: os.Path) extends TDMLDFDLProc
   // Unparses the infoset and returns a TDMLUnparseResult containing the data with
   // any errors and diagnostics.
   //
-  // We save the infoset to an input file and run the executable in a subprocess.
-  // The executable will unparse the infoset and write data to an output file.  We
-  // return the data with any errors and diagnostics messages written by the
-  // executable on its standard error and/or output.
+  // We send the infoset to the executable in an unparse request.  The executable
+  // will unparse the infoset and answer with data.  We return the data with any
+  // errors and diagnostics messages written by the executable in its response.
   override def unparse(infosetXML: Node, output: OutputStream): TDMLUnparseResult = {
-    // Write the infoset to an input file to let the executable parse it
-    val tempDir = os.temp.dir(dir = null, prefix = TDMLImplementation.DaffodilC.toString)
-    val infile = tempDir / "infile"
-    val outfile = tempDir / "outfile"
-    os.write(infile, infosetXML.toString)
+    val infoset = infosetXML.toString.getBytes(StandardCharsets.UTF_8)
 
-    // Unparse the infoset using the executable, capture its exit status, and return the data
+    // Unparse the infoset using the executable, capture its status, and return the data
     val unparseResult =
       try {
-        // Darwin and MSYS2 support only "daffodil -o outfile parse infile" (all getopt options must come first)
-        val result = os
-          .proc(executable, "-o", outfile, "unparse", infile)
-          .call(cwd = tempDir, stderr = os.Pipe)
-        os.read.stream(outfile).writeBytesTo(output)
-        val finalBitPos0b = os.size(outfile) * 8
-        val messages = if (result.chunks.nonEmpty) result.toString() else ""
-        new DaffodilCTDMLUnparseResult(finalBitPos0b, Success, messages)
+        val response = worker.request("unparse", infoset)
+        val finalBitPos0b = response.bytes.length.toLong * 8
+        if (response.ok) {
+          output.write(response.bytes)
+          new DaffodilCTDMLUnparseResult(finalBitPos0b, Success, response.messages)
+        } else {
+          val unparseError = new UnparseError(Nope, Nope, Nope, Maybe("%s"), response.messages)
+          new DaffodilCTDMLUnparseResult(finalBitPos0b, Failure(unparseError))
+        }
       } catch {
-        case e: os.SubprocessException =>
-          val finalBitPos0b = os.size(outfile) * 8
+        case e: IOException =>
           val unparseError = new UnparseError(Nope, Nope, Maybe(e), Nope)
-          new DaffodilCTDMLUnparseResult(finalBitPos0b, Failure(unparseError))
-      } finally {
-        os.remove.all(tempDir)
+          new DaffodilCTDMLUnparseResult(0, Failure(unparseError))
       }
 
     unparseResult
@@ -217,12 +219,94 @@ final class DaffodilCTDMLDFDLProcessor(executable: os.Path) extends TDMLDFDLProc
   }
 }
 
+/**
+ * A response to a parse or unparse request
+ */
+final case class DaffodilCTDMLResponse(ok: Boolean, bytes: Array[Byte], messages: String)
+
+/**
+ * A long-lived executable which answers parse and unparse requests
+ * framed by their lengths on its standard input and output (see the
+ * executable's serve command).  Starts the executable when the first
+ * request comes and again if the executable ever stops.  Closing the
+ * worker stops the executable; otherwise the executable stops by itself
+ * when the JVM exits since its standard input closes.
+ */
+final class DaffodilCTDMLWorker(executable: os.Path) extends AutoCloseable {
+
+  private var maybeProcess: Option[os.SubProcess] = None
+
+  // Sends a request to the executable and returns its response, or throws
+  // an IOException if the executable stops before answering the request
+  def request(command: String, payload: Array[Byte]): DaffodilCTDMLResponse = synchronized {
+    val process = maybeProcess.filter(_.isAlive()).getOrElse(start())
+    try {
+      process.stdin.write(s"$command ${payload.length}\n".getBytes(StandardCharsets.US_ASCII))
+      process.stdin.write(payload)
+      process.stdin.flush()
+
+      // Read the response's header line, infoset or data, and messages
+      val line = readLine(process.stdout)
+      val (ok, bytesLength, messagesLength) = line.split(' ') match {
+        case Array(status @ ("ok" | "error"), n1, n2) if n1.toIntOption.exists(_ >= 0) &&
+            n2.toIntOption.exists(_ >= 0) =>
+          (status == "ok", n1.toInt, n2.toInt)
+        case _ =>
+          throw new IOException(s"invalid response from $executable: $line")
+      }
+      val bytes = readBytes(process.stdout, bytesLength)
+      val messages = readBytes(process.stdout, messagesLength)
+      DaffodilCTDMLResponse(ok, bytes, new String(messages, StandardCharsets.UTF_8))
+    } catch {
+      case e: IOException =>
+        // Stop the executable since we can't tell where its next response starts
+        process.destroy()
+        maybeProcess = None
+        throw e
+    }
+  }
+
+  // Stops the executable if it's running (a later request will start it
+  // again)
+  override def close(): Unit = synchronized {
+    maybeProcess.foreach(_.destroy())
+    maybeProcess = None
+  }
+
+  // Starts the executable in serve mode
+  private def start(): os.SubProcess = {
+    val process = os.proc(executable, "serve").spawn(cwd = executable / os.up)
+    maybeProcess = Some(process)
+    process
+  }
+
+  // Reads a header line without its newline
+  private def readLine(in: InputStream): String = {
+    val line = new StringBuilder
+    var b = in.read()
+    while (b != '\n') {
+      if (b == -1) throw new EOFException(s"$executable stopped before answering request")
+      line += b.toChar
+      b = in.read()
+    }
+    line.toString
+  }
+
+  // Reads exactly the given number of bytes
+  private def readBytes(in: InputStream, length: Int): Array[Byte] = {
+    val bytes = in.readNBytes(length)
+    if (bytes.length < length)
+      throw new EOFException(s"$executable stopped before answering request")
+    bytes
+  }
+}
+
 /**
  * A TDML parse result which captures the result of running the executable
  */
 final class DaffodilCTDMLParseResult(
   finalBitPos0b: Long,
-  outfile: os.Path,
+  infoset: Array[Byte],
   processorResult: ProcessorResult,
   messages: String = ""
 ) extends TDMLParseResult {
@@ -237,15 +321,13 @@ final class DaffodilCTDMLParseResult(
     diagnostics = diagnostic +: diagnostics
   }
 
-  // We must read outFile right away (def or lazy val will not work) because the parse
-  // method will delete outFile before returning the parse result, but we must prevent
-  // loadFile errors from interrupting the parse result's construction
+  // We load the infoset right away, but we must prevent load errors (e.g., no
+  // infoset after a parse error) from interrupting the parse result's construction
   override val getResult: Node = {
     val elem =
       try {
-        XML.loadFile(outfile.toIO)
+        XML.load(new ByteArrayInputStream(infoset))
       } catch {
-        case _: FileNotFoundException => <noFile></noFile>
         case _: SAXParseException => <parseError></parseError>
       }
     elem
@@ -133,6 +133,22 @@ class TestDaffodilC {
     assert(os.exists(executable))
   }
 
+  // Checks that codeGenerator.compileCode(codeDir) succeeds with each build profile
+  @Test def test_compileCode_buildProfiles(): Unit = {
+    Seq("release", "pgo").foreach { profile =>
+      // Create a CodeGenerator and generate code with the build profile
+      val pf = Compiler().withTunable("cBuildProfile", profile).compileNode(testSchema)
+      val cg = pf.forLanguage("c")
+      val codeDir = cg.generateCode((tempDir / profile).toString)
+      assert(os.read(os.Path(codeDir) / "Makefile").contains(s"BUILD = $profile"))
+
+      // Compile the generated code into an executable successfully
+      val executable = os.Path(cg.compileCode(codeDir))
+      assert(!cg.isError, cg.getDiagnostics.asScala.map(_.getMessage()).mkString("\n"))
+      assert(os.exists(executable))
+    }
+  }
+
   // Checks that daffodilTDMLDFDLProcessor.parse(goodData) succeeds
   @Test def test_parse_success(): Unit = {
     // Compile the test schema into an executable
@@ -171,6 +187,29 @@ class TestDaffodilC {
     assert(!pr.getDiagnostics.isEmpty, "expected pr.getDiagnostics to be non-empty")
   }
 
+  // Checks that daffodilTDMLDFDLProcessor keeps answering requests after an error
+  @Test def test_parse_repeatedly(): Unit = {
+    // Compile the test schema into an executable
+    val pf = Compiler().compileNode(testSchema)
+    val cg = pf.forLanguage("c")
+    val codeDir = cg.generateCode(tempDir.toString)
+    val executable = os.Path(cg.compileCode(codeDir))
+
+    // Create a DaffodilCTDMLDFDLProcessor and send it good, bad, and good data
+    val tdp = new DaffodilCTDMLDFDLProcessor(executable)
+    val expected = <e1><x>1280</x></e1>
+    for (hex <- Seq("00000500", "50", "00000500")) {
+      val b = Misc.hex2Bytes(hex)
+      val pr = tdp.parse(new ByteArrayInputStream(b), b.length * 8)
+      if (b.length == 4) {
+        assert(!pr.isProcessingError, pr.getDiagnostics.asScala.map(_.getMessage()).mkString)
+        XMLUtils.compareAndReport(expected, pr.getResult)
+      } else {
+        assert(pr.isProcessingError, "expected pr.isError to be true")
+      }
+    }
+  }
+
   // Checks that daffodilTDMLDFDLProcessor.unparse(goodData) succeeds
   @Test def test_unparse_success(): Unit = {
     // Compile the test schema into an executable
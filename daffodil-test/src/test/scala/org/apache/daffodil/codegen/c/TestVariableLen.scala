@@ -39,6 +39,7 @@ class TestVariableLen extends TdmlTests {
   @Test def expression_01 = test
   @Test def expression_16 = test
   @Test def expression_17 = test
+  @Test def unbounded_17 = test
   @Test def stopValue = test
 }
 
@@ -56,5 +57,6 @@ class TestVariableLenC extends TdmlTests {
   @Test def expression_01 = test
   @Test def expression_16 = test
   @Test def expression_17_error = test
+  @Test def unbounded_17 = test
   @Test def stopValue = test
 }